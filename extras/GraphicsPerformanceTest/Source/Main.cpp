@@ -0,0 +1,461 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+   Renders a set of standard scenes into an offscreen image as quickly as possible,
+   and reports how long each one takes. The results can be written as JSON, and
+   compared against a previous run to catch any rendering performance regressions.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+struct Scene
+{
+    String name, description;
+    int operationsPerFrame;
+    std::function<void (Graphics&, int frameNumber)> drawFrame;
+};
+
+static Image createTestImage (Image::PixelFormat format, int width, int height)
+{
+    Image image (format, width, height, true);
+    Graphics g (image);
+
+    g.setGradientFill (ColourGradient (Colours::orange, 0.0f, 0.0f,
+                                       Colours::darkblue.withAlpha (0.7f), (float) width, (float) height, false));
+    g.fillEllipse (image.getBounds().toFloat());
+
+    g.setColour (Colours::white);
+    g.drawLine (0.0f, 0.0f, (float) width, (float) height, 3.0f);
+
+    return image;
+}
+
+static Path createTestPath()
+{
+    Path p;
+    p.startNewSubPath (10.0f, 40.0f);
+    p.cubicTo (20.0f, -10.0f, 70.0f, 0.0f, 60.0f, 30.0f);
+    p.quadraticTo (55.0f, 60.0f, 30.0f, 55.0f);
+    p.cubicTo (20.0f, 70.0f, 0.0f, 60.0f, 10.0f, 40.0f);
+    p.closeSubPath();
+    p.addStar ({ 35.0f, 30.0f }, 5, 6.0f, 14.0f);
+    return p;
+}
+
+static std::vector<Scene> createScenes (int width, int height)
+{
+    std::vector<Scene> scenes;
+
+    auto position = [=] (int index, int itemWidth, int itemHeight)
+    {
+        return Point<int> ((index * 997) % jmax (1, width - itemWidth),
+                           (index * 613) % jmax (1, height - itemHeight));
+    };
+
+    scenes.push_back ({ "text", "Lines of text in various sizes", 500, [=] (Graphics& g, int frame)
+    {
+        for (int i = 0; i < 500; ++i)
+        {
+            auto pos = position (i + frame, 200, 20);
+            g.setColour (Colour (0xff000000 | (uint32) (i * 0x3579bd)));
+            g.setFont ((float) (10 + i % 14));
+            g.drawSingleLineText ("Gain " + String (i % 61) + " dB", pos.x, pos.y + 15);
+        }
+    }});
+
+    scenes.push_back ({ "gradients", "Linear and radial gradient fills", 200, [=] (Graphics& g, int frame)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            auto area = Rectangle<int> (120, 80).withPosition (position (i + frame, 120, 80)).toFloat();
+
+            g.setGradientFill (ColourGradient (Colours::red.withAlpha (0.8f), area.getTopLeft(),
+                                               Colours::blue.withAlpha (0.6f), area.getBottomRight(),
+                                               (i & 1) != 0));
+            g.fillRoundedRectangle (area, 6.0f);
+        }
+    }});
+
+    auto sprite = createTestImage (Image::ARGB, 64, 64);
+    auto background = createTestImage (Image::RGB, 256, 256);
+
+    scenes.push_back ({ "imageBlits", "Untransformed image copies, with and without alpha", 400, [=] (Graphics& g, int frame)
+    {
+        for (int i = 0; i < 400; ++i)
+        {
+            auto& image = (i & 3) == 0 ? background : sprite;
+            auto pos = position (i + frame, image.getWidth(), image.getHeight());
+            g.setOpacity ((i & 1) != 0 ? 1.0f : 0.5f);
+            g.drawImageAt (image, pos.x, pos.y);
+        }
+    }});
+
+    scenes.push_back ({ "transformedImages", "Rotated and scaled images, at each resampling quality", 150, [=] (Graphics& g, int frame)
+    {
+        for (int i = 0; i < 150; ++i)
+        {
+            auto pos = position (i + frame, 100, 100).toFloat();
+
+            g.setOpacity (1.0f);
+            g.setImageResamplingQuality ((i % 3) == 0 ? Graphics::lowResamplingQuality
+                                                      : ((i % 3) == 1 ? Graphics::mediumResamplingQuality
+                                                                      : Graphics::highResamplingQuality));
+            g.drawImageTransformed (sprite, AffineTransform::rotation ((float) i * 0.3f, 32.0f, 32.0f)
+                                                            .scaled (0.5f + (float) (i % 5) * 0.3f)
+                                                            .translated (pos));
+        }
+    }});
+
+    auto strip = createTestImage (Image::ARGB, 1024, 16);
+
+    scenes.push_back ({ "translucentSpans", "Translucent fills and image blends, from 4 to 1024 pixels wide", 500, [=] (Graphics& g, int frame)
+    {
+        for (int i = 0; i < 250; ++i)
+        {
+            auto spanWidth = 4 << ((i % 5) * 2);
+            auto pos = position (i + frame, spanWidth, 32);
+
+            g.setColour (Colour ((uint32) (i * 0x3579bd)).withAlpha (0.6f));
+            g.fillRect (pos.x, pos.y, spanWidth, 16);
+
+            g.setOpacity (0.5f);
+            g.drawImage (strip, pos.x, pos.y + 16, spanWidth, 16, 0, 0, spanWidth, 16);
+        }
+    }});
+
+    auto path = createTestPath();
+
+    scenes.push_back ({ "paths", "Filled and stroked curved paths", 300, [=] (Graphics& g, int frame)
+    {
+        PathStrokeType stroke (2.0f, PathStrokeType::curved, PathStrokeType::rounded);
+
+        for (int i = 0; i < 150; ++i)
+        {
+            auto transform = AffineTransform::scale (1.0f + (float) (i % 3) * 0.5f)
+                                             .translated (position (i + frame, 120, 120).toFloat());
+
+            g.setColour (Colours::seagreen.withAlpha (0.7f));
+            g.fillPath (path, transform);
+            g.setColour (Colours::black);
+            g.strokePath (path, stroke, transform);
+        }
+    }});
+
+    scenes.push_back ({ "shadows", "Drop shadows behind paths and rectangles", 60, [=] (Graphics& g, int frame)
+    {
+        for (int i = 0; i < 60; ++i)
+        {
+            auto pos = position (i + frame, 120, 120);
+            DropShadow shadow (Colours::black.withAlpha (0.5f), 4 + (i % 3) * 6, { 3, 3 });
+
+            if ((i & 1) != 0)
+            {
+                auto shape = path;
+                shape.applyTransform (AffineTransform::scale (1.5f).translated (pos.toFloat()));
+                shadow.drawForPath (g, shape);
+            }
+            else
+                shadow.drawForRectangle (g, Rectangle<int> (100, 60).withPosition (pos));
+        }
+    }});
+
+    scenes.push_back ({ "clippedRegions", "Fills through complex clip regions", 100, [=] (Graphics& g, int frame)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            Graphics::ScopedSaveState state (g);
+            auto area = Rectangle<int> (200, 150).withPosition (position (i + frame, 200, 150));
+
+            RectangleList<int> clip;
+
+            for (int j = 0; j < 8; ++j)
+                clip.add (area.getX() + j * 25, area.getY() + (j * 17) % 60, 20, 90);
+
+            g.reduceClipRegion (clip);
+            g.excludeClipRegion (area.withSizeKeepingCentre (40, 40));
+            g.reduceClipRegion (path, AffineTransform::scale (2.5f).translated (area.getPosition().toFloat()));
+
+            g.setColour (Colours::purple.withAlpha (0.8f));
+            g.fillRect (area);
+        }
+    }});
+
+    return scenes;
+}
+
+//==============================================================================
+struct SceneResult
+{
+    String name;
+    int numFrames = 0;
+    double framesPerSecond = 0, nanosecondsPerOperation = 0;
+};
+
+static SceneResult runScene (const Scene& scene, Image& image, bool useTiledRenderer, double minimumSeconds)
+{
+    auto renderFrame = [&] (int frameNumber)
+    {
+        std::unique_ptr<LowLevelGraphicsContext> context;
+
+        if (useTiledRenderer)
+            context = std::make_unique<LowLevelGraphicsTiledSoftwareRenderer> (image);
+        else
+            context = std::make_unique<LowLevelGraphicsSoftwareRenderer> (image);
+
+        Graphics g (*context);
+        g.fillAll (Colours::white);
+        scene.drawFrame (g, frameNumber);
+    };
+
+    // Draw a couple of frames first so that any caches are warmed up
+    for (int i = 0; i < 2; ++i)
+        renderFrame (i);
+
+    SceneResult result;
+    result.name = scene.name;
+
+    auto start = Time::getHighResolutionTicks();
+    double elapsedSeconds = 0;
+
+    while (result.numFrames < 5 || elapsedSeconds < minimumSeconds)
+    {
+        renderFrame (result.numFrames++);
+        elapsedSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+    }
+
+    result.framesPerSecond = result.numFrames / elapsedSeconds;
+    result.nanosecondsPerOperation = elapsedSeconds * 1.0e9 / (result.numFrames * scene.operationsPerFrame);
+    return result;
+}
+
+static var createJSON (const Array<SceneResult>& results, const String& rendererName, int width, int height)
+{
+    auto json = std::make_unique<DynamicObject>();
+    json->setProperty ("juceVersion", SystemStats::getJUCEVersion());
+    json->setProperty ("platform", SystemStats::getOperatingSystemName());
+    json->setProperty ("cpu", SystemStats::getCpuModel());
+    json->setProperty ("renderer", rendererName);
+    json->setProperty ("width", width);
+    json->setProperty ("height", height);
+
+    Array<var> scenes;
+
+    for (auto& r : results)
+    {
+        auto scene = std::make_unique<DynamicObject>();
+        scene->setProperty ("name", r.name);
+        scene->setProperty ("frames", r.numFrames);
+        scene->setProperty ("framesPerSecond", r.framesPerSecond);
+        scene->setProperty ("nanosecondsPerOperation", r.nanosecondsPerOperation);
+        scenes.add (var (scene.release()));
+    }
+
+    json->setProperty ("scenes", scenes);
+    return var (json.release());
+}
+
+// Returns the number of scenes that were slower than the baseline by more than the given fraction.
+// Scenes that only appear in one of the two runs are listed, but don't count as regressions.
+static int compareWithBaseline (const Array<SceneResult>& results, const var& baseline,
+                                const StringArray& sceneNames, double maxSlowdown)
+{
+    int numRegressions = 0;
+    Array<var> baselineScenes;
+
+    if (auto* scenes = baseline["scenes"].getArray())
+        baselineScenes = *scenes;
+
+    for (auto& r : results)
+    {
+        auto b = std::find_if (baselineScenes.begin(), baselineScenes.end(),
+                               [&] (const var& s) { return s["name"].toString() == r.name; });
+
+        if (b == baselineScenes.end())
+        {
+            std::cout << r.name.paddedRight (' ', 20) << "not in the baseline" << std::endl;
+            continue;
+        }
+
+        auto previous = (double) (*b)["nanosecondsPerOperation"];
+
+        if (previous <= 0)
+        {
+            std::cout << r.name.paddedRight (' ', 20) << "no valid timing in the baseline" << std::endl;
+            continue;
+        }
+
+        auto change = r.nanosecondsPerOperation / previous - 1.0;
+        auto isRegression = change > maxSlowdown;
+
+        if (isRegression)
+            ++numRegressions;
+
+        std::cout << r.name.paddedRight (' ', 20)
+                  << String (change * 100.0, 1) << "%"
+                  << (isRegression ? "  ** SLOWER **" : "") << std::endl;
+    }
+
+    for (auto& b : baselineScenes)
+    {
+        auto name = b["name"].toString();
+
+        if (! sceneNames.isEmpty() && ! sceneNames.contains (name))
+            continue;
+
+        if (std::none_of (results.begin(), results.end(), [&] (const SceneResult& r) { return r.name == name; }))
+            std::cout << name.paddedRight (' ', 20) << "missing from this run" << std::endl;
+    }
+
+    return numRegressions;
+}
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << argv[0] << " [--help|-h] [--list] [--scene=name[,name...]] [--size=widthxheight]" << std::endl
+                  << "    [--seconds=secondsPerScene] [--renderer=software|tiled] [--json=outputFile]" << std::endl
+                  << "    [--baseline=previousResults.json] [--max-slowdown=percentage]" << std::endl;
+        return 0;
+    }
+
+    ScopedJuceInitialiser_GUI libraryInitialiser;
+
+    auto size = args.containsOption ("--size") ? args.getValueForOption ("--size") : String ("1280x800");
+    auto width  = jmax (128, size.upToFirstOccurrenceOf ("x", false, true).getIntValue());
+    auto height = jmax (128, size.fromFirstOccurrenceOf ("x", false, true).getIntValue());
+
+    auto scenes = createScenes (width, height);
+
+    if (args.containsOption ("--list"))
+    {
+        for (auto& scene : scenes)
+            std::cout << scene.name.paddedRight (' ', 20) << scene.description << std::endl;
+
+        return 0;
+    }
+
+    StringArray sceneNames;
+
+    if (args.containsOption ("--scene"))
+    {
+        sceneNames.addTokens (args.getValueForOption ("--scene"), ",", {});
+        sceneNames.trim();
+        sceneNames.removeEmptyStrings();
+
+        for (auto& name : sceneNames)
+        {
+            if (std::none_of (scenes.begin(), scenes.end(), [&] (const Scene& s) { return s.name == name; }))
+            {
+                std::cerr << "Unknown scene: " << name << " (use --list to see the available scenes)" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    auto rendererName = args.containsOption ("--renderer") ? args.getValueForOption ("--renderer") : String ("software");
+    auto useTiledRenderer = rendererName == "tiled";
+
+    if (! useTiledRenderer && rendererName != "software")
+    {
+        std::cerr << "Unknown renderer: " << rendererName << std::endl;
+        return 1;
+    }
+
+    auto secondsPerScene = args.containsOption ("--seconds") ? args.getValueForOption ("--seconds").getDoubleValue() : 1.0;
+
+    Image image (Image::ARGB, width, height, true, SoftwareImageType());
+    Array<SceneResult> results;
+
+    std::cout << "Rendering " << width << "x" << height << " frames with the " << rendererName << " renderer" << std::endl << std::endl
+              << String ("Scene").paddedRight (' ', 20) << String ("Frames/s").paddedLeft (' ', 10) << String ("ns/op").paddedLeft (' ', 12) << std::endl;
+
+    for (auto& scene : scenes)
+    {
+        if (! sceneNames.isEmpty() && ! sceneNames.contains (scene.name))
+            continue;
+
+        auto result = runScene (scene, image, useTiledRenderer, secondsPerScene);
+        results.add (result);
+
+        std::cout << scene.name.paddedRight (' ', 20)
+                  << String (result.framesPerSecond, 1).paddedLeft (' ', 10)
+                  << String (roundToInt (result.nanosecondsPerOperation)).paddedLeft (' ', 12) << std::endl;
+    }
+
+    if (args.containsOption ("--json"))
+    {
+        auto file = args.getFileForOption ("--json");
+
+        if (! file.replaceWithText (JSON::toString (createJSON (results, rendererName, width, height))))
+        {
+            std::cerr << "Couldn't write to " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    if (args.containsOption ("--baseline"))
+    {
+        auto baselineFile = args.getFileForOption ("--baseline");
+
+        if (! baselineFile.existsAsFile())
+        {
+            std::cerr << "Couldn't find " << baselineFile.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        auto baseline = JSON::parse (baselineFile);
+
+        // Timings from a different renderer or frame size can't be compared meaningfully
+        auto baselineRenderer = baseline["renderer"].toString();
+        auto baselineWidth = (int) baseline["width"], baselineHeight = (int) baseline["height"];
+
+        if (baselineRenderer != rendererName || baselineWidth != width || baselineHeight != height)
+        {
+            std::cerr << "Can't compare with " << baselineFile.getFullPathName() << ", which was recorded with the "
+                      << baselineRenderer << " renderer at " << baselineWidth << "x" << baselineHeight
+                      << ", as this run used the " << rendererName << " renderer at " << width << "x" << height << std::endl;
+            return 1;
+        }
+
+        auto maxSlowdown = args.containsOption ("--max-slowdown") ? args.getValueForOption ("--max-slowdown").getDoubleValue() / 100.0 : 0.1;
+
+        std::cout << std::endl << "Compared with " << baselineFile.getFullPathName() << ":" << std::endl;
+
+        if (compareWithBaseline (results, baseline, sceneNames, maxSlowdown) > 0)
+            return 1;
+    }
+
+    return 0;
+}
@@ -68,11 +68,19 @@ private:
     using Listener = AudioProcessorValueTreeState::Listener;
 
 public:
-    explicit ParameterAdapter (RangedAudioParameter& parameterIn)
+    /*  If changedFlagsIn is supplied, the flag at changedFlagIndexIn will be set
+        whenever this adapter has a new value that needs flushing to the tree.
+    */
+    explicit ParameterAdapter (RangedAudioParameter& parameterIn,
+                               FlagCache<1>* changedFlagsIn = nullptr,
+                               size_t changedFlagIndexIn = 0)
         : parameter (parameterIn),
+          changedFlags (changedFlagsIn),
+          changedFlagIndex (changedFlagIndexIn),
           // For legacy reasons, the unnormalised value should *not* be snapped on construction
           unnormalisedValue (getRange().convertFrom0to1 (parameter.getDefaultValue()))
     {
+        markAsChanged();
         parameter.addListener (this);
 
         if (auto* ptr = dynamic_cast<Parameter*> (&parameter))
@@ -150,7 +158,17 @@ private:
         unnormalisedValue = newValue;
         listeners.call ([this] (Listener& l) { l.parameterChanged (parameter.paramID, unnormalisedValue); });
         listenersNeedCalling = false;
+        markAsChanged();
+    }
+
+    void markAsChanged()
+    {
+        // needsUpdate must be visible before the flag, so that a flush that
+        // sees the flag will also see that this adapter needs updating
         needsUpdate = true;
+
+        if (changedFlags != nullptr)
+            changedFlags->set (changedFlagIndex, 1);
     }
 
     float denormalise (float normalised) const
@@ -199,12 +217,58 @@ private:
     };
 
     RangedAudioParameter& parameter;
+    FlagCache<1>* const changedFlags;
+    const size_t changedFlagIndex;
     LockedListeners listeners;
     std::atomic<float> unnormalisedValue { 0.0f };
     std::atomic<bool> needsUpdate { true }, listenersNeedCalling { true };
     bool ignoreParameterChangedCallbacks { false };
 };
 
+//==============================================================================
+/*  Keeps track of the adapters that have changed since they were last flushed to
+    the tree, so that a flush only has to visit those adapters rather than all of
+    them.
+
+    The flags are stored in fixed-size blocks which are never moved once created,
+    so adding a parameter can't disturb any other threads that are setting the
+    flags of the existing adapters.
+*/
+class AudioProcessorValueTreeState::ChangedAdapterSet
+{
+public:
+    std::unique_ptr<ParameterAdapter> createAdapter (RangedAudioParameter& param)
+    {
+        const auto index = adapters.size() % adaptersPerBlock;
+
+        if (index == 0)
+            blocks.push_back (std::make_unique<FlagCache<1>> (adaptersPerBlock));
+
+        auto adapter = std::make_unique<ParameterAdapter> (param, blocks.back().get(), index);
+        adapters.push_back (adapter.get());
+        return adapter;
+    }
+
+    /*  Calls the callback for each adapter that has changed since the last call,
+        and clears their flags.
+    */
+    template <typename Callback>
+    void forEachChanged (Callback&& callback)
+    {
+        for (size_t block = 0; block < blocks.size(); ++block)
+            blocks[block]->ifSet ([&] (size_t index, uint32_t)
+            {
+                callback (*adapters[block * adaptersPerBlock + index]);
+            });
+    }
+
+private:
+    static constexpr size_t adaptersPerBlock = 256;
+
+    std::vector<ParameterAdapter*> adapters;
+    std::vector<std::unique_ptr<FlagCache<1>>> blocks;
+};
+
 //==============================================================================
 AudioProcessorValueTreeState::AudioProcessorValueTreeState (AudioProcessor& processorToConnectTo,
                                                             UndoManager* undoManagerToUse,
@@ -264,7 +328,7 @@ AudioProcessorValueTreeState::AudioProcessorValueTreeState (AudioProcessor& proc
 }
 
 AudioProcessorValueTreeState::AudioProcessorValueTreeState (AudioProcessor& p, UndoManager* um)
-    : processor (p), undoManager (um)
+    : processor (p), undoManager (um), changedAdapters (std::make_unique<ChangedAdapterSet>())
 {
     startTimerHz (10);
     state.addListener (this);
@@ -327,7 +391,11 @@ RangedAudioParameter* AudioProcessorValueTreeState::createAndAddParameter (std::
 //==============================================================================
 void AudioProcessorValueTreeState::addParameterAdapter (RangedAudioParameter& param)
 {
-    adapterTable.emplace (param.paramID, std::make_unique<ParameterAdapter> (param));
+    // Parameter IDs must be unique, so only the first adapter for any ID is kept
+    if (adapterTable.find (param.paramID) != adapterTable.end())
+        return;
+
+    adapterTable.emplace (param.paramID, changedAdapters->createAdapter (param));
 }
 
 AudioProcessorValueTreeState::ParameterAdapter* AudioProcessorValueTreeState::getParameterAdapter (StringRef paramID) const
@@ -458,8 +526,10 @@ bool AudioProcessorValueTreeState::flushParameterValuesToValueTree()
 
     bool anyUpdated = false;
 
-    for (auto& p : adapterTable)
-        anyUpdated |= p.second->flushToTree (valuePropertyID, undoManager);
+    changedAdapters->forEachChanged ([&] (ParameterAdapter& adapter)
+    {
+        anyUpdated |= adapter.flushToTree (valuePropertyID, undoManager);
+    });
 
     return anyUpdated;
 }
@@ -981,6 +1051,51 @@ public:
             expectEquals (listener.value, newValue);
             expectEquals (listener.id, String (key));
         }
+
+        beginTest ("When some of many parameter values are changed, only those values are updated in the state");
+        {
+            struct PropertyListener final : public ValueTree::Listener
+            {
+                void valueTreePropertyChanged (ValueTree& tree, const Identifier& property) override
+                {
+                    if (property == Identifier ("value"))
+                        changedIds.add (tree.getProperty ("id"));
+                }
+
+                StringArray changedIds;
+            };
+
+            const auto numParameters = 600;
+            ParameterLayout layout;
+
+            for (auto i = 0; i < numParameters; ++i)
+                layout.add (std::make_unique<Parameter> (String (i), String(), NormalisableRange<float>(), 0.0f));
+
+            TestAudioProcessor proc (std::move (layout));
+            proc.state.copyState();
+
+            PropertyListener listener;
+            proc.state.state.addListener (&listener);
+
+            const StringArray changedIds { "0", "255", "256", "599" };
+
+            for (const auto& id : changedIds)
+                proc.state.getParameter (id)->setValueNotifyingHost (0.5f);
+
+            const auto copy = proc.state.copyState();
+            proc.state.state.removeListener (&listener);
+
+            listener.changedIds.sort (false);
+            auto expectedIds = changedIds;
+            expectedIds.sort (false);
+            expect (listener.changedIds == expectedIds);
+
+            for (auto i = 0; i < numParameters; ++i)
+            {
+                const auto expected = changedIds.contains (String (i)) ? 0.5f : 0.0f;
+                expectEquals ((float) copy.getChildWithProperty ("id", String (i)).getProperty ("value"), expected);
+            }
+        }
     }
     JUCE_END_IGNORE_WARNINGS_MSVC
 };
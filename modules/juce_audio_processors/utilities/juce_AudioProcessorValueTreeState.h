@@ -411,6 +411,7 @@ public:
 private:
     //==============================================================================
     class ParameterAdapter;
+    class ChangedAdapterSet;
 
 public:
     //==============================================================================
@@ -648,6 +649,7 @@ private:
         bool operator() (StringRef a, StringRef b) const noexcept { return a.text.compare (b.text) < 0; }
     };
 
+    std::unique_ptr<ChangedAdapterSet> changedAdapters;
     std::map<StringRef, std::unique_ptr<ParameterAdapter>, StringRefLessThan> adapterTable;
 
     CriticalSection valueTreeChanging;
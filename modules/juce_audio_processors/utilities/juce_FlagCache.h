@@ -58,6 +58,11 @@ public:
     {
         for (size_t flagIndex = 0; flagIndex < flags.size(); ++flagIndex)
         {
+            // A plain load is much cheaper than an exchange, and most words will
+            // usually be clear. Anything set after this load is seen on the next call.
+            if (flags[flagIndex].load (std::memory_order_relaxed) == 0)
+                continue;
+
             const auto prevFlags = flags[flagIndex].exchange (0, std::memory_order_acq_rel);
 
             for (size_t group = 0; group < groupsPerWord; ++group)
@@ -0,0 +1,535 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Selects the scoped lock types that a FlatHashMap uses for its read-only and
+    modifying operations.
+
+    For ordinary critical sections both of these are just the ScopedLockType, but
+    when a FlatHashMap is given a ReadWriteLock, lookups take a read lock so that
+    several threads can search the map at the same time.
+
+    @see FlatHashMap
+
+    @tags{Core}
+*/
+template <class TypeOfCriticalSectionToUse>
+struct FlatHashMapLockTraits
+{
+    using ScopedReadLockType  = typename TypeOfCriticalSectionToUse::ScopedLockType;
+    using ScopedWriteLockType = typename TypeOfCriticalSectionToUse::ScopedLockType;
+};
+
+/** @internal */
+template <>
+struct FlatHashMapLockTraits<ReadWriteLock>
+{
+    using ScopedReadLockType  = ScopedReadLock;
+    using ScopedWriteLockType = ScopedWriteLock;
+};
+
+//==============================================================================
+/**
+    An open-addressing hash map which keeps all of its items in a single contiguous
+    block of memory.
+
+    Unlike HashMap, which allocates a separate node for every item and needs its
+    table to be remapped manually, a FlatHashMap stores its keys and values inline
+    and uses Robin Hood probing with backward-shift deletion, so lookups touch very
+    few cache lines. The table grows automatically to keep its load factor below 7/8.
+
+    The hash function type has the same form as the one used by HashMap, so any
+    existing hash class (e.g. DefaultHashFunctions) can be used. The map calls it
+    with an upperLimit of std::numeric_limits<int>::max() and scrambles the result
+    itself, so your hash function doesn't need to spread its output evenly.
+
+    Lookups are heterogeneous: find(), contains() and remove() accept any type for
+    which the hash function has an overload that produces the same hash as the
+    equivalent key, and which can be compared with the key type using operator==.
+    For example, a FlatHashMap<String, int> can be searched with a StringRef without
+    constructing a temporary String. (Identifier keys are hashed by their pooled address,
+    so maps with Identifier keys must be searched with Identifiers.)
+
+    @code
+    FlatHashMap<String, int> map;
+    map.set ("one", 1);
+    map.set ("two", 2);
+
+    if (auto* value = map.find (StringRef ("two")))
+        DBG (*value); // prints "2"
+
+    for (auto item : map)
+        DBG (item.key << " -> " << item.value);
+    @endcode
+
+    If you pass a CriticalSection as the last template parameter, all operations
+    will be serialised. If you pass a ReadWriteLock instead, operations which don't
+    modify the map can run concurrently. In either case, remember that the pointers
+    and references returned by find() and getReference() are not protected by the
+    lock once the call returns, so when sharing a map between threads you should
+    use operator[] or getWithDefault(), which return copies.
+
+    Because items are moved around when the map is modified, any pointers, references
+    or iterators obtained from it are invalidated by calls to set(), getReference(),
+    remove(), reserve() or clear().
+
+    @see HashMap, DefaultHashFunctions, FlatHashMapLockTraits
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionType = DefaultHashFunctions,
+          class TypeOfCriticalSectionToUse = DummyCriticalSection>
+class FlatHashMap
+{
+private:
+    using KeyTypeParameter   = typename TypeHelpers::ParameterType<KeyType>::type;
+    using ValueTypeParameter = typename TypeHelpers::ParameterType<ValueType>::type;
+
+public:
+    //==============================================================================
+    /** Creates an empty map.
+
+        @param initialCapacity  the number of items the map should be able to hold before
+                                it needs to allocate more space. If this is zero, no memory
+                                is allocated until the first item is added.
+        @param hashFunction     an instance of HashFunctionType, which will be copied and
+                                stored to use with the map
+    */
+    explicit FlatHashMap (int initialCapacity = 0,
+                          HashFunctionType hashFunction = HashFunctionType())
+        : hashFunctionToUse (hashFunction)
+    {
+        if (initialCapacity > 0)
+            reserve (initialCapacity);
+    }
+
+    /** Destructor. */
+    ~FlatHashMap()
+    {
+        destroyAll();
+    }
+
+    //==============================================================================
+    /** Removes all items from the map, but keeps the memory that was allocated for them. */
+    void clear()
+    {
+        const ScopedWriteLockType sl (getLock());
+        destroyAll();
+    }
+
+    /** Returns the number of items in the map. */
+    inline int size() const noexcept                { return numItems; }
+
+    /** Returns true if the map contains no items. */
+    inline bool isEmpty() const noexcept            { return numItems == 0; }
+
+    /** Returns the number of slots that are currently allocated. */
+    inline int getCapacity() const noexcept         { return capacity; }
+
+    /** Makes sure that the map can hold the given number of items without needing to
+        allocate more memory.
+    */
+    void reserve (int numItemsNeeded)
+    {
+        const ScopedWriteLockType sl (getLock());
+        auto newCapacity = capacity > 0 ? capacity : (int) minimumCapacity;
+
+        while (exceedsMaxLoad (numItemsNeeded, newCapacity))
+            newCapacity *= 2;
+
+        if (newCapacity > capacity)
+            rehash (newCapacity);
+    }
+
+    //==============================================================================
+    /** Returns a copy of the value corresponding to a given key, or a default-constructed
+        value if the key isn't in the map.
+    */
+    template <typename OtherKeyType>
+    ValueType operator[] (const OtherKeyType& keyToLookFor) const
+    {
+        const ScopedReadLockType sl (getLock());
+        auto index = findIndex (keyToLookFor);
+        return index >= 0 ? entries[index].value : ValueType();
+    }
+
+    /** Returns a copy of the value corresponding to a given key, or the given default
+        value if the key isn't in the map.
+    */
+    template <typename OtherKeyType>
+    ValueType getWithDefault (const OtherKeyType& keyToLookFor, ValueTypeParameter defaultValue) const
+    {
+        const ScopedReadLockType sl (getLock());
+        auto index = findIndex (keyToLookFor);
+        return index >= 0 ? entries[index].value : defaultValue;
+    }
+
+    /** Returns a pointer to the value for a given key, or nullptr if the key isn't in the map.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename OtherKeyType>
+    ValueType* find (const OtherKeyType& keyToLookFor)
+    {
+        const ScopedReadLockType sl (getLock());
+        auto index = findIndex (keyToLookFor);
+        return index >= 0 ? &(entries[index].value) : nullptr;
+    }
+
+    /** Returns a pointer to the value for a given key, or nullptr if the key isn't in the map.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename OtherKeyType>
+    const ValueType* find (const OtherKeyType& keyToLookFor) const
+    {
+        const ScopedReadLockType sl (getLock());
+        auto index = findIndex (keyToLookFor);
+        return index >= 0 ? &(entries[index].value) : nullptr;
+    }
+
+    /** Returns true if the map contains an item with the given key. */
+    template <typename OtherKeyType>
+    bool contains (const OtherKeyType& keyToLookFor) const
+    {
+        const ScopedReadLockType sl (getLock());
+        return findIndex (keyToLookFor) >= 0;
+    }
+
+    /** Returns true if the map contains at least one occurrence of a given value. */
+    bool containsValue (ValueTypeParameter valueToLookFor) const
+    {
+        const ScopedReadLockType sl (getLock());
+
+        for (int i = 0; i < capacity; ++i)
+            if (hashes[i] != 0 && entries[i].value == valueToLookFor)
+                return true;
+
+        return false;
+    }
+
+    //==============================================================================
+    /** Returns a reference to the value corresponding to a given key.
+        If the map doesn't contain the key, a default-constructed value is added to the
+        map and a reference to it is returned. The reference is only valid until the map
+        is next modified.
+    */
+    ValueType& getReference (KeyTypeParameter keyToLookFor)
+    {
+        const ScopedWriteLockType sl (getLock());
+        return entries[findOrInsert (keyToLookFor)].value;
+    }
+
+    /** Adds or replaces an item in the map. */
+    void set (KeyTypeParameter newKey, ValueTypeParameter newValue)
+    {
+        const ScopedWriteLockType sl (getLock());
+        entries[findOrInsert (newKey)].value = newValue;
+    }
+
+    /** Removes the item with the given key, returning true if it was found. */
+    template <typename OtherKeyType>
+    bool remove (const OtherKeyType& keyToRemove)
+    {
+        const ScopedWriteLockType sl (getLock());
+        auto index = findIndex (keyToRemove);
+
+        if (index < 0)
+            return false;
+
+        removeIndex (index);
+        return true;
+    }
+
+    /** Removes all items with the given value. */
+    void removeValue (ValueTypeParameter valueToRemove)
+    {
+        const ScopedWriteLockType sl (getLock());
+
+        for (int i = 0; i < capacity;)
+        {
+            // removing an item may shift the next one back into this slot, so it
+            // needs to be checked again before moving on
+            if (hashes[i] != 0 && entries[i].value == valueToRemove)
+                removeIndex (i);
+            else
+                ++i;
+        }
+    }
+
+    //==============================================================================
+    /** Efficiently swaps the contents of two maps. */
+    void swapWith (FlatHashMap& other) noexcept
+    {
+        const ScopedWriteLockType lock1 (getLock());
+        const ScopedWriteLockType lock2 (other.getLock());
+
+        hashes.swapWith (other.hashes);
+        entries.swapWith (other.entries);
+        std::swap (capacity, other.capacity);
+        std::swap (numItems, other.numItems);
+        std::swap (hashShift, other.hashShift);
+    }
+
+    //==============================================================================
+    /** Returns the lock that protects this map. */
+    inline const TypeOfCriticalSectionToUse& getLock() const noexcept      { return lock; }
+
+    /** The type of scoped lock that is used by the non-modifying methods. */
+    using ScopedReadLockType  = typename FlatHashMapLockTraits<TypeOfCriticalSectionToUse>::ScopedReadLockType;
+
+    /** The type of scoped lock that is used by the modifying methods. */
+    using ScopedWriteLockType = typename FlatHashMapLockTraits<TypeOfCriticalSectionToUse>::ScopedWriteLockType;
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        KeyType key;
+        ValueType value;
+    };
+
+public:
+    //==============================================================================
+    /** A key/value pair of references, as returned when iterating a FlatHashMap. */
+    template <typename ValueReference>
+    struct ItemBase
+    {
+        const KeyType& key;
+        ValueReference value;
+    };
+
+    using Item      = ItemBase<ValueType&>;
+    using ConstItem = ItemBase<const ValueType&>;
+
+    /** Iterates over the items in a FlatHashMap.
+
+        The order in which items are visited is unrelated to the order in which they
+        were added. Any modification of the map invalidates its iterators.
+    */
+    template <typename MapType, typename ValueReference>
+    struct IteratorBase
+    {
+        IteratorBase (MapType& mapToIterate, int startIndex) noexcept
+            : map (&mapToIterate), index (startIndex)
+        {
+            skipEmptySlots();
+        }
+
+        ItemBase<ValueReference> operator*() const noexcept          { return { map->entries[index].key, map->entries[index].value }; }
+        IteratorBase& operator++() noexcept                          { ++index; skipEmptySlots(); return *this; }
+        bool operator== (const IteratorBase& other) const noexcept   { return index == other.index; }
+        bool operator!= (const IteratorBase& other) const noexcept   { return index != other.index; }
+
+        /** Returns the current item's key. */
+        const KeyType& getKey() const noexcept                       { return map->entries[index].key; }
+
+        /** Returns the current item's value. */
+        ValueReference getValue() const noexcept                     { return map->entries[index].value; }
+
+    private:
+        void skipEmptySlots() noexcept
+        {
+            while (index < map->capacity && map->hashes[index] == 0)
+                ++index;
+        }
+
+        MapType* map;
+        int index;
+    };
+
+    using Iterator      = IteratorBase<FlatHashMap, ValueType&>;
+    using ConstIterator = IteratorBase<const FlatHashMap, const ValueType&>;
+
+    /** Returns an iterator to the first item in the map. */
+    Iterator begin() noexcept                   { return { *this, 0 }; }
+
+    /** Returns an iterator to the end of the map. */
+    Iterator end() noexcept                     { return { *this, capacity }; }
+
+    /** Returns an iterator to the first item in the map. */
+    ConstIterator begin() const noexcept        { return { *this, 0 }; }
+
+    /** Returns an iterator to the end of the map. */
+    ConstIterator end() const noexcept          { return { *this, capacity }; }
+
+private:
+    //==============================================================================
+    enum { minimumCapacity = 8 };
+
+    HashFunctionType hashFunctionToUse;
+    HeapBlock<uint32> hashes;
+    HeapBlock<Entry> entries;
+    int capacity = 0, numItems = 0, hashShift = 32;
+    TypeOfCriticalSectionToUse lock;
+
+    static bool exceedsMaxLoad (int numItemsNeeded, int numSlots) noexcept
+    {
+        return (int64) numItemsNeeded * 8 > (int64) numSlots * 7;
+    }
+
+    // A zero hash marks an empty slot, so the low bit of every stored hash is set.
+    // The slot index is taken from the top bits, which this doesn't affect.
+    template <typename OtherKeyType>
+    uint32 generateHashFor (const OtherKeyType& key) const
+    {
+        auto hash = (uint32) hashFunctionToUse.generateHash (key, std::numeric_limits<int>::max());
+        return (hash * 0x9e3779b9u) | 1u;
+    }
+
+    inline int getHomeIndex (uint32 hash) const noexcept                 { return (int) (hash >> hashShift); }
+    inline int getProbeDistance (uint32 hash, int index) const noexcept  { return (index - getHomeIndex (hash)) & (capacity - 1); }
+
+    template <typename OtherKeyType>
+    int findIndex (const OtherKeyType& keyToLookFor) const
+    {
+        if (numItems == 0)
+            return -1;
+
+        auto hash = generateHashFor (keyToLookFor);
+        auto mask = capacity - 1;
+
+        for (int index = getHomeIndex (hash), distance = 0;; index = (index + 1) & mask, ++distance)
+        {
+            auto slotHash = hashes[index];
+
+            // In a Robin Hood table, meeting an item that's closer to its home slot than
+            // we are to ours means that the key can't be any further along.
+            if (slotHash == 0 || getProbeDistance (slotHash, index) < distance)
+                return -1;
+
+            if (slotHash == hash && entries[index].key == keyToLookFor)
+                return index;
+        }
+    }
+
+    int findOrInsert (KeyTypeParameter key)
+    {
+        auto existing = findIndex (key);
+
+        if (existing >= 0)
+            return existing;
+
+        if (capacity == 0 || exceedsMaxLoad (numItems + 1, capacity))
+            rehash (jmax ((int) minimumCapacity, capacity * 2));
+
+        ++numItems;
+        return insertNewEntry (generateHashFor (key), Entry { key, ValueType() });
+    }
+
+    // Inserts an item which is known not to be in the table, displacing any items
+    // that are closer to their home slots, and returns the index where it ended up.
+    int insertNewEntry (uint32 hash, Entry&& entry)
+    {
+        auto mask = capacity - 1;
+        auto index = getHomeIndex (hash);
+        auto distance = 0;
+        auto result = -1;
+        Entry carried (std::move (entry));
+
+        for (;; index = (index + 1) & mask, ++distance)
+        {
+            if (hashes[index] == 0)
+            {
+                new (entries + index) Entry (std::move (carried));
+                hashes[index] = hash;
+                return result >= 0 ? result : index;
+            }
+
+            auto residentDistance = getProbeDistance (hashes[index], index);
+
+            if (residentDistance < distance)
+            {
+                std::swap (hashes[index], hash);
+                std::swap (entries[index], carried);
+                distance = residentDistance;
+
+                if (result < 0)
+                    result = index;
+            }
+        }
+    }
+
+    void removeIndex (int index)
+    {
+        auto mask = capacity - 1;
+
+        // Shift back any following items that aren't in their home slots, which keeps
+        // the table free of tombstones.
+        for (auto next = (index + 1) & mask;
+             hashes[next] != 0 && getProbeDistance (hashes[next], next) > 0;
+             index = next, next = (next + 1) & mask)
+        {
+            hashes[index] = hashes[next];
+            entries[index] = std::move (entries[next]);
+        }
+
+        entries[index].~Entry();
+        hashes[index] = 0;
+        --numItems;
+    }
+
+    void rehash (int newCapacity)
+    {
+        jassert (isPowerOfTwo (newCapacity));
+
+        HeapBlock<uint32> oldHashes (std::move (hashes));
+        HeapBlock<Entry> oldEntries (std::move (entries));
+        auto oldCapacity = capacity;
+
+        hashes.calloc ((size_t) newCapacity);
+        entries.malloc ((size_t) newCapacity);
+        capacity = newCapacity;
+        hashShift = 32 - countNumberOfBits ((uint32) (newCapacity - 1));
+
+        for (int i = 0; i < oldCapacity; ++i)
+        {
+            if (oldHashes[i] != 0)
+            {
+                insertNewEntry (oldHashes[i], std::move (oldEntries[i]));
+                oldEntries[i].~Entry();
+            }
+        }
+    }
+
+    void destroyAll() noexcept
+    {
+        for (int i = 0; i < capacity; ++i)
+        {
+            if (hashes[i] != 0)
+            {
+                entries[i].~Entry();
+                hashes[i] = 0;
+            }
+        }
+
+        numItems = 0;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlatHashMap)
+};
+
+} // namespace juce
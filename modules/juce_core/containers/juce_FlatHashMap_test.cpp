@@ -0,0 +1,343 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct FlatHashMapTest : public UnitTest
+{
+    FlatHashMapTest()
+        : UnitTest ("FlatHashMap", UnitTestCategories::containers)
+    {}
+
+    void runTest() override
+    {
+        doTest<AddAndAccessTest> ("AddAndAccessTest");
+        doTest<RemoveTest> ("RemoveTest");
+        doTest<IterationTest> ("IterationTest");
+
+        beginTest ("Table grows automatically");
+        {
+            FlatHashMap<int, int> map;
+            expectEquals (map.getCapacity(), 0);
+
+            for (int i = 0; i < 1000; ++i)
+                map.set (i, i * 2);
+
+            expectEquals (map.size(), 1000);
+            expect (map.getCapacity() >= 1000);
+            expect (isPowerOfTwo (map.getCapacity()));
+
+            for (int i = 0; i < 1000; ++i)
+                expectEquals (map[i], i * 2);
+
+            auto capacity = map.getCapacity();
+            map.clear();
+            expect (map.isEmpty());
+            expectEquals (map.getCapacity(), capacity);
+            expect (! map.contains (10));
+        }
+
+        beginTest ("Reserve avoids reallocation");
+        {
+            FlatHashMap<int, int> map (500);
+            auto capacity = map.getCapacity();
+
+            for (int i = 0; i < 500; ++i)
+                map.set (i, i);
+
+            expectEquals (map.getCapacity(), capacity);
+        }
+
+        beginTest ("Heterogeneous lookup");
+        {
+            FlatHashMap<String, int> map;
+            map.set ("alpha", 1);
+            map.set ("beta", 2);
+
+            expect (map.contains (StringRef ("alpha")));
+            expectEquals (map[StringRef ("beta")], 2);
+            expect (! map.contains (StringRef ("gamma")));
+
+            if (auto* value = map.find (StringRef ("beta")))
+                *value = 3;
+
+            expectEquals (map[String ("beta")], 3);
+            expect (map.remove (StringRef ("alpha")));
+            expect (! map.contains (String ("alpha")));
+            expectEquals (map.size(), 1);
+
+            for (auto s : { "", "a", "some longer key", "\xc3\xa9t\xc3\xa9" })
+                expectEquals (DefaultHashFunctions::generateHash (StringRef (CharPointer_UTF8 (s)), 1000),
+                              DefaultHashFunctions::generateHash (String (CharPointer_UTF8 (s)), 1000));
+        }
+
+        beginTest ("Identifier keys");
+        {
+            FlatHashMap<Identifier, var> map;
+            map.set ("width", 10);
+            map.set ("height", 20);
+
+            expectEquals ((int) map[Identifier ("width")], 10);
+            expectEquals ((int) map.getWithDefault (Identifier ("depth"), 30), 30);
+        }
+
+        beginTest ("Remove values");
+        {
+            FlatHashMap<int, int> map;
+
+            for (int i = 0; i < 200; ++i)
+                map.set (i, i % 3);
+
+            map.removeValue (1);
+
+            expect (! map.containsValue (1));
+            expect (map.containsValue (2));
+
+            for (int i = 0; i < 200; ++i)
+                expect (map.contains (i) == (i % 3 != 1));
+        }
+
+        beginTest ("Swap");
+        {
+            FlatHashMap<int, String> a, b;
+            a.set (1, "one");
+            b.set (2, "two");
+            b.set (3, "three");
+
+            a.swapWith (b);
+
+            expectEquals (a.size(), 2);
+            expectEquals (b.size(), 1);
+            expectEquals (a[3], String ("three"));
+            expectEquals (b[1], String ("one"));
+        }
+
+        beginTest ("Concurrent readers");
+        {
+            FlatHashMap<int, int, DefaultHashFunctions, ReadWriteLock> map;
+
+            for (int i = 0; i < 100; ++i)
+                map.set (i, -i);
+
+            std::atomic<int> numErrors { 0 };
+
+            {
+                std::vector<std::thread> threads;
+
+                for (int t = 0; t < 4; ++t)
+                {
+                    threads.emplace_back ([&map, &numErrors]
+                    {
+                        for (int n = 0; n < 1000; ++n)
+                            if (map[n % 100] != -(n % 100))
+                                ++numErrors;
+                    });
+                }
+
+                for (int i = 100; i < 200; ++i)
+                    map.set (i, -i);
+
+                for (auto& thread : threads)
+                    thread.join();
+            }
+
+            expectEquals (numErrors.load(), 0);
+            expectEquals (map.size(), 200);
+        }
+    }
+
+    //==============================================================================
+    struct AddAndAccessTest
+    {
+        template <typename KeyType>
+        static void run (UnitTest& u)
+        {
+            HashMap<KeyType, int> groundTruth;
+            FlatHashMap<KeyType, int> map;
+
+            RandomKeys<KeyType> keyOracle (300, 3827829);
+            Random valueOracle (48735);
+
+            for (int i = 0; i < 10000; ++i)
+            {
+                auto key = keyOracle.next();
+                auto value = valueOracle.nextInt();
+
+                u.expectEquals ((int) groundTruth.contains (key), (int) map.contains (key));
+
+                groundTruth.set (key, value);
+                map.set (key, value);
+
+                u.expectEquals (map.size(), groundTruth.size());
+            }
+
+            for (auto it = groundTruth.begin(); it != groundTruth.end(); ++it)
+                u.expectEquals (map[it.getKey()], it.getValue());
+        }
+    };
+
+    struct RemoveTest
+    {
+        template <typename KeyType>
+        static void run (UnitTest& u)
+        {
+            HashMap<KeyType, int> groundTruth;
+            FlatHashMap<KeyType, int> map;
+            Array<KeyType> keys;
+
+            RandomKeys<KeyType> keyOracle (300, 3827829);
+            Random r (3827387);
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto key = keyOracle.next();
+                auto value = r.nextInt();
+
+                if (! groundTruth.contains (key))
+                    keys.add (key);
+
+                groundTruth.set (key, value);
+                map.set (key, value);
+            }
+
+            while (! keys.isEmpty())
+            {
+                auto key = keys.removeAndReturn (r.nextInt (keys.size()));
+
+                groundTruth.remove (key);
+                u.expect (map.remove (key));
+                u.expect (! map.contains (key));
+                u.expect (! map.remove (key));
+
+                for (auto& k : keys)
+                    u.expectEquals (map[k], groundTruth[k]);
+            }
+
+            u.expect (map.isEmpty());
+        }
+    };
+
+    struct IterationTest
+    {
+        template <typename KeyType>
+        static void run (UnitTest& u)
+        {
+            HashMap<KeyType, int> groundTruth;
+            FlatHashMap<KeyType, int> map;
+
+            RandomKeys<KeyType> keyOracle (300, 3827829);
+            Random valueOracle (48735);
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto key = keyOracle.next();
+                auto value = valueOracle.nextInt();
+
+                groundTruth.set (key, value);
+                map.set (key, value);
+            }
+
+            int numVisited = 0;
+
+            for (auto item : map)
+            {
+                u.expectEquals (item.value, groundTruth[item.key]);
+                ++item.value;
+                ++numVisited;
+            }
+
+            u.expectEquals (numVisited, groundTruth.size());
+
+            for (auto it = groundTruth.begin(); it != groundTruth.end(); ++it)
+                u.expectEquals (map[it.getKey()], it.getValue() + 1);
+
+            const auto& constMap = map;
+            numVisited = 0;
+
+            for (auto item : constMap)
+            {
+                static_assert (std::is_same<decltype (item.value), const int&>::value,
+                               "Iterating a const map shouldn't allow its values to be changed");
+
+                u.expectEquals (item.value, groundTruth[item.key] + 1);
+                ++numVisited;
+            }
+
+            u.expectEquals (numVisited, groundTruth.size());
+            static_assert (std::is_same<decltype (constMap.begin().getValue()), const int&>::value,
+                           "Iterating a const map shouldn't allow its values to be changed");
+        }
+    };
+
+    //==============================================================================
+    template <class Test>
+    void doTest (const String& testName)
+    {
+        beginTest (testName);
+
+        Test::template run<int> (*this);
+        Test::template run<void*> (*this);
+        Test::template run<String> (*this);
+    }
+
+    //==============================================================================
+    template <typename KeyType>
+    class RandomKeys
+    {
+    public:
+        RandomKeys (int maxUniqueKeys, int seed) : r (seed)
+        {
+            for (int i = 0; i < maxUniqueKeys; ++i)
+                keys.add (generateRandomKey (r));
+        }
+
+        const KeyType& next()
+        {
+            int i = r.nextInt (keys.size() - 1);
+            return keys.getReference (i);
+        }
+    private:
+        static KeyType generateRandomKey (Random&);
+
+        Random r;
+        Array<KeyType> keys;
+    };
+};
+
+template <> int   FlatHashMapTest::RandomKeys<int>  ::generateRandomKey (Random& rnd) { return rnd.nextInt(); }
+template <> void* FlatHashMapTest::RandomKeys<void*>::generateRandomKey (Random& rnd) { return reinterpret_cast<void*> (rnd.nextInt64()); }
+
+template <> String FlatHashMapTest::RandomKeys<String>::generateRandomKey (Random& rnd)
+{
+    String str;
+
+    int len = rnd.nextInt (8)+1;
+    for (int i = 0; i < len; ++i)
+        str += static_cast<char> (rnd.nextInt (95) + 32);
+
+    return str;
+}
+
+static FlatHashMapTest flatHashMapTest;
+
+} // namespace juce
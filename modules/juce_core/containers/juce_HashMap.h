@@ -43,6 +43,27 @@ struct DefaultHashFunctions
     static int generateHash (int64 key, int upperLimit) noexcept            { return generateHash ((uint64) key, upperLimit); }
     /** Generates a simple hash from a string. */
     static int generateHash (const String& key, int upperLimit) noexcept    { return generateHash ((uint32) key.hashCode(), upperLimit); }
+    /** Generates a simple hash from a StringRef.
+        This produces the same value as the equivalent String, so a StringRef can be used to
+        search a FlatHashMap which has String keys.
+    */
+    static int generateHash (StringRef key, int upperLimit) noexcept
+    {
+        uint32 hash = 0;
+
+        // This must match the algorithm used by String::hashCode()
+        for (auto t = key.text; ! t.isEmpty();)
+            hash = 31u * hash + (uint32) t.getAndAdvance();
+
+        return generateHash (hash, upperLimit);
+    }
+    /** Generates a simple hash from an Identifier.
+        Identifiers are pooled, so this uses the address of the shared string rather than its content.
+    */
+    static int generateHash (const Identifier& key, int upperLimit) noexcept
+    {
+        return generateHash (static_cast<const void*> (key.getCharPointer().getAddress()), upperLimit);
+    }
     /** Generates a simple hash from a variant. */
     static int generateHash (const var& key, int upperLimit) noexcept       { return generateHash (key.toString(), upperLimit); }
     /** Generates a simple hash from a void ptr. */
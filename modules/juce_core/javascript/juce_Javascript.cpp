@@ -77,16 +77,57 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
     void execute (const String& code)
     {
-        ExpressionTreeBuilder tb (code);
-        std::unique_ptr<BlockStatement> (tb.parseStatementList())->perform (Scope ({}, *this, *this), nullptr);
+        auto program = getParsedCode (code, false);
+        program->perform (Scope ({}, *this, *this), nullptr);
     }
 
     var evaluate (const String& code)
     {
+        auto program = getParsedCode (code, true);
+        return static_cast<const Expression&> (*program).getResult (Scope ({}, *this, *this));
+    }
+
+    //==============================================================================
+    /*  Code which is executed or evaluated repeatedly only needs to be parsed once, so
+        the most recently used parse trees are kept. They're returned as shared pointers
+        so that a script which calls exec() or eval() can't cause its own tree to be
+        deleted while it's running.
+    */
+    struct Statement;
+
+    struct ParsedCode
+    {
+        String code;
+        bool isExpression;
+        std::shared_ptr<const Statement> tree;
+    };
+
+    std::shared_ptr<const Statement> getParsedCode (const String& code, bool isExpression)
+    {
+        for (auto i = parsedCodeCache.begin(); i != parsedCodeCache.end(); ++i)
+        {
+            if (i->isExpression == isExpression && i->code == code)
+            {
+                std::rotate (parsedCodeCache.begin(), i, i + 1);
+                return parsedCodeCache.front().tree;
+            }
+        }
+
         ExpressionTreeBuilder tb (code);
-        return ExpPtr (tb.parseExpression())->getResult (Scope ({}, *this, *this));
+        std::shared_ptr<const Statement> tree (isExpression ? static_cast<Statement*> (tb.parseExpression())
+                                                            : static_cast<Statement*> (tb.parseStatementList()));
+
+        parsedCodeCache.insert (parsedCodeCache.begin(), { code, isExpression, tree });
+
+        if (parsedCodeCache.size() > maxNumParsedCodeItems)
+            parsedCodeCache.pop_back();
+
+        return tree;
     }
 
+    static constexpr size_t maxNumParsedCodeItems = 16;
+    std::vector<ParsedCode> parsedCodeCache;
+
     //==============================================================================
     static bool areTypeEqual (const var& a, const var& b)
     {
@@ -102,6 +143,35 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     static Identifier getPrototypeIdentifier()                { static const Identifier i ("prototype"); return i; }
     static var* getPropertyPointer (DynamicObject& o, const Identifier& i) noexcept   { return o.getProperties().getVarPointer (i); }
 
+    //==============================================================================
+    /*  An inline cache for a property lookup at a particular point in the code.
+
+        It remembers the index at which the property was last found, so that when the
+        same site is evaluated again with an object of the same shape, the property
+        can be fetched without searching the object's NamedValueSet. The cached index
+        is always checked against the name, so a stale entry just falls back to a search.
+    */
+    struct PropertyLookupCache
+    {
+        var* find (DynamicObject& o, const Identifier& name) const noexcept
+        {
+            auto& props = o.getProperties();
+
+            if (isPositiveAndBelow (index, props.size()) && props.begin()[index].name == name)
+                return props.getVarPointerAt (index);
+
+            auto newIndex = props.indexOf (name);
+
+            if (newIndex < 0)
+                return nullptr;
+
+            index = newIndex;
+            return props.getVarPointerAt (index);
+        }
+
+        mutable int index = -1;
+    };
+
     //==============================================================================
     struct CodeLocation
     {
@@ -187,6 +257,15 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                                      : var::undefined();
         }
 
+        var findSymbolInParentScopes (const Identifier& name, const PropertyLookupCache& cache) const
+        {
+            for (auto* s = this; s != nullptr; s = s->parent)
+                if (auto v = cache.find (*s->scope, name))
+                    return *v;
+
+            return var::undefined();
+        }
+
         bool findAndInvokeMethod (const Identifier& function, const var::NativeFunctionArgs& args, var& result) const
         {
             auto* target = args.thisObject.getDynamicObject();
@@ -375,17 +454,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         UnqualifiedName (const CodeLocation& l, const Identifier& n) noexcept : Expression (l), name (n) {}
 
-        var getResult (const Scope& s) const override  { return s.findSymbolInParentScopes (name); }
+        var getResult (const Scope& s) const override  { return s.findSymbolInParentScopes (name, cache); }
 
         void assign (const Scope& s, const var& newValue) const override
         {
-            if (auto* v = getPropertyPointer (*s.scope, name))
+            if (auto* v = cache.find (*s.scope, name))
                 *v = newValue;
             else
                 s.root->setProperty (name, newValue);
         }
 
         Identifier name;
+        PropertyLookupCache cache;
     };
 
     struct DotOperator  : public Expression
@@ -404,7 +484,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             }
 
             if (auto* o = p.getDynamicObject())
-                if (auto* v = getPropertyPointer (*o, child))
+                if (auto* v = cache.find (*o, child))
                     return *v;
 
             return var::undefined();
@@ -420,6 +500,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         ExpPtr parent;
         Identifier child;
+        PropertyLookupCache cache;
     };
 
     struct ArraySubscript  : public Expression
@@ -500,6 +581,10 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         {
             var a (lhs->getResult (s)), b (rhs->getResult (s));
 
+            // fast path for the most common case of arithmetic on plain numbers
+            if (a.isInt() && b.isInt())         return getWithInts ((int) a, (int) b);
+            if (a.isDouble() && b.isDouble())   return getWithDoubles ((double) a, (double) b);
+
             if ((a.isUndefined() || a.isVoid()) && (b.isUndefined() || b.isVoid()))
                 return getWithUndefinedArg();
 
@@ -827,10 +912,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         FunctionObject() noexcept {}
 
-        FunctionObject (const FunctionObject& other)  : DynamicObject(), functionCode (other.functionCode)
+        FunctionObject (const FunctionObject& other)
+            : DynamicObject(), functionCode (other.functionCode), parameters (other.parameters), body (other.body)
         {
-            ExpressionTreeBuilder tb (functionCode);
-            tb.parseFunctionParamsAndBody (*this);
         }
 
         DynamicObject::Ptr clone() override    { return *new FunctionObject (*this); }
@@ -858,7 +942,16 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         String functionCode;
         Array<Identifier> parameters;
-        std::unique_ptr<Statement> body;
+        std::shared_ptr<const Statement> body;
+    };
+
+    // Each evaluation creates a new function object, so that properties set on one
+    // don't appear on the others when a cached tree is run again
+    struct FunctionLiteral  : public Expression
+    {
+        FunctionLiteral (const CodeLocation& l, std::unique_ptr<FunctionObject> f) noexcept : Expression (l), function (std::move (f)) {}
+        var getResult (const Scope&) const override   { return var (new FunctionObject (*function)); }
+        std::unique_ptr<FunctionObject> function;
     };
 
     //==============================================================================
@@ -1200,7 +1293,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             if (name.isNull())
                 throwError ("Functions defined at statement-level must have a name");
 
-            ExpPtr nm (new UnqualifiedName (location, name)), value (new LiteralValue (location, fn));
+            ExpPtr nm (new UnqualifiedName (location, name)), value (new FunctionLiteral (location, std::move (fn)));
             return new Assignment (location, nm, value);
         }
 
@@ -1262,7 +1355,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return i;
         }
 
-        var parseFunctionDefinition (Identifier& functionName)
+        std::unique_ptr<FunctionObject> parseFunctionDefinition (Identifier& functionName)
         {
             auto functionStart = location.location;
 
@@ -1272,7 +1365,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             std::unique_ptr<FunctionObject> fo (new FunctionObject());
             parseFunctionParamsAndBody (*fo);
             fo->functionCode = String (functionStart, location.location);
-            return var (fo.release());
+            return fo;
         }
 
         Expression* parseFunctionCall (FunctionCall* call, ExpPtr& function)
@@ -1372,12 +1465,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             if (matchIf (TokenTypes::function))
             {
                 Identifier name;
-                var fn = parseFunctionDefinition (name);
+                auto fn = parseFunctionDefinition (name);
 
                 if (name.isValid())
                     throwError ("Inline functions definitions cannot have a name");
 
-                return new LiteralValue (location, fn);
+                return new FunctionLiteral (location, std::move (fn));
             }
 
             if (matchIf (TokenTypes::new_))
@@ -1420,8 +1513,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         Expression* parseUnary()
         {
-            if (matchIf (TokenTypes::minus))       { ExpPtr a (new LiteralValue (location, (int) 0)), b (parseUnary()); return new SubtractionOp   (location, a, b); }
-            if (matchIf (TokenTypes::logicalNot))  { ExpPtr a (new LiteralValue (location, (int) 0)), b (parseUnary()); return new EqualsOp        (location, a, b); }
+            if (matchIf (TokenTypes::minus))       { ExpPtr a (new LiteralValue (location, (int) 0)), b (parseUnary()); return foldConstants (new SubtractionOp (location, a, b)); }
+            if (matchIf (TokenTypes::logicalNot))  { ExpPtr a (new LiteralValue (location, (int) 0)), b (parseUnary()); return foldConstants (new EqualsOp (location, a, b)); }
             if (matchIf (TokenTypes::plusplus))    return parsePreIncDec<AdditionOp>();
             if (matchIf (TokenTypes::minusminus))  return parsePreIncDec<SubtractionOp>();
             if (matchIf (TokenTypes::typeof_))     return parseTypeof();
@@ -1435,9 +1528,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (;;)
             {
-                if (matchIf (TokenTypes::times))        { ExpPtr b (parseUnary()); a.reset (new MultiplyOp (location, a, b)); }
-                else if (matchIf (TokenTypes::divide))  { ExpPtr b (parseUnary()); a.reset (new DivideOp   (location, a, b)); }
-                else if (matchIf (TokenTypes::modulo))  { ExpPtr b (parseUnary()); a.reset (new ModuloOp   (location, a, b)); }
+                if (matchIf (TokenTypes::times))        { ExpPtr b (parseUnary()); a.reset (foldConstants (new MultiplyOp (location, a, b))); }
+                else if (matchIf (TokenTypes::divide))  { ExpPtr b (parseUnary()); a.reset (foldConstants (new DivideOp   (location, a, b))); }
+                else if (matchIf (TokenTypes::modulo))  { ExpPtr b (parseUnary()); a.reset (foldConstants (new ModuloOp   (location, a, b))); }
                 else break;
             }
 
@@ -1450,8 +1543,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (;;)
             {
-                if (matchIf (TokenTypes::plus))            { ExpPtr b (parseMultiplyDivide()); a.reset (new AdditionOp    (location, a, b)); }
-                else if (matchIf (TokenTypes::minus))      { ExpPtr b (parseMultiplyDivide()); a.reset (new SubtractionOp (location, a, b)); }
+                if (matchIf (TokenTypes::plus))            { ExpPtr b (parseMultiplyDivide()); a.reset (foldConstants (new AdditionOp    (location, a, b))); }
+                else if (matchIf (TokenTypes::minus))      { ExpPtr b (parseMultiplyDivide()); a.reset (foldConstants (new SubtractionOp (location, a, b))); }
                 else break;
             }
 
@@ -1464,9 +1557,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (;;)
             {
-                if (matchIf (TokenTypes::leftShift))                { ExpPtr b (parseExpression()); a.reset (new LeftShiftOp          (location, a, b)); }
-                else if (matchIf (TokenTypes::rightShift))          { ExpPtr b (parseExpression()); a.reset (new RightShiftOp         (location, a, b)); }
-                else if (matchIf (TokenTypes::rightShiftUnsigned))  { ExpPtr b (parseExpression()); a.reset (new RightShiftUnsignedOp (location, a, b)); }
+                if (matchIf (TokenTypes::leftShift))                { ExpPtr b (parseExpression()); a.reset (foldConstants (new LeftShiftOp          (location, a, b))); }
+                else if (matchIf (TokenTypes::rightShift))          { ExpPtr b (parseExpression()); a.reset (foldConstants (new RightShiftOp         (location, a, b))); }
+                else if (matchIf (TokenTypes::rightShiftUnsigned))  { ExpPtr b (parseExpression()); a.reset (foldConstants (new RightShiftUnsignedOp (location, a, b))); }
                 else break;
             }
 
@@ -1479,14 +1572,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (;;)
             {
-                if (matchIf (TokenTypes::equals))                  { ExpPtr b (parseShiftOperator()); a.reset (new EqualsOp             (location, a, b)); }
-                else if (matchIf (TokenTypes::notEquals))          { ExpPtr b (parseShiftOperator()); a.reset (new NotEqualsOp          (location, a, b)); }
+                if (matchIf (TokenTypes::equals))                  { ExpPtr b (parseShiftOperator()); a.reset (foldConstants (new EqualsOp             (location, a, b))); }
+                else if (matchIf (TokenTypes::notEquals))          { ExpPtr b (parseShiftOperator()); a.reset (foldConstants (new NotEqualsOp          (location, a, b))); }
                 else if (matchIf (TokenTypes::typeEquals))         { ExpPtr b (parseShiftOperator()); a.reset (new TypeEqualsOp         (location, a, b)); }
                 else if (matchIf (TokenTypes::typeNotEquals))      { ExpPtr b (parseShiftOperator()); a.reset (new TypeNotEqualsOp      (location, a, b)); }
-                else if (matchIf (TokenTypes::lessThan))           { ExpPtr b (parseShiftOperator()); a.reset (new LessThanOp           (location, a, b)); }
-                else if (matchIf (TokenTypes::lessThanOrEqual))    { ExpPtr b (parseShiftOperator()); a.reset (new LessThanOrEqualOp    (location, a, b)); }
-                else if (matchIf (TokenTypes::greaterThan))        { ExpPtr b (parseShiftOperator()); a.reset (new GreaterThanOp        (location, a, b)); }
-                else if (matchIf (TokenTypes::greaterThanOrEqual)) { ExpPtr b (parseShiftOperator()); a.reset (new GreaterThanOrEqualOp (location, a, b)); }
+                else if (matchIf (TokenTypes::lessThan))           { ExpPtr b (parseShiftOperator()); a.reset (foldConstants (new LessThanOp           (location, a, b))); }
+                else if (matchIf (TokenTypes::lessThanOrEqual))    { ExpPtr b (parseShiftOperator()); a.reset (foldConstants (new LessThanOrEqualOp    (location, a, b))); }
+                else if (matchIf (TokenTypes::greaterThan))        { ExpPtr b (parseShiftOperator()); a.reset (foldConstants (new GreaterThanOp        (location, a, b))); }
+                else if (matchIf (TokenTypes::greaterThanOrEqual)) { ExpPtr b (parseShiftOperator()); a.reset (foldConstants (new GreaterThanOrEqualOp (location, a, b))); }
                 else break;
             }
 
@@ -1501,15 +1594,41 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             {
                 if (matchIf (TokenTypes::logicalAnd))       { ExpPtr b (parseComparator()); a.reset (new LogicalAndOp (location, a, b)); }
                 else if (matchIf (TokenTypes::logicalOr))   { ExpPtr b (parseComparator()); a.reset (new LogicalOrOp  (location, a, b)); }
-                else if (matchIf (TokenTypes::bitwiseAnd))  { ExpPtr b (parseComparator()); a.reset (new BitwiseAndOp (location, a, b)); }
-                else if (matchIf (TokenTypes::bitwiseOr))   { ExpPtr b (parseComparator()); a.reset (new BitwiseOrOp  (location, a, b)); }
-                else if (matchIf (TokenTypes::bitwiseXor))  { ExpPtr b (parseComparator()); a.reset (new BitwiseXorOp (location, a, b)); }
+                else if (matchIf (TokenTypes::bitwiseAnd))  { ExpPtr b (parseComparator()); a.reset (foldConstants (new BitwiseAndOp (location, a, b))); }
+                else if (matchIf (TokenTypes::bitwiseOr))   { ExpPtr b (parseComparator()); a.reset (foldConstants (new BitwiseOrOp  (location, a, b))); }
+                else if (matchIf (TokenTypes::bitwiseXor))  { ExpPtr b (parseComparator()); a.reset (foldConstants (new BitwiseXorOp (location, a, b))); }
                 else break;
             }
 
             return a.release();
         }
 
+        // An operator whose operands are both constants (such as the "0 - x" which represents
+        // a negative number) is evaluated once here, rather than every time the code runs.
+        Expression* foldConstants (BinaryOperator* op)
+        {
+            ExpPtr e (op);
+
+            if (isConstant (op->lhs) && isConstant (op->rhs))
+            {
+                try
+                {
+                    return new LiteralValue (op->location, op->getResult (Scope (nullptr, nullptr, nullptr)));
+                }
+                catch (String&) {} // any error will be reported if the code is actually run
+            }
+
+            return e.release();
+        }
+
+        static bool isConstant (const ExpPtr& e)
+        {
+            if (auto* literal = dynamic_cast<LiteralValue*> (e.get()))
+                return isNumeric (literal->value) || literal->value.isString();
+
+            return false;
+        }
+
         Expression* parseTernaryOperator (ExpPtr& condition)
         {
             std::unique_ptr<ConditionalOp> e (new ConditionalOp (location));
@@ -1916,4 +2035,111 @@ const NamedValueSet& JavascriptEngine::getRootObjectProperties() const noexcept
 
 JUCE_END_IGNORE_WARNINGS_MSVC
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JavascriptEngineTests  : public UnitTest
+{
+public:
+    JavascriptEngineTests()
+        : UnitTest ("JavascriptEngine", UnitTestCategories::javascript)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Arithmetic and constant expressions");
+        {
+            JavascriptEngine engine;
+
+            expectEquals ((int) engine.evaluate ("-5"), -5);
+            expectEquals ((int) engine.evaluate ("2 * 3 + 4"), 10);
+            expectEquals ((double) engine.evaluate ("1.5 * 2"), 3.0);
+            expectEquals ((int) engine.evaluate ("7 % 4"), 3);
+            expect ((bool) engine.evaluate ("!0"));
+            expect ((bool) engine.evaluate ("3 < 4 && 4 >= 4"));
+            expectEquals (engine.evaluate ("\"a\" + 1").toString(), String ("a1"));
+            expectEquals ((int) engine.evaluate ("1 << 4"), 16);
+
+            Result result (Result::ok());
+            engine.evaluate ("1.5 | 2", &result);
+            expect (result.failed());
+        }
+
+        beginTest ("Repeated evaluation of the same code");
+        {
+            JavascriptEngine engine;
+            expect (engine.execute ("var counter = 0; var obj = { a: 1, b: 2 };").wasOk());
+
+            for (int i = 0; i < 100; ++i)
+                expect (engine.execute ("counter = counter + obj.b;").wasOk());
+
+            expectEquals ((int) engine.evaluate ("counter"), 200);
+
+            for (int i = 0; i < 10; ++i)
+                expectEquals ((int) engine.evaluate ("obj.a + obj.b"), 3);
+        }
+
+        beginTest ("Property caches follow changes in object shape");
+        {
+            JavascriptEngine engine;
+            expect (engine.execute ("function get (o) { return o.x; }"
+                                    "var first  = { x: 1, y: 2 };"
+                                    "var second = { y: 3, x: 4 };"
+                                    "var third  = { z: 5 };").wasOk());
+
+            for (int i = 0; i < 3; ++i)
+            {
+                expectEquals ((int) engine.evaluate ("get (first)"), 1);
+                expectEquals ((int) engine.evaluate ("get (second)"), 4);
+                expect (engine.evaluate ("get (third)").isUndefined());
+            }
+
+            expect (engine.execute ("first.x = 10; var x = 20;").wasOk());
+            expectEquals ((int) engine.evaluate ("get (first)"), 10);
+            expectEquals ((int) engine.evaluate ("x"), 20);
+        }
+
+        beginTest ("Nested scopes");
+        {
+            JavascriptEngine engine;
+            expect (engine.execute ("var total = 0;"
+                                    "function add (n) { var local = n * 2; total = total + local; return local; }"
+                                    "for (var i = 0; i < 10; ++i) add (i);").wasOk());
+
+            expectEquals ((int) engine.evaluate ("total"), 90);
+            expectEquals ((int) engine.evaluate ("add (4)"), 8);
+        }
+
+        beginTest ("Code can evaluate other code while running");
+        {
+            JavascriptEngine engine;
+            expect (engine.execute ("var n = 0;"
+                                    "for (var i = 0; i < 40; ++i) n = n + eval (\"1 + \" + i);").wasOk());
+
+            expectEquals ((int) engine.evaluate ("n"), 820);
+        }
+
+        beginTest ("Running code again creates new function objects");
+        {
+            JavascriptEngine engine;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                expect (engine.execute ("var f = function() {}; f.n = (f.n || 0) + 1;"
+                                        "function g() {} g.n = (g.n || 0) + 1;").wasOk());
+
+                expectEquals ((int) engine.evaluate ("f.n"), 1);
+                expectEquals ((int) engine.evaluate ("g.n"), 1);
+            }
+
+            expectEquals ((int) engine.evaluate ("[function (x) { return x * 2; }][0] (21)"), 42);
+        }
+    }
+};
+
+static JavascriptEngineTests javascriptEngineTests;
+
+#endif
+
 } // namespace juce
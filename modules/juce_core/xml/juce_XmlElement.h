@@ -774,6 +774,7 @@ private:
     };
 
     friend class XmlDocument;
+    friend class XmlPullParser;
     friend class LinkedListPointer<XmlAttributeNode>;
     friend class LinkedListPointer<XmlElement>;
     friend class LinkedListPointer<XmlElement>::Appender;
@@ -0,0 +1,884 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace XmlPullParserHelpers
+{
+    // Any byte of a multi-byte UTF-8 sequence is treated as part of a name, so names
+    // can be found without decoding the text.
+    static bool isNameByte (char c) noexcept
+    {
+        static const uint32 legalChars[] = { 0, 0x7ff6000, 0x87fffffe, 0x7fffffe };
+        auto b = (uint8) c;
+
+        return b >= 0x80 || (legalChars[b >> 5] & (uint32) (1 << (b & 31))) != 0;
+    }
+
+    static bool isWhitespaceByte (char c) noexcept
+    {
+        return c == ' ' || (c <= 13 && c >= 9);
+    }
+
+    static bool rangeEquals (const char* start, const char* end, StringRef s) noexcept
+    {
+        CharPointer_UTF8 p (start);
+        auto t = s.text;
+
+        while (p.getAddress() < end)
+            if (p.getAndAdvance() != t.getAndAdvance())
+                return false;
+
+        return t.isEmpty();
+    }
+
+    static bool rangeEquals (const char* start1, const char* end1,
+                             const char* start2, const char* end2) noexcept
+    {
+        return end1 - start1 == end2 - start2
+                && std::memcmp (start1, start2, (size_t) (end1 - start1)) == 0;
+    }
+
+    static bool equalsIgnoreCase (const char* start, const char* end, const char* lowerCaseName) noexcept
+    {
+        for (auto* p = start; p < end; ++p, ++lowerCaseName)
+            if (*lowerCaseName == 0 || CharacterFunctions::toLowerCase ((juce_wchar) (uint8) *p) != (juce_wchar) *lowerCaseName)
+                return false;
+
+        return *lowerCaseName == 0;
+    }
+
+    static const char* findSequence (const char* start, const char* end, const char* s, size_t length) noexcept
+    {
+        for (auto* p = start;; ++p)
+        {
+            p = static_cast<const char*> (std::memchr (p, s[0], (size_t) (end - p)));
+
+            if (p == nullptr || (size_t) (end - p) < length)
+                return nullptr;
+
+            if (std::memcmp (p, s, length) == 0)
+                return p;
+        }
+    }
+
+    static Identifier createIdentifier (const char* start, const char* end)
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        return Identifier (String::CharPointerType (start), String::CharPointerType (end));
+       #else
+        return Identifier (String (CharPointer_UTF8 (start), CharPointer_UTF8 (end)));
+       #endif
+    }
+
+    static juce_wchar parseCharacterReference (const char* start, const char* end) noexcept
+    {
+        int64 charCode = 0;
+
+        if (start < end && (*start == 'x' || *start == 'X'))
+        {
+            if (++start == end || end - start > 8)
+                return 0;
+
+            for (auto* p = start; p < end; ++p)
+            {
+                auto hexValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) *p);
+
+                if (hexValue < 0)
+                    return 0;
+
+                charCode = (charCode << 4) | hexValue;
+            }
+        }
+        else
+        {
+            if (start == end || end - start > 12)
+                return 0;
+
+            for (auto* p = start; p < end; ++p)
+            {
+                if (*p < '0' || *p > '9')
+                    return 0;
+
+                charCode = charCode * 10 + (*p - '0');
+            }
+        }
+
+        return charCode > 0 && charCode <= 0x10ffff ? (juce_wchar) charCode : 0;
+    }
+
+    // Appends the character for the entity starting at the given ampersand, and returns
+    // the position after it. Anything that can't be decoded is copied unchanged.
+    static const char* appendEntity (const char* ampersand, const char* end, String& result)
+    {
+        auto* semicolon = static_cast<const char*> (std::memchr (ampersand, ';', (size_t) (end - ampersand)));
+
+        if (semicolon == nullptr)
+        {
+            result << '&';
+            return ampersand + 1;
+        }
+
+        auto* name = ampersand + 1;
+
+        if      (equalsIgnoreCase (name, semicolon, "amp"))   result << '&';
+        else if (equalsIgnoreCase (name, semicolon, "quot"))  result << '"';
+        else if (equalsIgnoreCase (name, semicolon, "apos"))  result << '\'';
+        else if (equalsIgnoreCase (name, semicolon, "lt"))    result << '<';
+        else if (equalsIgnoreCase (name, semicolon, "gt"))    result << '>';
+        else if (name < semicolon && *name == '#')
+        {
+            if (auto c = parseCharacterReference (name + 1, semicolon))
+                result << c;
+            else
+                result.appendCharPointer (CharPointer_UTF8 (ampersand), CharPointer_UTF8 (semicolon + 1));
+        }
+        else
+        {
+            result.appendCharPointer (CharPointer_UTF8 (ampersand), CharPointer_UTF8 (semicolon + 1));
+        }
+
+        return semicolon + 1;
+    }
+}
+
+//==============================================================================
+XmlPullParser::XmlPullParser (const void* data, size_t numBytes)
+{
+    setData (data, numBytes);
+}
+
+XmlPullParser::XmlPullParser (const String& documentText)  : ownedText (documentText)
+{
+    position = ownedText.toRawUTF8();
+    end = position + ownedText.getNumBytesAsUTF8();
+}
+
+XmlPullParser::XmlPullParser (const File& file)
+    : mappedFile (new MemoryMappedFile (file, MemoryMappedFile::readOnly))
+{
+    if (mappedFile->getData() != nullptr)
+    {
+        setData (mappedFile->getData(), mappedFile->getSize());
+    }
+    else
+    {
+        mappedFile.reset();
+        file.loadFileAsData (fileData);
+        setData (fileData.getData(), fileData.getSize());
+    }
+}
+
+XmlPullParser::~XmlPullParser() {}
+
+void XmlPullParser::setData (const void* data, size_t numBytes)
+{
+    auto* bytes = static_cast<const char*> (data);
+
+    if (numBytes >= 2 && (CharPointer_UTF16::isByteOrderMarkBigEndian (bytes)
+                           || CharPointer_UTF16::isByteOrderMarkLittleEndian (bytes)))
+    {
+        ownedText = String::createStringFromData (data, (int) numBytes);
+        position = ownedText.toRawUTF8();
+        end = position + ownedText.getNumBytesAsUTF8();
+        return;
+    }
+
+    position = bytes;
+    end = bytes + numBytes;
+
+    if (numBytes >= 3 && CharPointer_UTF8::isByteOrderMark (bytes))
+        position += 3;
+}
+
+void XmlPullParser::setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept
+{
+    ignoreEmptyTextElements = shouldBeIgnored;
+}
+
+//==============================================================================
+XmlPullParser::Event XmlPullParser::next()
+{
+    if (currentEvent == Event::endOfDocument || currentEvent == Event::error)
+        return currentEvent;
+
+    if (currentEvent == Event::endElement)
+    {
+        openElements.pop_back();
+
+        if (openElements.empty())
+            return currentEvent = Event::endOfDocument;
+    }
+
+    if (currentEvent == Event::startElement && isEmptyElementTag)
+    {
+        isEmptyElementTag = false;
+        return currentEvent = Event::endElement;
+    }
+
+    for (;;)
+    {
+        if (openElements.empty())
+            skipWhitespace();
+
+        if (position >= end)
+            return setError (openElements.empty() ? "not enough input" : "unmatched tags");
+
+        if (*position != '<')
+        {
+            if (openElements.empty())
+                return setError ("illegal characters found outside the document element");
+
+            if (readText())
+                return currentEvent = Event::text;
+
+            if (currentEvent == Event::error)
+                return currentEvent;
+
+            continue;
+        }
+
+        if (startsWith ("<!--", 4))
+        {
+            if (! skipPast ("-->", 3))
+                return setError ("unterminated comment");
+
+            continue;
+        }
+
+        if (startsWith ("<?", 2))
+        {
+            if (! skipPast ("?>", 2))
+                return setError ("malformed header");
+
+            continue;
+        }
+
+        if (startsWith ("<![CDATA[", 9))
+        {
+            if (openElements.empty())
+                return setError ("illegal characters found outside the document element");
+
+            position += 9;
+            auto* start = position;
+
+            if (! skipPast ("]]>", 3))
+                return setError ("unterminated CDATA section");
+
+            text = { start, position - 3 };
+            textNeedsDecoding = false;
+            return currentEvent = Event::text;
+        }
+
+        if (startsWith ("<!", 2))
+        {
+            // a DOCTYPE, which may contain nested declarations
+            for (int depth = 0; position < end; ++position)
+            {
+                if (*position == '<')
+                    ++depth;
+                else if (*position == '>' && --depth == 0)
+                    break;
+            }
+
+            if (position >= end)
+                return setError ("malformed DTD");
+
+            ++position;
+            continue;
+        }
+
+        if (startsWith ("</", 2))
+            return readEndTag();
+
+        return readStartTag();
+    }
+}
+
+XmlPullParser::Event XmlPullParser::setError (const String& message)
+{
+    lastError = message;
+    position = end;
+    return currentEvent = Event::error;
+}
+
+bool XmlPullParser::startsWith (const char* s, size_t length) const noexcept
+{
+    return (size_t) (end - position) >= length && std::memcmp (position, s, length) == 0;
+}
+
+bool XmlPullParser::skipPast (const char* s, size_t length) noexcept
+{
+    if (auto* p = XmlPullParserHelpers::findSequence (position, end, s, length))
+    {
+        position = p + length;
+        return true;
+    }
+
+    position = end;
+    return false;
+}
+
+void XmlPullParser::skipWhitespace() noexcept
+{
+    while (position < end && XmlPullParserHelpers::isWhitespaceByte (*position))
+        ++position;
+}
+
+XmlPullParser::TextRange XmlPullParser::readName() noexcept
+{
+    auto* start = position;
+
+    while (position < end && XmlPullParserHelpers::isNameByte (*position))
+        ++position;
+
+    return { start, position };
+}
+
+XmlPullParser::Event XmlPullParser::readStartTag()
+{
+    ++position;
+    skipWhitespace();
+    tagName = readName();
+
+    if (tagName.start == tagName.end)
+        return setError ("tag name missing");
+
+    attributes.clear();
+
+    for (;;)
+    {
+        skipWhitespace();
+
+        if (position >= end)
+            return setError ("unmatched tags");
+
+        auto c = *position;
+
+        if (c == '/' && startsWith ("/>", 2))
+        {
+            position += 2;
+            isEmptyElementTag = true;
+            break;
+        }
+
+        if (c == '>')
+        {
+            ++position;
+            isEmptyElementTag = false;
+            break;
+        }
+
+        auto name = readName();
+
+        if (name.start == name.end)
+            return setError ("illegal character found in " + getTagName() + ": '" + String::charToString ((juce_wchar) (uint8) c) + "'");
+
+        skipWhitespace();
+
+        if (position >= end || *position != '=')
+            return setError ("expected '=' after attribute '" + String (CharPointer_UTF8 (name.start), CharPointer_UTF8 (name.end)) + "'");
+
+        ++position;
+        skipWhitespace();
+
+        if (position >= end || (*position != '"' && *position != '\''))
+            return setError ("expected a quoted value for attribute '" + String (CharPointer_UTF8 (name.start), CharPointer_UTF8 (name.end)) + "'");
+
+        auto quote = *position++;
+        auto* closingQuote = static_cast<const char*> (std::memchr (position, quote, (size_t) (end - position)));
+
+        if (closingQuote == nullptr)
+            return setError ("unmatched quotes");
+
+        attributes.push_back ({ name, { position, closingQuote } });
+        position = closingQuote + 1;
+    }
+
+    openElements.push_back (tagName);
+    return currentEvent = Event::startElement;
+}
+
+XmlPullParser::Event XmlPullParser::readEndTag()
+{
+    position += 2;
+    skipWhitespace();
+    auto name = readName();
+    skipWhitespace();
+
+    if (position >= end || *position != '>')
+        return setError ("malformed closing tag");
+
+    ++position;
+
+    if (openElements.empty()
+         || ! XmlPullParserHelpers::rangeEquals (name.start, name.end, openElements.back().start, openElements.back().end))
+        return setError ("mismatched closing tag: " + String (CharPointer_UTF8 (name.start), CharPointer_UTF8 (name.end)));
+
+    tagName = name;
+    return currentEvent = Event::endElement;
+}
+
+bool XmlPullParser::readText()
+{
+    auto* start = position;
+    bool hasContent = ! ignoreEmptyTextElements;
+    textNeedsDecoding = false;
+
+    for (;;)
+    {
+        auto* nextTag = static_cast<const char*> (std::memchr (position, '<', (size_t) (end - position)));
+
+        if (nextTag == nullptr)
+        {
+            setError ("unmatched tags");
+            return false;
+        }
+
+        for (auto* p = position; p < nextTag; ++p)
+        {
+            auto c = *p;
+
+            if (c == '&' || c == '\r')
+                textNeedsDecoding = true;
+
+            if (! XmlPullParserHelpers::isWhitespaceByte (c))
+                hasContent = true;
+        }
+
+        position = nextTag;
+
+        // comments don't split up a block of text, they're just removed from it
+        if (! startsWith ("<!--", 4))
+            break;
+
+        textNeedsDecoding = true;
+
+        if (! skipPast ("-->", 3))
+        {
+            setError ("unterminated comment");
+            return false;
+        }
+    }
+
+    text = { start, position };
+    return hasContent;
+}
+
+String XmlPullParser::decode (TextRange range, bool isText) const
+{
+    auto needsDecoding = isText ? textNeedsDecoding
+                                : std::memchr (range.start, '&', (size_t) (range.end - range.start)) != nullptr;
+
+    if (! needsDecoding)
+        return String (CharPointer_UTF8 (range.start), CharPointer_UTF8 (range.end));
+
+    String result;
+    result.preallocateBytes ((size_t) (range.end - range.start));
+
+    auto* p = range.start;
+    auto* runStart = p;
+
+    auto appendRun = [&]
+    {
+        if (p > runStart)
+            result.appendCharPointer (CharPointer_UTF8 (runStart), CharPointer_UTF8 (p));
+    };
+
+    while (p < range.end)
+    {
+        auto c = *p;
+
+        if (c == '&')
+        {
+            appendRun();
+            p = XmlPullParserHelpers::appendEntity (p, range.end, result);
+            runStart = p;
+        }
+        else if (isText && c == '\r')
+        {
+            appendRun();
+            result << '\n';
+
+            if (++p < range.end && *p == '\n')
+                ++p;
+
+            runStart = p;
+        }
+        else if (isText && c == '<')
+        {
+            // the only tags left in a block of text are comments
+            appendRun();
+            auto* commentEnd = XmlPullParserHelpers::findSequence (p, range.end, "-->", 3);
+            p = commentEnd != nullptr ? commentEnd + 3 : range.end;
+            runStart = p;
+        }
+        else
+        {
+            ++p;
+        }
+    }
+
+    appendRun();
+    return result;
+}
+
+//==============================================================================
+String XmlPullParser::getTagName() const
+{
+    return String (CharPointer_UTF8 (tagName.start), CharPointer_UTF8 (tagName.end));
+}
+
+bool XmlPullParser::hasTagName (StringRef possibleTagName) const noexcept
+{
+    return (currentEvent == Event::startElement || currentEvent == Event::endElement)
+             && XmlPullParserHelpers::rangeEquals (tagName.start, tagName.end, possibleTagName);
+}
+
+String XmlPullParser::getAttributeName (int attributeIndex) const
+{
+    if (isPositiveAndBelow (attributeIndex, getNumAttributes()))
+    {
+        auto& name = attributes[(size_t) attributeIndex].name;
+        return String (CharPointer_UTF8 (name.start), CharPointer_UTF8 (name.end));
+    }
+
+    return {};
+}
+
+String XmlPullParser::getAttributeValue (int attributeIndex) const
+{
+    if (isPositiveAndBelow (attributeIndex, getNumAttributes()))
+        return decode (attributes[(size_t) attributeIndex].value, false);
+
+    return {};
+}
+
+const XmlPullParser::Attribute* XmlPullParser::findAttribute (StringRef attributeName) const noexcept
+{
+    if (currentEvent == Event::startElement)
+        for (auto& att : attributes)
+            if (XmlPullParserHelpers::rangeEquals (att.name.start, att.name.end, attributeName))
+                return &att;
+
+    return nullptr;
+}
+
+bool XmlPullParser::hasAttribute (StringRef attributeName) const noexcept
+{
+    return findAttribute (attributeName) != nullptr;
+}
+
+String XmlPullParser::getAttributeValue (StringRef attributeName, const String& defaultReturnValue) const
+{
+    if (auto* att = findAttribute (attributeName))
+        return decode (att->value, false);
+
+    return defaultReturnValue;
+}
+
+String XmlPullParser::getText() const
+{
+    if (currentEvent == Event::text)
+        return decode (text, true);
+
+    return {};
+}
+
+//==============================================================================
+bool XmlPullParser::skipElement()
+{
+    if (currentEvent != Event::startElement)
+        return false;
+
+    auto depth = openElements.size();
+
+    for (;;)
+    {
+        auto event = next();
+
+        if (event == Event::endElement && openElements.size() == depth)
+            return true;
+
+        if (event == Event::error || event == Event::endOfDocument)
+            return false;
+    }
+}
+
+std::unique_ptr<XmlElement> XmlPullParser::createElement() const
+{
+    auto element = std::make_unique<XmlElement> (XmlPullParserHelpers::createIdentifier (tagName.start, tagName.end));
+    LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (element->attributes);
+
+    for (auto& att : attributes)
+        attributeAppender.append (new XmlElement::XmlAttributeNode (XmlPullParserHelpers::createIdentifier (att.name.start, att.name.end),
+                                                                    decode (att.value, false)));
+
+    return element;
+}
+
+std::unique_ptr<XmlElement> XmlPullParser::readElement()
+{
+    if (currentEvent != Event::startElement)
+        return {};
+
+    auto element = createElement();
+    LinkedListPointer<XmlElement>::Appender childAppender (element->firstChildElement);
+
+    for (;;)
+    {
+        auto event = next();
+
+        if (event == Event::startElement)
+        {
+            auto child = readElement();
+
+            if (child == nullptr)
+                return {};
+
+            childAppender.append (child.release());
+        }
+        else if (event == Event::text)
+        {
+            childAppender.append (XmlElement::createTextElement (getText()));
+        }
+        else if (event == Event::endElement)
+        {
+            return element;
+        }
+        else
+        {
+            return {};
+        }
+    }
+}
+
+std::unique_ptr<XmlElement> XmlPullParser::getDocumentElement()
+{
+    // this needs to be called before anything else has been read!
+    jassert (currentEvent == Event::none);
+
+    if (next() == Event::startElement)
+        return readElement();
+
+    return {};
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlPullParserTests  : public UnitTest
+{
+public:
+    XmlPullParserTests()
+        : UnitTest ("XmlPullParser", UnitTestCategories::xml)
+    {}
+
+    void runTest() override
+    {
+        using Event = XmlPullParser::Event;
+
+        beginTest ("Events");
+        {
+            XmlPullParser parser ("<?xml version=\"1.0\"?>\n<!-- a comment -->\n"
+                                  "<root a=\"1\" b='x &amp; y'>hello &lt;world&gt;"
+                                  "<child/><![CDATA[<raw &amp;>]]><!-- comment --><other>te<!--x-->xt</other></root>");
+
+            expect (parser.getCurrentEvent() == Event::none);
+            expect (parser.next() == Event::startElement);
+            expect (parser.hasTagName ("root"));
+            expect (! parser.hasTagName ("roo"));
+            expectEquals (parser.getDepth(), 1);
+            expectEquals (parser.getNumAttributes(), 2);
+            expectEquals (parser.getAttributeName (1), String ("b"));
+            expectEquals (parser.getAttributeValue (1), String ("x & y"));
+            expectEquals (parser.getAttributeValue ("a"), String ("1"));
+            expectEquals (parser.getAttributeValue ("c", "default"), String ("default"));
+            expect (! parser.hasAttribute ("c"));
+
+            expect (parser.next() == Event::text);
+            expectEquals (parser.getText(), String ("hello <world>"));
+
+            expect (parser.next() == Event::startElement);
+            expect (parser.hasTagName ("child"));
+            expectEquals (parser.getDepth(), 2);
+            expect (parser.next() == Event::endElement);
+            expect (parser.hasTagName ("child"));
+
+            expect (parser.next() == Event::text);
+            expectEquals (parser.getText(), String ("<raw &amp;>"));
+
+            expect (parser.next() == Event::startElement);
+            expectEquals (parser.getTagName(), String ("other"));
+            expect (parser.next() == Event::text);
+            expectEquals (parser.getText(), String ("text"));
+            expect (parser.next() == Event::endElement);
+
+            expect (parser.next() == Event::endElement);
+            expect (parser.hasTagName ("root"));
+            expectEquals (parser.getDepth(), 1);
+            expect (parser.next() == Event::endOfDocument);
+            expect (parser.next() == Event::endOfDocument);
+        }
+
+        beginTest ("Entities and line endings");
+        {
+            XmlPullParser parser ("<a v=\"&#65;&#x42;&Lt;&unknown;\">line1\r\nline2\rline3 &#x1F600;</a>");
+
+            expect (parser.next() == Event::startElement);
+            expectEquals (parser.getAttributeValue ("v"), String ("AB<&unknown;"));
+            expect (parser.next() == Event::text);
+            expectEquals (parser.getText(), "line1\nline2\nline3 " + String::charToString ((juce_wchar) 0x1f600));
+        }
+
+        beginTest ("Whitespace");
+        {
+            const String doc ("<a>\n  <b/>\n</a>");
+
+            XmlPullParser ignoring (doc);
+            expect (ignoring.next() == Event::startElement);
+            expect (ignoring.next() == Event::startElement);
+
+            XmlPullParser keeping (doc);
+            keeping.setEmptyTextElementsIgnored (false);
+            expect (keeping.next() == Event::startElement);
+            expect (keeping.next() == Event::text);
+            expectEquals (keeping.getText(), String ("\n  "));
+        }
+
+        beginTest ("Matches XmlDocument");
+        {
+            auto doc = createTestDocument();
+
+            auto expected = parseXML (doc);
+            auto actual = XmlPullParser (doc).getDocumentElement();
+
+            expect (expected != nullptr && actual != nullptr);
+            expect (actual->isEquivalentTo (expected.get(), false));
+            expectEquals (actual->toString(), expected->toString());
+        }
+
+        beginTest ("Reading and skipping sub-elements");
+        {
+            XmlPullParser parser (createTestDocument());
+            int numPresets = 0, numSkipped = 0;
+
+            while (parser.next() != Event::endOfDocument)
+            {
+                expect (parser.getCurrentEvent() != Event::error);
+
+                if (parser.getCurrentEvent() == Event::startElement)
+                {
+                    if (parser.hasTagName ("PRESET"))
+                    {
+                        auto preset = parser.readElement();
+                        expect (preset != nullptr && preset->hasTagName ("PRESET"));
+                        expectEquals (preset->getNumChildElements(), 2);
+                        expect (parser.hasTagName ("PRESET") && parser.getCurrentEvent() == Event::endElement);
+                        ++numPresets;
+                    }
+                    else if (parser.hasTagName ("SKIPPED"))
+                    {
+                        expect (parser.skipElement());
+                        expect (parser.hasTagName ("SKIPPED") && parser.getCurrentEvent() == Event::endElement);
+                        ++numSkipped;
+                    }
+                }
+            }
+
+            expectEquals (numPresets, 50);
+            expectEquals (numSkipped, 1);
+        }
+
+        beginTest ("Files and byte order marks");
+        {
+            auto doc = createTestDocument();
+            auto expected = parseXML (doc);
+
+            TemporaryFile tempFile (".xml");
+            expect (tempFile.getFile().replaceWithText (doc, false, true, nullptr));
+
+            auto fromFile = XmlPullParser (tempFile.getFile()).getDocumentElement();
+            expect (fromFile != nullptr && fromFile->isEquivalentTo (expected.get(), false));
+
+            MemoryOutputStream utf16;
+            utf16.writeText (doc, true, true, nullptr);
+
+            auto fromUTF16 = XmlPullParser (utf16.getData(), utf16.getDataSize()).getDocumentElement();
+            expect (fromUTF16 != nullptr && fromUTF16->isEquivalentTo (expected.get(), false));
+        }
+
+        beginTest ("Errors");
+        {
+            expectError ("", "not enough input");
+            expectError ("<a><b></a>", "mismatched closing tag: a");
+            expectError ("<a><b>", "unmatched tags");
+            expectError ("<a b=\"1></a>", "unmatched quotes");
+            expectError ("<a b></a>", "expected '=' after attribute 'b'");
+            expectError ("<a><!-- </a>", "unterminated comment");
+            expectError ("<a><![CDATA[ </a>", "unterminated CDATA section");
+            expectError ("text<a/>", "illegal characters found outside the document element");
+        }
+    }
+
+    void expectError (const String& doc, const String& expectedError)
+    {
+        XmlPullParser parser (doc);
+
+        while (parser.next() != XmlPullParser::Event::endOfDocument)
+        {
+            if (parser.getCurrentEvent() == XmlPullParser::Event::error)
+            {
+                expectEquals (parser.getLastParseError(), expectedError);
+                expect (parser.next() == XmlPullParser::Event::error);
+                return;
+            }
+        }
+
+        expect (false, "no error for: " + doc);
+    }
+
+    static String createTestDocument()
+    {
+        String doc (CharPointer_UTF8 ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n<!DOCTYPE presets [ <!ELEMENT PRESETS ANY> ]>\r\n"
+                                      "<PRESETS version=\"2\" name=\"caf\xc3\xa9\">\r\n"));
+
+        for (int i = 0; i < 50; ++i)
+            doc << "  <PRESET index=\"" << i << "\" name='Preset &quot;" << i << "&quot;'>\r\n"
+                << "    <PARAM id=\"gain\" value=\"" << (i * 0.5) << "\"/>\r\n"
+                << "    <!-- a comment -->\r\n"
+                << "    <NOTES>Some notes &amp; text\r\nover two lines<![CDATA[ <b>raw</b> ]]></NOTES>\r\n"
+                << "  </PRESET>\r\n";
+
+        doc << "  <SKIPPED><A><B/></A></SKIPPED>\r\n</PRESETS>\r\n";
+        return doc;
+    }
+};
+
+static XmlPullParserTests xmlPullParserTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads an XML document as a sequence of events, without building a tree of
+    XmlElement objects.
+
+    The parser works directly on a block of UTF-8 text - when it's given a File, the
+    file is memory-mapped rather than loaded - and each call to next() moves on to the
+    next start tag, end tag or block of text. Names, attribute values and text are only
+    turned into Strings when you ask for them, so scanning a large document for the few
+    elements you're interested in is much cheaper than parsing the whole thing with
+    XmlDocument.
+
+    e.g.
+    @code
+    XmlPullParser parser (File ("myfile.xml"));
+
+    while (parser.next() == XmlPullParser::Event::startElement)
+    {
+        if (parser.hasTagName ("PRESET"))
+        {
+            DBG (parser.getAttributeValue ("name"));
+
+            // build an XmlElement for just this part of the document..
+            if (auto preset = parser.readElement())
+                loadPreset (*preset);
+        }
+    }
+
+    if (parser.getCurrentEvent() == XmlPullParser::Event::error)
+        DBG (parser.getLastParseError());
+    @endcode
+
+    (Note that the loop above stops at the first end tag or block of text - a real one
+    would usually switch on the event type instead).
+
+    Unlike XmlDocument, this doesn't load DTDs: a DOCTYPE section is skipped, and any
+    entities other than the standard ones and numeric character references are left
+    in the text unchanged.
+
+    @see XmlDocument, XmlElement
+
+    @tags{Core}
+*/
+class JUCE_API  XmlPullParser
+{
+public:
+    //==============================================================================
+    /** Creates a parser that reads a block of UTF-8 or UTF-16 text.
+        The data isn't copied, so it must remain valid for the lifetime of the parser.
+    */
+    XmlPullParser (const void* data, size_t numBytes);
+
+    /** Creates a parser that reads the given text. */
+    explicit XmlPullParser (const String& documentText);
+
+    /** Creates a parser that reads a file.
+        The file is memory-mapped if possible, and must not be modified while the
+        parser is using it.
+    */
+    explicit XmlPullParser (const File& file);
+
+    /** Destructor. */
+    ~XmlPullParser();
+
+    //==============================================================================
+    /** The types of event that the parser produces. */
+    enum class Event
+    {
+        none,           /**< next() hasn't been called yet. */
+        startElement,   /**< An opening tag, or an empty-element tag such as \<foo/\>. */
+        endElement,     /**< A closing tag. An empty-element tag produces a startElement and an endElement. */
+        text,           /**< A block of text or a CDATA section between two tags. */
+        endOfDocument,  /**< The document element has been closed, so there's nothing more to read. */
+        error           /**< The document is malformed - use getLastParseError() for a description. */
+    };
+
+    /** Moves on to the next event in the document, and returns its type.
+        Once endOfDocument or error has been returned, it will keep being returned.
+    */
+    Event next();
+
+    /** Returns the type of the event that the last call to next() returned. */
+    Event getCurrentEvent() const noexcept              { return currentEvent; }
+
+    /** Returns the number of elements that are currently open.
+        For a startElement or endElement event, this includes the element itself, so
+        the document element is at depth 1.
+    */
+    int getDepth() const noexcept                       { return (int) openElements.size(); }
+
+    /** Returns a description of the problem if next() has returned an error. */
+    const String& getLastParseError() const noexcept    { return lastError; }
+
+    /** Sets whether blocks of text which contain only whitespace are reported.
+
+        If this is true (the default state), then text events will only be produced for
+        text which contains other characters. CDATA sections are always reported.
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept;
+
+    //==============================================================================
+    /** For a startElement or endElement event, returns the element's tag name. */
+    String getTagName() const;
+
+    /** For a startElement or endElement event, checks the element's tag name.
+        This is much quicker than calling getTagName(), as it doesn't create a String.
+    */
+    bool hasTagName (StringRef possibleTagName) const noexcept;
+
+    /** For a startElement event, returns the number of attributes in the tag. */
+    int getNumAttributes() const noexcept               { return currentEvent == Event::startElement ? (int) attributes.size() : 0; }
+
+    /** For a startElement event, returns the name of one of the attributes. */
+    String getAttributeName (int attributeIndex) const;
+
+    /** For a startElement event, returns the value of one of the attributes. */
+    String getAttributeValue (int attributeIndex) const;
+
+    /** For a startElement event, checks whether the tag has an attribute with the given name. */
+    bool hasAttribute (StringRef attributeName) const noexcept;
+
+    /** For a startElement event, returns the value of the named attribute, or the default
+        value if there isn't one.
+    */
+    String getAttributeValue (StringRef attributeName, const String& defaultReturnValue = {}) const;
+
+    /** For a text event, returns the text with any entities replaced. */
+    String getText() const;
+
+    //==============================================================================
+    /** When the current event is a startElement, skips forward to its matching endElement.
+        @returns false if an error was found
+    */
+    bool skipElement();
+
+    /** When the current event is a startElement, reads the element and all of its children
+        into a new XmlElement, leaving the parser at its matching endElement.
+
+        If the current event isn't a startElement, or an error is found, this returns nullptr.
+    */
+    std::unique_ptr<XmlElement> readElement();
+
+    /** Reads a whole document and returns its document element.
+        This produces the same elements as XmlDocument::getDocumentElement(), for documents
+        that don't rely on a DTD.
+        @returns the document element, or nullptr if there was an error
+    */
+    std::unique_ptr<XmlElement> getDocumentElement();
+
+private:
+    //==============================================================================
+    struct TextRange
+    {
+        const char* start;
+        const char* end;
+    };
+
+    struct Attribute
+    {
+        TextRange name, value;
+    };
+
+    String ownedText;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    MemoryBlock fileData;
+    const char* position = nullptr;
+    const char* end = nullptr;
+
+    Event currentEvent = Event::none;
+    TextRange tagName { nullptr, nullptr }, text { nullptr, nullptr };
+    std::vector<Attribute> attributes;
+    std::vector<TextRange> openElements;
+    bool textNeedsDecoding = false, isEmptyElementTag = false, isClosingTag = false;
+    bool ignoreEmptyTextElements = true;
+    String lastError;
+
+    void setData (const void*, size_t);
+    Event setError (const String&);
+    bool startsWith (const char*, size_t) const noexcept;
+    bool skipPast (const char*, size_t) noexcept;
+    void skipWhitespace() noexcept;
+    TextRange readName() noexcept;
+    Event readStartTag();
+    Event readEndTag();
+    bool readText();
+    String decode (TextRange, bool isText) const;
+    const Attribute* findAttribute (StringRef) const noexcept;
+    std::unique_ptr<XmlElement> createElement() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlPullParser)
+};
+
+} // namespace juce
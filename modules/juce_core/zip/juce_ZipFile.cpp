@@ -122,6 +122,16 @@ static int64 findCentralDirectoryFileHeader (InputStream& input, int& numEntries
     return 0;
 }
 
+// Entries may be extracted on several threads at once, and they'll often share parent
+// folders, so these are created one at a time to avoid the threads racing to create them.
+static Result createDirectoryForEntry (const File& directory)
+{
+    static CriticalSection directoryCreationLock;
+    const ScopedLock sl (directoryCreationLock);
+
+    return directory.createDirectory();
+}
+
 static bool hasSymbolicPart (const File& root, const File& f)
 {
     jassert (root == f || f.isAChildOf (root));
@@ -155,15 +165,14 @@ struct ZipFile::ZipInputStream  : public InputStream
            #endif
         }
 
-        char buffer[30];
-
-        if (inputStream != nullptr
-             && inputStream->setPosition (zei.streamOffset)
-             && inputStream->read (buffer, 30) == 30
-             && ByteOrder::littleEndianInt (buffer) == 0x04034b50)
+        if (inputStream == file.inputStream)
         {
-            headerSize = 30 + ByteOrder::littleEndianShort (buffer + 26)
-                            + ByteOrder::littleEndianShort (buffer + 28);
+            const ScopedLock sl (file.lock);
+            readLocalHeader();
+        }
+        else
+        {
+            readLocalHeader();
         }
     }
 
@@ -225,6 +234,20 @@ struct ZipFile::ZipInputStream  : public InputStream
     }
 
 private:
+    void readLocalHeader()
+    {
+        char buffer[30];
+
+        if (inputStream != nullptr
+             && inputStream->setPosition (zipEntryHolder.streamOffset)
+             && inputStream->read (buffer, 30) == 30
+             && ByteOrder::littleEndianInt (buffer) == 0x04034b50)
+        {
+            headerSize = 30 + ByteOrder::littleEndianShort (buffer + 26)
+                            + ByteOrder::littleEndianShort (buffer + 28);
+        }
+    }
+
     ZipFile& file;
     ZipEntryHolder zipEntryHolder;
     int64 pos = 0;
@@ -236,6 +259,98 @@ private:
 };
 
 
+//==============================================================================
+/*  Reading the central directory of a large archive means parsing a lot of data from
+    the end of the file, so the entries of the most recently opened files are kept here
+    and copied into any other ZipFile that is opened on the same, unmodified file.
+
+    As a file can be rewritten with the same size within the resolution of its
+    modification time, the last bytes of the file, which hold the end of central
+    directory record, are compared too.
+*/
+struct ZipFile::CentralDirectoryCache
+{
+    bool restore (const File& file, OwnedArray<ZipEntryHolder>& entries)
+    {
+        const Key key (file);
+        const ScopedLock sl (lock);
+
+        for (auto i = items.begin(); i != items.end(); ++i)
+        {
+            if (i->key == key)
+            {
+                for (auto& holder : i->entries)
+                    entries.add (new ZipEntryHolder (holder));
+
+                std::rotate (items.begin(), i, i + 1);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void store (const File& file, const OwnedArray<ZipEntryHolder>& entries)
+    {
+        Item item { Key (file), {} };
+        item.entries.reserve ((size_t) entries.size());
+
+        for (auto* holder : entries)
+            item.entries.push_back (*holder);
+
+        const ScopedLock sl (lock);
+        items.insert (items.begin(), std::move (item));
+
+        if (items.size() > maxNumFiles)
+            items.pop_back();
+    }
+
+    static CentralDirectoryCache& getInstance()
+    {
+        static CentralDirectoryCache cache;
+        return cache;
+    }
+
+private:
+    struct Key
+    {
+        explicit Key (const File& file)
+            : path (file.getFullPathName()),
+              size (file.getSize()),
+              modificationTime (file.getLastModificationTime())
+        {
+            FileInputStream in (file);
+
+            if (in.openedOk() && in.setPosition (jmax ((int64) 0, size - tailSize)))
+                in.readIntoMemoryBlock (tail, tailSize);
+        }
+
+        bool operator== (const Key& other) const
+        {
+            return path == other.path && size == other.size && modificationTime == other.modificationTime
+                    && tail == other.tail;
+        }
+
+        static constexpr int tailSize = 1024;
+
+        String path;
+        int64 size;
+        Time modificationTime;
+        MemoryBlock tail;
+    };
+
+    struct Item
+    {
+        Key key;
+        std::vector<ZipEntryHolder> entries;
+    };
+
+    static constexpr size_t maxNumFiles = 8;
+
+    CriticalSection lock;
+    std::vector<Item> items;
+};
+
 //==============================================================================
 ZipFile::ZipFile (InputStream* stream, bool deleteStreamWhenDestroyed)
    : inputStream (stream)
@@ -243,22 +358,22 @@ ZipFile::ZipFile (InputStream* stream, bool deleteStreamWhenDestroyed)
     if (deleteStreamWhenDestroyed)
         streamToDelete.reset (inputStream);
 
-    init();
+    init (nullptr);
 }
 
 ZipFile::ZipFile (InputStream& stream)  : inputStream (&stream)
 {
-    init();
+    init (nullptr);
 }
 
 ZipFile::ZipFile (const File& file)  : inputSource (new FileInputSource (file))
 {
-    init();
+    init (&file);
 }
 
 ZipFile::ZipFile (InputSource* source)  : inputSource (source)
 {
-    init();
+    init (nullptr);
 }
 
 ZipFile::~ZipFile()
@@ -349,8 +464,11 @@ void ZipFile::sortEntriesByFilename()
 }
 
 //==============================================================================
-void ZipFile::init()
+void ZipFile::init (const File* sourceFile)
 {
+    if (sourceFile != nullptr && CentralDirectoryCache::getInstance().restore (*sourceFile, entries))
+        return;
+
     std::unique_ptr<InputStream> toDelete;
     InputStream* in = inputStream;
 
@@ -393,6 +511,9 @@ void ZipFile::init()
                             + readUnalignedLittleEndianShort (buffer + 30u)
                             + readUnalignedLittleEndianShort (buffer + 32u);
                 }
+
+                if (sourceFile != nullptr)
+                    CentralDirectoryCache::getInstance().store (*sourceFile, entries);
             }
         }
     }
@@ -412,6 +533,80 @@ Result ZipFile::uncompressTo (const File& targetDirectory,
     return Result::ok();
 }
 
+Result ZipFile::uncompressTo (const File& targetDirectory,
+                              const bool shouldOverwriteFiles,
+                              ThreadPool& threadPool)
+{
+    const auto overwriteFiles = shouldOverwriteFiles ? OverwriteFiles::yes : OverwriteFiles::no;
+
+    // Symbolic links are left until last, so that a link can't redirect the path of a file
+    // which is being written by another thread, and any entry that duplicates an earlier
+    // name is done afterwards too, so that the last one still wins.
+    Array<int> parallelEntries, deferredEntries;
+    std::unordered_set<String> namesSeen;
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        auto& entry = entries.getUnchecked (i)->entry;
+
+        if (entry.isSymbolicLink || ! namesSeen.insert (entry.filename).second)
+            deferredEntries.add (i);
+        else
+            parallelEntries.add (i);
+    }
+
+    const auto numJobs = jmin (threadPool.getNumThreads(), parallelEntries.size());
+    std::atomic<int> nextEntry { 0 }, numJobsRunning { numJobs };
+    std::atomic<bool> anyFailed { false };
+    WaitableEvent allJobsFinished;
+    CriticalSection resultLock;
+    auto result = Result::ok();
+
+    for (int i = 0; i < numJobs; ++i)
+    {
+        threadPool.addJob ([&]
+        {
+            for (;;)
+            {
+                auto next = nextEntry++;
+
+                if (next >= parallelEntries.size() || anyFailed)
+                    break;
+
+                auto r = uncompressEntry (parallelEntries.getUnchecked (next), targetDirectory,
+                                          overwriteFiles, FollowSymlinks::no);
+
+                if (r.failed())
+                {
+                    const ScopedLock sl (resultLock);
+
+                    if (! anyFailed.exchange (true))
+                        result = r;
+                }
+            }
+
+            if (--numJobsRunning == 0)
+                allJobsFinished.signal();
+        });
+    }
+
+    if (numJobs > 0)
+        allJobsFinished.wait();
+
+    if (result.failed())
+        return result;
+
+    for (auto index : deferredEntries)
+    {
+        auto r = uncompressEntry (index, targetDirectory, overwriteFiles, FollowSymlinks::no);
+
+        if (r.failed())
+            return r;
+    }
+
+    return Result::ok();
+}
+
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool shouldOverwriteFiles)
 {
     return uncompressEntry (index,
@@ -439,7 +634,7 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, Overwri
         return Result::fail ("Entry " + entryPath + " is outside the target directory");
 
     if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
-        return targetFile.createDirectory(); // (entry is a directory, not a file)
+        return createDirectoryForEntry (targetFile); // (entry is a directory, not a file)
 
     std::unique_ptr<InputStream> in (createStreamForEntry (index));
 
@@ -458,7 +653,7 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, Overwri
     if (followSymlinks == FollowSymlinks::no && hasSymbolicPart (targetDirectory, targetFile.getParentDirectory()))
         return Result::fail ("Parent directory leads through symlink for target file: " + targetFile.getFullPathName());
 
-    if (! targetFile.getParentDirectory().createDirectory())
+    if (! createDirectoryForEntry (targetFile.getParentDirectory()))
         return Result::fail ("Failed to create target folder: " + targetFile.getParentDirectory().getFullPathName());
 
     if (zei->entry.isSymbolicLink)
@@ -498,7 +693,18 @@ struct ZipFile::Builder::Item
 
     bool writeData (OutputStream& target, const int64 overallStartPosition)
     {
-        MemoryOutputStream compressedData ((size_t) file.getSize());
+        if (! compressData())
+            return false;
+
+        writeCompressedData (target, overallStartPosition);
+        return true;
+    }
+
+    // This doesn't touch the target stream, so the data for several items can be
+    // compressed on different threads before being written out in order.
+    bool compressData()
+    {
+        compressedData = std::make_unique<MemoryOutputStream> ((size_t) file.getSize());
 
         if (symbolicLink)
         {
@@ -507,30 +713,36 @@ struct ZipFile::Builder::Item
             uncompressedSize = relativePath.length();
 
             checksum = zlibNamespace::crc32 (0, (uint8_t*) relativePath.toRawUTF8(), (unsigned int) uncompressedSize);
-            compressedData << relativePath;
+            *compressedData << relativePath;
         }
         else if (compressionLevel > 0)
         {
-            GZIPCompressorOutputStream compressor (compressedData, compressionLevel,
+            GZIPCompressorOutputStream compressor (*compressedData, compressionLevel,
                                                    GZIPCompressorOutputStream::windowBitsRaw);
             if (! writeSource (compressor))
                 return false;
         }
         else
         {
-            if (! writeSource (compressedData))
+            if (! writeSource (*compressedData))
                 return false;
         }
 
-        compressedSize = (int64) compressedData.getDataSize();
+        compressedSize = (int64) compressedData->getDataSize();
+        return true;
+    }
+
+    void writeCompressedData (OutputStream& target, const int64 overallStartPosition)
+    {
+        jassert (compressedData != nullptr);
         headerStart = target.getPosition() - overallStartPosition;
 
         target.writeInt (0x04034b50);
         writeFlagsAndSizes (target);
         target << storedPathname
-               << compressedData;
+               << *compressedData;
 
-        return true;
+        compressedData.reset();
     }
 
     bool writeDirectoryEntry (OutputStream& target)
@@ -551,6 +763,7 @@ struct ZipFile::Builder::Item
 private:
     const File file;
     std::unique_ptr<InputStream> stream;
+    std::unique_ptr<MemoryOutputStream> compressedData;
     String storedPathname;
     Time fileTime;
     int64 compressedSize = 0, uncompressedSize = 0, headerStart = 0;
@@ -642,6 +855,72 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
             return false;
     }
 
+    if (! writeCentralDirectory (target, fileStart))
+        return false;
+
+    if (progress != nullptr)
+        *progress = 1.0;
+
+    return true;
+}
+
+bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress, ThreadPool& threadPool) const
+{
+    struct CompressionState
+    {
+        WaitableEvent finished;
+        std::atomic<bool> succeeded { false };
+    };
+
+    auto fileStart = target.getPosition();
+    auto numItems = items.size();
+    auto maxItemsInProgress = jmax (1, threadPool.getNumThreads() * 2);
+    std::vector<CompressionState> states ((size_t) numItems);
+    int numStarted = 0;
+    bool succeeded = true;
+
+    for (int i = 0; i < numItems; ++i)
+    {
+        // keep a limited number of items compressing ahead of the one being written
+        for (; succeeded && numStarted < jmin (numItems, i + maxItemsInProgress); ++numStarted)
+        {
+            auto* item = items.getUnchecked (numStarted);
+            auto& state = states[(size_t) numStarted];
+
+            threadPool.addJob ([item, &state]
+            {
+                state.succeeded = item->compressData();
+                state.finished.signal();
+            });
+        }
+
+        // after a failure, this just waits for the jobs that were already started
+        if (i >= numStarted)
+            break;
+
+        states[(size_t) i].finished.wait();
+        succeeded = succeeded && states[(size_t) i].succeeded;
+
+        if (succeeded)
+        {
+            if (progress != nullptr)
+                *progress = (i + 0.5) / numItems;
+
+            items.getUnchecked (i)->writeCompressedData (target, fileStart);
+        }
+    }
+
+    if (! (succeeded && writeCentralDirectory (target, fileStart)))
+        return false;
+
+    if (progress != nullptr)
+        *progress = 1.0;
+
+    return true;
+}
+
+bool ZipFile::Builder::writeCentralDirectory (OutputStream& target, int64 fileStart) const
+{
     auto directoryStart = target.getPosition();
 
     for (auto* item : items)
@@ -659,9 +938,6 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
     target.writeInt ((int) (directoryStart - fileStart));
     target.writeShort (0);
 
-    if (progress != nullptr)
-        *progress = 1.0;
-
     return true;
 }
 
@@ -697,6 +973,44 @@ struct ZIPTests   : public UnitTest
         return data;
     }
 
+    // Like createZipMemoryBlock(), but with entries that are big enough for the
+    // compression to take some time, and optionally compressed on a thread pool
+    static MemoryBlock createLargeZipMemoryBlock (const StringArray& entryNames,
+                                                  ThreadPool* threadPool = nullptr,
+                                                  Time time = Time::getCurrentTime())
+    {
+        ZipFile::Builder builder;
+
+        for (auto& entryName : entryNames)
+        {
+            MemoryBlock block;
+            MemoryOutputStream mo (block, false);
+            mo << getExpectedContent (entryName);
+            mo.flush();
+            builder.addEntry (new MemoryInputStream (block, true), 9, entryName, time);
+        }
+
+        MemoryBlock data;
+        MemoryOutputStream mo (data, false);
+
+        if (threadPool != nullptr)
+            builder.writeToStream (mo, nullptr, *threadPool);
+        else
+            builder.writeToStream (mo, nullptr);
+
+        return data;
+    }
+
+    static String getExpectedContent (const String& entryName)
+    {
+        String content;
+
+        for (int i = 0; i < 100; ++i)
+            content << entryName << i;
+
+        return content;
+    }
+
     void runZipSlipTest()
     {
         const std::map<String, bool> testCases = { { "a",                    true  },
@@ -761,6 +1075,83 @@ struct ZIPTests   : public UnitTest
 
         beginTest ("ZipSlip");
         runZipSlipTest();
+
+        ThreadPool threadPool (3);
+        StringArray manyEntryNames;
+
+        for (int i = 0; i < 30; ++i)
+            manyEntryNames.add ("folder" + String (i % 4) + "/sub" + String (i % 3) + "/entry" + String (i));
+
+        beginTest ("Parallel compression");
+        {
+            const Time time (2020, 1, 2, 3, 4, 6);
+            auto serialData   = createLargeZipMemoryBlock (manyEntryNames, nullptr, time);
+            auto parallelData = createLargeZipMemoryBlock (manyEntryNames, &threadPool, time);
+
+            expect (serialData == parallelData);
+        }
+
+        beginTest ("Parallel extraction");
+        {
+            TemporaryFile tmpDir;
+            auto archiveData = createLargeZipMemoryBlock (manyEntryNames, &threadPool);
+            MemoryInputStream input (archiveData, false);
+            ZipFile parallelZip (input);
+
+            expect (parallelZip.uncompressTo (tmpDir.getFile(), true, threadPool).wasOk());
+
+            for (auto& entryName : manyEntryNames)
+                expectEquals (tmpDir.getFile().getChildFile (entryName).loadFileAsString(), getExpectedContent (entryName));
+
+            expect (tmpDir.getFile().deleteRecursively());
+        }
+
+        beginTest ("Central directory cache");
+        {
+            TemporaryFile tmpFile (".zip");
+            auto archive = tmpFile.getFile();
+
+            expect (archive.replaceWithData (data.getData(), data.getSize()));
+            ZipFile first (archive), second (archive);
+
+            expectEquals (first.getNumEntries(), entryNames.size());
+            expectEquals (second.getNumEntries(), entryNames.size());
+
+            for (int i = 0; i < first.getNumEntries(); ++i)
+            {
+                expectEquals (second.getEntry (i)->filename, first.getEntry (i)->filename);
+
+                std::unique_ptr<InputStream> input (second.createStreamForEntry (i));
+                expectEquals (input->readEntireStreamAsString(), first.getEntry (i)->filename);
+            }
+
+            // a modified file must be read again
+            auto newData = createLargeZipMemoryBlock (manyEntryNames);
+            expect (archive.replaceWithData (newData.getData(), newData.getSize()));
+
+            ZipFile third (archive);
+            expectEquals (third.getNumEntries(), manyEntryNames.size());
+
+            // a file rewritten with the same size and modification time must be read again
+            StringArray renamedEntryNames { "frist", "sceond", "thrid" };
+            auto renamedData = createZipMemoryBlock (renamedEntryNames);
+            expectEquals (renamedData.getSize(), data.getSize());
+
+            const Time modificationTime (2020, 1, 2, 3, 4, 6);
+
+            for (auto* archiveData : { &data, &renamedData })
+            {
+                expect (archive.replaceWithData (archiveData->getData(), archiveData->getSize()));
+                expect (archive.setLastModificationTime (modificationTime));
+
+                ZipFile reopened (archive);
+                const auto& expectedNames = archiveData == &data ? entryNames : renamedEntryNames;
+                expectEquals (reopened.getNumEntries(), expectedNames.size());
+
+                for (auto& entryName : expectedNames)
+                    expect (reopened.getEntry (entryName) != nullptr);
+            }
+        }
     }
 };
 
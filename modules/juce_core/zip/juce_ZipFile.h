@@ -164,6 +164,29 @@ public:
     Result uncompressTo (const File& targetDirectory,
                          bool shouldOverwriteFiles = true);
 
+    /** Uncompresses all of the files in the zip file, using a thread pool to decompress
+        several entries at the same time.
+
+        This produces the same files as the single-threaded version of uncompressTo(). To make
+        sure of this, any symbolic links, and any entries which have the same name as an earlier
+        entry, are extracted in order on the calling thread once all the other entries are done.
+
+        If the ZipFile was created from a File or InputSource, each entry will be read using its
+        own stream. If it was created with an InputStream, the entries will all share that stream,
+        but the decompression itself can still run in parallel.
+
+        This blocks until all the entries have been extracted, so it mustn't be called from one of
+        the pool's own threads.
+
+        @param targetDirectory      the root folder to uncompress to
+        @param shouldOverwriteFiles whether to overwrite existing files with similarly-named ones
+        @param threadPool           the pool whose threads should be used to decompress the entries
+        @returns success if the file is successfully unzipped
+    */
+    Result uncompressTo (const File& targetDirectory,
+                         bool shouldOverwriteFiles,
+                         ThreadPool& threadPool);
+
     /** Uncompresses one of the entries from the zip file.
 
         This will expand the entry and write it in a target directory. The entry's path is used to
@@ -246,11 +269,26 @@ public:
         */
         bool writeToStream (OutputStream& target, double* progress) const;
 
+        /** Generates the zip file, using a thread pool to compress several entries at once.
+
+            The entries are still written to the target stream in order, as soon as each one has
+            been compressed. Only a few entries beyond the one currently being written are
+            compressed in advance, so the amount of memory used stays bounded however large the
+            archive is.
+
+            This blocks until the whole archive has been written, so it mustn't be called from one
+            of the pool's own threads. If the progress parameter is non-null, it will be updated
+            with an approximate progress status between 0 and 1.0
+        */
+        bool writeToStream (OutputStream& target, double* progress, ThreadPool& threadPool) const;
+
         //==============================================================================
     private:
         struct Item;
         OwnedArray<Item> items;
 
+        bool writeCentralDirectory (OutputStream& target, int64 fileStart) const;
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Builder)
     };
 
@@ -258,6 +296,7 @@ private:
     //==============================================================================
     struct ZipInputStream;
     struct ZipEntryHolder;
+    struct CentralDirectoryCache;
 
     OwnedArray<ZipEntryHolder> entries;
     CriticalSection lock;
@@ -271,13 +310,13 @@ private:
         OpenStreamCounter() = default;
         ~OpenStreamCounter();
 
-        int numOpenStreams = 0;
+        std::atomic<int> numOpenStreams { 0 };
     };
 
     OpenStreamCounter streamCounter;
    #endif
 
-    void init();
+    void init (const File* sourceFile);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipFile)
 };
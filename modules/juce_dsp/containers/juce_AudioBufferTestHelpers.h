@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/*  Helpers for comparing and filling AudioBuffers, shared by the DSP unit tests. */
+namespace AudioBufferTestHelpers
+{
+    /*  Returns a buffer filled with uniform white noise between -level and level. */
+    template <typename Type>
+    static AudioBuffer<Type> makeNoise (Random& random, int numChannels, int numSamples, Type level = (Type) 1)
+    {
+        AudioBuffer<Type> buffer (numChannels, numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, level * (Type) (2.0f * random.nextFloat() - 1.0f));
+
+        return buffer;
+    }
+
+    /*  Returns the largest difference between the first numSamples samples of two arrays. */
+    template <typename Type>
+    static Type getMaxDifference (const Type* expected, const Type* actual, int numSamples)
+    {
+        auto maxError = (Type) 0;
+
+        for (int i = 0; i < numSamples; ++i)
+            maxError = jmax (maxError, std::abs (expected[i] - actual[i]));
+
+        return maxError;
+    }
+
+    /*  Returns the largest difference between each sample of actual and the sample of
+        expected that's latency samples earlier.
+
+        Samples of actual before the latency are compared with silence, and samples
+        before start aren't compared at all.
+    */
+    template <typename Type>
+    static Type getMaxDifference (const AudioBuffer<Type>& expected, const AudioBuffer<Type>& actual,
+                                  int latency = 0, int start = 0)
+    {
+        jassert (expected.getNumChannels() == actual.getNumChannels());
+
+        auto maxError = (Type) 0;
+
+        for (int ch = 0; ch < actual.getNumChannels(); ++ch)
+        {
+            for (int i = start; i < jmin (latency, actual.getNumSamples()); ++i)
+                maxError = jmax (maxError, std::abs (actual.getSample (ch, i)));
+
+            const auto first = jmax (start, latency);
+
+            if (first < actual.getNumSamples())
+                maxError = jmax (maxError, getMaxDifference (expected.getReadPointer (ch, first - latency),
+                                                             actual.getReadPointer (ch, first),
+                                                             actual.getNumSamples() - first));
+        }
+
+        return maxError;
+    }
+} // namespace AudioBufferTestHelpers
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+namespace dsp
+{
+
+#ifndef DOXYGEN
+
+namespace detail
+{
+    /*  The type used by processors that run several channels or values side by side,
+        with one of them in each lane of a SIMDRegister. Without SIMD support each
+        register holds a single value, so the same code runs one value at a time.
+    */
+    template <typename SampleType>
+    struct SIMDLanes
+    {
+       #if JUCE_USE_SIMD
+        using Type = SIMDRegister<SampleType>;
+       #else
+        using Type = SampleType;
+       #endif
+
+        static constexpr size_t numLanes = sizeof (Type) / sizeof (SampleType);
+
+        /*  Returns the individual lanes of an array of registers, with all the lanes
+            of the first register followed by all the lanes of the next one.
+        */
+        static SampleType* getLanes (Type* registers) noexcept               { return reinterpret_cast<SampleType*> (registers); }
+        static const SampleType* getLanes (const Type* registers) noexcept   { return reinterpret_cast<const SampleType*> (registers); }
+
+        /*  Returns a single lane of a container of registers, using the same ordering as getLanes(). */
+        template <typename Container>
+        static SampleType& getLane (Container& registers, size_t index) noexcept
+        {
+            return getLanes (std::data (registers))[index];
+        }
+
+        /*  Returns the sum of all the lanes of a register. */
+        static SampleType sum (Type registers) noexcept
+        {
+           #if JUCE_USE_SIMD
+            return registers.sum();
+           #else
+            return registers;
+           #endif
+        }
+
+        /*  Returns the samples of a modulation block to use for a channel, along with the
+            step between them. An empty block gives the fallback value with a step of zero,
+            and channels beyond the end of the block use its last channel.
+        */
+        static std::pair<const SampleType*, size_t> getModulation (const AudioBlock<const SampleType>& block,
+                                                                   size_t channel, const SampleType& fallback) noexcept
+        {
+            if (block.getNumChannels() == 0)
+                return { &fallback, 0 };
+
+            return { block.getChannelPointer (jmin (channel, block.getNumChannels() - 1)), 1 };
+        }
+    };
+} // namespace detail
+
+#endif
+
+} // namespace dsp
+} // namespace juce
@@ -45,7 +45,7 @@ typename FIR::Coefficients<FloatType>::Ptr
 
     for (size_t i = 0; i <= order; ++i)
     {
-        if (i == order / 2)
+        if (i == order / 2 && order % 2 == 0)
         {
             c[i] = static_cast<FloatType> (normalisedFrequency * 2);
         }
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+STFTProcessor::STFTProcessor()
+{
+    setParameters (parameters);
+}
+
+STFTProcessor::~STFTProcessor() = default;
+
+//==============================================================================
+void STFTProcessor::setParameters (const Parameters& newParameters)
+{
+    jassert (newParameters.windowSize > 0);
+    jassert (newParameters.hopSize > 0 && newParameters.hopSize <= newParameters.windowSize);
+    jassert (isPowerOfTwo (newParameters.fftSize) && newParameters.fftSize >= newParameters.windowSize);
+
+    parameters = newParameters;
+    parameters.hopSize = jlimit (1, parameters.windowSize, parameters.hopSize);
+    parameters.fftSize = jmax (nextPowerOfTwo (parameters.fftSize), nextPowerOfTwo (parameters.windowSize), 2);
+
+    fft = std::make_unique<FFT> (roundToInt (std::log2 (parameters.fftSize)));
+
+    const auto windowSize = (size_t) parameters.windowSize;
+    const auto hopSize    = (size_t) parameters.hopSize;
+
+    analysisWindow.resize (windowSize);
+    WindowingFunction<float>::fillWindowingTables (analysisWindow.data(), windowSize, parameters.window, false);
+
+    // Each output sample is the sum of the overlapping frames, which have been
+    // multiplied by both windows. Dividing the synthesis window by the sum of the
+    // squared analysis windows at each position makes these products add up to one.
+    std::vector<double> sums (hopSize, 0.0);
+
+    for (size_t i = 0; i < windowSize; ++i)
+        sums[i % hopSize] += (double) analysisWindow[i] * (double) analysisWindow[i];
+
+    synthesisWindow.resize (windowSize);
+
+    for (size_t i = 0; i < windowSize; ++i)
+    {
+        const auto sum = sums[i % hopSize];
+        synthesisWindow[i] = sum > 1.0e-9 ? (float) ((double) analysisWindow[i] / sum) : 0.0f;
+    }
+
+    allocate();
+}
+
+void STFTProcessor::setSpectrumCallback (SpectrumCallback newCallback)
+{
+    callback = std::move (newCallback);
+}
+
+//==============================================================================
+void STFTProcessor::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.numChannels > 0);
+
+    numPreparedChannels = spec.numChannels;
+    allocate();
+}
+
+void STFTProcessor::allocate()
+{
+    const auto numChannels = (int) numPreparedChannels;
+
+    inputRing .setSize (numChannels, parameters.windowSize);
+    outputRing.setSize (numChannels, parameters.windowSize);
+    frames    .setSize (numChannels, parameters.fftSize * 2);
+
+    spectra.resize (numPreparedChannels);
+
+    for (size_t channel = 0; channel < numPreparedChannels; ++channel)
+        spectra[channel] = reinterpret_cast<Complex<float>*> (frames.getWritePointer ((int) channel));
+
+    reset();
+}
+
+void STFTProcessor::reset()
+{
+    inputRing.clear();
+    outputRing.clear();
+
+    ringPosition = 0;
+    samplesUntilNextFrame = (size_t) parameters.hopSize;
+}
+
+//==============================================================================
+void STFTProcessor::processSamples (const AudioBlock<const float>& inputBlock, const AudioBlock<float>& outputBlock) noexcept
+{
+    const auto numChannels = inputBlock.getNumChannels();
+    const auto numSamples  = inputBlock.getNumSamples();
+    const auto windowSize  = (size_t) parameters.windowSize;
+
+    for (size_t start = 0; start < numSamples;)
+    {
+        // Each step stops at the next frame or at the end of the rings, whichever comes first
+        const auto num = jmin (numSamples - start, samplesUntilNextFrame, windowSize - ringPosition);
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+            FloatVectorOperations::copy (inputRing.getWritePointer ((int) channel, (int) ringPosition),
+                                         inputBlock.getChannelPointer (channel) + start, num);
+
+        samplesUntilNextFrame -= num;
+
+        // The output of each sample is read from the next position of the rings, and the
+        // last sample before a frame must wait for that frame to be added
+        const auto isFrameReady = samplesUntilNextFrame == 0;
+        const auto numBeforeFrame = isFrameReady ? num - 1 : num;
+
+        readOutput (outputBlock, start, ringPosition + 1, numBeforeFrame);
+        ringPosition = (ringPosition + num) % windowSize;
+
+        if (isFrameReady)
+        {
+            processFrame();
+            readOutput (outputBlock, start + num - 1, ringPosition, 1);
+            samplesUntilNextFrame = (size_t) parameters.hopSize;
+        }
+
+        start += num;
+    }
+}
+
+void STFTProcessor::readOutput (const AudioBlock<float>& outputBlock, size_t outputStart, size_t ringStart, size_t numSamples) noexcept
+{
+    const auto windowSize = (size_t) parameters.windowSize;
+
+    if (numSamples == 0)
+        return;
+
+    ringStart %= windowSize;
+    const auto numFirst = jmin (numSamples, windowSize - ringStart);
+
+    for (size_t channel = 0; channel < outputBlock.getNumChannels(); ++channel)
+    {
+        auto* output = outputBlock.getChannelPointer (channel) + outputStart;
+        auto* ring = outputRing.getWritePointer ((int) channel);
+
+        FloatVectorOperations::copy (output, ring + ringStart, numFirst);
+        FloatVectorOperations::clear (ring + ringStart, numFirst);
+
+        FloatVectorOperations::copy (output + numFirst, ring, numSamples - numFirst);
+        FloatVectorOperations::clear (ring, numSamples - numFirst);
+    }
+}
+
+void STFTProcessor::processFrame() noexcept
+{
+    const auto windowSize = (size_t) parameters.windowSize;
+    const auto fftSize    = (size_t) parameters.fftSize;
+
+    // The oldest sample of the frame is at the current position of the rings
+    const auto numFirst = windowSize - ringPosition;
+
+    for (size_t channel = 0; channel < numPreparedChannels; ++channel)
+    {
+        auto* frame = frames.getWritePointer ((int) channel);
+        const auto* ring = inputRing.getReadPointer ((int) channel);
+
+        FloatVectorOperations::multiply (frame, ring + ringPosition, analysisWindow.data(), numFirst);
+        FloatVectorOperations::multiply (frame + numFirst, ring, analysisWindow.data() + numFirst, ringPosition);
+        FloatVectorOperations::clear (frame + windowSize, fftSize - windowSize);
+
+        fft->performRealOnlyForwardTransform (frame, true);
+    }
+
+    if (callback != nullptr)
+        callback (spectra.data(), numPreparedChannels, getNumBins());
+
+    for (size_t channel = 0; channel < numPreparedChannels; ++channel)
+    {
+        auto* frame = frames.getWritePointer ((int) channel);
+        auto* ring = outputRing.getWritePointer ((int) channel);
+
+        fft->performRealOnlyInverseTransform (frame);
+
+        FloatVectorOperations::addWithMultiply (ring + ringPosition, frame, synthesisWindow.data(), numFirst);
+        FloatVectorOperations::addWithMultiply (ring, frame + numFirst, synthesisWindow.data() + numFirst, ringPosition);
+    }
+}
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    Performs a short-time Fourier transform of a multi-channel signal, lets a
+    callback change the spectra, and resynthesises the result with overlap-add.
+
+    The input is cut into overlapping frames of getParameters().windowSize samples,
+    one every hopSize samples. Each frame is multiplied by an analysis window,
+    padded with zeros up to fftSize samples and transformed. The spectra of all the
+    channels are then passed to the callback at once, which can change them in
+    place, before they are transformed back, multiplied by a synthesis window and
+    added to the output.
+
+    The synthesis window is worked out so that, when the callback doesn't change
+    anything, the output is exactly the input delayed by getLatencyInSamples(),
+    whatever the window and the hop size are.
+
+    @see FFT, WindowingFunction, Convolution
+
+    @tags{DSP}
+*/
+class JUCE_API  STFTProcessor
+{
+public:
+    //==============================================================================
+    /** Holds the settings of the transforms. */
+    struct Parameters
+    {
+        /** The number of input samples in each frame. */
+        int windowSize = 2048;
+
+        /** The number of samples between the starts of two frames, which must be
+            between 1 and windowSize.
+        */
+        int hopSize = 512;
+
+        /** The size of the transforms, which must be a power of two at least as
+            big as windowSize. Any extra samples are zeros padded after the frame.
+        */
+        int fftSize = 2048;
+
+        /** The window used for both the analysis and the synthesis. */
+        WindowingFunction<float>::WindowingMethod window = WindowingFunction<float>::hann;
+    };
+
+    /** The type of the callback which changes the spectra.
+
+        It receives one array of getNumBins() complex values per channel, holding
+        the bins from DC up to the Nyquist frequency. Any changes made to them are
+        heard in the output. As the transforms are done on real signals, the
+        imaginary parts of the first and last bins are ignored.
+    */
+    using SpectrumCallback = std::function<void (Complex<float>* const* spectra, size_t numChannels, size_t numBins)>;
+
+    //==============================================================================
+    /** Constructor. */
+    STFTProcessor();
+
+    /** Destructor. */
+    ~STFTProcessor();
+
+    //==============================================================================
+    /** Changes the settings of the transforms.
+
+        Memory is allocated and the processor is reset, so this shouldn't be done on
+        the audio thread.
+    */
+    void setParameters (const Parameters& newParameters);
+
+    /** Returns the current settings of the transforms. */
+    const Parameters& getParameters() const noexcept             { return parameters; }
+
+    /** Sets the callback which changes the spectra. It's called on the audio thread,
+        from inside process(), so it mustn't block or allocate memory.
+
+        This shouldn't be changed while processing.
+    */
+    void setSpectrumCallback (SpectrumCallback newCallback);
+
+    /** Returns the number of bins in the spectrum of each channel. */
+    size_t getNumBins() const noexcept                           { return (size_t) parameters.fftSize / 2 + 1; }
+
+    /** Returns the delay of the output in samples, which is windowSize - 1. */
+    int getLatencyInSamples() const noexcept                     { return parameters.windowSize - 1; }
+
+    //==============================================================================
+    /** Initialises the processor. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Clears the frames which are being built. */
+    void reset();
+
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() == numPreparedChannels);
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+
+        if (context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        processSamples (inputBlock, outputBlock);
+    }
+
+private:
+    //==============================================================================
+    void processSamples (const AudioBlock<const float>& inputBlock, const AudioBlock<float>& outputBlock) noexcept;
+    void processFrame() noexcept;
+    void readOutput (const AudioBlock<float>& outputBlock, size_t outputStart, size_t ringStart, size_t numSamples) noexcept;
+    void allocate();
+
+    //==============================================================================
+    Parameters parameters;
+    SpectrumCallback callback;
+
+    std::unique_ptr<FFT> fft;
+    std::vector<float> analysisWindow, synthesisWindow;
+
+    // The input and output rings hold windowSize samples per channel and share the
+    // same write position. Each frame is added to the output at the positions of the
+    // samples it was made from, and an output sample is read and cleared just before
+    // its position is written again.
+    AudioBuffer<float> inputRing, outputRing, frames;
+    std::vector<Complex<float>*> spectra;
+    size_t ringPosition = 0, samplesUntilNextFrame = 0, numPreparedChannels = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (STFTProcessor)
+};
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class STFTProcessorTest : public UnitTest
+{
+public:
+    STFTProcessorTest()
+        : UnitTest ("STFTProcessor", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        using namespace AudioBufferTestHelpers;
+
+        constexpr int numChannels = 3, numSamples = 10000;
+        Random random (0x5eed);
+
+        const auto input = makeNoise<float> (random, numChannels, numSamples);
+
+        beginTest ("The output is the delayed input when the spectra aren't changed");
+        {
+            const std::pair<STFTProcessor::Parameters, const char*> settings[] =
+            {
+                { { 2048, 512, 2048, WindowingFunction<float>::hann },        "Hann, 75% overlap" },
+                { { 1000, 300, 4096, WindowingFunction<float>::hamming },     "Hamming, uneven hop and zero padding" },
+                { { 256,  256, 256,  WindowingFunction<float>::rectangular }, "Rectangular, no overlap" },
+                { { 777,  100, 1024, WindowingFunction<float>::blackman },    "Blackman" }
+            };
+
+            for (const auto& setting : settings)
+            {
+                logMessage (setting.second);
+
+                STFTProcessor stft;
+                stft.setParameters (setting.first);
+                stft.prepare ({ 44100.0, (uint32) numSamples, (uint32) numChannels });
+                expectEquals (stft.getLatencyInSamples(), setting.first.windowSize - 1);
+
+                const auto output = process (stft, input);
+                expectLessThan (getMaxDifference (input, output, stft.getLatencyInSamples()), 1.0e-4f);
+
+                // ...and after a reset, it starts again from silence
+                stft.reset();
+                const auto outputAfterReset = process (stft, input);
+                expectLessThan (getMaxDifference (output, outputAfterReset, 0), 1.0e-6f);
+            }
+        }
+
+        beginTest ("The callback changes the spectra of all the channels");
+        {
+            STFTProcessor stft;
+            stft.prepare ({ 44100.0, (uint32) numSamples, (uint32) numChannels });
+
+            auto numCalls = 0;
+
+            stft.setSpectrumCallback ([&] (Complex<float>* const* spectra, size_t numSpectra, size_t numBins)
+            {
+                expectEquals ((int) numSpectra, numChannels);
+                expectEquals ((int) numBins, 1025);
+                ++numCalls;
+
+                for (size_t ch = 0; ch < numSpectra; ++ch)
+                    for (size_t bin = 0; bin < numBins; ++bin)
+                        spectra[ch][bin] *= (float) ch * 0.5f;
+            });
+
+            const auto output = process (stft, input);
+            expectEquals (numCalls, numSamples / stft.getParameters().hopSize);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                AudioBuffer<float> expected (1, numSamples), actual (1, numSamples);
+                expected.copyFrom (0, 0, input, ch, 0, numSamples);
+                expected.applyGain ((float) ch * 0.5f);
+                actual.copyFrom (0, 0, output, ch, 0, numSamples);
+
+                expectLessThan (getMaxDifference (expected, actual, stft.getLatencyInSamples()), 1.0e-4f);
+            }
+        }
+
+        beginTest ("Spectral filtering");
+        {
+            // A brick-wall lowpass filter at 5 kHz removes the higher of two sines
+            constexpr auto sampleRate = 48000.0;
+
+            STFTProcessor stft;
+            stft.prepare ({ sampleRate, (uint32) numSamples, 1 });
+
+            stft.setSpectrumCallback ([&] (Complex<float>* const* spectra, size_t, size_t numBins)
+            {
+                const auto firstRemovedBin = (size_t) (5000.0 * (double) stft.getParameters().fftSize / sampleRate);
+
+                for (auto bin = firstRemovedBin; bin < numBins; ++bin)
+                    spectra[0][bin] = {};
+            });
+
+            AudioBuffer<float> sines (1, numSamples), expected (1, numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto low = (float) std::sin (MathConstants<double>::twoPi * 440.0 * i / sampleRate);
+                const auto high = (float) std::sin (MathConstants<double>::twoPi * 12000.0 * i / sampleRate);
+                sines.setSample (0, i, low + high);
+                expected.setSample (0, i, low);
+            }
+
+            // The frames which contain the start of the sines aren't filtered perfectly
+            const auto output = process (stft, sines);
+            const auto latency = stft.getLatencyInSamples();
+
+            expectLessThan (getMaxDifference (expected, output, latency, latency + stft.getParameters().windowSize), 1.0e-4f);
+        }
+    }
+
+private:
+    static AudioBuffer<float> process (STFTProcessor& stft, const AudioBuffer<float>& input)
+    {
+        AudioBuffer<float> buffer (input);
+
+        // Uneven blocks, processed in place
+        for (int start = 0; start < buffer.getNumSamples();)
+        {
+            const auto num = jmin (buffer.getNumSamples() - start, 1 + (start * 7) % 613);
+            auto block = AudioBlock<float> (buffer).getSubBlock ((size_t) start, (size_t) num);
+            stft.process (ProcessContextReplacing<float> (block));
+            start += num;
+        }
+
+        return buffer;
+    }
+};
+
+static STFTProcessorTest stftProcessorTest;
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,415 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+SpectrumAnalyser::SpectrumAnalyser (TimeSliceThread& threadToUse)
+    : thread (threadToUse), chunk (1024)
+{
+    setParameters (parameters);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    thread.removeTimeSliceClient (this);
+}
+
+//==============================================================================
+void SpectrumAnalyser::setParameters (const Parameters& newParameters)
+{
+    jassert (newParameters.fftOrder > 0 && newParameters.numBands > 0 && newParameters.maxNumLevels > 0);
+    jassert (newParameters.minFrequency > 0.0f && newParameters.minFrequency <= newParameters.maxFrequency);
+    jassert (newParameters.framesPerSecond > 0.0f);
+
+    thread.removeTimeSliceClient (this);
+
+    parameters = newParameters;
+    parameters.numBands = jmax (1, parameters.numBands);
+    parameters.maxNumLevels = jmax (1, parameters.maxNumLevels);
+
+    const auto fftSize = (size_t) 1 << parameters.fftOrder;
+    fft = std::make_unique<FFT> (parameters.fftOrder);
+    fftBuffer.resize (fftSize * 2);
+
+    window.resize (fftSize);
+    WindowingFunction<float>::fillWindowingTables (window.data(), fftSize, WindowingFunction<float>::hann, false);
+
+    // This makes a sine wave with an amplitude of one peak at 0 dB
+    amplitudeScale = 2.0f / std::accumulate (window.begin(), window.end(), 0.0f);
+
+    levels.clear();
+    levels.resize ((size_t) parameters.maxNumLevels);
+
+    for (auto& level : levels)
+    {
+        level.history.resize (fftSize);
+        level.magnitudes.resize (fftSize / 2 + 1);
+    }
+
+    const auto numBands = (size_t) parameters.numBands;
+    bands.resize (numBands);
+    smoothedLevels.resize (numBands);
+
+    for (auto& buffer : buffers)
+        buffer.assign (numBands, parameters.minimumDecibels);
+
+    latestBuffer = -1;
+    numFrames = 0;
+
+    updateBands();
+    clear();
+
+    thread.addTimeSliceClient (this);
+}
+
+float SpectrumAnalyser::getBandFrequency (int band) const noexcept
+{
+    if (parameters.numBands < 2)
+        return parameters.minFrequency;
+
+    return parameters.minFrequency * std::pow (parameters.maxFrequency / parameters.minFrequency,
+                                               (float) band / (float) (parameters.numBands - 1));
+}
+
+//==============================================================================
+void SpectrumAnalyser::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+
+    thread.removeTimeSliceClient (this);
+
+    sampleRate = spec.sampleRate;
+
+    // Enough room for a few frames, even if the thread is late
+    const auto fifoSize = jmax (4 * (int) spec.maximumBlockSize, roundToInt (sampleRate / 4.0));
+    fifoBuffer.resize ((size_t) fifoSize);
+    fifo.setTotalSize (fifoSize);
+
+    updateBands();
+    clear();
+
+    thread.addTimeSliceClient (this);
+}
+
+void SpectrumAnalyser::reset() noexcept
+{
+    resetPosition = numSamplesPushed.load();
+}
+
+void SpectrumAnalyser::clear()
+{
+    fifo.reset();
+    numSamplesPushed = 0;
+    numSamplesRead = 0;
+    resetPosition = -1;
+
+    clearLevels();
+}
+
+void SpectrumAnalyser::clearLevels()
+{
+    for (auto& level : levels)
+    {
+        std::fill (level.history.begin(), level.history.end(), 0.0f);
+        level.historyPosition = 0;
+        level.skipNextSample = false;
+        level.decimationFilter.reset();
+    }
+
+    std::fill (smoothedLevels.begin(), smoothedLevels.end(), parameters.minimumDecibels);
+}
+
+void SpectrumAnalyser::updateBands()
+{
+    const auto fftSize = (double) ((size_t) 1 << parameters.fftOrder);
+    const auto numBands = parameters.numBands;
+    const auto maxBin = (int) fftSize / 2;
+
+    // Each band reaches halfway to its neighbours, on a logarithmic scale
+    const auto halfBandRatio = numBands > 1 ? std::pow ((double) parameters.maxFrequency / (double) parameters.minFrequency,
+                                                        0.5 / (double) (numBands - 1))
+                                            : 1.0;
+    numUsedLevels = 1;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        const auto centre = (double) getBandFrequency (i);
+        const auto low = centre / halfBandRatio, high = centre * halfBandRatio;
+        size_t level = 0;
+
+        // Each level has twice the resolution of the previous one, but the decimation
+        // filters only leave the bottom quarter of its sample rate free of aliasing
+        while (level + 1 < levels.size()
+                && high <= sampleRate / (double) (1 << (level + 1)) / 4.0
+                && sampleRate / (double) (1 << level) / fftSize > high - low)
+            ++level;
+
+        const auto binWidth = sampleRate / (double) (1 << level) / fftSize;
+
+        auto& band = bands[(size_t) i];
+        band.level = level;
+        band.position = (float) jmin ((double) maxBin, centre / binWidth);
+
+        // A band which is wider than a bin covers all the bins it overlaps
+        if (high - low >= binWidth)
+        {
+            band.firstBin = jmin (maxBin, roundToInt (low / binWidth));
+            band.lastBin  = jmin (maxBin, roundToInt (high / binWidth));
+        }
+        else
+        {
+            band.firstBin = 0;
+            band.lastBin = -1;
+        }
+
+        numUsedLevels = jmax (numUsedLevels, level + 1);
+    }
+
+    for (size_t i = 1; i < numUsedLevels; ++i)
+    {
+        const auto previousRate = sampleRate / (double) (1 << (i - 1));
+
+        levels[i].decimationFilter.prepare ({ previousRate, (uint32) chunk.size(), 1 });
+        levels[i].decimationFilter.setSections (FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod ((float) (previousRate / 8.0),
+                                                                                                                previousRate, 8));
+    }
+
+    const auto getCoefficient = [this] (float timeMs)
+    {
+        return timeMs > 0.0f ? std::exp (-1000.0f / (timeMs * parameters.framesPerSecond)) : 0.0f;
+    };
+
+    attackCoefficient  = getCoefficient (parameters.attackTime);
+    releaseCoefficient = getCoefficient (parameters.releaseTime);
+}
+
+//==============================================================================
+void SpectrumAnalyser::pushSamples (const AudioBlock<const float>& block) noexcept
+{
+    const auto numChannels = block.getNumChannels();
+
+    if (numChannels == 0)
+        return;
+
+    const auto gain = 1.0f / (float) numChannels;
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite ((int) block.getNumSamples(), start1, size1, start2, size2);
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* input = block.getChannelPointer (channel);
+
+        for (const auto& [start, size, offset] : { std::make_tuple (start1, size1, 0), std::make_tuple (start2, size2, size1) })
+        {
+            if (channel == 0)
+                FloatVectorOperations::copyWithMultiply (fifoBuffer.data() + start, input + offset, gain, size);
+            else
+                FloatVectorOperations::addWithMultiply (fifoBuffer.data() + start, input + offset, gain, size);
+        }
+    }
+
+    fifo.finishedWrite (size1 + size2);
+    numSamplesPushed.store (numSamplesPushed.load (std::memory_order_relaxed) + size1 + size2, std::memory_order_release);
+}
+
+//==============================================================================
+int SpectrumAnalyser::useTimeSlice()
+{
+    const auto startTime = Time::getMillisecondCounterHiRes();
+
+    const auto position = resetPosition.exchange (-1);
+
+    if (position >= 0)
+    {
+        // Only the samples pushed before reset() are dropped, and only the reading
+        // end of the FIFO is used, as pushSamples() may be writing to it
+        const auto numToDrop = (int) jlimit ((int64) 0, (int64) fifo.getNumReady(), position - numSamplesRead);
+        fifo.finishedRead (numToDrop);
+        numSamplesRead += numToDrop;
+
+        clearLevels();
+    }
+
+    if (fifo.getNumReady() > 0)
+    {
+        readSamples();
+        measureSpectrum();
+        publish();
+    }
+
+    const auto elapsed = Time::getMillisecondCounterHiRes() - startTime;
+    return jmax (1, roundToInt (1000.0 / (double) parameters.framesPerSecond - elapsed));
+}
+
+void SpectrumAnalyser::readSamples()
+{
+    while (fifo.getNumReady() > 0)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (jmin (fifo.getNumReady(), (int) chunk.size()), start1, size1, start2, size2);
+
+        std::copy (fifoBuffer.data() + start1, fifoBuffer.data() + start1 + size1, chunk.data());
+        std::copy (fifoBuffer.data() + start2, fifoBuffer.data() + start2 + size2, chunk.data() + size1);
+        fifo.finishedRead (size1 + size2);
+        numSamplesRead += size1 + size2;
+
+        addToLevels ((size_t) (size1 + size2));
+    }
+}
+
+void SpectrumAnalyser::addToLevels (size_t numSamples) noexcept
+{
+    auto* samples = chunk.data();
+
+    for (size_t i = 0; i < numUsedLevels; ++i)
+    {
+        auto& level = levels[i];
+
+        // Each level is made by filtering the previous one and keeping every second sample
+        if (i > 0)
+        {
+            float* channels[] = { samples };
+            AudioBlock<float> block (channels, 1, numSamples);
+            level.decimationFilter.process (ProcessContextReplacing<float> (block));
+
+            size_t numKept = 0;
+
+            for (size_t j = 0; j < numSamples; ++j)
+            {
+                if (! level.skipNextSample)
+                    samples[numKept++] = samples[j];
+
+                level.skipNextSample = ! level.skipNextSample;
+            }
+
+            numSamples = numKept;
+        }
+
+        const auto historySize = level.history.size();
+
+        for (size_t start = 0; start < numSamples;)
+        {
+            const auto num = jmin (numSamples - start, historySize - level.historyPosition);
+            std::copy (samples + start, samples + start + num, level.history.data() + level.historyPosition);
+
+            level.historyPosition = (level.historyPosition + num) % historySize;
+            start += num;
+        }
+    }
+}
+
+void SpectrumAnalyser::measureSpectrum()
+{
+    const auto fftSize = window.size();
+
+    for (size_t i = 0; i < numUsedLevels; ++i)
+    {
+        auto& level = levels[i];
+
+        // The oldest sample is at the current position of the history
+        const auto numFirst = fftSize - level.historyPosition;
+
+        FloatVectorOperations::multiply (fftBuffer.data(), level.history.data() + level.historyPosition, window.data(), numFirst);
+        FloatVectorOperations::multiply (fftBuffer.data() + numFirst, level.history.data(), window.data() + numFirst, level.historyPosition);
+
+        fft->performFrequencyOnlyForwardTransform (fftBuffer.data(), true);
+        FloatVectorOperations::multiply (level.magnitudes.data(), fftBuffer.data(), amplitudeScale, level.magnitudes.size());
+    }
+
+    for (size_t i = 0; i < bands.size(); ++i)
+    {
+        const auto& band = bands[i];
+        const auto* magnitudes = levels[band.level].magnitudes.data();
+        float magnitude;
+
+        if (band.firstBin <= band.lastBin)
+        {
+            magnitude = FloatVectorOperations::findMaximum (magnitudes + band.firstBin, band.lastBin - band.firstBin + 1);
+        }
+        else
+        {
+            const auto bin = jmin ((size_t) band.position, fftSize / 2 - 1);
+            const auto fraction = band.position - (float) bin;
+            magnitude = magnitudes[bin] + (magnitudes[bin + 1] - magnitudes[bin]) * fraction;
+        }
+
+        const auto decibels = Decibels::gainToDecibels (magnitude, parameters.minimumDecibels);
+        const auto coefficient = decibels > smoothedLevels[i] ? attackCoefficient : releaseCoefficient;
+
+        smoothedLevels[i] = decibels + (smoothedLevels[i] - decibels) * coefficient;
+    }
+}
+
+void SpectrumAnalyser::publish()
+{
+    const auto latest = latestBuffer.load();
+
+    for (int i = 0; i < numBuffers; ++i)
+    {
+        if (i != latest && readerCounts[i].load() == 0)
+        {
+            std::copy (smoothedLevels.begin(), smoothedLevels.end(), buffers[i].begin());
+            bufferFrameNumbers[i] = ++numFrames;
+            latestBuffer = i;
+            return;
+        }
+    }
+
+    // Every other buffer is still being read, so this spectrum is skipped
+}
+
+int64 SpectrumAnalyser::copyLatestSpectrum (float* destination) const noexcept
+{
+    for (;;)
+    {
+        const auto index = latestBuffer.load();
+
+        if (index < 0)
+        {
+            std::fill (destination, destination + parameters.numBands, parameters.minimumDecibels);
+            return 0;
+        }
+
+        ++readerCounts[index];
+
+        // If this is still the latest buffer after it's been marked as being read, the
+        // analyser can't start writing to it until it's been copied
+        if (latestBuffer.load() == index)
+        {
+            std::copy (buffers[index].begin(), buffers[index].end(), destination);
+            const auto frameNumber = bufferFrameNumbers[index];
+            --readerCounts[index];
+            return frameNumber;
+        }
+
+        --readerCounts[index];
+    }
+}
+
+} // namespace dsp
+} // namespace juce
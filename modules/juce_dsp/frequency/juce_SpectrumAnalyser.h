@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    Measures the spectrum of a signal for display, on a background thread.
+
+    The audio thread only copies the samples into a lock-free FIFO, using
+    process() or pushSamples(). The transforms are done on a TimeSliceThread, which
+    can be shared by many analysers, and produce a new spectrum at a fixed frame
+    rate as long as new samples are arriving.
+
+    The spectrum is made of bands with logarithmically spaced frequencies. To get a
+    better resolution at low frequencies without making the transforms bigger, the
+    signal is also decimated into several levels, each one at half the sample rate
+    of the previous one. Each band is then measured on the level which has just
+    enough resolution for it, so the low bands use longer windows, much like a
+    constant-Q transform. The levels in dB are smoothed with separate attack and
+    release times.
+
+    The latest spectrum can be copied by any number of threads at once with
+    copyLatestSpectrum(). The results are triple-buffered, so the readers never
+    block the analyser, and they always get a complete spectrum.
+
+    @see FFT, STFTProcessor
+
+    @tags{DSP}
+*/
+class JUCE_API  SpectrumAnalyser  : private TimeSliceClient
+{
+public:
+    //==============================================================================
+    /** Holds the settings of the analyser. */
+    struct Parameters
+    {
+        /** The size of the transforms is 2 ^ fftOrder. */
+        int fftOrder = 11;
+
+        /** The number of bands in the spectrum. */
+        int numBands = 256;
+
+        /** The centre frequencies in Hz of the first and last bands. */
+        float minFrequency = 20.0f, maxFrequency = 20000.0f;
+
+        /** The number of spectra measured per second. */
+        float framesPerSecond = 30.0f;
+
+        /** The times in milliseconds the levels take to rise and fall. */
+        float attackTime = 0.0f, releaseTime = 300.0f;
+
+        /** The number of levels the signal can be decimated into. Each level doubles
+            the resolution of the lowest bands, and the length of their window.
+        */
+        int maxNumLevels = 4;
+
+        /** The lowest level in dB that the spectrum shows. */
+        float minimumDecibels = -100.0f;
+    };
+
+    //==============================================================================
+    /** Creates an analyser, which will do its work on the given thread.
+
+        The thread must be started for the analyser to do anything, and it must
+        outlive the analyser.
+    */
+    explicit SpectrumAnalyser (TimeSliceThread& thread);
+
+    /** Destructor. */
+    ~SpectrumAnalyser() override;
+
+    //==============================================================================
+    /** Changes the settings of the analyser.
+
+        Memory is allocated, so this shouldn't be done on the audio thread, or while
+        copyLatestSpectrum() is being called.
+    */
+    void setParameters (const Parameters& newParameters);
+
+    /** Returns the current settings of the analyser. */
+    const Parameters& getParameters() const noexcept             { return parameters; }
+
+    /** Returns the number of bands in the spectrum. */
+    int getNumBands() const noexcept                             { return parameters.numBands; }
+
+    /** Returns the centre frequency in Hz of one of the bands. */
+    float getBandFrequency (int band) const noexcept;
+
+    //==============================================================================
+    /** Initialises the analyser. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Clears the samples which haven't been analysed yet and the smoothed levels.
+
+        This only asks the background thread to clear them before its next
+        measurement, so it never blocks, and it can be called on the audio thread.
+    */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Copies the samples of the context to the analyser, and to the output block if
+        it isn't the same as the input. The channels are mixed down to mono.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom (inputBlock);
+
+        if (! context.isBypassed)
+            pushSamples (inputBlock);
+    }
+
+    /** Copies some samples to the analyser, mixing the channels down to mono. This
+        can be called on the audio thread, but only by one thread at a time.
+
+        If the background thread doesn't keep up, the samples which don't fit in the
+        FIFO are dropped.
+    */
+    void pushSamples (const AudioBlock<const float>& block) noexcept;
+
+    //==============================================================================
+    /** Copies the latest spectrum to an array of getNumBands() values in dB.
+
+        Returns the number of the spectrum, which increases by one for each new one,
+        or zero if there hasn't been any yet. This can be called by any number of
+        threads at once, and never blocks.
+    */
+    int64 copyLatestSpectrum (float* destination) const noexcept;
+
+private:
+    //==============================================================================
+    struct Level
+    {
+        IIR::Cascade<float> decimationFilter;
+        std::vector<float> history, magnitudes;
+        size_t historyPosition = 0;
+        bool skipNextSample = false;
+    };
+
+    // Each band is the largest magnitude of the bins between firstBin and lastBin on
+    // its level, or if it's narrower than a bin, the interpolated magnitude at position
+    struct Band
+    {
+        size_t level = 0;
+        int firstBin = 0, lastBin = -1;
+        float position = 0.0f;
+    };
+
+    static constexpr int numBuffers = 3;
+
+    //==============================================================================
+    int useTimeSlice() override;
+    void readSamples();
+    void addToLevels (size_t numSamples) noexcept;
+    void measureSpectrum();
+    void publish();
+    void updateBands();
+    void clear();
+    void clearLevels();
+
+    //==============================================================================
+    TimeSliceThread& thread;
+    Parameters parameters;
+    double sampleRate = 44100.0;
+
+    AbstractFifo fifo { 1 };
+    std::vector<float> fifoBuffer;
+
+    // The total numbers of samples written to and read from the FIFO. When reset() is
+    // called, the number written so far is left in resetPosition for the thread to
+    // drop everything up to it.
+    std::atomic<int64> numSamplesPushed { 0 }, resetPosition { -1 };
+    int64 numSamplesRead = 0;
+
+
+    std::unique_ptr<FFT> fft;
+    std::vector<float> window, fftBuffer, chunk, smoothedLevels;
+    float amplitudeScale = 1.0f, attackCoefficient = 0.0f, releaseCoefficient = 0.0f;
+    std::vector<Level> levels;
+    std::vector<Band> bands;
+    size_t numUsedLevels = 1;
+
+    // Readers take the latest buffer after increasing its count, and the analyser only
+    // writes to a buffer which isn't the latest one and isn't being read
+    std::vector<float> buffers[numBuffers];
+    int64 bufferFrameNumbers[numBuffers] {};
+    mutable std::atomic<int> readerCounts[numBuffers] {};
+    std::atomic<int> latestBuffer { -1 };
+    int64 numFrames = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyser)
+};
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class SpectrumAnalyserTest : public UnitTest
+{
+public:
+    SpectrumAnalyserTest()
+        : UnitTest ("SpectrumAnalyser", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        TimeSliceThread thread ("Spectrum analyser test");
+        thread.startThread();
+
+        beginTest ("No spectrum before any samples");
+        {
+            SpectrumAnalyser analyser (thread);
+            analyser.prepare (spec);
+
+            std::vector<float> spectrum ((size_t) analyser.getNumBands(), 1.0f);
+            expectEquals ((int) analyser.copyLatestSpectrum (spectrum.data()), 0);
+            expectEquals (spectrum.front(), analyser.getParameters().minimumDecibels);
+        }
+
+        beginTest ("Sine wave");
+        {
+            SpectrumAnalyser analyser (thread);
+            analyser.setParameters (getParameters (256, 4));
+            analyser.prepare (spec);
+
+            const auto spectrum = analyse (analyser, { 1000.0 }, 0.5);
+            const auto peak = std::max_element (spectrum.begin(), spectrum.end());
+
+            // The Hann window loses up to 1.42 dB between two bins
+            expectWithinAbsoluteError (*peak, Decibels::gainToDecibels (0.5f) - 0.7f, 0.75f);
+            expectWithinAbsoluteError (std::abs (getBandIndex (analyser, 1000.0f) - (int) std::distance (spectrum.begin(), peak)), 0, 1);
+            expectLessThan (spectrum[(size_t) getBandIndex (analyser, 500.0f)], -60.0f);
+            expectLessThan (spectrum[(size_t) getBandIndex (analyser, 2000.0f)], -60.0f);
+        }
+
+        beginTest ("The decimated levels resolve close low frequencies");
+        {
+            for (auto maxNumLevels : { 1, 4 })
+            {
+                SpectrumAnalyser analyser (thread);
+                analyser.setParameters (getParameters (512, maxNumLevels));
+                analyser.prepare (spec);
+
+                const auto spectrum = analyse (analyser, { 50.0, 70.0 }, 0.25);
+                const auto peaks = spectrum[(size_t) getBandIndex (analyser, 50.0f)];
+                const auto dip = spectrum[(size_t) getBandIndex (analyser, 60.0f)];
+
+                if (maxNumLevels == 1)
+                {
+                    expectGreaterThan (dip, peaks - 3.0f);
+                }
+                else
+                {
+                    expectWithinAbsoluteError (peaks, Decibels::gainToDecibels (0.25f) - 0.7f, 0.75f);
+                    expectLessThan (dip, peaks - 20.0f);
+                }
+            }
+        }
+
+        beginTest ("Resetting clears the previous signal");
+        {
+            for (auto shouldReset : { false, true })
+            {
+                SpectrumAnalyser analyser (thread);
+                analyser.setParameters (getParameters (256, 4));
+                analyser.prepare (spec);
+
+                analyse (analyser, { 1000.0 }, 0.5);
+
+                if (shouldReset)
+                    analyser.reset();
+
+                // With the default release time, the sine fades out slowly unless the levels are reset
+                const auto spectrum = analyse (analyser, {}, 0.0);
+                const auto level = spectrum[(size_t) getBandIndex (analyser, 1000.0f)];
+
+                if (shouldReset)
+                    expectLessThan (level, analyser.getParameters().minimumDecibels + 10.0f);
+                else
+                    expectGreaterThan (level, analyser.getParameters().minimumDecibels + 30.0f);
+            }
+        }
+
+        beginTest ("Several readers");
+        {
+            SpectrumAnalyser analyser (thread);
+            analyser.prepare (spec);
+            std::atomic<bool> isRunning { true };
+
+            // Each reader checks that the spectra never go backwards
+            std::vector<std::unique_ptr<std::thread>> readers;
+            std::atomic<int> numErrors { 0 };
+
+            for (int i = 0; i < 4; ++i)
+            {
+                readers.push_back (std::make_unique<std::thread> ([&]
+                {
+                    std::vector<float> spectrum ((size_t) analyser.getNumBands());
+                    int64 lastFrame = 0;
+
+                    while (isRunning)
+                    {
+                        const auto frame = analyser.copyLatestSpectrum (spectrum.data());
+
+                        if (frame < lastFrame)
+                            ++numErrors;
+
+                        lastFrame = frame;
+                    }
+                }));
+            }
+
+            const auto spectrum = analyse (analyser, { 440.0 }, 1.0);
+            expectWithinAbsoluteError (*std::max_element (spectrum.begin(), spectrum.end()), -0.7f, 0.75f);
+
+            isRunning = false;
+
+            for (auto& reader : readers)
+                reader->join();
+
+            expectEquals (numErrors.load(), 0);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 4800;
+    const ProcessSpec spec { sampleRate, (uint32) blockSize, 2 };
+
+    static SpectrumAnalyser::Parameters getParameters (int numBands, int maxNumLevels)
+    {
+        SpectrumAnalyser::Parameters parameters;
+        parameters.numBands = numBands;
+        parameters.maxNumLevels = maxNumLevels;
+        parameters.framesPerSecond = 200.0f;
+        return parameters;
+    }
+
+    static int getBandIndex (const SpectrumAnalyser& analyser, float frequency)
+    {
+        auto closest = 0;
+
+        for (int i = 1; i < analyser.getNumBands(); ++i)
+            if (std::abs (std::log (analyser.getBandFrequency (i) / frequency))
+                  < std::abs (std::log (analyser.getBandFrequency (closest) / frequency)))
+                closest = i;
+
+        return closest;
+    }
+
+    // Sends two seconds of sines to the analyser, waiting for each block to be
+    // analysed, and returns the last spectrum
+    std::vector<float> analyse (SpectrumAnalyser& analyser, std::initializer_list<double> frequencies, double amplitude)
+    {
+        AudioBuffer<float> buffer (2, blockSize);
+        std::vector<float> spectrum ((size_t) analyser.getNumBands());
+        auto frame = analyser.copyLatestSpectrum (spectrum.data());
+
+        for (int start = 0; start < 2 * (int) sampleRate; start += blockSize)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                auto sample = 0.0;
+
+                for (auto frequency : frequencies)
+                    sample += amplitude * std::sin (MathConstants<double>::twoPi * frequency * (start + i) / sampleRate);
+
+                buffer.setSample (0, i, (float) sample);
+                buffer.setSample (1, i, (float) sample);
+            }
+
+            AudioBlock<float> block (buffer);
+            analyser.process (ProcessContextReplacing<float> (block));
+
+            const auto previousFrame = frame;
+
+            for (int attempt = 0; attempt < 5000 && frame == previousFrame; ++attempt)
+            {
+                Thread::sleep (1);
+                frame = analyser.copyLatestSpectrum (spectrum.data());
+            }
+
+            expectGreaterThan ((int) frame, (int) previousFrame);
+        }
+
+        return spectrum;
+    }
+};
+
+static SpectrumAnalyserTest spectrumAnalyserTest;
+
+} // namespace dsp
+} // namespace juce
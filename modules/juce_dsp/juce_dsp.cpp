@@ -56,6 +56,7 @@
 
 #include "processors/juce_FIRFilter.cpp"
 #include "processors/juce_IIRFilter.cpp"
+#include "processors/juce_IIRCascade.cpp"
 #include "processors/juce_FirstOrderTPTFilter.cpp"
 #include "processors/juce_Panner.cpp"
 #include "processors/juce_Oversampling.cpp"
@@ -70,6 +71,8 @@
 #include "frequency/juce_FFT.cpp"
 #include "frequency/juce_Convolution.cpp"
 #include "frequency/juce_Windowing.cpp"
+#include "frequency/juce_STFTProcessor.cpp"
+#include "frequency/juce_SpectrumAnalyser.cpp"
 #include "filter_design/juce_FilterDesign.cpp"
 #include "widgets/juce_LadderFilter.cpp"
 #include "widgets/juce_Compressor.cpp"
@@ -77,6 +80,9 @@
 #include "widgets/juce_Limiter.cpp"
 #include "widgets/juce_Phaser.cpp"
 #include "widgets/juce_Chorus.cpp"
+#include "widgets/juce_MultibandDynamics.cpp"
+#include "widgets/juce_WavetableOscillatorBank.cpp"
+#include "widgets/juce_FDNReverb.cpp"
 
 #if JUCE_USE_SIMD
  #if JUCE_INTEL
@@ -93,6 +99,8 @@
 #endif
 
 #if JUCE_UNIT_TESTS
+ #include "containers/juce_AudioBufferTestHelpers.h"
+
  #include "maths/juce_Matrix_test.cpp"
  #include "maths/juce_LogRampedValue_test.cpp"
 
@@ -104,6 +112,16 @@
  #include "containers/juce_FixedSizeFunction_test.cpp"
  #include "frequency/juce_Convolution_test.cpp"
  #include "frequency/juce_FFT_test.cpp"
+ #include "frequency/juce_STFTProcessor_test.cpp"
+ #include "frequency/juce_SpectrumAnalyser_test.cpp"
+ #include "processors/juce_DelayLine_test.cpp"
  #include "processors/juce_FIRFilter_test.cpp"
+ #include "processors/juce_IIRFilter_test.cpp"
  #include "processors/juce_ProcessorChain_test.cpp"
+ #include "processors/juce_Oversampling_test.cpp"
+ #include "processors/juce_StateVariableTPTFilter_test.cpp"
+ #include "widgets/juce_LadderFilter_test.cpp"
+ #include "widgets/juce_MultibandDynamics_test.cpp"
+ #include "widgets/juce_WavetableOscillatorBank_test.cpp"
+ #include "widgets/juce_FDNReverb_test.cpp"
 #endif
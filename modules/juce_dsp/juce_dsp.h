@@ -246,12 +246,14 @@ namespace juce
 #include "maths/juce_LookupTable.h"
 #include "maths/juce_LogRampedValue.h"
 #include "containers/juce_AudioBlock.h"
+#include "containers/juce_SIMDLanes.h"
 #include "containers/juce_FixedSizeFunction.h"
 #include "processors/juce_ProcessContext.h"
 #include "processors/juce_ProcessorWrapper.h"
 #include "processors/juce_ProcessorChain.h"
 #include "processors/juce_ProcessorDuplicator.h"
 #include "processors/juce_IIRFilter.h"
+#include "processors/juce_IIRCascade.h"
 #include "processors/juce_FIRFilter.h"
 #include "processors/juce_StateVariableFilter.h"
 #include "processors/juce_FirstOrderTPTFilter.h"
@@ -265,6 +267,8 @@ namespace juce
 #include "frequency/juce_FFT.h"
 #include "frequency/juce_Convolution.h"
 #include "frequency/juce_Windowing.h"
+#include "frequency/juce_STFTProcessor.h"
+#include "frequency/juce_SpectrumAnalyser.h"
 #include "filter_design/juce_FilterDesign.h"
 #include "widgets/juce_Reverb.h"
 #include "widgets/juce_Bias.h"
@@ -277,3 +281,6 @@ namespace juce
 #include "widgets/juce_Limiter.h"
 #include "widgets/juce_Phaser.h"
 #include "widgets/juce_Chorus.h"
+#include "widgets/juce_MultibandDynamics.h"
+#include "widgets/juce_WavetableOscillatorBank.h"
+#include "widgets/juce_FDNReverb.h"
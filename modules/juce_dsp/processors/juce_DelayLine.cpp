@@ -71,7 +71,8 @@ void DelayLine<SampleType, InterpolationType>::prepare (const ProcessSpec& spec)
 {
     jassert (spec.numChannels > 0);
 
-    bufferData.setSize ((int) spec.numChannels, totalSize, false, false, true);
+    maximumBlockSize = (int) spec.maximumBlockSize;
+    updateBufferSize ((int) spec.numChannels);
 
     writePos.resize (spec.numChannels);
     readPos.resize  (spec.numChannels);
@@ -87,10 +88,19 @@ void DelayLine<SampleType, InterpolationType>::setMaximumDelayInSamples (int max
 {
     jassert (maxDelayInSamples >= 0);
     totalSize = jmax (4, maxDelayInSamples + 1);
-    bufferData.setSize ((int) bufferData.getNumChannels(), totalSize, false, false, true);
+    updateBufferSize (bufferData.getNumChannels());
     reset();
 }
 
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::updateBufferSize (int numChannels)
+{
+    // There must be room for a whole block to be pushed without overwriting any of
+    // the samples that the first read of the block may need for its interpolation
+    bufferSize = totalSize + maximumBlockSize + mirrorSize;
+    bufferData.setSize (numChannels, bufferSize + mirrorSize, false, false, true);
+}
+
 template <typename SampleType, typename InterpolationType>
 void DelayLine<SampleType, InterpolationType>::reset()
 {
@@ -106,8 +116,15 @@ void DelayLine<SampleType, InterpolationType>::reset()
 template <typename SampleType, typename InterpolationType>
 void DelayLine<SampleType, InterpolationType>::pushSample (int channel, SampleType sample)
 {
-    bufferData.setSample (channel, writePos[(size_t) channel], sample);
-    writePos[(size_t) channel] = (writePos[(size_t) channel] + totalSize - 1) % totalSize;
+    auto& position = writePos[(size_t) channel];
+    auto* samples = bufferData.getWritePointer (channel);
+
+    samples[position] = sample;
+
+    if (position < mirrorSize)
+        samples[position + bufferSize] = sample;
+
+    position = (position + bufferSize - 1) % bufferSize;
 }
 
 template <typename SampleType, typename InterpolationType>
@@ -119,11 +136,163 @@ SampleType DelayLine<SampleType, InterpolationType>::popSample (int channel, Sam
     auto result = interpolateSample (channel);
 
     if (updateReadPointer)
-        readPos[(size_t) channel] = (readPos[(size_t) channel] + totalSize - 1) % totalSize;
+        readPos[(size_t) channel] = (readPos[(size_t) channel] + bufferSize - 1) % bufferSize;
 
     return result;
 }
 
+//==============================================================================
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::pushBlock (int channel, const SampleType* input, int numSamples)
+{
+    jassert (isPositiveAndNotGreaterThan (numSamples, jmax (1, maximumBlockSize)));
+
+    auto& position = writePos[(size_t) channel];
+    auto* samples = bufferData.getWritePointer (channel);
+
+    // The samples are stored backwards from the write position, so the block is
+    // copied in reverse, in two parts if it goes past the start of the buffer
+    const auto numBeforeWrap = jmin (numSamples, position + 1);
+    const auto numAfterWrap = numSamples - numBeforeWrap;
+
+    std::reverse_copy (input, input + numBeforeWrap, samples + position + 1 - numBeforeWrap);
+    std::reverse_copy (input + numBeforeWrap, input + numSamples, samples + bufferSize - numAfterWrap);
+    std::copy (samples, samples + mirrorSize, samples + bufferSize);
+
+    position -= numSamples;
+
+    if (position < 0)
+        position += bufferSize;
+}
+
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::popBlock (int channel, SampleType* output, int numSamples,
+                                                          const SampleType* delaysInSamples, bool updateReadPointer)
+{
+    jassert (isPositiveAndNotGreaterThan (numSamples, jmax (1, maximumBlockSize)));
+
+    if (numSamples <= 0)
+        return;
+
+    auto& position = readPos[(size_t) channel];
+    const auto startPosition = position;
+
+    if constexpr (std::is_same_v<InterpolationType, DelayLineInterpolationTypes::Thiran>)
+    {
+        // The Thiran interpolator is recursive, so it has to go one sample at a time
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (delaysInSamples != nullptr)
+                setDelay (delaysInSamples[i]);
+
+            output[i] = interpolateSample (channel);
+            position = (position == 0 ? bufferSize : position) - 1;
+        }
+    }
+    else
+    {
+        interpolateBlock (bufferData.getReadPointer (channel), position, output, numSamples, delaysInSamples);
+
+        if (delaysInSamples != nullptr)
+            setDelay (delaysInSamples[numSamples - 1]);
+
+        position -= numSamples;
+
+        if (position < 0)
+            position += bufferSize;
+    }
+
+    if (! updateReadPointer)
+        position = startPosition;
+}
+
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::interpolateBlock (const SampleType* samples, int position, SampleType* output,
+                                                                  int numSamples, const SampleType* delaysInSamples) noexcept
+{
+    constexpr auto isLagrange = std::is_same_v<InterpolationType, DelayLineInterpolationTypes::Lagrange3rd>;
+    constexpr auto numPoints = std::is_same_v<InterpolationType, DelayLineInterpolationTypes::None> ? 1 : (isLagrange ? 4 : 2);
+    constexpr auto numRegisters = (size_t) chunkSize / Lanes::numLanes;
+
+    const auto maxDelay = (SampleType) getMaximumDelayInSamples();
+
+    // The samples around each read position are gathered first, so that the
+    // interpolation can then be worked out for several of them at once
+    LanesType fractionLanes[numRegisters] {}, valueLanes[numPoints][numRegisters] {}, resultLanes[numRegisters] {};
+    auto* fractions = Lanes::getLanes (fractionLanes);
+    auto* results = Lanes::getLanes (resultLanes);
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto num = jmin (chunkSize, numSamples - start);
+
+        for (int i = 0; i < num; ++i)
+        {
+            auto integer = delayInt;
+            auto fraction = delayFrac;
+
+            if (delaysInSamples != nullptr)
+            {
+                const auto delayInSamples = jlimit (SampleType(), maxDelay, delaysInSamples[start + i]);
+                integer = (int) delayInSamples;
+                fraction = delayInSamples - (SampleType) integer;
+
+                if constexpr (isLagrange)
+                {
+                    if (integer >= 1)
+                    {
+                        fraction++;
+                        integer--;
+                    }
+                }
+            }
+
+            const auto* source = samples + getReadIndex (position, integer);
+            fractions[i] = fraction;
+
+            for (int point = 0; point < numPoints; ++point)
+                Lanes::getLanes (valueLanes[point])[i] = source[point];
+
+            position = (position == 0 ? bufferSize : position) - 1;
+        }
+
+        if constexpr (numPoints == 1)
+        {
+            std::copy (Lanes::getLanes (valueLanes[0]), Lanes::getLanes (valueLanes[0]) + num, output + start);
+        }
+        else
+        {
+            const auto numRegistersUsed = ((size_t) num + Lanes::numLanes - 1) / Lanes::numLanes;
+
+            for (size_t r = 0; r < numRegistersUsed; ++r)
+            {
+                const auto fraction = fractionLanes[r];
+
+                if constexpr (isLagrange)
+                {
+                    const auto d1 = fraction - (SampleType) 1;
+                    const auto d2 = fraction - (SampleType) 2;
+                    const auto d3 = fraction - (SampleType) 3;
+
+                    const auto c1 = d1 * d2 * d3 * (SampleType) (-1.0 / 6.0);
+                    const auto c2 = d2 * d3 * (SampleType) 0.5;
+                    const auto c3 = d1 * d3 * (SampleType) -0.5;
+                    const auto c4 = d1 * d2 * (SampleType) (1.0 / 6.0);
+
+                    resultLanes[r] = valueLanes[0][r] * c1
+                                   + fraction * (valueLanes[1][r] * c2 + valueLanes[2][r] * c3 + valueLanes[3][r] * c4);
+                }
+                else
+                {
+                    resultLanes[r] = valueLanes[0][r] + fraction * (valueLanes[1][r] - valueLanes[0][r]);
+                }
+            }
+
+            std::copy (results, results + num, output + start);
+        }
+    }
+}
+
 //==============================================================================
 template class DelayLine<float,  DelayLineInterpolationTypes::None>;
 template class DelayLine<double, DelayLineInterpolationTypes::None>;
@@ -83,6 +83,14 @@ namespace DelayLineInterpolationTypes
     modulating the delay in real time or creating a standard delay effect with
     feedback.
 
+    Whole blocks can also be written with pushBlock() and read back with
+    popBlock(), which takes a separate delay time for each sample. Several taps
+    can be read from the same block by calling popBlock() once for each of them.
+    Reading a block this way is much cheaper than popping its samples one by one,
+    as the interpolation is worked out for several samples at once using SIMD
+    registers where possible. The first few samples of the buffer are mirrored
+    past its end, so that the interpolation never has to wrap around.
+
     Note: If you intend to change the delay in real time, you may want to smooth
     changes to the delay systematically using either a ramp or a low-pass filter.
 
@@ -109,7 +117,11 @@ public:
     SampleType getDelay() const;
 
     //==============================================================================
-    /** Initialises the processor. */
+    /** Initialises the processor.
+
+        The buffer has room for the maximum delay plus the maximum block size of the
+        spec, so that a whole block can be pushed before it's read with popBlock().
+    */
     void prepare (const ProcessSpec& spec);
 
     /** Sets a new maximum delay in samples.
@@ -160,6 +172,47 @@ public:
     */
     SampleType popSample (int channel, SampleType delayInSamples = -1, bool updateReadPointer = true);
 
+    //==============================================================================
+    /** Pushes a block of samples into one channel of the delay line.
+
+        This does the same as calling pushSample() for each sample in turn. The
+        number of samples must not be greater than the maximum block size passed
+        to prepare().
+
+        @see popBlock
+    */
+    void pushBlock (int channel, const SampleType* samples, int numSamples);
+
+    /** Pops a block of samples from one channel of the delay line.
+
+        This returns the same values as calling popSample() once for each sample,
+        straight after the matching sample was pushed. It's normally used after
+        pushing the same number of samples with pushBlock(). If every delay is at
+        least one sample longer than the block, it can also be called before the block
+        is pushed, which is useful for effects with a feedback loop.
+
+        @param channel              the target channel for the delay line.
+
+        @param output               where the samples will be written.
+
+        @param numSamples           the number of samples to read, which must not be
+                                    greater than the maximum block size passed to
+                                    prepare().
+
+        @param delaysInSamples      an array holding the fractional delay in samples to
+                                    use for each sample, or nullptr to use the value set
+                                    with setDelay. After the call, the delay will be
+                                    the last one in the array.
+
+        @param updateReadPointer    should be set to true if you read the block once,
+                                    or false for all but the last tap if you need
+                                    multi-tap delay capabilities.
+
+        @see pushBlock, popSample
+    */
+    void popBlock (int channel, SampleType* output, int numSamples,
+                   const SampleType* delaysInSamples = nullptr, bool updateReadPointer = true);
+
     //==============================================================================
     /** Processes the input and output samples supplied in the processing context.
 
@@ -186,65 +239,59 @@ public:
             return;
         }
 
+        const auto maxChunkSize = (size_t) jmax (1, maximumBlockSize);
+
         for (size_t channel = 0; channel < numChannels; ++channel)
         {
             auto* inputSamples = inputBlock.getChannelPointer (channel);
             auto* outputSamples = outputBlock.getChannelPointer (channel);
 
-            for (size_t i = 0; i < numSamples; ++i)
+            for (size_t start = 0; start < numSamples; start += maxChunkSize)
             {
-                pushSample ((int) channel, inputSamples[i]);
-                outputSamples[i] = popSample ((int) channel);
+                const auto num = (int) jmin (maxChunkSize, numSamples - start);
+
+                pushBlock ((int) channel, inputSamples + start, num);
+                popBlock ((int) channel, outputSamples + start, num);
             }
         }
     }
 
 private:
     //==============================================================================
+    using Lanes     = detail::SIMDLanes<SampleType>;
+    using LanesType = typename Lanes::Type;
+
+    static constexpr int chunkSize = 64;
+
+    // The samples at the start of each channel are copied after its end, so that
+    // reading up to three samples after any position in the ring never wraps
+    static constexpr int mirrorSize = 3;
+
+    //==============================================================================
+    int getReadIndex (int position, int offset) const noexcept
+    {
+        auto index = position + offset;
+        return index >= bufferSize ? index - bufferSize : index;
+    }
+
     SampleType interpolateSample (int channel)
     {
+        auto* samples = bufferData.getReadPointer (channel) + getReadIndex (readPos[(size_t) channel], delayInt);
+
         if constexpr (std::is_same_v<InterpolationType, DelayLineInterpolationTypes::None>)
         {
-            auto index = (readPos[(size_t) channel] + delayInt) % totalSize;
-            return bufferData.getSample (channel, index);
+            return samples[0];
         }
         else if constexpr (std::is_same_v<InterpolationType, DelayLineInterpolationTypes::Linear>)
         {
-            auto index1 = readPos[(size_t) channel] + delayInt;
-            auto index2 = index1 + 1;
-
-            if (index2 >= totalSize)
-            {
-                index1 %= totalSize;
-                index2 %= totalSize;
-            }
-
-            auto value1 = bufferData.getSample (channel, index1);
-            auto value2 = bufferData.getSample (channel, index2);
-
-            return value1 + delayFrac * (value2 - value1);
+            return samples[0] + delayFrac * (samples[1] - samples[0]);
         }
         else if constexpr (std::is_same_v<InterpolationType, DelayLineInterpolationTypes::Lagrange3rd>)
         {
-            auto index1 = readPos[(size_t) channel] + delayInt;
-            auto index2 = index1 + 1;
-            auto index3 = index2 + 1;
-            auto index4 = index3 + 1;
-
-            if (index4 >= totalSize)
-            {
-                index1 %= totalSize;
-                index2 %= totalSize;
-                index3 %= totalSize;
-                index4 %= totalSize;
-            }
-
-            auto* samples = bufferData.getReadPointer (channel);
-
-            auto value1 = samples[index1];
-            auto value2 = samples[index2];
-            auto value3 = samples[index3];
-            auto value4 = samples[index4];
+            auto value1 = samples[0];
+            auto value2 = samples[1];
+            auto value3 = samples[2];
+            auto value4 = samples[3];
 
             auto d1 = delayFrac - 1.f;
             auto d2 = delayFrac - 2.f;
@@ -259,17 +306,8 @@ private:
         }
         else if constexpr (std::is_same_v<InterpolationType, DelayLineInterpolationTypes::Thiran>)
         {
-            auto index1 = readPos[(size_t) channel] + delayInt;
-            auto index2 = index1 + 1;
-
-            if (index2 >= totalSize)
-            {
-                index1 %= totalSize;
-                index2 %= totalSize;
-            }
-
-            auto value1 = bufferData.getSample (channel, index1);
-            auto value2 = bufferData.getSample (channel, index2);
+            auto value1 = samples[0];
+            auto value2 = samples[1];
 
             auto output = delayFrac == 0 ? value1 : value2 + alpha * (value1 - v[(size_t) channel]);
             v[(size_t) channel] = output;
@@ -301,6 +339,10 @@ private:
         }
     }
 
+    void interpolateBlock (const SampleType* samples, int position, SampleType* output,
+                           int numSamples, const SampleType* delaysInSamples) noexcept;
+    void updateBufferSize (int numChannels);
+
     //==============================================================================
     double sampleRate;
 
@@ -309,7 +351,7 @@ private:
     std::vector<SampleType> v;
     std::vector<int> writePos, readPos;
     SampleType delay = 0.0, delayFrac = 0.0;
-    int delayInt = 0, totalSize = 4;
+    int delayInt = 0, totalSize = 4, bufferSize = 4, maximumBlockSize = 0;
     SampleType alpha = 0.0;
 };
 
@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class DelayLineTest : public UnitTest
+{
+public:
+    DelayLineTest()
+        : UnitTest ("DelayLine", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runTests<float,  DelayLineInterpolationTypes::None>        ("None");
+        runTests<double, DelayLineInterpolationTypes::None>        ("None");
+        runTests<float,  DelayLineInterpolationTypes::Linear>      ("Linear");
+        runTests<double, DelayLineInterpolationTypes::Linear>      ("Linear");
+        runTests<float,  DelayLineInterpolationTypes::Lagrange3rd> ("Lagrange3rd");
+        runTests<double, DelayLineInterpolationTypes::Lagrange3rd> ("Lagrange3rd");
+        runTests<float,  DelayLineInterpolationTypes::Thiran>      ("Thiran");
+        runTests<double, DelayLineInterpolationTypes::Thiran>      ("Thiran");
+    }
+
+private:
+    template <typename Type>
+    static std::vector<Type> getRandomSamples (Random& random, int numSamples, Type minimum, Type maximum)
+    {
+        std::vector<Type> samples ((size_t) numSamples);
+
+        for (auto& s : samples)
+            s = minimum + (maximum - minimum) * (Type) random.nextFloat();
+
+        return samples;
+    }
+
+    template <typename Type, typename Interpolation>
+    void runTests (const String& interpolationName)
+    {
+        using namespace AudioBufferTestHelpers;
+
+        constexpr auto maxDelay = 300;
+        constexpr int numChannels = 2, maxBlockSize = 128, numBlocks = 20;
+        const auto tolerance = (Type) 1.0e-5;
+        Random random (0x1234);
+
+        const auto createDelayLines = [&]
+        {
+            std::array<DelayLine<Type, Interpolation>, 2> delayLines { DelayLine<Type, Interpolation> (maxDelay),
+                                                                       DelayLine<Type, Interpolation> (maxDelay) };
+
+            for (auto& d : delayLines)
+                d.prepare ({ 44100.0, (uint32) maxBlockSize, (uint32) numChannels });
+
+            return delayLines;
+        };
+
+        beginTest ("Block reads match popping each sample (" + interpolationName + ")");
+        {
+            auto [reference, delayLine] = createDelayLines();
+
+            for (int n = 0; n < numBlocks; ++n)
+            {
+                const auto numSamples = random.nextInt ({ 1, maxBlockSize + 1 });
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    const auto input  = getRandomSamples (random, numSamples, (Type) -1, (Type) 1);
+                    const auto delays = getRandomSamples (random, numSamples, (Type) 0, (Type) maxDelay);
+                    std::vector<Type> expected ((size_t) numSamples), actual ((size_t) numSamples);
+
+                    for (size_t i = 0; i < (size_t) numSamples; ++i)
+                    {
+                        reference.pushSample (ch, input[i]);
+                        expected[i] = reference.popSample (ch, delays[i]);
+                    }
+
+                    delayLine.pushBlock (ch, input.data(), numSamples);
+                    delayLine.popBlock (ch, actual.data(), numSamples, delays.data());
+
+                    expectLessThan (getMaxDifference (expected.data(), actual.data(), (int) expected.size()), tolerance);
+                    expectEquals (delayLine.getDelay(), reference.getDelay());
+                }
+            }
+        }
+
+        // The taps share the state of the Thiran interpolator, so reading them one
+        // block at a time gives different results to reading them one sample at a time
+        if (! std::is_same_v<Interpolation, DelayLineInterpolationTypes::Thiran>)
+        {
+            beginTest ("Multi-tap block reads match popping each sample (" + interpolationName + ")");
+            {
+                auto [reference, delayLine] = createDelayLines();
+
+                for (int n = 0; n < numBlocks; ++n)
+                {
+                    const auto numSamples = random.nextInt ({ 1, maxBlockSize + 1 });
+                    const auto input  = getRandomSamples (random, numSamples, (Type) -1, (Type) 1);
+                    const auto delays1 = getRandomSamples (random, numSamples, (Type) 0, (Type) maxDelay);
+                    const auto delays2 = getRandomSamples (random, numSamples, (Type) 0, (Type) 10);
+                    std::vector<Type> expected ((size_t) numSamples * 2), actual ((size_t) numSamples * 2);
+
+                    for (size_t i = 0; i < (size_t) numSamples; ++i)
+                    {
+                        reference.pushSample (0, input[i]);
+                        expected[i]                       = reference.popSample (0, delays1[i], false);
+                        expected[i + (size_t) numSamples] = reference.popSample (0, delays2[i], true);
+                    }
+
+                    delayLine.pushBlock (0, input.data(), numSamples);
+                    delayLine.popBlock (0, actual.data(), numSamples, delays1.data(), false);
+                    delayLine.popBlock (0, actual.data() + numSamples, numSamples, delays2.data(), true);
+
+                    expectLessThan (getMaxDifference (expected.data(), actual.data(), (int) expected.size()), tolerance);
+                }
+            }
+        }
+
+        beginTest ("Reading a block before pushing it works with long enough delays (" + interpolationName + ")");
+        {
+            auto [reference, delayLine] = createDelayLines();
+            Type referenceFeedback = 0, feedback = 0;
+
+            for (int n = 0; n < numBlocks; ++n)
+            {
+                const auto numSamples = random.nextInt ({ 1, maxBlockSize + 1 });
+                const auto input  = getRandomSamples (random, numSamples, (Type) -1, (Type) 1);
+                const auto delays = getRandomSamples (random, numSamples, (Type) (numSamples + 1), (Type) maxDelay);
+                std::vector<Type> expected ((size_t) numSamples), actual ((size_t) numSamples);
+
+                for (size_t i = 0; i < (size_t) numSamples; ++i)
+                {
+                    reference.pushSample (0, input[i] + referenceFeedback);
+                    expected[i] = reference.popSample (0, delays[i]);
+                    referenceFeedback = expected[i] * (Type) 0.5;
+                }
+
+                delayLine.popBlock (0, actual.data(), numSamples, delays.data());
+                std::vector<Type> pushed ((size_t) numSamples);
+
+                for (size_t i = 0; i < (size_t) numSamples; ++i)
+                {
+                    pushed[i] = input[i] + feedback;
+                    feedback = actual[i] * (Type) 0.5;
+                }
+
+                delayLine.pushBlock (0, pushed.data(), numSamples);
+
+                expectLessThan (getMaxDifference (expected.data(), actual.data(), (int) expected.size()), tolerance);
+            }
+        }
+
+        beginTest ("Processing a block with a fixed delay matches popping each sample (" + interpolationName + ")");
+        {
+            auto [reference, delayLine] = createDelayLines();
+
+            for (auto delay : { (Type) 0, (Type) 1.25, (Type) 17.5, (Type) maxDelay })
+            {
+                reference.setDelay (delay);
+                delayLine.setDelay (delay);
+
+                for (int n = 0; n < 4; ++n)
+                {
+                    AudioBuffer<Type> buffer (numChannels, maxBlockSize);
+                    std::vector<Type> expected, actual;
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                    {
+                        const auto input = getRandomSamples (random, maxBlockSize, (Type) -1, (Type) 1);
+                        buffer.copyFrom (ch, 0, input.data(), maxBlockSize);
+
+                        for (auto x : input)
+                        {
+                            reference.pushSample (ch, x);
+                            expected.push_back (reference.popSample (ch));
+                        }
+                    }
+
+                    AudioBlock<Type> block (buffer);
+                    delayLine.process (ProcessContextReplacing<Type> (block));
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        actual.insert (actual.end(), buffer.getReadPointer (ch), buffer.getReadPointer (ch) + maxBlockSize);
+
+                    expectLessThan (getMaxDifference (expected.data(), actual.data(), (int) expected.size()), tolerance);
+                }
+            }
+        }
+    }
+};
+
+static DelayLineTest delayLineTest;
+
+} // namespace dsp
+} // namespace juce
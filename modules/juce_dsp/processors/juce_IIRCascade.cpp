@@ -0,0 +1,356 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+namespace IIR
+{
+
+//==============================================================================
+template <typename SampleType>
+void Cascade<SampleType>::setSections (const ReferenceCountedArray<Coefficients<SampleType>>& newSections)
+{
+    const auto newNumSections = (size_t) newSections.size();
+    std::vector<SampleType> newCoefficients (newNumSections * coefficientsPerSection, SampleType());
+
+    for (size_t i = 0; i < newNumSections; ++i)
+    {
+        auto* section = newSections.getObjectPointerUnchecked ((int) i);
+        jassert (section != nullptr);
+
+        const auto order = section->getFilterOrder();
+        const auto* raw = section->getRawCoefficients();
+        auto* c = newCoefficients.data() + i * coefficientsPerSection;
+
+        // Each section of a cascade must be a first or second order filter!
+        jassert (order == 1 || order == 2);
+
+        if (order == 1)
+        {
+            c[0] = raw[0];
+            c[1] = raw[1];
+            c[3] = raw[2];
+        }
+        else if (order == 2)
+        {
+            std::copy (raw, raw + coefficientsPerSection, c);
+        }
+    }
+
+    if (newNumSections == numSections && numInterpolationSamples > 0)
+    {
+        targetCoefficients = std::move (newCoefficients);
+
+        for (size_t i = 0; i < coefficients.size(); ++i)
+            coefficientIncrements[i] = (targetCoefficients[i] - coefficients[i]) / (SampleType) numInterpolationSamples;
+
+        numInterpolationSamplesRemaining = numInterpolationSamples;
+        return;
+    }
+
+    coefficients = newCoefficients;
+    targetCoefficients = std::move (newCoefficients);
+    coefficientIncrements.assign (coefficients.size(), SampleType());
+    numInterpolationSamplesRemaining = 0;
+
+    if (newNumSections != numSections)
+    {
+        numSections = newNumSections;
+        state.assign (numPreparedChannels * numSections * 2, SampleType());
+
+       #if JUCE_USE_SIMD
+        blockCoefficientsMemory.malloc (numSections * blockCoefficientsPerSection + 1);
+        blockCoefficients = snapPointerToAlignment (blockCoefficientsMemory.getData(), sizeof (SIMDType));
+       #endif
+    }
+
+    updateBlockCoefficients();
+}
+
+template <typename SampleType>
+void Cascade<SampleType>::setInterpolationTime (double newTimeInSeconds)
+{
+    jassert (newTimeInSeconds >= 0.0);
+
+    interpolationTime = jmax (0.0, newTimeInSeconds);
+    numInterpolationSamples = roundToInt (interpolationTime * sampleRate);
+}
+
+//==============================================================================
+template <typename SampleType>
+void Cascade<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+    jassert (spec.numChannels > 0);
+
+    sampleRate = spec.sampleRate;
+    numPreparedChannels = spec.numChannels;
+    setInterpolationTime (interpolationTime);
+
+    state.resize (numPreparedChannels * numSections * 2);
+    reset();
+}
+
+template <typename SampleType>
+void Cascade<SampleType>::reset()
+{
+    std::fill (state.begin(), state.end(), SampleType());
+
+    if (isInterpolating())
+    {
+        coefficients = targetCoefficients;
+        numInterpolationSamplesRemaining = 0;
+        updateBlockCoefficients();
+    }
+}
+
+template <typename SampleType>
+void Cascade<SampleType>::snapToZero() noexcept
+{
+    for (auto& s : state)
+        util::snapToZero (s);
+}
+
+//==============================================================================
+template <typename SampleType>
+void Cascade<SampleType>::processChannel (size_t channel, const SampleType* input, SampleType* output, size_t numSamples) noexcept
+{
+    auto* channelState = state.data() + channel * numSections * 2;
+
+    if (isInterpolating())
+    {
+        const auto numInterpolated = jmin (numSamples, (size_t) numInterpolationSamplesRemaining);
+
+        processInterpolatedSamples (channelState, input, output, numInterpolated);
+        processSamples (targetCoefficients.data(), channelState, input + numInterpolated,
+                        output + numInterpolated, numSamples - numInterpolated);
+        return;
+    }
+
+   #if JUCE_USE_SIMD
+    const auto numBlocks = numSamples / samplesPerBlock;
+    processBlocks (channelState, input, output, numBlocks);
+
+    const auto numDone = numBlocks * samplesPerBlock;
+    input  += numDone;
+    output += numDone;
+    numSamples -= numDone;
+   #endif
+
+    processSamples (coefficients.data(), channelState, input, output, numSamples);
+}
+
+template <typename SampleType>
+void Cascade<SampleType>::processSamples (const SampleType* coeffs, SampleType* channelState,
+                                          const SampleType* input, SampleType* output, size_t numSamples) noexcept
+{
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto x = input[i];
+
+        for (size_t section = 0; section < numSections; ++section)
+        {
+            const auto* c = coeffs + section * coefficientsPerSection;
+            auto* s = channelState + section * 2;
+
+            auto y = (x * c[0]) + s[0];
+            s[0] = (x * c[1]) - (y * c[3]) + s[1];
+            s[1] = (x * c[2]) - (y * c[4]);
+            x = y;
+        }
+
+        output[i] = x;
+    }
+}
+
+template <typename SampleType>
+void Cascade<SampleType>::processInterpolatedSamples (SampleType* channelState, const SampleType* input,
+                                                      SampleType* output, size_t numSamples) noexcept
+{
+    // The coefficients are worked out from the start of the ramp for each sample, so
+    // that every channel gets exactly the same values without accumulating errors
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        const auto t = (SampleType) (i + 1);
+        auto x = input[i];
+
+        for (size_t section = 0; section < numSections; ++section)
+        {
+            const auto* c = coefficients.data() + section * coefficientsPerSection;
+            const auto* d = coefficientIncrements.data() + section * coefficientsPerSection;
+            auto* s = channelState + section * 2;
+
+            auto y = (x * (c[0] + d[0] * t)) + s[0];
+            s[0] = (x * (c[1] + d[1] * t)) - (y * (c[3] + d[3] * t)) + s[1];
+            s[1] = (x * (c[2] + d[2] * t)) - (y * (c[4] + d[4] * t));
+            x = y;
+        }
+
+        output[i] = x;
+    }
+}
+
+template <typename SampleType>
+void Cascade<SampleType>::advanceInterpolation (size_t numSamples) noexcept
+{
+    if (! isInterpolating())
+        return;
+
+    if (numSamples >= (size_t) numInterpolationSamplesRemaining)
+    {
+        std::copy (targetCoefficients.begin(), targetCoefficients.end(), coefficients.begin());
+        numInterpolationSamplesRemaining = 0;
+        updateBlockCoefficients();
+        return;
+    }
+
+    for (size_t i = 0; i < coefficients.size(); ++i)
+        coefficients[i] += coefficientIncrements[i] * (SampleType) numSamples;
+
+    numInterpolationSamplesRemaining -= (int) numSamples;
+}
+
+//==============================================================================
+#if JUCE_USE_SIMD
+
+/*  For a block of L samples, the state-space form of a TDF-II section gives
+
+        y[n + m] = C A^m s[n] + D x[n + m] + sum (j < m) C A^(m - 1 - j) B x[n + j]
+
+    where s is the pair of state variables, A = [-a1 1; -a2 0], B = [b1 - a1 b0; b2 - a2 b0],
+    C = [1 0] and D = b0. Each output in the block only depends on the state at the
+    start of it, so all of them can be worked out at once, one per lane. The state at
+    the end of the block only depends on the last two inputs and outputs.
+
+    For each section, the first L registers hold the columns of the impulse response
+    matrix, and the next two hold C A^m for each of the state variables.
+*/
+template <typename SampleType>
+void Cascade<SampleType>::updateBlockCoefficients()
+{
+    constexpr auto L = samplesPerBlock;
+
+    for (size_t section = 0; section < numSections; ++section)
+    {
+        const auto* c = coefficients.data() + section * coefficientsPerSection;
+        const auto b0 = (double) c[0], b1 = (double) c[1], b2 = (double) c[2];
+        const auto a1 = (double) c[3], a2 = (double) c[4];
+
+        const double A[2][2] = { { -a1, 1.0 }, { -a2, 0.0 } };
+        const double B[2] = { b1 - a1 * b0, b2 - a2 * b0 };
+
+        double CAm[L][2], impulse[L];
+        CAm[0][0] = 1.0;
+        CAm[0][1] = 0.0;
+        impulse[0] = b0;
+
+        for (size_t m = 1; m < L; ++m)
+        {
+            CAm[m][0] = CAm[m - 1][0] * A[0][0] + CAm[m - 1][1] * A[1][0];
+            CAm[m][1] = CAm[m - 1][0] * A[0][1] + CAm[m - 1][1] * A[1][1];
+            impulse[m] = CAm[m - 1][0] * B[0] + CAm[m - 1][1] * B[1];
+        }
+
+        auto* blockCoeffs = blockCoefficients + section * blockCoefficientsPerSection;
+
+        for (size_t j = 0; j < L; ++j)
+        {
+            auto* column = reinterpret_cast<SampleType*> (blockCoeffs + j);
+
+            for (size_t m = 0; m < L; ++m)
+                column[m] = m >= j ? (SampleType) impulse[m - j] : SampleType();
+        }
+
+        auto* stateToOutput0 = reinterpret_cast<SampleType*> (blockCoeffs + L);
+        auto* stateToOutput1 = reinterpret_cast<SampleType*> (blockCoeffs + L + 1);
+
+        for (size_t m = 0; m < L; ++m)
+        {
+            stateToOutput0[m] = (SampleType) CAm[m][0];
+            stateToOutput1[m] = (SampleType) CAm[m][1];
+        }
+    }
+}
+
+template <typename SampleType>
+void Cascade<SampleType>::processBlocks (SampleType* channelState, const SampleType* input,
+                                         SampleType* output, size_t numBlocks) noexcept
+{
+    constexpr auto L = samplesPerBlock;
+    static_assert (L >= 2 && L % 2 == 0, "The blocks must hold an even number of samples");
+
+    for (size_t block = 0; block < numBlocks; ++block)
+    {
+        SIMDType x;
+        std::copy (input, input + L, reinterpret_cast<SampleType*> (&x));
+
+        for (size_t section = 0; section < numSections; ++section)
+        {
+            const auto* blockCoeffs = blockCoefficients + section * blockCoefficientsPerSection;
+            const auto* c = coefficients.data() + section * coefficientsPerSection;
+            const auto* xs = reinterpret_cast<const SampleType*> (&x);
+            auto* s = channelState + section * 2;
+
+            // Two separate sums make a shorter chain of dependent additions
+            auto y0 = blockCoeffs[L]     * SIMDType::expand (s[0]);
+            auto y1 = blockCoeffs[L + 1] * SIMDType::expand (s[1]);
+
+            for (size_t j = 0; j < L; j += 2)
+            {
+                y0 += blockCoeffs[j]     * SIMDType::expand (xs[j]);
+                y1 += blockCoeffs[j + 1] * SIMDType::expand (xs[j + 1]);
+            }
+
+            const auto y = y0 + y1;
+            const auto* ys = reinterpret_cast<const SampleType*> (&y);
+            s[1] = (xs[L - 1] * c[2]) - (ys[L - 1] * c[4]);
+            s[0] = (xs[L - 1] * c[1]) - (ys[L - 1] * c[3]) + (xs[L - 2] * c[2]) - (ys[L - 2] * c[4]);
+            x = y;
+        }
+
+        const auto* xs = reinterpret_cast<const SampleType*> (&x);
+        std::copy (xs, xs + L, output);
+
+        input  += L;
+        output += L;
+    }
+}
+
+#else
+
+template <typename SampleType>
+void Cascade<SampleType>::updateBlockCoefficients() {}
+
+#endif
+
+//==============================================================================
+template class Cascade<float>;
+template class Cascade<double>;
+
+} // namespace IIR
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+namespace IIR
+{
+
+/**
+    A processing class that runs a chain of first and second order IIR sections,
+    such as the ones returned by the FilterDesign class, on a multi-channel signal.
+
+    Instead of making a separate pass over the block for each section, as a
+    ProcessorChain of IIR::Filter objects would, every sample goes through all of
+    the sections in turn while their state stays in registers. Each section uses
+    the Transposed Direct Form II structure.
+
+    When SIMD is available and the coefficients aren't changing, the signal is
+    processed in groups of SIMDRegister<SampleType>::size() samples using a
+    block state-space form of each section, so that a single channel can also
+    make use of vector instructions.
+
+    The sections can be changed while processing, and setInterpolationTime() lets
+    the coefficients glide smoothly to their new values instead of jumping, which
+    avoids zipper noise when a filter is being modulated. As the set of stable
+    coefficients for a second order section is convex, every intermediate filter
+    is stable if both the old and the new ones are.
+
+    @see Filter, FilterDesign
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class Cascade
+{
+public:
+    //==============================================================================
+    /** A typedef for a ref-counted pointer to the coefficients object */
+    using CoefficientsPtr = typename Coefficients<SampleType>::Ptr;
+
+    //==============================================================================
+    /** Creates a cascade without any sections, which leaves the signal unchanged. */
+    Cascade() = default;
+
+    //==============================================================================
+    /** Replaces the sections of the cascade.
+
+        Each set of coefficients must be for a first or second order filter. Their
+        values are copied, so changing a Coefficients object afterwards has no effect
+        until it's passed to this method again.
+
+        If the number of sections is the same as before and the interpolation time is
+        greater than zero, the coefficients will glide from their current values to
+        the new ones. Otherwise, the new sections are used straight away, and the state
+        is reset if the number of sections has changed.
+    */
+    void setSections (const ReferenceCountedArray<Coefficients<SampleType>>& newSections);
+
+    /** Returns the number of sections in the cascade. */
+    size_t getNumSections() const noexcept                  { return numSections; }
+
+    /** Sets how long the coefficients take to reach new values passed to setSections().
+        A time of zero, which is the default, makes the changes happen immediately.
+    */
+    void setInterpolationTime (double newTimeInSeconds);
+
+    /** Returns the time set by setInterpolationTime(). */
+    double getInterpolationTime() const noexcept            { return interpolationTime; }
+
+    /** Returns true if the coefficients are gliding towards new values. */
+    bool isInterpolating() const noexcept                   { return numInterpolationSamplesRemaining > 0; }
+
+    //==============================================================================
+    /** Initialises the cascade. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the internal state of all the sections, and finishes any interpolation. */
+    void reset();
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+        const auto numChannels = outputBlock.getNumChannels();
+        const auto numSamples  = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumChannels() <= numPreparedChannels);
+        jassert (inputBlock.getNumChannels() == numChannels);
+        jassert (inputBlock.getNumSamples()  == numSamples);
+
+        if (context.isBypassed || numSections == 0)
+        {
+            outputBlock.copyFrom (inputBlock);
+            advanceInterpolation (numSamples);
+            return;
+        }
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+            processChannel (channel, inputBlock.getChannelPointer (channel),
+                            outputBlock.getChannelPointer (channel), numSamples);
+
+        advanceInterpolation (numSamples);
+
+       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+        snapToZero();
+       #endif
+    }
+
+    /** Ensure that the state variables are rounded to zero if the state
+        variables are denormals.
+    */
+    void snapToZero() noexcept;
+
+private:
+    //==============================================================================
+    static constexpr size_t coefficientsPerSection = 5;
+
+    void processChannel (size_t channel, const SampleType* input, SampleType* output, size_t numSamples) noexcept;
+    void processSamples (const SampleType* coeffs, SampleType* channelState,
+                         const SampleType* input, SampleType* output, size_t numSamples) noexcept;
+    void processInterpolatedSamples (SampleType* channelState, const SampleType* input, SampleType* output, size_t numSamples) noexcept;
+    void advanceInterpolation (size_t numSamples) noexcept;
+    void updateBlockCoefficients();
+
+    //==============================================================================
+    size_t numSections = 0, numPreparedChannels = 0;
+    std::vector<SampleType> coefficients, targetCoefficients, coefficientIncrements, state;
+
+    double sampleRate = 44100.0, interpolationTime = 0.0;
+    int numInterpolationSamples = 0, numInterpolationSamplesRemaining = 0;
+
+   #if JUCE_USE_SIMD
+    using SIMDType = SIMDRegister<SampleType>;
+    static constexpr size_t samplesPerBlock = SIMDType::size();
+    static constexpr size_t blockCoefficientsPerSection = samplesPerBlock + 2;
+
+    void processBlocks (SampleType* channelState, const SampleType* input, SampleType* output, size_t numBlocks) noexcept;
+
+    HeapBlock<SIMDType> blockCoefficientsMemory;
+    SIMDType* blockCoefficients = nullptr;
+   #endif
+
+    JUCE_LEAK_DETECTOR (Cascade)
+};
+
+} // namespace IIR
+} // namespace dsp
+} // namespace juce
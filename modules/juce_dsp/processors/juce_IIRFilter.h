@@ -396,7 +396,149 @@ namespace IIR
 
         JUCE_LEAK_DETECTOR (Filter)
     };
+
+   #if JUCE_USE_SIMD || DOXYGEN
+    //==============================================================================
+    /**
+        A processing class that performs IIR filtering on several channels at once.
+
+        Because each output sample of an IIR filter depends on the previous ones, a
+        single Filter can't make use of SIMD instructions. Instead, this class packs
+        the same sample from several different channels into the lanes of a
+        SIMDRegister, and runs the Transposed Direct Form II recurrence on all of them
+        at once. The output is the same as that of running a separate Filter on each
+        channel, but a multi-channel stream gets processed several channels at a time.
+
+        Each channel can be given its own coefficients, and the channels don't need
+        to use filters of the same order.
+
+        You don't normally need to use this class directly: a ProcessorDuplicator of
+        IIR::Filter<float> or IIR::Filter<double> objects will use one automatically.
+
+        @see Filter, ProcessorDuplicator
+
+        @tags{DSP}
+    */
+    template <typename NumericType>
+    class MultiChannelFilter
+    {
+    public:
+        /** A typedef for a ref-counted pointer to the coefficients object */
+        using CoefficientsPtr = typename Coefficients<NumericType>::Ptr;
+
+        //==============================================================================
+        /** Creates a filter.
+
+            Initially the filter is inactive, so will have no effect on samples that
+            you process with it.
+        */
+        MultiChannelFilter();
+
+        /** Creates a filter which uses the same set of coefficients for all channels. */
+        MultiChannelFilter (CoefficientsPtr coefficientsForAllChannels);
+
+        //==============================================================================
+        /** Makes all of the channels use the same set of coefficients.
+
+            This will also be used for any extra channels if prepare() is called with
+            a larger number of channels later on.
+        */
+        void setCoefficients (CoefficientsPtr newCoefficients);
+
+        /** Gives a channel its own set of coefficients.
+            The channel index must be less than the number of channels passed to prepare().
+        */
+        void setCoefficients (size_t channel, CoefficientsPtr newCoefficients);
+
+        /** Returns the coefficients that a channel is using. */
+        CoefficientsPtr getCoefficients (size_t channel) const noexcept;
+
+        /** Returns the number of channels that the filter was prepared for. */
+        size_t getNumChannels() const noexcept      { return channelCoefficients.size(); }
+
+        /** Returns true if this class is likely to process the given number of channels
+            more quickly than a separate Filter for each one would.
+
+            Interleaving the channels has a cost, so it only pays off when at least half
+            of the lanes of a SIMDRegister get used.
+        */
+        static constexpr bool isWorthUsingFor (size_t numChannels) noexcept
+        {
+            return numChannels > 1 && numChannels * 2 > SIMDRegister<NumericType>::size();
+        }
+
+        //==============================================================================
+        /** Resets the filter's processing pipeline, ready to start a new stream of data.
+
+            Note that this clears the processing state, but the type of filter and
+            its coefficients aren't changed.
+        */
+        void reset() noexcept;
+
+        /** Called before processing starts. */
+        void prepare (const ProcessSpec&);
+
+        /** Processes a block of samples */
+        template <typename ProcessContext>
+        void process (const ProcessContext& context) noexcept
+        {
+            if (context.isBypassed)
+                processInternal<ProcessContext, true> (context);
+            else
+                processInternal<ProcessContext, false> (context);
+        }
+
+    private:
+        //==============================================================================
+        using SIMDType = SIMDRegister<NumericType>;
+        static constexpr size_t numLanes = SIMDType::size();
+        static constexpr size_t samplesPerChunk = 32;
+
+        void check();
+        void updateLaneCoefficients (size_t group) noexcept;
+        void snapToZero (size_t group) noexcept;
+
+        SIMDType* getLaneCoefficients (size_t group) const noexcept  { return state + group * (3 * order + 1); }
+        SIMDType* getLaneState (size_t group) const noexcept         { return getLaneCoefficients (group) + 2 * order + 1; }
+
+        template <typename ProcessContext, bool isBypassed>
+        void processInternal (const ProcessContext& context) noexcept;
+
+        template <bool isBypassed, size_t fixedOrder>
+        void processChunk (size_t numSamples, size_t numActiveGroups) noexcept;
+
+        //==============================================================================
+        CoefficientsPtr coefficientsForNewChannels;
+        std::vector<CoefficientsPtr> channelCoefficients;
+        std::vector<size_t> channelOrders;
+
+        HeapBlock<SIMDType> memory, chunkMemory;
+        SIMDType* state = nullptr;
+        SIMDType* chunk = nullptr;
+        size_t order = 0, numGroups = 0;
+
+        JUCE_LEAK_DETECTOR (MultiChannelFilter)
+    };
+   #endif
 } // namespace IIR
+
+#if JUCE_USE_SIMD && ! defined (DOXYGEN)
+namespace detail
+{
+    template <>
+    struct MultiChannelProcessorFor<IIR::Filter<float>, IIR::Coefficients<float>>
+    {
+        using Type = IIR::MultiChannelFilter<float>;
+    };
+
+    template <>
+    struct MultiChannelProcessorFor<IIR::Filter<double>, IIR::Coefficients<double>>
+    {
+        using Type = IIR::MultiChannelFilter<double>;
+    };
+}
+#endif
+
 } // namespace dsp
 } // namespace juce
 
@@ -238,6 +238,250 @@ void Filter<SampleType>::check()
         reset();
 }
 
+//==============================================================================
+#if JUCE_USE_SIMD
+
+template <typename NumericType>
+MultiChannelFilter<NumericType>::MultiChannelFilter()
+    : coefficientsForNewChannels (new Coefficients<NumericType> (1, 0, 1, 0))
+{
+}
+
+template <typename NumericType>
+MultiChannelFilter<NumericType>::MultiChannelFilter (CoefficientsPtr c)
+    : coefficientsForNewChannels (std::move (c))
+{
+    jassert (coefficientsForNewChannels != nullptr);
+}
+
+template <typename NumericType>
+void MultiChannelFilter<NumericType>::setCoefficients (CoefficientsPtr newCoefficients)
+{
+    jassert (newCoefficients != nullptr);
+    coefficientsForNewChannels = newCoefficients;
+
+    for (auto& c : channelCoefficients)
+        c = newCoefficients;
+}
+
+template <typename NumericType>
+void MultiChannelFilter<NumericType>::setCoefficients (size_t channel, CoefficientsPtr newCoefficients)
+{
+    jassert (newCoefficients != nullptr);
+    jassert (channel < channelCoefficients.size());
+
+    if (channel < channelCoefficients.size())
+        channelCoefficients[channel] = std::move (newCoefficients);
+}
+
+template <typename NumericType>
+typename MultiChannelFilter<NumericType>::CoefficientsPtr MultiChannelFilter<NumericType>::getCoefficients (size_t channel) const noexcept
+{
+    return channel < channelCoefficients.size() ? channelCoefficients[channel] : CoefficientsPtr();
+}
+
+template <typename NumericType>
+void MultiChannelFilter<NumericType>::prepare (const ProcessSpec& spec)
+{
+    channelCoefficients.resize (spec.numChannels, coefficientsForNewChannels);
+    channelOrders.assign (spec.numChannels, 0);
+    numGroups = (spec.numChannels + numLanes - 1) / numLanes;
+
+    chunkMemory.malloc (numGroups * samplesPerChunk + 1);
+    chunk = snapPointerToAlignment (chunkMemory.getData(), sizeof (SIMDType));
+
+    memory.free();
+    state = nullptr;
+    order = 0;
+
+    check();
+}
+
+template <typename NumericType>
+void MultiChannelFilter<NumericType>::reset() noexcept
+{
+    for (size_t group = 0; group < numGroups; ++group)
+        std::fill (getLaneState (group), getLaneState (group) + order, SIMDType::expand (0));
+}
+
+template <typename NumericType>
+void MultiChannelFilter<NumericType>::check()
+{
+    size_t newOrder = 1;
+
+    for (auto& c : channelCoefficients)
+    {
+        jassert (c != nullptr);
+        newOrder = jmax (newOrder, c->getFilterOrder());
+    }
+
+    if (newOrder > order || state == nullptr)
+    {
+        // When a channel's order goes up, the state of the other channels is kept so
+        // that they carry on without a glitch
+        HeapBlock<SIMDType> newMemory (numGroups * (3 * newOrder + 1) + 1, true);
+        auto* newState = snapPointerToAlignment (newMemory.getData(), sizeof (SIMDType));
+
+        for (size_t group = 0; group < numGroups; ++group)
+            std::copy (getLaneState (group), getLaneState (group) + order,
+                       newState + group * (3 * newOrder + 1) + 2 * newOrder + 1);
+
+        std::swap (memory, newMemory);
+        state = newState;
+        order = newOrder;
+    }
+
+    for (size_t channel = 0; channel < channelCoefficients.size(); ++channel)
+    {
+        auto channelOrder = channelCoefficients[channel]->getFilterOrder();
+
+        if (channelOrders[channel] != channelOrder)
+        {
+            // Like a Filter, a channel starts again from silence if its order changes
+            auto* laneState = reinterpret_cast<NumericType*> (getLaneState (channel / numLanes));
+
+            for (size_t i = 0; i < order; ++i)
+                laneState[i * numLanes + channel % numLanes] = 0;
+
+            channelOrders[channel] = channelOrder;
+        }
+    }
+}
+
+template <typename NumericType>
+void MultiChannelFilter<NumericType>::updateLaneCoefficients (size_t group) noexcept
+{
+    // Channels with a lower order than the others get zero coefficients for the
+    // extra stages, which leaves their output unchanged
+    auto* laneCoeffs = reinterpret_cast<NumericType*> (getLaneCoefficients (group));
+    std::fill (laneCoeffs, laneCoeffs + (2 * order + 1) * numLanes, NumericType());
+
+    for (size_t lane = 0; lane < numLanes; ++lane)
+    {
+        auto channel = group * numLanes + lane;
+
+        if (channel >= channelCoefficients.size())
+            break;
+
+        auto* coeffs = channelCoefficients[channel]->getRawCoefficients();
+        auto channelOrder = channelOrders[channel];
+
+        for (size_t i = 0; i <= channelOrder; ++i)
+            laneCoeffs[i * numLanes + lane] = coeffs[i];
+
+        for (size_t i = 1; i <= channelOrder; ++i)
+            laneCoeffs[(order + i) * numLanes + lane] = coeffs[channelOrder + i];
+    }
+}
+
+template <typename NumericType>
+void MultiChannelFilter<NumericType>::snapToZero (size_t group) noexcept
+{
+    auto* laneState = reinterpret_cast<NumericType*> (getLaneState (group));
+
+    for (size_t i = 0; i < order * numLanes; ++i)
+        util::snapToZero (laneState[i]);
+}
+
+template <typename NumericType>
+template <typename ProcessContext, bool bypassed>
+void MultiChannelFilter<NumericType>::processInternal (const ProcessContext& context) noexcept
+{
+    static_assert (std::is_same_v<typename ProcessContext::SampleType, NumericType>,
+                   "The sample-type of the IIR filter must match the sample-type supplied to this process callback");
+    check();
+
+    auto&& inputBlock  = context.getInputBlock();
+    auto&& outputBlock = context.getOutputBlock();
+
+    jassert (inputBlock.getNumChannels()  <= getNumChannels());
+    jassert (outputBlock.getNumChannels() <= getNumChannels());
+    jassert (inputBlock.getNumSamples() == outputBlock.getNumSamples());
+
+    auto numChannels = jmin (inputBlock.getNumChannels(), outputBlock.getNumChannels(), getNumChannels());
+    auto numSamples = inputBlock.getNumSamples();
+    auto numActiveGroups = (numChannels + numLanes - 1) / numLanes;
+
+    for (size_t group = 0; group < numActiveGroups; ++group)
+        updateLaneCoefficients (group);
+
+    // Each sample of the chunk holds one lane for every channel, so the channels are
+    // spread across the lanes of consecutive SIMDRegisters
+    auto* interleaved = reinterpret_cast<NumericType*> (chunk);
+    auto stride = numActiveGroups * numLanes;
+
+    for (size_t start = 0; start < numSamples; start += samplesPerChunk)
+    {
+        auto numChunkSamples = jmin (samplesPerChunk, numSamples - start);
+
+        for (size_t channel = 0; channel < stride; ++channel)
+        {
+            if (channel < numChannels)
+            {
+                auto* src = inputBlock.getChannelPointer (channel) + start;
+
+                for (size_t i = 0; i < numChunkSamples; ++i)
+                    interleaved[i * stride + channel] = src[i];
+            }
+            else
+            {
+                for (size_t i = 0; i < numChunkSamples; ++i)
+                    interleaved[i * stride + channel] = 0;
+            }
+        }
+
+        switch (order)
+        {
+            case 1:   processChunk<bypassed, 1> (numChunkSamples, numActiveGroups); break;
+            case 2:   processChunk<bypassed, 2> (numChunkSamples, numActiveGroups); break;
+            case 3:   processChunk<bypassed, 3> (numChunkSamples, numActiveGroups); break;
+            case 4:   processChunk<bypassed, 4> (numChunkSamples, numActiveGroups); break;
+            default:  processChunk<bypassed, 0> (numChunkSamples, numActiveGroups); break;
+        }
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* dst = outputBlock.getChannelPointer (channel) + start;
+
+            for (size_t i = 0; i < numChunkSamples; ++i)
+                dst[i] = interleaved[i * stride + channel];
+        }
+    }
+
+    for (size_t group = 0; group < numActiveGroups; ++group)
+        snapToZero (group);
+}
+
+template <typename NumericType>
+template <bool bypassed, size_t fixedOrder>
+void MultiChannelFilter<NumericType>::processChunk (size_t numSamples, size_t numActiveGroups) noexcept
+{
+    // The groups are independent of each other, so running them side by side for each
+    // sample avoids having to wait for the result of one sample before starting the next
+    const auto filterOrder = fixedOrder != 0 ? fixedOrder : order;
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto* samples = chunk + i * numActiveGroups;
+
+        for (size_t group = 0; group < numActiveGroups; ++group)
+        {
+            auto* coeffs = getLaneCoefficients (group);
+            auto* lv = getLaneState (group);
+
+            auto input = samples[group];
+            auto output = (input * coeffs[0]) + lv[0];
+            samples[group] = bypassed ? input : output;
+
+            for (size_t j = 0; j < filterOrder - 1; ++j)
+                lv[j] = (input * coeffs[j + 1]) - (output * coeffs[filterOrder + j + 1]) + lv[j + 1];
+
+            lv[filterOrder - 1] = (input * coeffs[filterOrder]) - (output * coeffs[filterOrder * 2]);
+        }
+    }
+}
+
+#endif
 #endif
 
 } // namespace IIR
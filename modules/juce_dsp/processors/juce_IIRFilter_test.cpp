@@ -0,0 +1,340 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class IIRFilterTest : public UnitTest
+{
+public:
+    IIRFilterTest()
+        : UnitTest ("IIR Filter", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+       #if JUCE_USE_SIMD
+        runMultiChannelTests<float>();
+        runMultiChannelTests<double>();
+       #endif
+
+        runCascadeTests<float>();
+        runCascadeTests<double>();
+    }
+
+private:
+    template <typename Type>
+    void expectBuffersAreSimilar (const AudioBuffer<Type>& a, const AudioBuffer<Type>& b, Type tolerance = (Type) 1.0e-5)
+    {
+        expectLessThan (AudioBufferTestHelpers::getMaxDifference (a, b), tolerance);
+    }
+
+    template <typename Type>
+    static Type getMaxStep (const AudioBuffer<Type>& buffer)
+    {
+        auto maxStep = (Type) 0;
+
+        for (int i = 1; i < buffer.getNumSamples(); ++i)
+            maxStep = jmax (maxStep, std::abs (buffer.getSample (0, i) - buffer.getSample (0, i - 1)));
+
+        return maxStep;
+    }
+
+    template <typename Type>
+    void runCascadeTests()
+    {
+        using namespace AudioBufferTestHelpers;
+
+        constexpr auto sampleRate = 48000.0;
+        Random random (0x4321);
+
+        beginTest ("Cascade matches a chain of separate filters");
+        {
+            constexpr int numChannels = 2;
+
+            for (auto order : { 1, 2, 7, 12 })
+            {
+                auto sections = FilterDesign<Type>::designIIRLowpassHighOrderButterworthMethod ((Type) 3000, sampleRate, order);
+
+                IIR::Cascade<Type> cascade;
+                cascade.setSections (sections);
+                cascade.prepare ({ sampleRate, 512, (uint32) numChannels });
+                expectEquals (cascade.getNumSections(), (size_t) sections.size());
+
+                std::vector<std::vector<IIR::Filter<Type>>> reference (numChannels);
+
+                for (auto& filters : reference)
+                    for (auto* section : sections)
+                        filters.emplace_back (section);
+
+                for (auto blockSize : { 1, 3, 64, 301, 512 })
+                {
+                    auto expected = makeNoise<Type> (random, numChannels, blockSize);
+                    AudioBuffer<Type> actual (expected);
+
+                    for (size_t ch = 0; ch < numChannels; ++ch)
+                    {
+                        for (auto& filter : reference[ch])
+                        {
+                            auto block = AudioBlock<Type> (expected).getSingleChannelBlock (ch);
+                            filter.process (ProcessContextReplacing<Type> (block));
+                        }
+                    }
+
+                    AudioBlock<Type> block (actual);
+                    cascade.process (ProcessContextReplacing<Type> (block));
+
+                    expectBuffersAreSimilar (expected, actual, (Type) 1.0e-4);
+                }
+            }
+        }
+
+        beginTest ("Cascade interpolates between coefficients");
+        {
+            auto makeSections = [&] (Type gain)
+            {
+                ReferenceCountedArray<IIR::Coefficients<Type>> sections;
+                sections.add (IIR::Coefficients<Type>::makeLowShelf (sampleRate, (Type) 500, (Type) 0.7, gain));
+                sections.add (IIR::Coefficients<Type>::makeLowPass (sampleRate, (Type) 8000));
+                return sections;
+            };
+
+            auto processDC = [] (IIR::Cascade<Type>& cascade, int numSamples)
+            {
+                AudioBuffer<Type> buffer (1, numSamples);
+
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample (0, i, (Type) 1);
+
+                AudioBlock<Type> block (buffer);
+                cascade.process (ProcessContextReplacing<Type> (block));
+                return buffer;
+            };
+
+            IIR::Cascade<Type> immediate, interpolated;
+            interpolated.setInterpolationTime (0.01);
+
+            for (auto* cascade : { &immediate, &interpolated })
+            {
+                cascade->setSections (makeSections ((Type) 1));
+                cascade->prepare ({ sampleRate, 512, 1 });
+                processDC (*cascade, 4800);
+                cascade->setSections (makeSections ((Type) 4));
+            }
+
+            expect (! immediate.isInterpolating());
+            expect (interpolated.isInterpolating());
+
+            auto immediateOutput = processDC (immediate, 400);
+            auto interpolatedOutput = processDC (interpolated, 400);
+
+            expect (interpolated.isInterpolating());
+            expectLessThan (getMaxStep (interpolatedOutput) * 5, getMaxStep (immediateOutput));
+
+            processDC (interpolated, 80);
+            expect (! interpolated.isInterpolating());
+
+            // Once the interpolation has finished, both cascades settle on the same filter
+            immediateOutput = processDC (immediate, 4800);
+            interpolatedOutput = processDC (interpolated, 4800);
+            expectWithinAbsoluteError (interpolatedOutput.getSample (0, 4799), (Type) 4, (Type) 1.0e-3);
+            expectWithinAbsoluteError (immediateOutput.getSample (0, 4799), (Type) 4, (Type) 1.0e-3);
+        }
+    }
+
+   #if JUCE_USE_SIMD
+    template <typename Type>
+    using CoefficientsPtr = typename IIR::Coefficients<Type>::Ptr;
+
+    template <typename Type>
+    static std::vector<CoefficientsPtr<Type>> getTestCoefficients()
+    {
+        constexpr auto sampleRate = 48000.0;
+
+        return { IIR::Coefficients<Type>::makeFirstOrderLowPass (sampleRate, (Type) 1000),
+                 IIR::Coefficients<Type>::makePeakFilter (sampleRate, (Type) 2500, (Type) 0.7, (Type) 2),
+                 IIR::Coefficients<Type>::makeHighPass (sampleRate, (Type) 80),
+                 new IIR::Coefficients<Type> ((Type) 0.2, (Type) 0.3, (Type) 0.2, (Type) 0.1,
+                                              (Type) 1, (Type) -0.5, (Type) 0.25, (Type) -0.125),
+                 new IIR::Coefficients<Type> (std::array<Type, 12> { { (Type) 0.1, (Type) 0.2, (Type) 0.3, (Type) 0.2, (Type) 0.1, (Type) 0.05,
+                                                                       (Type) 1, (Type) -0.2, (Type) 0.1, (Type) -0.05, (Type) 0.02, (Type) -0.01 } }) };
+    }
+
+    template <typename Type>
+    static std::vector<IIR::Filter<Type>> makeFilters (size_t numChannels, CoefficientsPtr<Type> coefficients)
+    {
+        std::vector<IIR::Filter<Type>> filters;
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            filters.emplace_back (coefficients);
+
+        return filters;
+    }
+
+    // Runs a block through a separate IIR::Filter for each channel
+    template <typename Type>
+    static void processReference (std::vector<IIR::Filter<Type>>& filters, AudioBuffer<Type>& buffer, bool bypassed)
+    {
+        for (size_t ch = 0; ch < filters.size(); ++ch)
+        {
+            auto block = AudioBlock<Type> (buffer).getSingleChannelBlock (ch);
+            ProcessContextReplacing<Type> context (block);
+            context.isBypassed = bypassed;
+            filters[ch].process (context);
+        }
+    }
+
+    template <typename Type, typename Processor>
+    static void processMultiChannel (Processor& processor, AudioBuffer<Type>& buffer, bool bypassed)
+    {
+        AudioBlock<Type> block (buffer);
+        ProcessContextReplacing<Type> context (block);
+        context.isBypassed = bypassed;
+        processor.process (context);
+    }
+
+    template <typename Type>
+    void runMultiChannelTests()
+    {
+        using namespace AudioBufferTestHelpers;
+
+        Random random (0x1234);
+        auto allCoefficients = getTestCoefficients<Type>();
+        const int blockSizes[] = { 1, 37, 64, 300, 512 };
+
+        beginTest ("ProcessorDuplicator matches separate filters");
+        {
+            for (auto numChannels : { 1, 2, 3, 8, 13 })
+            {
+                for (auto& coefficients : allCoefficients)
+                {
+                    ProcessorDuplicator<IIR::Filter<Type>, IIR::Coefficients<Type>> duplicator (coefficients);
+                    duplicator.prepare ({ 48000.0, 512, (uint32) numChannels });
+
+                    auto reference = makeFilters<Type> ((size_t) numChannels, coefficients);
+
+                    for (auto blockSize : blockSizes)
+                    {
+                        auto expected = makeNoise<Type> (random, numChannels, blockSize);
+                        AudioBuffer<Type> actual (expected);
+
+                        processReference (reference, expected, false);
+                        processMultiChannel (duplicator, actual, false);
+                        expectBuffersAreSimilar (expected, actual);
+                    }
+                }
+            }
+        }
+
+        beginTest ("Per-channel coefficients of different orders");
+        {
+            constexpr int numChannels = 11;
+
+            IIR::MultiChannelFilter<Type> filter;
+            filter.prepare ({ 48000.0, 512, (uint32) numChannels });
+
+            std::vector<IIR::Filter<Type>> reference;
+
+            for (size_t ch = 0; ch < (size_t) numChannels; ++ch)
+            {
+                auto& coefficients = allCoefficients[(ch * 3) % allCoefficients.size()];
+                filter.setCoefficients (ch, coefficients);
+                reference.emplace_back (coefficients);
+            }
+
+            expect (filter.getCoefficients (1) == allCoefficients[3]);
+
+            for (auto blockSize : blockSizes)
+            {
+                auto expected = makeNoise<Type> (random, numChannels, blockSize);
+                AudioBuffer<Type> actual (expected);
+
+                processReference (reference, expected, false);
+                processMultiChannel (filter, actual, false);
+                expectBuffersAreSimilar (expected, actual);
+            }
+
+            // Changing a channel's order restarts that channel, as it would for a Filter
+            filter.setCoefficients (2, allCoefficients[4]);
+            reference[2].coefficients = allCoefficients[4];
+
+            filter.setCoefficients (5, allCoefficients[0]);
+            reference[5].coefficients = allCoefficients[0];
+
+            for (auto blockSize : blockSizes)
+            {
+                auto expected = makeNoise<Type> (random, numChannels, blockSize);
+                AudioBuffer<Type> actual (expected);
+
+                processReference (reference, expected, false);
+                processMultiChannel (filter, actual, false);
+                expectBuffersAreSimilar (expected, actual);
+            }
+        }
+
+        beginTest ("Bypassed blocks pass the input through and keep the state running");
+        {
+            constexpr int numChannels = 6;
+
+            IIR::MultiChannelFilter<Type> filter (allCoefficients[1]);
+            filter.prepare ({ 48000.0, 512, (uint32) numChannels });
+
+            auto reference = makeFilters<Type> ((size_t) numChannels, allCoefficients[1]);
+
+            for (auto bypassed : { false, true, false })
+            {
+                auto input = makeNoise<Type> (random, numChannels, 200);
+
+                AudioBuffer<Type> expected (input), actual (input);
+                processReference (reference, expected, bypassed);
+                processMultiChannel (filter, actual, bypassed);
+                expectBuffersAreSimilar (expected, actual);
+
+                if (bypassed)
+                    expectBuffersAreSimilar (input, actual);
+            }
+
+            filter.reset();
+
+            for (auto& f : reference)
+                f.reset();
+
+            auto expected = makeNoise<Type> (random, numChannels, 100);
+            AudioBuffer<Type> actual (expected);
+
+            processReference (reference, expected, false);
+            processMultiChannel (filter, actual, false);
+            expectBuffersAreSimilar (expected, actual);
+        }
+    }
+   #endif
+};
+
+static IIRFilterTest iirFilterUnitTest;
+
+} // namespace dsp
+} // namespace juce
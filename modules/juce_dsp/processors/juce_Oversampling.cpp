@@ -28,13 +28,80 @@ namespace juce
 namespace dsp
 {
 
+/** Holds the filter designs used by the oversampling stages, so that all the
+    Oversampling objects using the same settings share a single copy of their
+    coefficients instead of running the filter design again for each instance.
+    It's used through a SharedResourcePointer, so it's deleted along with the last
+    stage using it.
+*/
+template <typename SampleType>
+struct OversamplingDesignCache
+{
+    struct Design  : public ReferenceCountedObject
+    {
+        using Ptr = ReferenceCountedObjectPtr<Design>;
+
+        std::vector<SampleType> coefficients;
+        SampleType latency = 0;
+    };
+
+    enum class DesignType
+    {
+        halfBandFIR,
+        halfBandPolyphaseIIR,
+        polyphaseFIRUp,
+        polyphaseFIRDown
+    };
+
+    /** Returns the design with the given settings, calling createDesign() to make it
+        if it isn't in the cache yet.
+    */
+    template <typename DesignFunction>
+    typename Design::Ptr getDesign (DesignType type, size_t factor,
+                                    SampleType normalisedTransitionWidth, SampleType stopbandAmplitudedB,
+                                    DesignFunction&& createDesign)
+    {
+        const ScopedLock sl (lock);
+
+        for (auto& entry : entries)
+            if (entry.type == type && entry.factor == factor
+                 && entry.normalisedTransitionWidth == normalisedTransitionWidth
+                 && entry.stopbandAmplitudedB == stopbandAmplitudedB)
+                return entry.design;
+
+        typename Design::Ptr design (new Design());
+        createDesign (*design);
+        entries.push_back ({ type, factor, normalisedTransitionWidth, stopbandAmplitudedB, design });
+
+        return design;
+    }
+
+private:
+    struct Entry
+    {
+        DesignType type;
+        size_t factor;
+        SampleType normalisedTransitionWidth, stopbandAmplitudedB;
+        typename Design::Ptr design;
+    };
+
+    CriticalSection lock;
+    std::vector<Entry> entries;
+};
+
+//==============================================================================
 /** Abstract class for the provided oversampling stages used internally in
     the Oversampling class.
 */
 template <typename SampleType>
 struct Oversampling<SampleType>::OversamplingStage
 {
-    OversamplingStage (size_t numChans, size_t newFactor)  : numChannels (numChans), factor (newFactor) {}
+    OversamplingStage (size_t numChans, size_t newFactor)
+        : numChannels (numChans), factor (newFactor),
+          chunk (samplesPerChunk * (newFactor + 1))
+    {
+    }
+
     virtual ~OversamplingStage() {}
 
     //==============================================================================
@@ -62,6 +129,129 @@ struct Oversampling<SampleType>::OversamplingStage
 
     AudioBuffer<SampleType> buffer;
     size_t numChannels, factor;
+
+protected:
+    //==============================================================================
+    /*  When there are enough channels to make it worth it, the filters run on groups
+        of channels, with one channel in each lane of a LanesType. The samples are then
+        moved in and out of the lanes in chunks of samplesPerChunk samples at the lower
+        sample rate. Otherwise, each channel is a group of its own and is processed in
+        place, using plain SampleType values.
+    */
+    using LanesType = typename detail::SIMDLanes<SampleType>::Type;
+
+    static constexpr size_t numLanes = detail::SIMDLanes<SampleType>::numLanes;
+    static constexpr size_t samplesPerChunk = 32;
+
+    static size_t getNumGroups (size_t numChans) noexcept
+    {
+        return (numChans + numLanes - 1) / numLanes;
+    }
+
+    /** Resizes a state vector to hold sizePerGroup values for each group of channels. */
+    void resizeState (std::vector<LanesType>& state, size_t sizePerGroup) const
+    {
+        auto numValuesPerGroup = useLanes ? numLanes : 1;
+        auto numGroups = useLanes ? getNumGroups (numChannels) : numChannels;
+
+        state.resize ((numGroups * numValuesPerGroup * sizePerGroup + numLanes - 1) / numLanes);
+    }
+
+    template <typename Lanes>
+    static Lanes* getState (std::vector<LanesType>& state, size_t group, size_t sizePerGroup) noexcept
+    {
+        return reinterpret_cast<Lanes*> (state.data()) + group * sizePerGroup;
+    }
+
+    static void snapToZero (std::vector<LanesType>& state) noexcept
+    {
+        auto* s = detail::SIMDLanes<SampleType>::getLanes (state.data());
+
+        for (size_t i = 0; i < state.size() * numLanes; ++i)
+            util::snapToZero (s[i]);
+    }
+
+    /** Calls process (inputs, outputs, group, numSamples) for each group of channels,
+        where the inputs hold numSamples * inputFactor samples and the outputs
+        numSamples * outputFactor samples.
+    */
+    template <typename Lanes, typename ProcessFunction>
+    void processGroups (const AudioBlock<const SampleType>& inputBlock, const AudioBlock<SampleType>& outputBlock,
+                        size_t numSamples, size_t inputFactor, size_t outputFactor, ProcessFunction&& process) noexcept
+    {
+        const auto numChans = jmin (inputBlock.getNumChannels(), outputBlock.getNumChannels());
+
+        if constexpr (std::is_same_v<Lanes, SampleType>)
+        {
+            for (size_t channel = 0; channel < numChans; ++channel)
+                process (inputBlock.getChannelPointer (channel), outputBlock.getChannelPointer (channel), channel, numSamples);
+        }
+        else
+        {
+            auto* inputs  = chunk.data();
+            auto* outputs = inputs + samplesPerChunk * inputFactor;
+
+            for (size_t group = 0; group < getNumGroups (numChans); ++group)
+            {
+                for (size_t start = 0; start < numSamples; start += samplesPerChunk)
+                {
+                    auto num = jmin (samplesPerChunk, numSamples - start);
+
+                    interleave (inputBlock, group, start * inputFactor, num * inputFactor, inputs);
+                    process (static_cast<const LanesType*> (inputs), outputs, group, num);
+                    deinterleave (outputs, num * outputFactor, outputBlock, group, start * outputFactor);
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    using DesignCache = OversamplingDesignCache<SampleType>;
+    using DesignType  = typename DesignCache::DesignType;
+    using DesignPtr   = typename DesignCache::Design::Ptr;
+
+    SharedResourcePointer<DesignCache> designCache;
+    std::vector<LanesType> chunk;
+
+    // Using the lanes doesn't pay off when most of them would be left empty
+    const bool useLanes = numChannels * 2 > numLanes;
+
+private:
+    //==============================================================================
+    static void interleave (const AudioBlock<const SampleType>& block, size_t group,
+                            size_t startSample, size_t numSamples, LanesType* destination) noexcept
+    {
+        auto* dest = detail::SIMDLanes<SampleType>::getLanes (destination);
+        const auto firstChannel = group * numLanes;
+        const auto numChannelsInGroup = jmin (numLanes, block.getNumChannels() - firstChannel);
+
+        if (numChannelsInGroup < numLanes)
+            std::fill (dest, dest + numSamples * numLanes, SampleType());
+
+        for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+        {
+            auto* src = block.getChannelPointer (firstChannel + lane) + startSample;
+
+            for (size_t i = 0; i < numSamples; ++i)
+                dest[i * numLanes + lane] = src[i];
+        }
+    }
+
+    static void deinterleave (const LanesType* source, size_t numSamples,
+                              const AudioBlock<SampleType>& block, size_t group, size_t startSample) noexcept
+    {
+        auto* src = detail::SIMDLanes<SampleType>::getLanes (source);
+        const auto firstChannel = group * numLanes;
+        const auto numChannelsInGroup = jmin (numLanes, block.getNumChannels() - firstChannel);
+
+        for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+        {
+            auto* dest = block.getChannelPointer (firstChannel + lane) + startSample;
+
+            for (size_t i = 0; i < numSamples; ++i)
+                dest[i] = src[i * numLanes + lane];
+        }
+    }
 };
 
 
@@ -113,6 +303,9 @@ template <typename SampleType>
 struct Oversampling2TimesEquirippleFIR  : public Oversampling<SampleType>::OversamplingStage
 {
     using ParentType = typename Oversampling<SampleType>::OversamplingStage;
+    using typename ParentType::LanesType;
+    using typename ParentType::DesignType;
+    using typename ParentType::DesignPtr;
 
     Oversampling2TimesEquirippleFIR (size_t numChans,
                                      SampleType normalisedTransitionWidthUp,
@@ -121,37 +314,38 @@ struct Oversampling2TimesEquirippleFIR  : public Oversampling<SampleType>::Overs
                                      SampleType stopbandAmplitudedBDown)
         : ParentType (numChans, 2)
     {
-        coefficientsUp   = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthUp,   stopbandAmplitudedBUp);
-        coefficientsDown = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthDown, stopbandAmplitudedBDown);
-
-        auto N = coefficientsUp.getFilterOrder() + 1;
-        stateUp.setSize (static_cast<int> (this->numChannels), static_cast<int> (N));
-
-        N = coefficientsDown.getFilterOrder() + 1;
-        auto Ndiv2 = N / 2;
-        auto Ndiv4 = Ndiv2 / 2;
-
-        stateDown.setSize  (static_cast<int> (this->numChannels), static_cast<int> (N));
-        stateDown2.setSize (static_cast<int> (this->numChannels), static_cast<int> (Ndiv4 + 1));
-
-        position.resize (static_cast<int> (this->numChannels));
+        designUp   = getDesign (normalisedTransitionWidthUp,   stopbandAmplitudedBUp);
+        designDown = getDesign (normalisedTransitionWidthDown, stopbandAmplitudedBDown);
+
+        // Only the samples with an even index are kept in the states, as the other
+        // ones are only ever multiplied by zero coefficients. They are written twice,
+        // so that the latest ones can always be read from contiguous memory.
+        ParentType::resizeState (stateUp,    2 * getNumEvenSamples (designUp));
+        ParentType::resizeState (stateDown,  2 * getNumEvenSamples (designDown));
+        ParentType::resizeState (stateDown2, getNumCoefficients (designDown) / 4 + 1);
+
+        positionUp.resize    (this->numChannels);
+        positionDown.resize  (this->numChannels);
+        positionDown2.resize (this->numChannels);
     }
 
     //==============================================================================
     SampleType getLatencyInSamples() const override
     {
-        return static_cast<SampleType> (coefficientsUp.getFilterOrder() + coefficientsDown.getFilterOrder()) * 0.5f;
+        return designUp->latency + designDown->latency;
     }
 
     void reset() override
     {
         ParentType::reset();
 
-        stateUp.clear();
-        stateDown.clear();
-        stateDown2.clear();
+        std::fill (stateUp.begin(),    stateUp.end(),    LanesType());
+        std::fill (stateDown.begin(),  stateDown.end(),  LanesType());
+        std::fill (stateDown2.begin(), stateDown2.end(), LanesType());
 
-        position.fill (0);
+        std::fill (positionUp.begin(),    positionUp.end(),    (size_t) 0);
+        std::fill (positionDown.begin(),  positionDown.end(),  (size_t) 0);
+        std::fill (positionDown2.begin(), positionDown2.end(), (size_t) 0);
     }
 
     void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
@@ -159,97 +353,136 @@ struct Oversampling2TimesEquirippleFIR  : public Oversampling<SampleType>::Overs
         jassert (inputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
         jassert (inputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
 
+        if (ParentType::useLanes)
+            processUp<LanesType> (inputBlock);
+        else
+            processUp<SampleType> (inputBlock);
+    }
+
+    void processSamplesDown (AudioBlock<SampleType>& outputBlock) override
+    {
+        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
+        jassert (outputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
+
+        if (ParentType::useLanes)
+            processDown<LanesType> (outputBlock);
+        else
+            processDown<SampleType> (outputBlock);
+    }
+
+private:
+    //==============================================================================
+    template <typename Lanes>
+    void processUp (const AudioBlock<const SampleType>& inputBlock) noexcept
+    {
         // Initialization
-        auto fir = coefficientsUp.getRawCoefficients();
-        auto N = coefficientsUp.getFilterOrder() + 1;
+        auto fir = designUp->coefficients.data();
+        auto N = getNumCoefficients (designUp);
         auto Ndiv2 = N / 2;
-        auto numSamples = inputBlock.getNumSamples();
+        auto M = getNumEvenSamples (designUp);
 
         // Processing
-        for (size_t channel = 0; channel < inputBlock.getNumChannels(); ++channel)
+        ParentType::template processGroups<Lanes> (inputBlock, AudioBlock<SampleType> (ParentType::buffer), inputBlock.getNumSamples(), 1, 2,
+                                                   [&] (const Lanes* samples, Lanes* bufferSamples, size_t group, size_t numSamples)
         {
-            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto buf = stateUp.getWritePointer (static_cast<int> (channel));
-            auto samples = inputBlock.getChannelPointer (channel);
+            auto buf = ParentType::template getState<Lanes> (stateUp, group, 2 * M);
+            auto pos = positionUp[group];
 
             for (size_t i = 0; i < numSamples; ++i)
             {
                 // Input
-                buf[N - 1] = 2 * samples[i];
+                buf[pos] = buf[pos + M] = samples[i] * static_cast<SampleType> (2);
+                auto window = buf + pos + 1;
 
                 // Convolution
-                auto out = static_cast<SampleType> (0.0);
+                auto out = Lanes();
 
                 for (size_t k = 0; k < Ndiv2; k += 2)
-                    out += (buf[k] + buf[N - k - 1]) * fir[k];
+                    out += (window[k / 2] + window[M - 1 - k / 2]) * fir[k];
 
                 // Outputs
                 bufferSamples[i << 1] = out;
-                bufferSamples[(i << 1) + 1] = buf[Ndiv2 + 1] * fir[Ndiv2];
+                bufferSamples[(i << 1) + 1] = window[(Ndiv2 + 1) / 2] * fir[Ndiv2];
 
-                // Shift data
-                for (size_t k = 0; k < N - 2; k += 2)
-                    buf[k] = buf[k + 2];
+                // Circular buffer
+                pos = (pos + 1 == M ? 0 : pos + 1);
             }
-        }
+
+            positionUp[group] = pos;
+        });
     }
 
-    void processSamplesDown (AudioBlock<SampleType>& outputBlock) override
+    template <typename Lanes>
+    void processDown (AudioBlock<SampleType>& outputBlock) noexcept
     {
-        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
-        jassert (outputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
-
         // Initialization
-        auto fir = coefficientsDown.getRawCoefficients();
-        auto N = coefficientsDown.getFilterOrder() + 1;
+        auto fir = designDown->coefficients.data();
+        auto N = getNumCoefficients (designDown);
         auto Ndiv2 = N / 2;
         auto Ndiv4 = Ndiv2 / 2;
-        auto numSamples = outputBlock.getNumSamples();
+        auto M = getNumEvenSamples (designDown);
 
         // Processing
-        for (size_t channel = 0; channel < outputBlock.getNumChannels(); ++channel)
+        ParentType::template processGroups<Lanes> (AudioBlock<const SampleType> (ParentType::buffer), outputBlock, outputBlock.getNumSamples(), 2, 1,
+                                                   [&] (const Lanes* bufferSamples, Lanes* samples, size_t group, size_t numSamples)
         {
-            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto buf = stateDown.getWritePointer (static_cast<int> (channel));
-            auto buf2 = stateDown2.getWritePointer (static_cast<int> (channel));
-            auto samples = outputBlock.getChannelPointer (channel);
-            auto pos = position.getUnchecked (static_cast<int> (channel));
+            auto buf = ParentType::template getState<Lanes> (stateDown, group, 2 * M);
+            auto buf2 = ParentType::template getState<Lanes> (stateDown2, group, Ndiv4 + 1);
+            auto pos = positionDown[group];
+            auto pos2 = positionDown2[group];
 
             for (size_t i = 0; i < numSamples; ++i)
             {
                 // Input
-                buf[N - 1] = bufferSamples[i << 1];
+                buf[pos] = buf[pos + M] = bufferSamples[i << 1];
+                auto window = buf + pos + 1;
 
                 // Convolution
-                auto out = static_cast<SampleType> (0.0);
+                auto out = Lanes();
 
                 for (size_t k = 0; k < Ndiv2; k += 2)
-                    out += (buf[k] + buf[N - k - 1]) * fir[k];
+                    out += (window[k / 2] + window[M - 1 - k / 2]) * fir[k];
 
                 // Output
-                out += buf2[pos] * fir[Ndiv2];
-                buf2[pos] = bufferSamples[(i << 1) + 1];
+                out += buf2[pos2] * fir[Ndiv2];
+                buf2[pos2] = bufferSamples[(i << 1) + 1];
 
                 samples[i] = out;
 
-                // Shift data
-                for (size_t k = 0; k < N - 2; ++k)
-                    buf[k] = buf[k + 2];
-
-                // Circular buffer
-                pos = (pos == 0 ? Ndiv4 : pos - 1);
+                // Circular buffers
+                pos = (pos + 1 == M ? 0 : pos + 1);
+                pos2 = (pos2 == 0 ? Ndiv4 : pos2 - 1);
             }
 
-            position.setUnchecked (static_cast<int> (channel), pos);
-        }
+            positionDown[group] = pos;
+            positionDown2[group] = pos2;
+        });
+    }
 
+    //==============================================================================
+    DesignPtr getDesign (SampleType normalisedTransitionWidth, SampleType stopbandAmplitudedB)
+    {
+        return ParentType::designCache->getDesign (DesignType::halfBandFIR, 2, normalisedTransitionWidth, stopbandAmplitudedB,
+                                                   [&] (auto& design)
+        {
+            auto coefficients = FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidth,
+                                                                                                   stopbandAmplitudedB);
+            auto* raw = coefficients->getRawCoefficients();
+            design.coefficients.assign (raw, raw + coefficients->getFilterOrder() + 1);
+            design.latency = static_cast<SampleType> (coefficients->getFilterOrder()) * static_cast<SampleType> (0.5);
+
+            // The processing relies on the middle coefficient having an odd index
+            jassert (coefficients->getFilterOrder() % 4 == 2);
+        });
     }
 
-private:
+    static size_t getNumCoefficients (const DesignPtr& design) noexcept    { return design->coefficients.size(); }
+    static size_t getNumEvenSamples  (const DesignPtr& design) noexcept    { return (getNumCoefficients (design) + 1) / 2; }
+
     //==============================================================================
-    FIR::Coefficients<SampleType> coefficientsUp, coefficientsDown;
-    AudioBuffer<SampleType> stateUp, stateDown, stateDown2;
-    Array<size_t> position;
+    DesignPtr designUp, designDown;
+    std::vector<LanesType> stateUp, stateDown, stateDown2;
+    std::vector<size_t> positionUp, positionDown, positionDown2;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesEquirippleFIR)
@@ -265,6 +498,9 @@ template <typename SampleType>
 struct Oversampling2TimesPolyphaseIIR  : public Oversampling<SampleType>::OversamplingStage
 {
     using ParentType = typename Oversampling<SampleType>::OversamplingStage;
+    using typename ParentType::LanesType;
+    using typename ParentType::DesignType;
+    using typename ParentType::DesignPtr;
 
     Oversampling2TimesPolyphaseIIR (size_t numChans,
                                     SampleType normalisedTransitionWidthUp,
@@ -273,43 +509,27 @@ struct Oversampling2TimesPolyphaseIIR  : public Oversampling<SampleType>::Oversa
                                     SampleType stopbandAmplitudedBDown)
         : ParentType (numChans, 2)
     {
-        auto structureUp = FilterDesign<SampleType>::designIIRLowpassHalfBandPolyphaseAllpassMethod (normalisedTransitionWidthUp, stopbandAmplitudedBUp);
-        auto coeffsUp = getCoefficients (structureUp);
-        latency = static_cast<SampleType> (-(coeffsUp.getPhaseForFrequency (0.0001, 1.0)) / (0.0001 * MathConstants<double>::twoPi));
-
-        auto structureDown = FilterDesign<SampleType>::designIIRLowpassHalfBandPolyphaseAllpassMethod (normalisedTransitionWidthDown, stopbandAmplitudedBDown);
-        auto coeffsDown = getCoefficients (structureDown);
-        latency += static_cast<SampleType> (-(coeffsDown.getPhaseForFrequency (0.0001, 1.0)) / (0.0001 * MathConstants<double>::twoPi));
-
-        for (auto i = 0; i < structureUp.directPath.size(); ++i)
-            coefficientsUp.add (structureUp.directPath.getObjectPointer (i)->coefficients[0]);
-
-        for (auto i = 1; i < structureUp.delayedPath.size(); ++i)
-            coefficientsUp.add (structureUp.delayedPath.getObjectPointer (i)->coefficients[0]);
+        designUp   = getDesign (normalisedTransitionWidthUp,   stopbandAmplitudedBUp);
+        designDown = getDesign (normalisedTransitionWidthDown, stopbandAmplitudedBDown);
 
-        for (auto i = 0; i < structureDown.directPath.size(); ++i)
-            coefficientsDown.add (structureDown.directPath.getObjectPointer (i)->coefficients[0]);
-
-        for (auto i = 1; i < structureDown.delayedPath.size(); ++i)
-            coefficientsDown.add (structureDown.delayedPath.getObjectPointer (i)->coefficients[0]);
-
-        v1Up.setSize   (static_cast<int> (this->numChannels), coefficientsUp.size());
-        v1Down.setSize (static_cast<int> (this->numChannels), coefficientsDown.size());
-        delayDown.resize (static_cast<int> (this->numChannels));
+        ParentType::resizeState (v1Up,   designUp->coefficients.size());
+        ParentType::resizeState (v1Down, designDown->coefficients.size());
+        ParentType::resizeState (delayDown, 1);
     }
 
     //==============================================================================
     SampleType getLatencyInSamples() const override
     {
-        return latency;
+        return designUp->latency + designDown->latency;
     }
 
     void reset() override
     {
         ParentType::reset();
-        v1Up.clear();
-        v1Down.clear();
-        delayDown.fill (0);
+
+        std::fill (v1Up.begin(),      v1Up.end(),      LanesType());
+        std::fill (v1Down.begin(),    v1Down.end(),    LanesType());
+        std::fill (delayDown.begin(), delayDown.end(), LanesType());
     }
 
     void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
@@ -317,30 +537,58 @@ struct Oversampling2TimesPolyphaseIIR  : public Oversampling<SampleType>::Oversa
         jassert (inputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
         jassert (inputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
 
+        if (ParentType::useLanes)
+            processUp<LanesType> (inputBlock);
+        else
+            processUp<SampleType> (inputBlock);
+
+       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+        ParentType::snapToZero (v1Up);
+       #endif
+    }
+
+    void processSamplesDown (AudioBlock<SampleType>& outputBlock) override
+    {
+        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
+        jassert (outputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
+
+        if (ParentType::useLanes)
+            processDown<LanesType> (outputBlock);
+        else
+            processDown<SampleType> (outputBlock);
+
+       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+        ParentType::snapToZero (v1Down);
+       #endif
+    }
+
+private:
+    //==============================================================================
+    template <typename Lanes>
+    void processUp (const AudioBlock<const SampleType>& inputBlock) noexcept
+    {
         // Initialization
-        auto coeffs = coefficientsUp.getRawDataPointer();
-        auto numStages = coefficientsUp.size();
+        auto coeffs = designUp->coefficients.data();
+        auto numStages = designUp->coefficients.size();
         auto delayedStages = numStages / 2;
         auto directStages = numStages - delayedStages;
-        auto numSamples = inputBlock.getNumSamples();
 
         // Processing
-        for (size_t channel = 0; channel < inputBlock.getNumChannels(); ++channel)
+        ParentType::template processGroups<Lanes> (inputBlock, AudioBlock<SampleType> (ParentType::buffer), inputBlock.getNumSamples(), 1, 2,
+                                                   [&] (const Lanes* samples, Lanes* bufferSamples, size_t group, size_t numSamples)
         {
-            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto lv1 = v1Up.getWritePointer (static_cast<int> (channel));
-            auto samples = inputBlock.getChannelPointer (channel);
+            auto lv1 = ParentType::template getState<Lanes> (v1Up, group, numStages);
 
             for (size_t i = 0; i < numSamples; ++i)
             {
                 // Direct path cascaded allpass filters
                 auto input = samples[i];
 
-                for (auto n = 0; n < directStages; ++n)
+                for (size_t n = 0; n < directStages; ++n)
                 {
                     auto alpha = coeffs[n];
-                    auto output = alpha * input + lv1[n];
-                    lv1[n] = input - alpha * output;
+                    auto output = input * alpha + lv1[n];
+                    lv1[n] = input - output * alpha;
                     input = output;
                 }
 
@@ -353,51 +601,43 @@ struct Oversampling2TimesPolyphaseIIR  : public Oversampling<SampleType>::Oversa
                 for (auto n = directStages; n < numStages; ++n)
                 {
                     auto alpha = coeffs[n];
-                    auto output = alpha * input + lv1[n];
-                    lv1[n] = input - alpha * output;
+                    auto output = input * alpha + lv1[n];
+                    lv1[n] = input - output * alpha;
                     input = output;
                 }
 
                 // Output
                 bufferSamples[(i << 1) + 1] = input;
             }
-        }
-
-       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
-        snapToZero (true);
-       #endif
+        });
     }
 
-    void processSamplesDown (AudioBlock<SampleType>& outputBlock) override
+    template <typename Lanes>
+    void processDown (AudioBlock<SampleType>& outputBlock) noexcept
     {
-        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
-        jassert (outputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
-
         // Initialization
-        auto coeffs = coefficientsDown.getRawDataPointer();
-        auto numStages = coefficientsDown.size();
+        auto coeffs = designDown->coefficients.data();
+        auto numStages = designDown->coefficients.size();
         auto delayedStages = numStages / 2;
         auto directStages = numStages - delayedStages;
-        auto numSamples = outputBlock.getNumSamples();
 
         // Processing
-        for (size_t channel = 0; channel < outputBlock.getNumChannels(); ++channel)
+        ParentType::template processGroups<Lanes> (AudioBlock<const SampleType> (ParentType::buffer), outputBlock, outputBlock.getNumSamples(), 2, 1,
+                                                   [&] (const Lanes* bufferSamples, Lanes* samples, size_t group, size_t numSamples)
         {
-            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto lv1 = v1Down.getWritePointer (static_cast<int> (channel));
-            auto samples = outputBlock.getChannelPointer (channel);
-            auto delay = delayDown.getUnchecked (static_cast<int> (channel));
+            auto lv1 = ParentType::template getState<Lanes> (v1Down, group, numStages);
+            auto delay = *ParentType::template getState<Lanes> (delayDown, group, 1);
 
             for (size_t i = 0; i < numSamples; ++i)
             {
                 // Direct path cascaded allpass filters
                 auto input = bufferSamples[i << 1];
 
-                for (auto n = 0; n < directStages; ++n)
+                for (size_t n = 0; n < directStages; ++n)
                 {
                     auto alpha = coeffs[n];
-                    auto output = alpha * input + lv1[n];
-                    lv1[n] = input - alpha * output;
+                    auto output = input * alpha + lv1[n];
+                    lv1[n] = input - output * alpha;
                     input = output;
                 }
 
@@ -409,8 +649,8 @@ struct Oversampling2TimesPolyphaseIIR  : public Oversampling<SampleType>::Oversa
                 for (auto n = directStages; n < numStages; ++n)
                 {
                     auto alpha = coeffs[n];
-                    auto output = alpha * input + lv1[n];
-                    lv1[n] = input - alpha * output;
+                    auto output = input * alpha + lv1[n];
+                    lv1[n] = input - output * alpha;
                     input = output;
                 }
 
@@ -419,46 +659,33 @@ struct Oversampling2TimesPolyphaseIIR  : public Oversampling<SampleType>::Oversa
                 delay = input;
             }
 
-            delayDown.setUnchecked (static_cast<int> (channel), delay);
-        }
-
-       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
-        snapToZero (false);
-       #endif
+            *ParentType::template getState<Lanes> (delayDown, group, 1) = delay;
+        });
     }
 
-    void snapToZero (bool snapUpProcessing)
+    //==============================================================================
+    DesignPtr getDesign (SampleType normalisedTransitionWidth, SampleType stopbandAmplitudedB)
     {
-        if (snapUpProcessing)
+        return ParentType::designCache->getDesign (DesignType::halfBandPolyphaseIIR, 2, normalisedTransitionWidth, stopbandAmplitudedB,
+                                                   [&] (auto& design)
         {
-            for (auto channel = 0; channel < ParentType::buffer.getNumChannels(); ++channel)
-            {
-                auto lv1 = v1Up.getWritePointer (channel);
-                auto numStages = coefficientsUp.size();
+            auto structure = FilterDesign<SampleType>::designIIRLowpassHalfBandPolyphaseAllpassMethod (normalisedTransitionWidth,
+                                                                                                      stopbandAmplitudedB);
+            auto coeffs = getCoefficients (structure);
+            design.latency = static_cast<SampleType> (-(coeffs.getPhaseForFrequency (0.0001, 1.0)) / (0.0001 * MathConstants<double>::twoPi));
 
-                for (auto n = 0; n < numStages; ++n)
-                    util::snapToZero (lv1[n]);
-            }
-        }
-        else
-        {
-            for (auto channel = 0; channel < ParentType::buffer.getNumChannels(); ++channel)
-            {
-                auto lv1 = v1Down.getWritePointer (channel);
-                auto numStages = coefficientsDown.size();
+            for (auto i = 0; i < structure.directPath.size(); ++i)
+                design.coefficients.push_back (structure.directPath.getObjectPointer (i)->coefficients[0]);
 
-                for (auto n = 0; n < numStages; ++n)
-                    util::snapToZero (lv1[n]);
-            }
-        }
+            for (auto i = 1; i < structure.delayedPath.size(); ++i)
+                design.coefficients.push_back (structure.delayedPath.getObjectPointer (i)->coefficients[0]);
+        });
     }
 
-private:
-    //==============================================================================
     /** This function calculates the equivalent high order IIR filter of a given
         polyphase cascaded allpass filters structure.
     */
-    IIR::Coefficients<SampleType> getCoefficients (typename FilterDesign<SampleType>::IIRPolyphaseAllpassStructure& structure) const
+    static IIR::Coefficients<SampleType> getCoefficients (typename FilterDesign<SampleType>::IIRPolyphaseAllpassStructure& structure)
     {
         constexpr auto one = static_cast<SampleType> (1.0);
 
@@ -517,17 +744,220 @@ private:
     }
 
     //==============================================================================
-    Array<SampleType> coefficientsUp, coefficientsDown;
-    SampleType latency;
-
-    AudioBuffer<SampleType> v1Up, v1Down;
-    Array<SampleType> delayDown;
+    DesignPtr designUp, designDown;
+    std::vector<LanesType> v1Up, v1Down, delayDown;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesPolyphaseIIR)
 };
 
 
+//==============================================================================
+/** Oversampling stage class performing oversampling by any integer factor, using
+    linear phase FIR filters designed with the Kaiser window method. The filters
+    are split into one polyphase component per output sample, so that nothing is
+    computed for the zeros inserted when upsampling, and only the samples which are
+    kept are computed when downsampling.
+*/
+template <typename SampleType>
+struct OversamplingPolyphaseFIR  : public Oversampling<SampleType>::OversamplingStage
+{
+    using ParentType = typename Oversampling<SampleType>::OversamplingStage;
+    using typename ParentType::LanesType;
+    using typename ParentType::DesignType;
+    using typename ParentType::DesignPtr;
+
+    OversamplingPolyphaseFIR (size_t numChans,
+                              size_t newFactor,
+                              SampleType normalisedTransitionWidthUp,
+                              SampleType stopbandAmplitudedBUp,
+                              SampleType normalisedTransitionWidthDown,
+                              SampleType stopbandAmplitudedBDown)
+        : ParentType (numChans, newFactor)
+    {
+        jassert (newFactor > 1);
+
+        designUp   = getDesign (DesignType::polyphaseFIRUp,   normalisedTransitionWidthUp,   stopbandAmplitudedBUp);
+        designDown = getDesign (DesignType::polyphaseFIRDown, normalisedTransitionWidthDown, stopbandAmplitudedBDown);
+
+        ParentType::resizeState (stateUp,   2 * getPhaseLength());
+        ParentType::resizeState (stateDown, 2 * designDown->coefficients.size());
+
+        positionUp.resize   (this->numChannels);
+        positionDown.resize (this->numChannels);
+    }
+
+    //==============================================================================
+    SampleType getLatencyInSamples() const override
+    {
+        // Each output sample of the downsampling is the last one of its group of
+        // input samples, which takes factor - 1 samples off the delay of the filters
+        return designUp->latency + designDown->latency - static_cast<SampleType> (this->factor - 1);
+    }
+
+    void reset() override
+    {
+        ParentType::reset();
+
+        std::fill (stateUp.begin(),   stateUp.end(),   LanesType());
+        std::fill (stateDown.begin(), stateDown.end(), LanesType());
+
+        std::fill (positionUp.begin(),   positionUp.end(),   (size_t) 0);
+        std::fill (positionDown.begin(), positionDown.end(), (size_t) 0);
+    }
+
+    void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
+    {
+        jassert (inputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
+        jassert (inputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
+
+        if (ParentType::useLanes)
+            processUp<LanesType> (inputBlock);
+        else
+            processUp<SampleType> (inputBlock);
+    }
+
+    void processSamplesDown (AudioBlock<SampleType>& outputBlock) override
+    {
+        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
+        jassert (outputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
+
+        if (ParentType::useLanes)
+            processDown<LanesType> (outputBlock);
+        else
+            processDown<SampleType> (outputBlock);
+    }
+
+private:
+    //==============================================================================
+    template <typename Lanes>
+    void processUp (const AudioBlock<const SampleType>& inputBlock) noexcept
+    {
+        // Initialization
+        auto phases = designUp->coefficients.data();
+        auto L = this->factor;
+        auto K = getPhaseLength();
+
+        // Processing
+        ParentType::template processGroups<Lanes> (inputBlock, AudioBlock<SampleType> (ParentType::buffer), inputBlock.getNumSamples(), 1, L,
+                                                   [&] (const Lanes* samples, Lanes* bufferSamples, size_t group, size_t numSamples)
+        {
+            auto buf = ParentType::template getState<Lanes> (stateUp, group, 2 * K);
+            auto pos = positionUp[group];
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                // Input, written twice so that the last K samples are always contiguous
+                buf[pos] = buf[pos + K] = samples[i];
+                auto window = buf + pos + 1;
+
+                // One convolution for each output sample
+                for (size_t p = 0; p < L; ++p)
+                {
+                    auto phase = phases + p * K;
+                    auto out = Lanes();
+
+                    for (size_t k = 0; k < K; ++k)
+                        out += window[k] * phase[k];
+
+                    bufferSamples[i * L + p] = out;
+                }
+
+                // Circular buffer
+                pos = (pos + 1 == K ? 0 : pos + 1);
+            }
+
+            positionUp[group] = pos;
+        });
+    }
+
+    template <typename Lanes>
+    void processDown (AudioBlock<SampleType>& outputBlock) noexcept
+    {
+        // Initialization
+        auto fir = designDown->coefficients.data();
+        auto L = this->factor;
+        auto N = designDown->coefficients.size();
+
+        // Processing
+        ParentType::template processGroups<Lanes> (AudioBlock<const SampleType> (ParentType::buffer), outputBlock, outputBlock.getNumSamples(), L, 1,
+                                                   [&] (const Lanes* bufferSamples, Lanes* samples, size_t group, size_t numSamples)
+        {
+            auto buf = ParentType::template getState<Lanes> (stateDown, group, 2 * N);
+            auto pos = positionDown[group];
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                // Inputs
+                for (size_t p = 0; p < L; ++p)
+                {
+                    buf[pos] = buf[pos + N] = bufferSamples[i * L + p];
+                    pos = (pos + 1 == N ? 0 : pos + 1);
+                }
+
+                // Convolution, only for the samples which are kept
+                auto window = buf + pos;
+                auto out = Lanes();
+
+                for (size_t k = 0; k < N; ++k)
+                    out += window[k] * fir[k];
+
+                samples[i] = out;
+            }
+
+            positionDown[group] = pos;
+        });
+    }
+
+    //==============================================================================
+    /*  For upsampling, the coefficients hold the polyphase components one after the
+        other, each one in reverse order and multiplied by the factor to compensate
+        for the gain of the zero stuffing. For downsampling, they hold the whole
+        filter in reverse order. Both can then be applied to the samples stored
+        oldest first.
+    */
+    DesignPtr getDesign (DesignType type, SampleType normalisedTransitionWidth, SampleType stopbandAmplitudedB)
+    {
+        const auto L = this->factor;
+
+        return ParentType::designCache->getDesign (type, L, normalisedTransitionWidth, stopbandAmplitudedB,
+                                                   [&] (auto& design)
+        {
+            auto coefficients = FilterDesign<SampleType>::designFIRLowpassKaiserMethod (static_cast<SampleType> (0.5) / static_cast<SampleType> (L),
+                                                                                       1.0, normalisedTransitionWidth, stopbandAmplitudedB);
+            auto* fir = coefficients->getRawCoefficients();
+            auto N = coefficients->getFilterOrder() + 1;
+
+            design.latency = static_cast<SampleType> (N - 1) * static_cast<SampleType> (0.5);
+
+            if (type == DesignType::polyphaseFIRDown)
+            {
+                design.coefficients.assign (fir, fir + N);
+                std::reverse (design.coefficients.begin(), design.coefficients.end());
+                return;
+            }
+
+            auto K = (N + L - 1) / L;
+            design.coefficients.assign (K * L, SampleType());
+
+            for (size_t p = 0; p < L; ++p)
+                for (size_t k = 0; k < K && k * L + p < N; ++k)
+                    design.coefficients[p * K + K - 1 - k] = fir[k * L + p] * static_cast<SampleType> (L);
+        });
+    }
+
+    size_t getPhaseLength() const noexcept      { return designUp->coefficients.size() / this->factor; }
+
+    //==============================================================================
+    DesignPtr designUp, designDown;
+    std::vector<LanesType> stateUp, stateDown;
+    std::vector<size_t> positionUp, positionDown;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OversamplingPolyphaseFIR)
+};
+
+
 //==============================================================================
 template <typename SampleType>
 Oversampling<SampleType>::Oversampling (size_t newNumChannels)
@@ -547,43 +977,9 @@ Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor,
     jassert (isPositiveAndBelow (newFactor, 5) && numChannels > 0);
 
     if (newFactor == 0)
-    {
         addDummyOversamplingStage();
-    }
-    else if (newType == FilterType::filterHalfBandPolyphaseIIR)
-    {
-        for (size_t n = 0; n < newFactor; ++n)
-        {
-            auto twUp   = (isMaximumQuality ? 0.10f : 0.12f) * (n == 0 ? 0.5f : 1.0f);
-            auto twDown = (isMaximumQuality ? 0.12f : 0.15f) * (n == 0 ? 0.5f : 1.0f);
-
-            auto gaindBStartUp    = (isMaximumQuality ? -90.0f : -70.0f);
-            auto gaindBStartDown  = (isMaximumQuality ? -75.0f : -60.0f);
-            auto gaindBFactorUp   = (isMaximumQuality ? 10.0f  : 8.0f);
-            auto gaindBFactorDown = (isMaximumQuality ? 10.0f  : 8.0f);
-
-            addOversamplingStage (FilterType::filterHalfBandPolyphaseIIR,
-                                  twUp, gaindBStartUp + gaindBFactorUp * (float) n,
-                                  twDown, gaindBStartDown + gaindBFactorDown * (float) n);
-        }
-    }
-    else if (newType == FilterType::filterHalfBandFIREquiripple)
-    {
-        for (size_t n = 0; n < newFactor; ++n)
-        {
-            auto twUp   = (isMaximumQuality ? 0.10f : 0.12f) * (n == 0 ? 0.5f : 1.0f);
-            auto twDown = (isMaximumQuality ? 0.12f : 0.15f) * (n == 0 ? 0.5f : 1.0f);
-
-            auto gaindBStartUp    = (isMaximumQuality ? -90.0f : -70.0f);
-            auto gaindBStartDown  = (isMaximumQuality ? -75.0f : -60.0f);
-            auto gaindBFactorUp   = (isMaximumQuality ? 10.0f  : 8.0f);
-            auto gaindBFactorDown = (isMaximumQuality ? 10.0f  : 8.0f);
-
-            addOversamplingStage (FilterType::filterHalfBandFIREquiripple,
-                                  twUp, gaindBStartUp + gaindBFactorUp * (float) n,
-                                  twDown, gaindBStartDown + gaindBFactorDown * (float) n);
-        }
-    }
+    else
+        addOversamplingStages ((size_t) 1 << newFactor, newType, isMaximumQuality);
 }
 
 template <typename SampleType>
@@ -622,6 +1018,67 @@ void Oversampling<SampleType>::addOversamplingStage (FilterType type,
     factorOversampling *= 2;
 }
 
+template <typename SampleType>
+void Oversampling<SampleType>::addPolyphaseFIROversamplingStage (size_t factor,
+                                                                 float normalisedTransitionWidthUp,
+                                                                 float stopbandAmplitudedBUp,
+                                                                 float normalisedTransitionWidthDown,
+                                                                 float stopbandAmplitudedBDown)
+{
+    jassert (factor > 1);
+
+    stages.add (new OversamplingPolyphaseFIR<SampleType> (numChannels, factor,
+                                                          normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
+                                                          normalisedTransitionWidthDown, stopbandAmplitudedBDown));
+
+    factorOversampling *= factor;
+}
+
+template <typename SampleType>
+void Oversampling<SampleType>::addOversamplingStages (size_t factor, FilterType type, bool isMaximumQuality)
+{
+    jassert (factor > 0);
+
+    // The filters of the first stage need the steepest transition, and the ones of the
+    // following stages can have less attenuation as they run at higher sample rates
+    auto stageIndex = (size_t) std::count_if (stages.begin(), stages.end(), [] (auto* stage) { return stage->factor > 1; });
+
+    auto addStage = [&] (size_t stageFactor)
+    {
+        auto n = stageIndex++;
+
+        auto twUp   = (isMaximumQuality ? 0.10f : 0.12f) * (n == 0 ? 0.5f : 1.0f);
+        auto twDown = (isMaximumQuality ? 0.12f : 0.15f) * (n == 0 ? 0.5f : 1.0f);
+
+        auto gaindBStartUp    = (isMaximumQuality ? -90.0f : -70.0f);
+        auto gaindBStartDown  = (isMaximumQuality ? -75.0f : -60.0f);
+        auto gaindBFactorUp   = (isMaximumQuality ? 10.0f  : 8.0f);
+        auto gaindBFactorDown = (isMaximumQuality ? 10.0f  : 8.0f);
+
+        auto gaindBUp   = gaindBStartUp   + gaindBFactorUp   * (float) n;
+        auto gaindBDown = gaindBStartDown + gaindBFactorDown * (float) n;
+
+        if (stageFactor == 2)
+        {
+            addOversamplingStage (type, twUp, gaindBUp, twDown, gaindBDown);
+        }
+        else
+        {
+            // The transition widths are relative to the oversampled rate, so they are
+            // scaled to keep the same pass band as a half-band stage would
+            auto scale = 2.0f / (float) stageFactor;
+            addPolyphaseFIROversamplingStage (stageFactor, twUp * scale, gaindBUp, twDown * scale, gaindBDown);
+        }
+    };
+
+    // The half-band stages are the cheapest, so they do all the factors of two first
+    for (; factor % 2 == 0; factor /= 2)
+        addStage (2);
+
+    if (factor > 1)
+        addStage (factor);
+}
+
 template <typename SampleType>
 void Oversampling<SampleType>::clearOversamplingStages()
 {
@@ -640,7 +1097,11 @@ template <typename SampleType>
 SampleType Oversampling<SampleType>::getLatencyInSamples() const noexcept
 {
     auto latency = getUncompensatedLatency();
-    return shouldUseIntegerLatency ? latency + fractionalDelay : latency;
+
+    // The compensation is worked out again rather than using the one set up by
+    // initProcessing, so that the result is right even if the stages have changed
+    // since, and it's rounded so that adding it doesn't leave any rounding error
+    return shouldUseIntegerLatency ? std::round (latency + getFractionalDelay (latency)) : latency;
 }
 
 template <typename SampleType>
@@ -658,6 +1119,22 @@ SampleType Oversampling<SampleType>::getUncompensatedLatency() const noexcept
     return latency;
 }
 
+template <typename SampleType>
+SampleType Oversampling<SampleType>::getFractionalDelay (SampleType latency) noexcept
+{
+    auto fraction = static_cast<SampleType> (1.0) - (latency - std::floor (latency));
+
+    if (fraction == static_cast<SampleType> (1.0))
+        return static_cast<SampleType> (0.0);
+
+    // The Thiran filter doing the fractional delay is only accurate for delays
+    // above 0.618 samples, so one whole sample is added to the shorter ones
+    if (fraction < static_cast<SampleType> (0.618))
+        fraction += static_cast<SampleType> (1.0);
+
+    return fraction;
+}
+
 template <typename SampleType>
 size_t Oversampling<SampleType>::getOversamplingFactor() const noexcept
 {
@@ -734,10 +1211,11 @@ void Oversampling<SampleType>::processSamplesDown (AudioBlock<SampleType>& outpu
     for (int n = stages.size() - 1; n > 0; --n)
     {
         auto& stage = *stages.getUnchecked(n);
-        auto audioBlock = stages.getUnchecked (n - 1)->getProcessedSamples (currentNumSamples);
+        auto& previousStage = *stages.getUnchecked (n - 1);
+        auto audioBlock = previousStage.getProcessedSamples (currentNumSamples);
         stage.processSamplesDown (audioBlock);
 
-        currentNumSamples /= stage.factor;
+        currentNumSamples /= previousStage.factor;
     }
 
     stages.getFirst()->processSamplesDown (outputBlock);
@@ -752,14 +1230,7 @@ void Oversampling<SampleType>::processSamplesDown (AudioBlock<SampleType>& outpu
 template <typename SampleType>
 void Oversampling<SampleType>::updateDelayLine()
 {
-    auto latency = getUncompensatedLatency();
-    fractionalDelay = static_cast<SampleType> (1.0) - (latency - std::floor (latency));
-
-    if (fractionalDelay == static_cast<SampleType> (1.0))
-        fractionalDelay = static_cast<SampleType> (0.0);
-    else if (fractionalDelay < static_cast<SampleType> (0.618))
-        fractionalDelay += static_cast<SampleType> (1.0);
-
+    fractionalDelay = getFractionalDelay (getUncompensatedLatency());
     delay.setDelay (fractionalDelay);
 }
 
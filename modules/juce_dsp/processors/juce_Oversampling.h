@@ -34,7 +34,9 @@ namespace dsp
 
     This class can be configured to do a factor of 2, 4, 8 or 16 times
     oversampling, using multiple stages, with polyphase allpass IIR filters or FIR
-    filters, and latency compensation.
+    filters, and latency compensation. Other integer factors such as 3 or 6 times
+    can be set up with addOversamplingStages(), which uses a polyphase FIR stage
+    for the part of the factor which isn't a power of two.
 
     The principle of oversampling is to increase the sample rate of a given
     non-linear process to prevent it from creating aliasing. Oversampling works
@@ -47,6 +49,10 @@ namespace dsp
     latency is maximised. With IIR filtering the phase is compromised around the
     Nyquist frequency but the latency is minimised.
 
+    The channels are filtered several at a time using SIMD instructions where
+    available, and the filter designs are shared between all the Oversampling
+    objects using the same settings, so creating many of them is cheap.
+
     @see FilterDesign.
 
     @tags{DSP}
@@ -111,7 +117,8 @@ public:
         Note: If you have not opted to use an integer latency then the latency may not be
         integer, so you might need to round its value or to compensate it properly in
         your processing code since plug-ins can only report integer latency values in
-        samples to the DAW.
+        samples to the DAW. Otherwise, the result includes the fractional delay added
+        to the signal path, and is a whole number.
     */
     SampleType getLatencyInSamples() const noexcept;
 
@@ -171,6 +178,53 @@ public:
                                float normalisedTransitionWidthUp,   float stopbandAmplitudedBUp,
                                float normalisedTransitionWidthDown, float stopbandAmplitudedBDown);
 
+    /** Adds a new oversampling stage to the Oversampling class, multiplying the
+        current oversampling factor by any integer greater than one. The filtering
+        uses linear phase FIR filters designed with the Kaiser window method, split
+        into polyphase components so that the zeros inserted when upsampling and the
+        samples dropped when downsampling cost nothing.
+
+        For factors of two, the half-band stages added by addOversamplingStage are
+        cheaper, so this is mainly useful for the odd factors.
+
+        @param factor                          the factor by which this stage oversamples
+        @param normalisedTransitionWidthUp     a value between 0 and 0.5 which specifies how much
+                                               the transition between passband and stopband is
+                                               steep, relative to the oversampled rate, for
+                                               upsampling filtering (the lower the better)
+        @param stopbandAmplitudedBUp           the amplitude in dB in the stopband for upsampling
+                                               filtering, between -100 and 0
+        @param normalisedTransitionWidthDown   a value between 0 and 0.5 which specifies how much
+                                               the transition between passband and stopband is
+                                               steep, relative to the oversampled rate, for
+                                               downsampling filtering (the lower the better)
+        @param stopbandAmplitudedBDown         the amplitude in dB in the stopband for downsampling
+                                               filtering, between -100 and 0
+
+        @see addOversamplingStages, clearOversamplingStages
+    */
+    void addPolyphaseFIROversamplingStage (size_t factor,
+                                           float normalisedTransitionWidthUp,   float stopbandAmplitudedBUp,
+                                           float normalisedTransitionWidthDown, float stopbandAmplitudedBDown);
+
+    /** Adds the oversampling stages needed to multiply the current oversampling
+        factor by any integer, with the same filter settings as the constructor.
+
+        The factors of two are done by half-band stages using the given type of filter,
+        and what's left, such as the 3 of 6 times oversampling, by a polyphase FIR stage
+        at the end of the chain. Like the other methods adding stages, this needs a
+        call to clearOversamplingStages first when using the default constructor.
+
+        @param factor         the factor by which to multiply the current oversampling factor
+        @param type           the type of filter design employed for the half-band stages
+        @param isMaxQuality   if the oversampling is done using the maximum quality, where
+                              the filters will be more efficient but the CPU load will
+                              increase as well
+
+        @see addOversamplingStage, addPolyphaseFIROversamplingStage, clearOversamplingStages
+    */
+    void addOversamplingStages (size_t factor, FilterType type, bool isMaxQuality = true);
+
     /** Adds a new "dummy" oversampling stage, which does nothing to the signal. Using
         one can be useful if your application features a customisable oversampling factor
         and if you want to select the current one from an OwnedArray without changing
@@ -199,6 +253,7 @@ private:
     //===============================================================================
     void updateDelayLine();
     SampleType getUncompensatedLatency() const noexcept;
+    static SampleType getFractionalDelay (SampleType latency) noexcept;
 
     //===============================================================================
     OwnedArray<OversamplingStage> stages;
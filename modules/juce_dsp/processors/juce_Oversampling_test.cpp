@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class OversamplingTest : public UnitTest
+{
+public:
+    OversamplingTest()
+        : UnitTest ("Oversampling", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runOversamplingTests<float>();
+        runOversamplingTests<double>();
+    }
+
+private:
+    template <typename Type>
+    struct Configuration
+    {
+        size_t factor;
+        typename Oversampling<Type>::FilterType type;
+    };
+
+    template <typename Type>
+    static std::unique_ptr<Oversampling<Type>> createOversampling (size_t numChannels, Configuration<Type> config)
+    {
+        auto oversampling = std::make_unique<Oversampling<Type>> (numChannels);
+        oversampling->clearOversamplingStages();
+        oversampling->addOversamplingStages (config.factor, config.type);
+        return oversampling;
+    }
+
+    template <typename Type>
+    static AudioBuffer<Type> process (Oversampling<Type>& oversampling, const AudioBuffer<Type>& input, int blockSize)
+    {
+        AudioBuffer<Type> output (input);
+        oversampling.initProcessing ((size_t) blockSize);
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            auto numSamples = jmin (blockSize, output.getNumSamples() - start);
+            auto block = AudioBlock<Type> (output).getSubBlock ((size_t) start, (size_t) numSamples);
+
+            oversampling.processSamplesUp (block);
+            oversampling.processSamplesDown (block);
+        }
+
+        return output;
+    }
+
+    // Each channel holds a sine at a multiple of the base frequency, delayed by the given number of samples
+    template <typename Type>
+    static AudioBuffer<Type> makeSines (int numChannels, int numSamples, double baseFrequency, double delay = 0.0)
+    {
+        AudioBuffer<Type> buffer (numChannels, numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, (Type) std::sin (MathConstants<double>::twoPi * baseFrequency * (ch + 1) * ((double) i - delay)));
+
+        return buffer;
+    }
+
+    template <typename Type>
+    void runOversamplingTests()
+    {
+        using namespace AudioBufferTestHelpers;
+        using FilterType = typename Oversampling<Type>::FilterType;
+
+        const Configuration<Type> configurations[] = { { 2,  FilterType::filterHalfBandPolyphaseIIR },
+                                                 { 4,  FilterType::filterHalfBandFIREquiripple },
+                                                 { 3,  FilterType::filterHalfBandPolyphaseIIR },
+                                                 { 6,  FilterType::filterHalfBandPolyphaseIIR },
+                                                 { 12, FilterType::filterHalfBandFIREquiripple } };
+
+        beginTest ("Arbitrary factors are split into half-band and polyphase stages");
+        {
+            for (auto config : configurations)
+            {
+                auto oversampling = createOversampling<Type> (2, config);
+                oversampling->initProcessing (64);
+
+                AudioBuffer<Type> buffer (2, 64);
+                buffer.clear();
+
+                expectEquals (oversampling->getOversamplingFactor(), config.factor);
+                expectEquals (oversampling->processSamplesUp (AudioBlock<Type> (buffer)).getNumSamples(), 64 * config.factor);
+            }
+        }
+
+        beginTest ("Each channel gives the same result as a single channel instance");
+        {
+            for (auto config : configurations)
+            {
+                for (int numChannels : { 2, 3, 5, 8 })
+                {
+                    const auto input = makeSines<Type> (numChannels, 1000, 0.013);
+                    auto multi = createOversampling<Type> ((size_t) numChannels, config);
+                    const auto output = process (*multi, input, 100);
+
+                    AudioBuffer<Type> expected (numChannels, input.getNumSamples());
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                    {
+                        AudioBuffer<Type> channelInput (1, input.getNumSamples());
+                        channelInput.copyFrom (0, 0, input, ch, 0, input.getNumSamples());
+
+                        auto single = createOversampling<Type> (1, config);
+                        const auto channelOutput = process (*single, channelInput, 100);
+                        expected.copyFrom (ch, 0, channelOutput, 0, 0, input.getNumSamples());
+                    }
+
+                    expectLessThan (getMaxDifference (expected, output), (Type) 1.0e-5);
+                }
+            }
+        }
+
+        beginTest ("The reported latency matches the delay of the signal");
+        {
+            for (auto config : configurations)
+            {
+                for (auto useIntegerLatency : { false, true })
+                {
+                    constexpr auto frequency = 0.002;
+                    const auto input = makeSines<Type> (1, 4000, frequency);
+
+                    auto oversampling = createOversampling<Type> (1, config);
+                    oversampling->setUsingIntegerLatency (useIntegerLatency);
+                    const auto output = process (*oversampling, input, 256);
+
+                    const auto latency = (double) oversampling->getLatencyInSamples();
+
+                    if (useIntegerLatency)
+                        expectEquals (latency, std::round (latency));
+
+                    const auto expected = makeSines<Type> (1, input.getNumSamples(), frequency, latency);
+                    expectLessThan (getMaxDifference (expected, output, 0, 2000), (Type) 1.0e-3);
+                }
+            }
+        }
+
+        beginTest ("Upsampling removes the images of the signal");
+        {
+            for (auto config : configurations)
+            {
+                constexpr auto frequency = 0.1;
+                constexpr int numSamples = 2048;
+                const auto input = makeSines<Type> (1, numSamples, frequency);
+
+                auto oversampling = createOversampling<Type> (1, config);
+                oversampling->initProcessing (numSamples);
+                auto upsampled = oversampling->processSamplesUp (AudioBlock<const Type> (input));
+
+                const auto factor = (double) config.factor;
+
+                // Measures the level of the given frequency in the second half of the
+                // upsampled signal, using a Hann window to limit the leakage
+                auto getLevel = [&] (double normalisedFrequency)
+                {
+                    const auto start = upsampled.getNumSamples() / 2;
+                    const auto length = upsampled.getNumSamples() - start;
+                    std::complex<double> sum;
+
+                    for (size_t i = 0; i < length; ++i)
+                    {
+                        auto window = 0.5 - 0.5 * std::cos (MathConstants<double>::twoPi * (double) i / (double) length);
+                        auto sample = (double) upsampled.getSample (0, (int) (start + i)) * window;
+                        sum += sample * std::polar (1.0, -MathConstants<double>::twoPi * normalisedFrequency * (double) i);
+                    }
+
+                    return std::abs (sum);
+                };
+
+                const auto signalLevel = getLevel (frequency / factor);
+                const auto imageLevel  = getLevel ((1.0 - frequency) / factor);
+
+                expectLessThan (Decibels::gainToDecibels (imageLevel / signalLevel), -60.0);
+            }
+        }
+    }
+};
+
+static OversamplingTest oversamplingTest;
+
+} // namespace dsp
+} // namespace juce
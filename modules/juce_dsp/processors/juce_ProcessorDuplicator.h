@@ -28,6 +28,23 @@ namespace juce
 namespace dsp
 {
 
+#ifndef DOXYGEN
+namespace detail
+{
+    /** ProcessorDuplicator will use the Type given by a specialisation of this
+        template to process all of its channels at once, instead of running one
+        MonoProcessorType per channel. The Type must be constructible from a
+        StateType::Ptr, must produce the same output as the mono processors, and
+        must have a static isWorthUsingFor (size_t numChannels) function.
+    */
+    template <typename MonoProcessorType, typename StateType>
+    struct MultiChannelProcessorFor
+    {
+        using Type = void;
+    };
+}
+#endif
+
 /**
     Converts a mono processor class into a multi-channel version by duplicating it
     and applying multichannel buffers across an array of instances.
@@ -36,6 +53,11 @@ namespace dsp
     instantiate the appropriate number of instances, which it then uses in its
     process() method.
 
+    Some processors have a multi-channel version which works on several channels at
+    once, and which is used instead of the duplicated instances when there are enough
+    channels for it to be quicker. For example, a ProcessorDuplicator<IIR::Filter<float>, IIR::Coefficients<float>>
+    will use an IIR::MultiChannelFilter when SIMD is available.
+
     @tags{DSP}
 */
 template <typename MonoProcessorType, typename StateType>
@@ -59,9 +81,30 @@ struct ProcessorDuplicator
 
         for (auto* p : processors)
             p->prepare (monoSpec);
+
+        if constexpr (hasMultiChannelProcessor)
+        {
+            if (MultiChannelProcessorType::isWorthUsingFor (spec.numChannels))
+            {
+                multiChannelProcessor = std::make_unique<MultiChannelProcessorType> (state);
+                multiChannelProcessor->prepare (spec);
+            }
+            else
+            {
+                multiChannelProcessor.reset();
+            }
+        }
     }
 
-    void reset() noexcept      { for (auto* p : processors) p->reset(); }
+    void reset() noexcept
+    {
+        for (auto* p : processors)
+            p->reset();
+
+        if constexpr (hasMultiChannelProcessor)
+            if (multiChannelProcessor != nullptr)
+                multiChannelProcessor->reset();
+    }
 
     template <typename ProcessContext>
     void process (const ProcessContext& context) noexcept
@@ -69,6 +112,15 @@ struct ProcessorDuplicator
         jassert ((int) context.getInputBlock().getNumChannels()  <= processors.size());
         jassert ((int) context.getOutputBlock().getNumChannels() <= processors.size());
 
+        if constexpr (hasMultiChannelProcessor)
+        {
+            if (multiChannelProcessor != nullptr)
+            {
+                multiChannelProcessor->process (context);
+                return;
+            }
+        }
+
         auto numChannels = static_cast<size_t> (jmin (context.getInputBlock().getNumChannels(),
                                                       context.getOutputBlock().getNumChannels()));
 
@@ -79,6 +131,9 @@ struct ProcessorDuplicator
     typename StateType::Ptr state;
 
 private:
+    using MultiChannelProcessorType = typename detail::MultiChannelProcessorFor<MonoProcessorType, StateType>::Type;
+    static constexpr bool hasMultiChannelProcessor = ! std::is_void_v<MultiChannelProcessorType>;
+
     template <typename ProcessContext>
     struct MonoProcessContext : public ProcessContext
     {
@@ -93,6 +148,7 @@ private:
     };
 
     juce::OwnedArray<MonoProcessorType> processors;
+    std::conditional_t<hasMultiChannelProcessor, std::unique_ptr<MultiChannelProcessorType>, std::nullptr_t> multiChannelProcessor = nullptr;
 };
 
 } // namespace dsp
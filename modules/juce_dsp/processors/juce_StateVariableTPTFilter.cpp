@@ -120,6 +120,120 @@ SampleType StateVariableTPTFilter<SampleType>::processSample (int channel, Sampl
     }
 }
 
+//==============================================================================
+template <typename SampleType>
+void StateVariableTPTFilter<SampleType>::processModulated (const AudioBlock<const SampleType>& inputBlock,
+                                                           const AudioBlock<SampleType>& outputBlock,
+                                                           const AudioBlock<const SampleType>& cutoffFrequenciesHz,
+                                                           const AudioBlock<const SampleType>& resonances) noexcept
+{
+    for (size_t channel = 0; channel < outputBlock.getNumChannels(); channel += detail::SIMDLanes<SampleType>::numLanes)
+        processModulatedLanes (channel, inputBlock, outputBlock, cutoffFrequenciesHz, resonances);
+}
+
+/*  Runs a group of channels, one in each lane. For every chunk of samples, the coefficients
+    of all the lanes are worked out first, as they don't depend on the signal, which
+    leaves only multiplications and additions in the loop that runs the filters.
+*/
+template <typename SampleType>
+void StateVariableTPTFilter<SampleType>::processModulatedLanes (size_t firstChannel,
+                                                                const AudioBlock<const SampleType>& inputBlock,
+                                                                const AudioBlock<SampleType>& outputBlock,
+                                                                const AudioBlock<const SampleType>& cutoffFrequenciesHz,
+                                                                const AudioBlock<const SampleType>& resonances) noexcept
+{
+    using Lanes = detail::SIMDLanes<SampleType>;
+    using LanesType = typename Lanes::Type;
+    constexpr auto numLanes = Lanes::numLanes;
+    constexpr size_t samplesPerChunk = 32;
+
+    const auto numChannels = jmin (numLanes, outputBlock.getNumChannels() - firstChannel);
+    const auto numSamples  = outputBlock.getNumSamples();
+
+    // Above this, the approximation of tan starts to lose accuracy
+    const auto maxAngle = static_cast<SampleType> (MathConstants<double>::pi * 0.499);
+    const auto angleScaler = static_cast<SampleType> (MathConstants<double>::pi / sampleRate);
+
+    LanesType ls1, ls2;
+    auto* s1Lanes = Lanes::getLanes (&ls1);
+    auto* s2Lanes = Lanes::getLanes (&ls2);
+
+    for (size_t lane = 0; lane < numLanes; ++lane)
+    {
+        s1Lanes[lane] = lane < numChannels ? s1[firstChannel + lane] : SampleType();
+        s2Lanes[lane] = lane < numChannels ? s2[firstChannel + lane] : SampleType();
+    }
+
+    std::array<LanesType, samplesPerChunk> x, gs, ks, hs;
+    auto* xLanes = Lanes::getLanes (x.data());
+    auto* gLanes = Lanes::getLanes (gs.data());
+    auto* kLanes = Lanes::getLanes (ks.data());
+    auto* hLanes = Lanes::getLanes (hs.data());
+
+    if (numChannels < numLanes)
+        for (auto* lanes : { xLanes, gLanes, kLanes, hLanes })
+            std::fill (lanes, lanes + samplesPerChunk * numLanes, SampleType());
+
+    for (size_t start = 0; start < numSamples; start += samplesPerChunk)
+    {
+        const auto numChunkSamples = jmin (samplesPerChunk, numSamples - start);
+
+        for (size_t lane = 0; lane < numChannels; ++lane)
+        {
+            const auto channel = firstChannel + lane;
+            const auto* input = inputBlock.getChannelPointer (channel) + start;
+            const auto [cutoffs, cutoffStep] = Lanes::getModulation (cutoffFrequenciesHz, channel, cutoffFrequency);
+            const auto [qs, qStep] = Lanes::getModulation (resonances, channel, resonance);
+
+            for (size_t i = 0; i < numChunkSamples; ++i)
+            {
+                const auto index = i * numLanes + lane;
+                const auto angle = jlimit (SampleType(), maxAngle, cutoffs[(start + i) * cutoffStep] * angleScaler);
+                const auto g1 = FastMathApproximations::tan (angle);
+                const auto r2 = static_cast<SampleType> (1) / qs[(start + i) * qStep];
+
+                xLanes[index] = input[i];
+                gLanes[index] = g1;
+                kLanes[index] = g1 + r2;
+                hLanes[index] = static_cast<SampleType> (1) / (static_cast<SampleType> (1) + r2 * g1 + g1 * g1);
+            }
+        }
+
+        for (size_t i = 0; i < numChunkSamples; ++i)
+        {
+            const auto yHP = hs[i] * (x[i] - ls1 * ks[i] - ls2);
+
+            const auto yBP = yHP * gs[i] + ls1;
+            ls1            = yHP * gs[i] + yBP;
+
+            const auto yLP = yBP * gs[i] + ls2;
+            ls2            = yBP * gs[i] + yLP;
+
+            switch (filterType)
+            {
+                case Type::bandpass:  x[i] = yBP; break;
+                case Type::highpass:  x[i] = yHP; break;
+                case Type::lowpass:
+                default:              x[i] = yLP; break;
+            }
+        }
+
+        for (size_t lane = 0; lane < numChannels; ++lane)
+        {
+            auto* output = outputBlock.getChannelPointer (firstChannel + lane) + start;
+
+            for (size_t i = 0; i < numChunkSamples; ++i)
+                output[i] = xLanes[i * numLanes + lane];
+        }
+    }
+
+    for (size_t lane = 0; lane < numChannels; ++lane)
+    {
+        s1[firstChannel + lane] = s1Lanes[lane];
+        s2[firstChannel + lane] = s2Lanes[lane];
+    }
+}
+
 //==============================================================================
 template <typename SampleType>
 void StateVariableTPTFilter<SampleType>::update()
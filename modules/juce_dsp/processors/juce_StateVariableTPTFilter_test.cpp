@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class StateVariableTPTFilterTest : public UnitTest
+{
+public:
+    StateVariableTPTFilterTest()
+        : UnitTest ("StateVariableTPTFilter", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runModulationTests<float>();
+        runModulationTests<double>();
+    }
+
+private:
+    template <typename Type>
+    void runModulationTests()
+    {
+        using namespace AudioBufferTestHelpers;
+        using Filter = StateVariableTPTFilter<Type>;
+
+        constexpr auto sampleRate = 44100.0;
+        constexpr int numChannels = 5, blockSize = 100;
+        Random random (0x1234);
+
+        beginTest ("Modulated processing matches changing the parameters on every sample");
+        {
+            for (auto type : { Filter::Type::lowpass, Filter::Type::bandpass, Filter::Type::highpass })
+            {
+                Filter reference, filter;
+
+                for (auto* f : { &reference, &filter })
+                {
+                    f->setType (type);
+                    f->prepare ({ sampleRate, (uint32) blockSize, (uint32) numChannels });
+                }
+
+                AudioBuffer<Type> cutoffs (numChannels, blockSize), resonances (1, blockSize);
+
+                // Two blocks in a row, to check that the state is carried over
+                for (int n = 0; n < 2; ++n)
+                {
+                    auto expected = makeNoise<Type> (random, numChannels, blockSize);
+
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        for (int ch = 0; ch < numChannels; ++ch)
+                            cutoffs.setSample (ch, i, (Type) (20.0f + 15000.0f * random.nextFloat()));
+
+                        resonances.setSample (0, i, (Type) (0.1f + 5.0f * random.nextFloat()));
+                    }
+
+                    AudioBuffer<Type> actual (expected);
+
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        reference.setResonance (resonances.getSample (0, i));
+
+                        for (int ch = 0; ch < numChannels; ++ch)
+                        {
+                            reference.setCutoffFrequency (cutoffs.getSample (ch, i));
+                            expected.setSample (ch, i, reference.processSample (ch, expected.getSample (ch, i)));
+                        }
+                    }
+
+                    AudioBlock<Type> block (actual);
+                    filter.process (ProcessContextReplacing<Type> (block), AudioBlock<const Type> (cutoffs), AudioBlock<const Type> (resonances));
+
+                    expectLessThan (getMaxDifference (expected, actual), (Type) 1.0e-4);
+                }
+            }
+        }
+
+        beginTest ("Empty modulation blocks use the filter's parameters");
+        {
+            Filter reference, filter;
+
+            for (auto* f : { &reference, &filter })
+            {
+                f->setCutoffFrequency ((Type) 2500);
+                f->setResonance ((Type) 2);
+                f->prepare ({ sampleRate, (uint32) blockSize, (uint32) numChannels });
+            }
+
+            auto expected = makeNoise<Type> (random, numChannels, blockSize);
+            AudioBuffer<Type> actual (expected);
+
+            AudioBlock<Type> expectedBlock (expected), actualBlock (actual);
+            reference.process (ProcessContextReplacing<Type> (expectedBlock));
+            filter.process (ProcessContextReplacing<Type> (actualBlock), {}, {});
+
+            expectLessThan (getMaxDifference (expected, actual), (Type) 1.0e-4);
+        }
+    }
+};
+
+static StateVariableTPTFilterTest stateVariableTPTFilterTest;
+
+} // namespace dsp
+} // namespace juce
@@ -102,6 +102,8 @@ void Chorus<SampleType>::prepare (const ProcessSpec& spec)
 
     osc.prepare (spec);
     bufferDelayTimes.setSize (1, (int) spec.maximumBlockSize, false, false, true);
+    bufferDelayedSamples.setSize (1, (int) spec.maximumBlockSize, false, false, true);
+    subBlockSize = (size_t) jmax (1, (int) (sampleRate / 1000.0));
 
     update();
     reset();
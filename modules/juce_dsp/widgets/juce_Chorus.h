@@ -120,22 +120,31 @@ public:
 
         dryWet.pushDrySamples (inputBlock);
 
+        auto* delayedSamples = bufferDelayedSamples.getWritePointer (0);
+
         for (size_t channel = 0; channel < numChannels; ++channel)
         {
             auto* inputSamples  = inputBlock .getChannelPointer (channel);
             auto* outputSamples = outputBlock.getChannelPointer (channel);
 
-            for (size_t i = 0; i < numSamples; ++i)
+            // The delay is never shorter than a millisecond, so a sub-block of that length
+            // can be read from the delay line before its feedback has been pushed into it
+            for (size_t start = 0; start < numSamples; start += subBlockSize)
             {
-                auto input = inputSamples[i];
-                auto output = input - lastOutput[channel];
+                const auto num = jmin (subBlockSize, numSamples - start);
+
+                delay.popBlock ((int) channel, delayedSamples, (int) num, delaySamples + start);
+
+                for (size_t i = 0; i < num; ++i)
+                {
+                    auto output = delayedSamples[i];
+                    delayedSamples[i] = inputSamples[start + i] - lastOutput[channel];
 
-                delay.pushSample ((int) channel, output);
-                delay.setDelay (delaySamples[i]);
-                output = delay.popSample ((int) channel);
+                    outputSamples[start + i] = output;
+                    lastOutput[channel] = output * feedbackVolume[channel].getNextValue();
+                }
 
-                outputSamples[i] = output;
-                lastOutput[channel] = output * feedbackVolume[channel].getNextValue();
+                delay.pushBlock ((int) channel, delayedSamples, (int) num);
             }
         }
 
@@ -153,9 +162,10 @@ private:
     std::vector<SmoothedValue<SampleType, ValueSmoothingTypes::Linear>> feedbackVolume { 2 };
     DryWetMixer<SampleType> dryWet;
     std::vector<SampleType> lastOutput { 2 };
-    AudioBuffer<SampleType> bufferDelayTimes;
+    AudioBuffer<SampleType> bufferDelayTimes, bufferDelayedSamples;
 
     double sampleRate = 44100.0;
+    size_t subBlockSize = 1;
     SampleType rate = 1.0, depth = 0.25, feedback = 0.0, mix = 0.5,
                centreDelay = 7.0;
 
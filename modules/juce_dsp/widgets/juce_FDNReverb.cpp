@@ -0,0 +1,379 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+FDNReverb<SampleType>::FDNReverb()
+{
+    // The input and output taps each use the signs of a different row of a 16x16
+    // Hadamard matrix, which are all orthogonal to each other and to the vector
+    // that the Householder matrix reflects around
+    const auto getHadamardSign = [] (size_t row, size_t column)
+    {
+        return (SampleType) (countNumberOfBits ((uint32) (row & column)) % 2 == 0 ? 1 : -1)
+                 / std::sqrt ((SampleType) numDelayLines);
+    };
+
+    for (size_t line = 0; line < numDelayLines; ++line)
+    {
+        Lanes::getLane (inputSignsLeft,   line) = getHadamardSign (1,  line);
+        Lanes::getLane (inputSignsRight,  line) = getHadamardSign (2,  line);
+        Lanes::getLane (outputSignsLeft,  line) = getHadamardSign (5,  line);
+        Lanes::getLane (outputSignsRight, line) = getHadamardSign (10, line);
+    }
+
+    setParameters (parameters);
+}
+
+template <typename SampleType>
+void FDNReverb<SampleType>::setParameters (const Parameters& newParams)
+{
+    jassert (isPositiveAndNotGreaterThan (newParams.roomSize, (SampleType) 1));
+    jassert (newParams.lowCrossoverFrequency <= newParams.highCrossoverFrequency);
+
+    constexpr auto minimumDecayTime = (SampleType) 0.01;
+
+    parameters = newParams;
+    parameters.roomSize               = jlimit ((SampleType) 0, (SampleType) 1, parameters.roomSize);
+    parameters.lowDecayTime           = jmax (minimumDecayTime, parameters.lowDecayTime);
+    parameters.midDecayTime           = jmax (minimumDecayTime, parameters.midDecayTime);
+    parameters.highDecayTime          = jmax (minimumDecayTime, parameters.highDecayTime);
+    parameters.highCrossoverFrequency = jmax (parameters.lowCrossoverFrequency, parameters.highCrossoverFrequency);
+    parameters.modulationDepth        = jlimit ((SampleType) 0, (SampleType) 5, parameters.modulationDepth);
+    parameters.modulationRate         = jlimit ((SampleType) 0, (SampleType) 10, parameters.modulationRate);
+
+    const auto wet = parameters.wetLevel;
+    roomSize.setTargetValue (parameters.roomSize);
+    wetGain1.setTargetValue (wet * (parameters.width / 2 + (SampleType) 0.5));
+    wetGain2.setTargetValue (wet * (1 - parameters.width) / 2);
+    dryGain .setTargetValue (parameters.dryLevel);
+
+    decayGainsNeedUpdating = true;
+    updateCoefficients();
+}
+
+//==============================================================================
+template <typename SampleType>
+void FDNReverb<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+
+    sampleRate = spec.sampleRate;
+
+    // The ring must hold one more sample than the longest delay, for the interpolation
+    ringLength = (int) std::ceil ((longestDelayTime + maximumModulationDepth) * sampleRate) + 2;
+    rings.resize ((size_t) getRingSize() * numDelayLines);
+
+    for (auto* smoothed : { &roomSize, &wetGain1, &wetGain2, &dryGain })
+        smoothed->reset (sampleRate, 0.05);
+
+    updateCoefficients();
+    reset();
+}
+
+template <typename SampleType>
+void FDNReverb<SampleType>::reset()
+{
+    std::fill (rings.begin(), rings.end(), SampleType());
+    writeIndex = 1;
+
+    std::fill (lowStates .begin(), lowStates .end(), LanesType());
+    std::fill (highStates.begin(), highStates.end(), LanesType());
+
+    for (auto* smoothed : { &roomSize, &wetGain1, &wetGain2, &dryGain })
+        smoothed->setCurrentAndTargetValue (smoothed->getTargetValue());
+
+    updateDelayLengths (roomSize.getCurrentValue());
+
+    for (size_t line = 0; line < numDelayLines; ++line)
+    {
+        modulationPhases[line] = MathConstants<SampleType>::twoPi * (SampleType) line / (SampleType) numDelayLines;
+        chunkEndDelays[line] = getModulatedDelay (line);
+    }
+
+    samplesIntoChunk = 0;
+}
+
+//==============================================================================
+template <typename SampleType>
+void FDNReverb<SampleType>::processSamples (const SampleType* inputLeft, const SampleType* inputRight,
+                                            SampleType* outputLeft, SampleType* outputRight, int numSamples) noexcept
+{
+    const LanesType lowCoefficients (lowCoefficient), highCoefficients (highCoefficient);
+    const auto feedbackScale = (SampleType) -2 / (SampleType) numDelayLines;
+
+    for (int start = 0; start < numSamples;)
+    {
+        if (samplesIntoChunk == 0)
+            startChunk();
+
+        const auto numThisTime = jmin (numSamples - start, chunkSize - samplesIntoChunk);
+        readDelayLines (numThisTime);
+
+        for (int n = 0; n < numThisTime; ++n)
+        {
+            const auto i = start + n;
+            auto& lanes = chunk[(size_t) n];
+            LanesType sum {}, wetLeft {}, wetRight {};
+
+            for (size_t group = 0; group < numGroups; ++group)
+            {
+                const auto x = lanes[group];
+
+                // Two one-pole lowpass filters split each line into three bands, which
+                // are weighted by the gains that give their decay times
+                lowStates[group]  += lowCoefficients  * (x - lowStates[group]);
+                highStates[group] += highCoefficients * (x - highStates[group]);
+
+                const auto y = highGains[group] * x
+                             + midGainDifferences[group] * highStates[group]
+                             + lowGainDifferences[group] * lowStates[group];
+
+                lanes[group] = y;
+                sum += y;
+                wetLeft  += y * outputSignsLeft[group];
+                wetRight += y * outputSignsRight[group];
+            }
+
+            const auto inLeft = inputLeft[i], inRight = inputRight[i];
+
+            // The Householder matrix is I - 2/N, so it only needs the sum of the lines
+            const LanesType reflection (Lanes::sum (sum) * feedbackScale);
+
+            for (size_t group = 0; group < numGroups; ++group)
+                lanes[group] += reflection + inputSignsLeft[group] * inLeft + inputSignsRight[group] * inRight;
+
+            const auto left = Lanes::sum (wetLeft), right = Lanes::sum (wetRight);
+            const auto wet1 = wetGain1.getNextValue(), wet2 = wetGain2.getNextValue(), dry = dryGain.getNextValue();
+
+            if (outputRight != nullptr)
+            {
+                outputLeft[i]  = left  * wet1 + right * wet2 + inLeft  * dry;
+                outputRight[i] = right * wet1 + left  * wet2 + inRight * dry;
+            }
+            else
+            {
+                outputLeft[i] = ((left + right) * (wet1 + wet2) + (inLeft + inRight) * dry) * (SampleType) 0.5;
+            }
+        }
+
+        writeDelayLines (numThisTime);
+
+        start += numThisTime;
+        samplesIntoChunk = (samplesIntoChunk + numThisTime) % chunkSize;
+    }
+
+   #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+    for (size_t line = 0; line < numDelayLines; ++line)
+    {
+        util::snapToZero (Lanes::getLane (lowStates,  line));
+        util::snapToZero (Lanes::getLane (highStates, line));
+    }
+   #endif
+}
+
+template <typename SampleType>
+void FDNReverb<SampleType>::startChunk() noexcept
+{
+    // The chunks always have the same length, so the parameters and modulation are
+    // updated at the same points whatever the size of the blocks being processed
+    const auto previousSize = roomSize.getCurrentValue();
+    const auto size = roomSize.skip (chunkSize);
+
+    if (decayGainsNeedUpdating || size != previousSize)
+        updateDelayLengths (size);
+
+    for (size_t line = 0; line < numDelayLines; ++line)
+    {
+        modulationPhases[line] += modulationIncrements[line] * (SampleType) chunkSize;
+
+        if (modulationPhases[line] >= MathConstants<SampleType>::twoPi)
+            modulationPhases[line] -= MathConstants<SampleType>::twoPi;
+
+        // The delays ramp linearly towards their values at the end of the chunk
+        chunkStartDelays[line] = chunkEndDelays[line];
+        chunkEndDelays[line] = getModulatedDelay (line);
+        delayIncrements[line] = (chunkEndDelays[line] - chunkStartDelays[line]) / (SampleType) chunkSize;
+    }
+}
+
+template <typename SampleType>
+void FDNReverb<SampleType>::readDelayLines (int numSamples) noexcept
+{
+    for (size_t line = 0; line < numDelayLines; ++line)
+    {
+        const auto* ring = rings.data() + line * (size_t) getRingSize();
+        const auto startDelay = chunkStartDelays[line], increment = delayIncrements[line];
+
+        const auto getDelay = [&] (int i)
+        {
+            return startDelay + increment * (SampleType) (samplesIntoChunk + i + 1);
+        };
+
+        for (int start = 0; start < numSamples;)
+        {
+            // The delay ramps so slowly that its whole number of samples rarely changes
+            // during a chunk. While it stays the same, the samples can be read from
+            // consecutive positions in the ring.
+            const auto integer = (int) getDelay (start);
+            auto end = numSamples;
+
+            if ((int) getDelay (end - 1) != integer)
+            {
+                auto last = start;
+
+                while (end - last > 1)
+                {
+                    const auto middle = (last + end) / 2;
+
+                    if ((int) getDelay (middle) == integer)
+                        last = middle;
+                    else
+                        end = middle;
+                }
+            }
+
+            // No delay is shorter than a chunk, so every sample read here was written
+            // before the chunk started
+            auto index = writeIndex + start + 1 - integer;
+
+            if (index < 1)
+                index += ringLength;
+
+            const auto* newer = ring + index - start;
+
+            for (int i = start; i < end; ++i)
+            {
+                const auto fraction = getDelay (i) - (SampleType) integer;
+                Lanes::getLane (chunk[(size_t) i], line) = newer[i] + fraction * (newer[i - 1] - newer[i]);
+            }
+
+            start = end;
+        }
+    }
+}
+
+template <typename SampleType>
+void FDNReverb<SampleType>::writeDelayLines (int numSamples) noexcept
+{
+    // The samples go after the last one written, wrapping around to index 1, and any
+    // that land in the first chunk of the ring are copied to the end of it too
+    const auto numBeforeWrap = jmin (numSamples, ringLength - writeIndex);
+    const auto numMirrored = jmax (0, jmin (numBeforeWrap, chunkSize - writeIndex));
+
+    for (size_t line = 0; line < numDelayLines; ++line)
+    {
+        auto* ring = rings.data() + line * (size_t) getRingSize();
+        auto* destination = ring + writeIndex + 1;
+
+        for (int i = 0; i < numBeforeWrap; ++i)
+            destination[i] = Lanes::getLane (chunk[(size_t) i], line);
+
+        destination = ring + 1 - numBeforeWrap;
+
+        for (int i = numBeforeWrap; i < numSamples; ++i)
+            destination[i] = destination[i + ringLength] = Lanes::getLane (chunk[(size_t) i], line);
+
+        for (int i = 0; i < numMirrored; ++i)
+            ring[writeIndex + 1 + i + ringLength] = ring[writeIndex + 1 + i];
+
+        ring[0] = ring[ringLength];
+    }
+
+    writeIndex = (writeIndex + numSamples - 1) % ringLength + 1;
+}
+
+//==============================================================================
+template <typename SampleType>
+void FDNReverb<SampleType>::updateCoefficients()
+{
+    const auto getCoefficient = [this] (SampleType frequency)
+    {
+        return (SampleType) (1.0 - std::exp (-MathConstants<double>::twoPi * jmin ((double) frequency, sampleRate * 0.5) / sampleRate));
+    };
+
+    lowCoefficient  = getCoefficient (parameters.lowCrossoverFrequency);
+    highCoefficient = getCoefficient (parameters.highCrossoverFrequency);
+
+    // Each line gets a slightly different rate so that they don't move together
+    for (size_t line = 0; line < numDelayLines; ++line)
+    {
+        const auto rate = parameters.modulationRate * ((SampleType) 0.8 + (SampleType) 0.4 * (SampleType) line / (SampleType) (numDelayLines - 1));
+        modulationIncrements[line] = (SampleType) (MathConstants<double>::twoPi * rate / sampleRate);
+    }
+}
+
+template <typename SampleType>
+void FDNReverb<SampleType>::updateDelayLengths (SampleType size) noexcept
+{
+    const auto shortest = (shortestDelayTime + (maximumShortestDelayTime - shortestDelayTime) * (double) size) * sampleRate;
+    const auto ratio = longestDelayTime / maximumShortestDelayTime;
+
+    for (size_t line = 0; line < numDelayLines; ++line)
+    {
+        // Whole numbers of samples mean that the lines don't need any interpolation
+        // unless they're being modulated
+        const auto delay = std::round (shortest * std::pow (ratio, (double) line / (double) (numDelayLines - 1)));
+        baseDelays[line] = (SampleType) delay;
+
+        // The gain that makes a signal going round this line decay by 60 dB in the given time
+        const auto getGain = [&] (SampleType decayTime)
+        {
+            return (SampleType) std::pow (10.0, -3.0 * delay / ((double) decayTime * sampleRate));
+        };
+
+        const auto lowGain  = getGain (parameters.lowDecayTime);
+        const auto midGain  = getGain (parameters.midDecayTime);
+        const auto highGain = getGain (parameters.highDecayTime);
+
+        Lanes::getLane (highGains,          line) = highGain;
+        Lanes::getLane (midGainDifferences, line) = midGain - highGain;
+        Lanes::getLane (lowGainDifferences, line) = lowGain - midGain;
+    }
+
+    decayGainsNeedUpdating = false;
+}
+
+template <typename SampleType>
+SampleType FDNReverb<SampleType>::getModulatedDelay (size_t line) const noexcept
+{
+    const auto depth = (SampleType) (parameters.modulationDepth * 0.001 * sampleRate);
+
+    // A chunk is read from the lines before any of it is written back, so the delays
+    // can't be shorter than a chunk. This only limits the modulation at low sample rates.
+    return jmax ((SampleType) chunkSize, baseDelays[line] + depth * std::sin (modulationPhases[line]));
+}
+
+//==============================================================================
+template class FDNReverb<float>;
+template class FDNReverb<double>;
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A reverb based on a feedback delay network, which can be used instead of the
+    Freeverb algorithm of juce::Reverb and dsp::Reverb.
+
+    The network has 16 delay lines of exponentially spread lengths, which are fed
+    back into each other through a Householder matrix. This matrix mixes all of the
+    lines together at a cost that only grows linearly with their number. The input
+    and output taps use the signs of rows of a Hadamard matrix, so that the left
+    and right channels are decorrelated.
+
+    Each line has a filter in its feedback path that splits it into three bands,
+    so the low, mid and high frequencies can be given separate decay times. The
+    lengths of the lines are slowly modulated to smear their resonances, which also
+    damps the high frequencies a little more than their decay time on its own.
+
+    The signal is processed in short chunks, which are never longer than the
+    shortest delay. Each line is read a chunk at a time from its own ring buffer,
+    then the filters and feedback matrix work on all the lines together in SIMD
+    registers, and the results are written back to each line in one go.
+
+    @see Reverb
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class FDNReverb
+{
+public:
+    //==============================================================================
+    /** Holds the parameters being used by an FDNReverb object. */
+    struct Parameters
+    {
+        SampleType roomSize               = (SampleType) 0.5;      /**< Room size, 0 to 1.0, where 1.0 is big, 0 is small. */
+        SampleType lowDecayTime           = (SampleType) 2.5;      /**< Time in seconds for the low frequencies to decay by 60 dB. */
+        SampleType midDecayTime           = (SampleType) 2.0;      /**< Time in seconds for the mid frequencies to decay by 60 dB. */
+        SampleType highDecayTime          = (SampleType) 1.0;      /**< Time in seconds for the high frequencies to decay by 60 dB. */
+        SampleType lowCrossoverFrequency  = (SampleType) 400;      /**< Frequency in Hz between the low and mid bands. */
+        SampleType highCrossoverFrequency = (SampleType) 4000;     /**< Frequency in Hz between the mid and high bands. */
+        SampleType modulationDepth        = (SampleType) 0.5;      /**< Depth of the delay modulation in milliseconds, 0 to 5.0. */
+        SampleType modulationRate         = (SampleType) 0.7;      /**< Rate of the delay modulation in Hz, 0 to 10.0. */
+        SampleType wetLevel               = (SampleType) 0.33;     /**< Wet level, 0 to 1.0 */
+        SampleType dryLevel               = (SampleType) 0.4;      /**< Dry level, 0 to 1.0 */
+        SampleType width                  = (SampleType) 1.0;      /**< Reverb width, 0 to 1.0, where 1.0 is very wide. */
+    };
+
+    //==============================================================================
+    /** Creates an uninitialised reverb. Call prepare() before first use. */
+    FDNReverb();
+
+    /** Returns the reverb's current parameters. */
+    const Parameters& getParameters() const noexcept    { return parameters; }
+
+    /** Applies a new set of parameters to the reverb.
+
+        The room size and levels glide smoothly to their new values. As with Reverb,
+        this doesn't lock anything, so it must be called on the same thread as the
+        process method.
+    */
+    void setParameters (const Parameters& newParams);
+
+    //==============================================================================
+    /** Initialises the reverb. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the reverb's internal state. */
+    void reset();
+
+    //==============================================================================
+    /** Applies the reverb to a mono or stereo block.
+
+        The input and output blocks can each have one or two channels. The result
+        doesn't depend on how the signal is split into blocks.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+        const auto numInChannels  = inputBlock.getNumChannels();
+        const auto numOutChannels = outputBlock.getNumChannels();
+        const auto numSamples     = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumSamples() == numSamples);
+        jassert (numInChannels == 1 || numInChannels == 2);
+        jassert (numOutChannels == 1 || numOutChannels == 2);
+
+        if (context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        processSamples (inputBlock.getChannelPointer (0),
+                        inputBlock.getChannelPointer (numInChannels - 1),
+                        outputBlock.getChannelPointer (0),
+                        numOutChannels > 1 ? outputBlock.getChannelPointer (1) : nullptr,
+                        (int) numSamples);
+    }
+
+    //==============================================================================
+    /** The number of delay lines in the network. */
+    static constexpr size_t numDelayLines = 16;
+
+private:
+    //==============================================================================
+    using Lanes     = detail::SIMDLanes<SampleType>;
+    using LanesType = typename Lanes::Type;
+
+    static constexpr size_t numGroups = numDelayLines / Lanes::numLanes;
+    static constexpr int chunkSize = 64;
+
+    // The delay times in seconds of the shortest line for the smallest and biggest
+    // rooms, and of the longest line for the biggest room
+    static constexpr double shortestDelayTime = 0.012, maximumShortestDelayTime = 0.06,
+                            longestDelayTime = 0.168, maximumModulationDepth = 0.005;
+
+    // Holds one value for each delay line
+    using LineValues = std::array<LanesType, numGroups>;
+
+    //==============================================================================
+    void processSamples (const SampleType* inputLeft, const SampleType* inputRight,
+                         SampleType* outputLeft, SampleType* outputRight, int numSamples) noexcept;
+    void startChunk() noexcept;
+    void readDelayLines (int numSamples) noexcept;
+    void writeDelayLines (int numSamples) noexcept;
+    void updateCoefficients();
+    void updateDelayLengths (SampleType size) noexcept;
+    SampleType getModulatedDelay (size_t line) const noexcept;
+    int getRingSize() const noexcept    { return ringLength + chunkSize + 1; }
+
+
+    //==============================================================================
+    Parameters parameters;
+    double sampleRate = 44100.0;
+
+    // Each line has its own ring, which holds ringLength samples from index 1. Index 0
+    // is a copy of the last sample, and the chunk after the end is a copy of the first
+    // chunk, so that a whole chunk can be read from anywhere without wrapping around
+    std::vector<SampleType> rings;
+    int ringLength = 1, writeIndex = 1;
+
+    // Holds one sample of every line for each sample of the chunk
+    std::array<LineValues, chunkSize> chunk;
+
+    LineValues lowStates, highStates, highGains, midGainDifferences, lowGainDifferences,
+               inputSignsLeft, inputSignsRight, outputSignsLeft, outputSignsRight;
+
+    std::array<SampleType, numDelayLines> baseDelays, modulationPhases, modulationIncrements,
+                                          chunkStartDelays, chunkEndDelays, delayIncrements;
+    SampleType lowCoefficient = 0, highCoefficient = 0;
+
+    SmoothedValue<SampleType, ValueSmoothingTypes::Linear> roomSize, wetGain1, wetGain2, dryGain;
+    bool decayGainsNeedUpdating = true;
+    int samplesIntoChunk = 0;
+
+    //==============================================================================
+    JUCE_LEAK_DETECTOR (FDNReverb)
+};
+
+} // namespace dsp
+} // namespace juce
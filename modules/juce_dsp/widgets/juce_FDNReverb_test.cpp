@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class FDNReverbTest : public UnitTest
+{
+public:
+    FDNReverbTest()
+        : UnitTest ("FDNReverb", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runReverbTests<float>();
+        runReverbTests<double>();
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    template <typename Type>
+    static AudioBuffer<Type> process (FDNReverb<Type>& reverb, AudioBuffer<Type> buffer, Random* random = nullptr)
+    {
+        for (int start = 0; start < buffer.getNumSamples();)
+        {
+            const auto num = jmin (buffer.getNumSamples() - start, random != nullptr ? random->nextInt ({ 1, blockSize + 1 }) : blockSize);
+            auto block = AudioBlock<Type> (buffer).getSubBlock ((size_t) start, (size_t) num);
+            reverb.process (ProcessContextReplacing<Type> (block));
+            start += num;
+        }
+
+        return buffer;
+    }
+
+    template <typename Type>
+    static double getEnergy (const AudioBuffer<Type>& buffer, double startTime, double endTime)
+    {
+        auto energy = 0.0;
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (auto i = (int) (startTime * sampleRate); i < (int) (endTime * sampleRate); ++i)
+                energy += square ((double) buffer.getSample (ch, i));
+
+        return energy;
+    }
+
+    // Returns the ratio in decibels of the energy below 250 Hz to the energy above
+    // 4 kHz, in a window starting at the given time
+    template <typename Type>
+    static double getLowToHighRatio (const AudioBuffer<Type>& buffer, double startTime)
+    {
+        constexpr int order = 12, size = 1 << order;
+        FFT fft (order);
+        WindowingFunction<float> window ((size_t) size, WindowingFunction<float>::hann, false);
+        auto low = 0.0, high = 0.0;
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            std::vector<float> data ((size_t) size * 2);
+
+            for (int i = 0; i < size; ++i)
+                data[(size_t) i] = (float) buffer.getSample (ch, (int) (startTime * sampleRate) + i);
+
+            window.multiplyWithWindowingTable (data.data(), (size_t) size);
+            fft.performFrequencyOnlyForwardTransform (data.data(), true);
+
+            for (int bin = 1; bin < size / 2; ++bin)
+            {
+                const auto frequency = bin * sampleRate / size;
+                const auto energy = square ((double) data[(size_t) bin]);
+
+                if (frequency < 250.0)
+                    low += energy;
+                else if (frequency > 4000.0)
+                    high += energy;
+            }
+        }
+
+        return Decibels::gainToDecibels (low / high, -1000.0) * 0.5;
+    }
+
+    template <typename Type>
+    static FDNReverb<Type> createReverb (typename FDNReverb<Type>::Parameters parameters, double rate = sampleRate)
+    {
+        parameters.wetLevel = 1;
+        parameters.dryLevel = 0;
+
+        FDNReverb<Type> reverb;
+        reverb.setParameters (parameters);
+        reverb.prepare ({ rate, (uint32) blockSize, 2 });
+        return reverb;
+    }
+
+    template <typename Type>
+    static AudioBuffer<Type> getImpulseResponse (FDNReverb<Type>& reverb, double length)
+    {
+        AudioBuffer<Type> buffer (2, (int) (length * sampleRate));
+        buffer.clear();
+        buffer.setSample (0, 0, (Type) 1);
+
+        return process (reverb, buffer);
+    }
+
+    template <typename Type>
+    void runReverbTests()
+    {
+        using namespace AudioBufferTestHelpers;
+        using Parameters = typename FDNReverb<Type>::Parameters;
+        Random random (0x1234);
+
+        beginTest ("The tail decays at the rate given by the decay time");
+        {
+            for (auto size : { (Type) 0, (Type) 0.5, (Type) 1 })
+            {
+                Parameters parameters;
+                parameters.roomSize = size;
+                parameters.lowDecayTime = parameters.midDecayTime = parameters.highDecayTime = (Type) 1;
+                parameters.modulationDepth = 0;
+
+                auto reverb = createReverb<Type> (parameters);
+                const auto response = getImpulseResponse (reverb, 1.0);
+
+                // A decay time of one second means 60 dB per second
+                const auto decay = Decibels::gainToDecibels (getEnergy (response, 0.3, 0.4) / getEnergy (response, 0.8, 0.9)) * 0.5;
+                expectWithinAbsoluteError (decay, 30.0, 1.5);
+            }
+        }
+
+        beginTest ("Each band decays at its own rate");
+        {
+            Parameters lowParameters;
+            lowParameters.lowDecayTime = (Type) 3;
+            lowParameters.midDecayTime = lowParameters.highDecayTime = (Type) 0.3;
+
+            Parameters highParameters;
+            highParameters.highDecayTime = (Type) 3;
+            highParameters.lowDecayTime = highParameters.midDecayTime = (Type) 0.3;
+
+            auto lowReverb  = createReverb<Type> (lowParameters);
+            auto highReverb = createReverb<Type> (highParameters);
+
+            const auto lowResponse  = getImpulseResponse (lowReverb,  1.2);
+            const auto highResponse = getImpulseResponse (highReverb, 1.2);
+
+            expectGreaterThan (getLowToHighRatio (lowResponse, 1.0), 40.0);
+            expectLessThan (getLowToHighRatio (highResponse, 1.0), -40.0);
+        }
+
+        beginTest ("The output doesn't depend on the block sizes");
+        {
+            Parameters parameters;
+            parameters.modulationDepth = (Type) 2;
+            parameters.modulationRate = (Type) 3;
+
+            auto reference = createReverb<Type> (parameters);
+            auto reverb    = createReverb<Type> (parameters);
+
+            const auto input = makeNoise<Type> (random, 2, (int) sampleRate / 4);
+
+            auto expected = process (reference, input);
+            auto actual   = process (reverb, input, &random);
+
+            expectLessThan (getMaxDifference (expected, actual), (Type) 1.0e-6);
+        }
+
+        beginTest ("Deep modulation of a small room at a low sample rate");
+        {
+            Parameters parameters;
+            parameters.roomSize = (Type) 0;
+            parameters.modulationDepth = (Type) 5;
+            parameters.modulationRate = (Type) 10;
+
+            auto reference = createReverb<Type> (parameters, 8000.0);
+            auto reverb    = createReverb<Type> (parameters, 8000.0);
+
+            const auto input = makeNoise<Type> (random, 2, 8000);
+
+            auto expected = process (reference, input);
+            auto actual   = process (reverb, input, &random);
+
+            expectLessThan (getMaxDifference (expected, actual), (Type) 1.0e-6);
+        }
+
+        beginTest ("Long decay times stay stable");
+        {
+            Parameters parameters;
+            parameters.lowDecayTime = parameters.midDecayTime = parameters.highDecayTime = (Type) 100;
+            parameters.modulationDepth = (Type) 5;
+
+            auto reverb = createReverb<Type> (parameters);
+            // A burst of noise, followed by silence
+            constexpr auto burstLength = (int) sampleRate / 10;
+            auto buffer = makeNoise<Type> (random, 2, (int) sampleRate * 2);
+            buffer.clear (burstLength, buffer.getNumSamples() - burstLength);
+
+            buffer = process (reverb, buffer);
+
+            expectLessThan (getEnergy (buffer, 1.9, 2.0), getEnergy (buffer, 0.2, 0.3) * 1.01);
+        }
+
+        beginTest ("Mono processing");
+        {
+            auto reverb = createReverb<Type> ({});
+            AudioBuffer<Type> buffer (1, (int) sampleRate / 2);
+            buffer.clear();
+            buffer.setSample (0, 0, (Type) 1);
+
+            buffer = process (reverb, buffer);
+
+            expectGreaterThan (getEnergy (buffer, 0.1, 0.2), 1.0e-3);
+            expect (buffer.findMinMax (0, 0, buffer.getNumSamples()).getLength() < (Type) 2);
+        }
+    }
+};
+
+static FDNReverbTest fdnReverbTest;
+
+} // namespace dsp
+} // namespace juce
@@ -146,6 +146,125 @@ SampleType LadderFilter<SampleType>::processSample (SampleType inputValue, size_
     return a * A[0] + b * A[1] + c * A[2] + d * A[3] + e * A[4];
 }
 
+//==============================================================================
+template <typename SampleType>
+void LadderFilter<SampleType>::processModulated (const AudioBlock<const SampleType>& inputBlock,
+                                                 const AudioBlock<SampleType>& outputBlock,
+                                                 const AudioBlock<const SampleType>& cutoffFrequenciesHz,
+                                                 const AudioBlock<const SampleType>& resonances) noexcept
+{
+    for (size_t channel = 0; channel < outputBlock.getNumChannels(); channel += detail::SIMDLanes<SampleType>::numLanes)
+        processModulatedLanes (channel, inputBlock, outputBlock, cutoffFrequenciesHz, resonances);
+}
+
+/*  Runs a group of channels, one in each lane. For every chunk of samples, the coefficients
+    and the saturated input of all the lanes are worked out first, so that only the
+    feedback path has to go through the saturation lookup table lane by lane.
+*/
+template <typename SampleType>
+void LadderFilter<SampleType>::processModulatedLanes (size_t firstChannel,
+                                                      const AudioBlock<const SampleType>& inputBlock,
+                                                      const AudioBlock<SampleType>& outputBlock,
+                                                      const AudioBlock<const SampleType>& cutoffFrequenciesHz,
+                                                      const AudioBlock<const SampleType>& resonances) noexcept
+{
+    using Lanes = detail::SIMDLanes<SampleType>;
+    using LanesType = typename Lanes::Type;
+    constexpr auto numLanes = Lanes::numLanes;
+    constexpr size_t samplesPerChunk = 32;
+
+    const auto numChannels = jmin (numLanes, outputBlock.getNumChannels() - firstChannel);
+    const auto numSamples  = outputBlock.getNumSamples();
+
+    // The exponent for a cutoff frequency of half the sample rate
+    const auto minExponent = static_cast<SampleType> (-MathConstants<double>::pi);
+
+    std::array<LanesType, numStates> s;
+    std::array<SampleType*, numStates> sLanes;
+
+    for (size_t i = 0; i < numStates; ++i)
+    {
+        sLanes[i] = Lanes::getLanes (&s[i]);
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            sLanes[i][lane] = lane < numChannels ? state[firstChannel + lane][i] : SampleType();
+    }
+
+    std::array<LanesType, samplesPerChunk> dxs, a1s, rs;
+    auto* dxLanes = Lanes::getLanes (dxs.data());
+    auto* a1Lanes = Lanes::getLanes (a1s.data());
+    auto* rLanes  = Lanes::getLanes (rs.data());
+
+    if (numChannels < numLanes)
+        for (auto* lanes : { dxLanes, a1Lanes, rLanes })
+            std::fill (lanes, lanes + samplesPerChunk * numLanes, SampleType());
+
+    for (size_t start = 0; start < numSamples; start += samplesPerChunk)
+    {
+        const auto numChunkSamples = jmin (samplesPerChunk, numSamples - start);
+
+        for (size_t lane = 0; lane < numChannels; ++lane)
+        {
+            const auto channel = firstChannel + lane;
+            const auto* input = inputBlock.getChannelPointer (channel) + start;
+            const auto [cutoffs, cutoffStep] = Lanes::getModulation (cutoffFrequenciesHz, channel, cutoffFreqHz);
+            const auto [qs, qStep] = Lanes::getModulation (resonances, channel, resonance);
+
+            for (size_t i = 0; i < numChunkSamples; ++i)
+            {
+                const auto index = i * numLanes + lane;
+                const auto exponent = jlimit (minExponent, SampleType(), cutoffs[(start + i) * cutoffStep] * cutoffFreqScaler);
+
+                dxLanes[index] = gain * saturationLUT (drive * input[i]);
+                a1Lanes[index] = FastMathApproximations::exp (exponent);
+                rLanes[index]  = jmap (qs[(start + i) * qStep], SampleType (0.1), SampleType (1.0)) * SampleType (-4);
+            }
+        }
+
+        for (size_t i = 0; i < numChunkSamples; ++i)
+        {
+            const auto a1 = a1s[i];
+            const auto g  = a1 * SampleType (-1) + SampleType (1);
+            const auto b0 = g * SampleType (0.76923076923);
+            const auto b1 = g * SampleType (0.23076923076);
+
+            auto feedback = s[4] * drive2;
+            auto* feedbackLanes = Lanes::getLanes (&feedback);
+
+            for (size_t lane = 0; lane < numLanes; ++lane)
+                feedbackLanes[lane] = saturationLUT (feedbackLanes[lane]);
+
+            const auto dx = dxs[i];
+            const auto a  = dx + rs[i] * (feedback * gain2 - dx * comp);
+
+            const auto b = b1 * s[0] + a1 * s[1] + b0 * a;
+            const auto c = b1 * s[1] + a1 * s[2] + b0 * b;
+            const auto d = b1 * s[2] + a1 * s[3] + b0 * c;
+            const auto e = b1 * s[3] + a1 * s[4] + b0 * d;
+
+            s[0] = a;
+            s[1] = b;
+            s[2] = c;
+            s[3] = d;
+            s[4] = e;
+
+            dxs[i] = a * A[0] + b * A[1] + c * A[2] + d * A[3] + e * A[4];
+        }
+
+        for (size_t lane = 0; lane < numChannels; ++lane)
+        {
+            auto* output = outputBlock.getChannelPointer (firstChannel + lane) + start;
+
+            for (size_t i = 0; i < numChunkSamples; ++i)
+                output[i] = dxLanes[i * numLanes + lane];
+        }
+    }
+
+    for (size_t i = 0; i < numStates; ++i)
+        for (size_t lane = 0; lane < numChannels; ++lane)
+            state[firstChannel + lane][i] = sLanes[i][lane];
+}
+
 //==============================================================================
 template <typename SampleType>
 void LadderFilter<SampleType>::updateSmoothers() noexcept
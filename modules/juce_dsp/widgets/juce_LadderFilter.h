@@ -41,6 +41,10 @@ enum class LadderFilterMode
 /**
     Multi-mode filter based on the Moog ladder filter.
 
+    For audio-rate modulation, such as a filter envelope on every voice of a synth,
+    there is an overload of process() which takes a cutoff frequency and resonance
+    for each sample.
+
     @tags{DSP}
 */
 template <typename SampleType>
@@ -115,6 +119,50 @@ public:
         }
     }
 
+    /** Processes the input and output samples supplied in the processing context,
+        using a different cutoff frequency and resonance for every sample.
+
+        Each of the modulation blocks must have the same number of samples as the
+        context, and either one channel per channel of the context, or a single
+        channel whose values are used for all of them. An empty block means that
+        the value given to setCutoffFrequencyHz() or setResonance() is used instead.
+
+        The values are used as they are, without the smoothing that's applied to the
+        ones passed to setCutoffFrequencyHz() and setResonance(). Cutoff frequencies
+        are limited to the range between 0 and half the sample rate, and resonances
+        must be between 0 and 1. The coefficients are worked out with
+        FastMathApproximations::exp(), whose relative error is below 0.2% over that
+        range, and several channels are processed at once in the lanes of a
+        SIMDRegister when SIMD is available.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context,
+                  const AudioBlock<const SampleType>& cutoffFrequenciesHz,
+                  const AudioBlock<const SampleType>& resonances) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+        const auto numChannels = outputBlock.getNumChannels();
+        const auto numSamples  = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumChannels() <= getNumChannels());
+        jassert (inputBlock.getNumChannels() == numChannels);
+        jassert (inputBlock.getNumSamples()  == numSamples);
+
+        jassert (cutoffFrequenciesHz.getNumChannels() <= 1 || cutoffFrequenciesHz.getNumChannels() == numChannels);
+        jassert (cutoffFrequenciesHz.getNumChannels() == 0 || cutoffFrequenciesHz.getNumSamples() == numSamples);
+        jassert (resonances.getNumChannels() <= 1 || resonances.getNumChannels() == numChannels);
+        jassert (resonances.getNumChannels() == 0 || resonances.getNumSamples() == numSamples);
+
+        if (! enabled || context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        processModulated (inputBlock, outputBlock, cutoffFrequenciesHz, resonances);
+    }
+
 protected:
     //==============================================================================
     SampleType processSample (SampleType inputValue, size_t channelToUse) noexcept;
@@ -127,6 +175,17 @@ private:
     void updateCutoffFreq() noexcept        { cutoffTransformSmoother.setTargetValue (std::exp (cutoffFreqHz * cutoffFreqScaler)); }
     void updateResonance() noexcept         { scaledResonanceSmoother.setTargetValue (jmap (resonance, SampleType (0.1), SampleType (1.0))); }
 
+    void processModulated (const AudioBlock<const SampleType>& inputBlock,
+                           const AudioBlock<SampleType>& outputBlock,
+                           const AudioBlock<const SampleType>& cutoffFrequenciesHz,
+                           const AudioBlock<const SampleType>& resonances) noexcept;
+
+    void processModulatedLanes (size_t firstChannel,
+                                const AudioBlock<const SampleType>& inputBlock,
+                                const AudioBlock<SampleType>& outputBlock,
+                                const AudioBlock<const SampleType>& cutoffFrequenciesHz,
+                                const AudioBlock<const SampleType>& resonances) noexcept;
+
     //==============================================================================
     SampleType drive, drive2, gain, gain2, comp;
 
@@ -147,6 +206,10 @@ private:
 
     Mode mode;
     bool enabled = true;
+
+   #if JUCE_UNIT_TESTS
+    friend class LadderFilterTest;
+   #endif
 };
 
 } // namespace dsp
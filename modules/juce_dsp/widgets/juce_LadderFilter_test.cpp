@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class LadderFilterTest : public UnitTest
+{
+public:
+    LadderFilterTest()
+        : UnitTest ("LadderFilter", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runModulationTests<float>();
+        runModulationTests<double>();
+    }
+
+private:
+    // Runs one sample through the filter with the given parameters, skipping the
+    // smoothing that setCutoffFrequencyHz() and setResonance() normally apply
+    template <typename Type>
+    static Type processSampleWithParameters (LadderFilter<Type>& filter, size_t channel,
+                                             Type input, Type cutoffFrequencyHz, Type resonance)
+    {
+        filter.setCutoffFrequencyHz (cutoffFrequencyHz);
+        filter.setResonance (resonance);
+        filter.cutoffTransformSmoother.setCurrentAndTargetValue (filter.cutoffTransformSmoother.getTargetValue());
+        filter.scaledResonanceSmoother.setCurrentAndTargetValue (filter.scaledResonanceSmoother.getTargetValue());
+        filter.updateSmoothers();
+        return filter.processSample (input, channel);
+    }
+
+    template <typename Type>
+    void runModulationTests()
+    {
+        using namespace AudioBufferTestHelpers;
+        using Mode = typename LadderFilter<Type>::Mode;
+
+        constexpr auto sampleRate = 44100.0;
+        constexpr int numChannels = 5, blockSize = 256;
+        Random random (0x5678);
+
+        beginTest ("Modulated processing matches changing the parameters on every sample");
+        {
+            for (auto mode : { Mode::LPF12, Mode::HPF12, Mode::BPF12, Mode::LPF24, Mode::HPF24, Mode::BPF24 })
+            {
+                // Either a separate cutoff for each channel, or one shared by all of them
+                for (auto numCutoffChannels : { numChannels, 1 })
+                {
+                    LadderFilter<Type> reference, filter;
+
+                    for (auto* f : { &reference, &filter })
+                    {
+                        f->setMode (mode);
+                        f->prepare ({ sampleRate, (uint32) blockSize, (uint32) numChannels });
+                    }
+
+                    AudioBuffer<Type> cutoffs (numCutoffChannels, blockSize), resonances (1, blockSize);
+
+                    // Several blocks in a row, to check that the state is carried over
+                    for (int n = 0; n < 4; ++n)
+                    {
+                        // Exponential sweeps between 20 Hz and 20 kHz, a different one for each channel
+                        for (int ch = 0; ch < numCutoffChannels; ++ch)
+                        {
+                            for (int i = 0; i < blockSize; ++i)
+                            {
+                                const auto phase = MathConstants<double>::twoPi * (n * blockSize + i) / 300.0 + ch;
+                                cutoffs.setSample (ch, i, (Type) (20.0 * std::pow (1000.0, 0.5 + 0.5 * std::sin (phase))));
+                            }
+                        }
+
+                        for (int i = 0; i < blockSize; ++i)
+                            resonances.setSample (0, i, (Type) random.nextFloat());
+
+                        auto expected = makeNoise<Type> (random, numChannels, blockSize);
+                        AudioBuffer<Type> actual (expected);
+
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            for (int ch = 0; ch < numChannels; ++ch)
+                            {
+                                expected.setSample (ch, i, processSampleWithParameters (reference, (size_t) ch, expected.getSample (ch, i),
+                                                                                        cutoffs.getSample (jmin (ch, numCutoffChannels - 1), i),
+                                                                                        resonances.getSample (0, i)));
+                            }
+                        }
+
+                        AudioBlock<Type> block (actual);
+                        filter.process (ProcessContextReplacing<Type> (block), AudioBlock<const Type> (cutoffs), AudioBlock<const Type> (resonances));
+
+                        // The modulated coefficients use an approximation of exp(), hence the tolerance
+                        expectLessThan (getMaxDifference (expected, actual), (Type) 2.0e-3);
+                    }
+                }
+            }
+        }
+
+        beginTest ("Empty modulation blocks use the filter's parameters");
+        {
+            LadderFilter<Type> reference, filter;
+
+            for (auto* f : { &reference, &filter })
+            {
+                f->setCutoffFrequencyHz ((Type) 1000);
+                f->setResonance ((Type) 0.7);
+                f->prepare ({ sampleRate, (uint32) blockSize, (uint32) numChannels });
+            }
+
+            auto expected = makeNoise<Type> (random, numChannels, blockSize);
+            AudioBuffer<Type> actual (expected);
+
+            AudioBlock<Type> expectedBlock (expected), actualBlock (actual);
+            reference.process (ProcessContextReplacing<Type> (expectedBlock));
+            filter.process (ProcessContextReplacing<Type> (actualBlock), {}, {});
+
+            expectLessThan (getMaxDifference (expected, actual), (Type) 1.0e-3);
+        }
+    }
+};
+
+static LadderFilterTest ladderFilterTest;
+
+} // namespace dsp
+} // namespace juce
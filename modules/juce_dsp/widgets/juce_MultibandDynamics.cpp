@@ -0,0 +1,453 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+MultibandDynamics<SampleType>::MultibandDynamics()
+{
+    for (size_t band = 0; band < bands.size(); ++band)
+        update (band);
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandDynamics<SampleType>::setCrossoverFrequencies (const Array<SampleType>& newFrequenciesHz)
+{
+    for (int i = 1; i < newFrequenciesHz.size(); ++i)
+        jassert (newFrequenciesHz.getUnchecked (i - 1) < newFrequenciesHz.getUnchecked (i));
+
+    const auto newNumBands = (size_t) newFrequenciesHz.size() + 1;
+    const auto numBandsChanged = newNumBands != bands.size();
+
+    crossoverFrequencies.assign (newFrequenciesHz.begin(), newFrequenciesHz.end());
+    bands.resize (newNumBands);
+
+    if (numBandsChanged && numPreparedChannels > 0)
+    {
+        allocate();
+        reset();
+        return;
+    }
+
+    updateCrossovers();
+}
+
+template <typename SampleType>
+SampleType MultibandDynamics<SampleType>::getCrossoverFrequency (size_t index) const noexcept
+{
+    jassert (index < crossoverFrequencies.size());
+    return crossoverFrequencies[index];
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandDynamics<SampleType>::setThreshold (size_t band, SampleType newThreshold)
+{
+    jassert (band < bands.size());
+
+    bands[band].thresholddB = newThreshold;
+    update (band);
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::setRatio (size_t band, SampleType newRatio)
+{
+    jassert (band < bands.size());
+    jassert (newRatio >= static_cast<SampleType> (1.0));
+
+    bands[band].ratio = newRatio;
+    update (band);
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::setAttack (size_t band, SampleType newAttack)
+{
+    jassert (band < bands.size());
+
+    bands[band].attackTime = newAttack;
+    update (band);
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::setRelease (size_t band, SampleType newRelease)
+{
+    jassert (band < bands.size());
+
+    bands[band].releaseTime = newRelease;
+    update (band);
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::setMakeupGain (size_t band, SampleType newGain)
+{
+    jassert (band < bands.size());
+
+    bands[band].makeupGaindB = newGain;
+    update (band);
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandDynamics<SampleType>::setChannelLink (SampleType newAmount)
+{
+    jassert (isPositiveAndNotGreaterThan (newAmount, static_cast<SampleType> (1.0)));
+
+    channelLink = jlimit (static_cast<SampleType> (0.0), static_cast<SampleType> (1.0), newAmount);
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::setLookAhead (SampleType newLookAheadMs)
+{
+    jassert (isPositiveAndNotGreaterThan (newLookAheadMs, maxLookAheadMs));
+
+    const auto wasDelaying = lookAheadSamples > 0;
+
+    lookAheadTime = jlimit (static_cast<SampleType> (0.0), maxLookAheadMs, newLookAheadMs);
+    lookAheadSamples = roundToInt (lookAheadTime * sampleRate / 1000.0);
+
+    if (numPreparedChannels > 0)
+    {
+        // Nothing is pushed into the delay line while there's no look-ahead, so
+        // clear out what's left from before instead of playing it back
+        if (! wasDelaying && lookAheadSamples > 0)
+            lookAheadDelay.reset();
+
+        lookAheadDelay.setDelay (static_cast<SampleType> (lookAheadSamples));
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandDynamics<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+    jassert (spec.numChannels > 0);
+
+    sampleRate = spec.sampleRate;
+    numPreparedChannels = spec.numChannels;
+    maximumBlockSize = spec.maximumBlockSize;
+
+    allocate();
+    reset();
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::reset()
+{
+    for (auto* filters : { &splitters, &sidechainSplitters, &allpassFilters })
+        for (auto& filter : *filters)
+            filter.reset();
+
+    lookAheadDelay.reset();
+    std::fill (envelopes.begin(), envelopes.end(), LanesType());
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::snapToZero() noexcept
+{
+    for (auto* filters : { &splitters, &sidechainSplitters, &allpassFilters })
+        for (auto& filter : *filters)
+            filter.snapToZero();
+
+    auto* envelopeLanes = Lanes::getLanes (envelopes.data());
+
+    for (size_t lane = 0; lane < numLanes; ++lane)
+        util::snapToZero (envelopeLanes[lane]);
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandDynamics<SampleType>::allocate()
+{
+    const auto numBands = bands.size();
+    const ProcessSpec filterSpec { sampleRate, maximumBlockSize, (uint32) numPreparedChannels };
+
+    const auto makeFilters = [&] (size_t numFilters, LinkwitzRileyFilterType type)
+    {
+        std::vector<LinkwitzRileyFilter<SampleType>> filters (numFilters);
+
+        for (auto& filter : filters)
+        {
+            filter.setType (type);
+            filter.prepare (filterSpec);
+        }
+
+        return filters;
+    };
+
+    splitters          = makeFilters (numBands - 1, LinkwitzRileyFilterType::lowpass);
+    sidechainSplitters = makeFilters (numBands - 1, LinkwitzRileyFilterType::lowpass);
+    allpassFilters     = makeFilters (numBands > 1 ? (numBands - 1) * (numBands - 2) / 2 : 0, LinkwitzRileyFilterType::allpass);
+
+    updateCrossovers();
+
+    const auto numBandLanes = numBands * numPreparedChannels;
+    const auto numRegisters = (numBandLanes + Lanes::numLanes - 1) / Lanes::numLanes;
+    numLanes = numRegisters * Lanes::numLanes;
+
+    bandSamples.assign (numBandLanes * samplesPerChunk, SampleType());
+    levels.assign (numRegisters * samplesPerChunk, LanesType());
+    envelopes.assign (numRegisters, LanesType());
+    attackCoefficients.assign (numRegisters, LanesType());
+    releaseCoefficients.assign (numRegisters, LanesType());
+
+    lookAheadDelay = DelayLine<SampleType, DelayLineInterpolationTypes::None> { (int) std::ceil (maxLookAheadMs * sampleRate / 1000.0) };
+    lookAheadDelay.prepare ({ sampleRate, maximumBlockSize, (uint32) numBandLanes });
+    setLookAhead (lookAheadTime);
+
+    for (size_t band = 0; band < numBands; ++band)
+        update (band);
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::updateCrossovers()
+{
+    if (splitters.size() != crossoverFrequencies.size())
+        return;
+
+    for (size_t i = 0; i < crossoverFrequencies.size(); ++i)
+    {
+        splitters[i].setCutoffFrequency (crossoverFrequencies[i]);
+        sidechainSplitters[i].setCutoffFrequency (crossoverFrequencies[i]);
+    }
+
+    // The allpass filters of each band match the crossovers above it
+    size_t allpassIndex = 0;
+
+    for (size_t band = 0; band < bands.size(); ++band)
+        for (size_t i = band + 1; i < crossoverFrequencies.size(); ++i)
+            allpassFilters[allpassIndex++].setCutoffFrequency (crossoverFrequencies[i]);
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::update (size_t band)
+{
+    auto& b = bands[band];
+
+    b.threshold        = Decibels::decibelsToGain (b.thresholddB, static_cast<SampleType> (-200.0));
+    b.thresholdInverse = static_cast<SampleType> (1.0) / b.threshold;
+    b.ratioInverse     = static_cast<SampleType> (1.0) / b.ratio;
+    b.makeupGain       = Decibels::decibelsToGain (b.makeupGaindB, static_cast<SampleType> (-200.0));
+
+    if (attackCoefficients.empty())
+        return;
+
+    auto* attackLanes  = Lanes::getLanes (attackCoefficients.data());
+    auto* releaseLanes = Lanes::getLanes (releaseCoefficients.data());
+
+    for (size_t channel = 0; channel < numPreparedChannels; ++channel)
+    {
+        attackLanes [band * numPreparedChannels + channel] = calculateBallisticsCoefficient (b.attackTime);
+        releaseLanes[band * numPreparedChannels + channel] = calculateBallisticsCoefficient (b.releaseTime);
+    }
+}
+
+template <typename SampleType>
+SampleType MultibandDynamics<SampleType>::calculateBallisticsCoefficient (SampleType timeMs) const noexcept
+{
+    // The same as in BallisticsFilter
+    const auto expFactor = -2.0 * MathConstants<double>::pi * 1000.0 / sampleRate;
+
+    return timeMs < static_cast<SampleType> (1.0e-3) ? 0
+                                                     : static_cast<SampleType> (std::exp (expFactor / timeMs));
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandDynamics<SampleType>::splitIntoBands (const AudioBlock<const SampleType>& inputBlock,
+                                                    size_t start, size_t numSamples, bool measureLevels) noexcept
+{
+    const auto numBands = bands.size();
+    auto* levelLanes = Lanes::getLanes (levels.data());
+
+    for (size_t channel = 0; channel < numPreparedChannels; ++channel)
+    {
+        const auto* input = inputBlock.getChannelPointer (channel) + start;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto rest = input[i];
+            size_t allpassIndex = 0;
+
+            for (size_t band = 0; band < numBands; ++band)
+            {
+                auto value = rest;
+
+                if (band + 1 < numBands)
+                    splitters[band].processSample ((int) channel, rest, value, rest);
+
+                for (size_t j = band + 1; j + 1 < numBands; ++j)
+                    value = allpassFilters[allpassIndex++].processSample ((int) channel, value);
+
+                const auto lane = band * numPreparedChannels + channel;
+                bandSamples[lane * samplesPerChunk + i] = value;
+
+                if (measureLevels)
+                    levelLanes[i * numLanes + lane] = std::abs (value);
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::measureSidechain (const AudioBlock<const SampleType>& sidechainBlock,
+                                                      size_t start, size_t numSamples) noexcept
+{
+    const auto numBands = bands.size();
+    auto* levelLanes = Lanes::getLanes (levels.data());
+
+    for (size_t channel = 0; channel < numPreparedChannels; ++channel)
+    {
+        const auto* sidechain = sidechainBlock.getChannelPointer (jmin (channel, sidechainBlock.getNumChannels() - 1)) + start;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto rest = sidechain[i];
+
+            for (size_t band = 0; band < numBands; ++band)
+            {
+                auto value = rest;
+
+                if (band + 1 < numBands)
+                    sidechainSplitters[band].processSample ((int) channel, rest, value, rest);
+
+                levelLanes[i * numLanes + band * numPreparedChannels + channel] = std::abs (value);
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::linkChannels (size_t numSamples) noexcept
+{
+    if (channelLink <= static_cast<SampleType> (0.0) || numPreparedChannels < 2)
+        return;
+
+    auto* levelLanes = Lanes::getLanes (levels.data());
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        for (size_t band = 0; band < bands.size(); ++band)
+        {
+            auto* bandLevels = levelLanes + i * numLanes + band * numPreparedChannels;
+            const auto loudest = *std::max_element (bandLevels, bandLevels + numPreparedChannels);
+
+            for (size_t channel = 0; channel < numPreparedChannels; ++channel)
+                bandLevels[channel] += channelLink * (loudest - bandLevels[channel]);
+        }
+    }
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::followEnvelopes (size_t numSamples) noexcept
+{
+    const auto numRegisters = envelopes.size();
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto* sampleLevels = levels.data() + i * numRegisters;
+
+        for (size_t r = 0; r < numRegisters; ++r)
+        {
+            const auto level = sampleLevels[r];
+            auto& envelope = envelopes[r];
+
+            envelope = level + getBallisticsCoefficient (level, envelope, attackCoefficients[r], releaseCoefficients[r]) * (envelope - level);
+            sampleLevels[r] = envelope;
+        }
+    }
+}
+
+template <typename SampleType>
+void MultibandDynamics<SampleType>::applyGains (const AudioBlock<SampleType>& outputBlock, size_t start, size_t numSamples) noexcept
+{
+    const auto* envelopeLanes = Lanes::getLanes (levels.data());
+
+    for (size_t channel = 0; channel < numPreparedChannels; ++channel)
+    {
+        auto* output = outputBlock.getChannelPointer (channel) + start;
+        std::fill (output, output + numSamples, SampleType());
+
+        for (size_t band = 0; band < bands.size(); ++band)
+        {
+            const auto& b = bands[band];
+            const auto lane = band * numPreparedChannels + channel;
+            const auto* samples = bandSamples.data() + lane * samplesPerChunk;
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                auto value = samples[i];
+
+                if (lookAheadSamples > 0)
+                {
+                    lookAheadDelay.pushSample ((int) lane, value);
+                    value = lookAheadDelay.popSample ((int) lane);
+                }
+
+                const auto envelope = envelopeLanes[i * numLanes + lane];
+
+                // VCA
+                const auto gain = (envelope < b.threshold) ? static_cast<SampleType> (1.0)
+                                                           : std::pow (envelope * b.thresholdInverse, b.ratioInverse - static_cast<SampleType> (1.0));
+
+                output[i] += gain * b.makeupGain * value;
+            }
+        }
+    }
+}
+
+//==============================================================================
+#if JUCE_USE_SIMD
+
+template <typename SampleType>
+typename MultibandDynamics<SampleType>::LanesType MultibandDynamics<SampleType>::getBallisticsCoefficient (LanesType level, LanesType envelope,
+                                                                                                          LanesType attack, LanesType release) noexcept
+{
+    const auto isRising = LanesType::greaterThan (level, envelope);
+    return (attack & isRising) + (release & ~isRising);
+}
+
+#else
+
+template <typename SampleType>
+typename MultibandDynamics<SampleType>::LanesType MultibandDynamics<SampleType>::getBallisticsCoefficient (LanesType level, LanesType envelope,
+                                                                                                          LanesType attack, LanesType release) noexcept
+{
+    return level > envelope ? attack : release;
+}
+
+#endif
+
+//==============================================================================
+template class MultibandDynamics<float>;
+template class MultibandDynamics<double>;
+
+} // namespace dsp
+} // namespace juce
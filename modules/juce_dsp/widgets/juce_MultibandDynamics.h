@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A multiband compressor, which splits the signal into several bands with a
+    Linkwitz-Riley crossover and compresses each of them separately.
+
+    The bands are made with LinkwitzRileyFilter objects, and the lower bands go
+    through allpass filters matching the higher crossovers, so that the bands add
+    up to a signal with a flat magnitude response when no compression is applied.
+
+    All the bands of all the channels share a single envelope detector, with the
+    same attack and release ballistics as a BallisticsFilter in peak mode, which
+    follows several of them at once using SIMD instructions when they are available.
+    Each band has the threshold, ratio, attack and release controls of a Compressor,
+    plus a makeup gain.
+
+    The channels can be linked, so that they get the same gain reduction and keep
+    the stereo image stable, and the detection can be driven by a sidechain signal
+    instead of the input. A look-ahead time delays the audio relative to the
+    detector, so that the gain is already reduced when a transient arrives.
+
+    @see Compressor, LinkwitzRileyFilter, BallisticsFilter
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class MultibandDynamics
+{
+public:
+    //==============================================================================
+    /** Constructor. By default, there are three bands, split at 200 Hz and 2 kHz. */
+    MultibandDynamics();
+
+    //==============================================================================
+    /** Sets the frequencies in Hz at which the bands are split, in ascending order.
+        There is one more band than there are crossover frequencies.
+
+        If the number of bands changes, memory is allocated and the processor is
+        reset, so this shouldn't be done on the audio thread. The settings of the
+        existing bands are kept, and new bands don't apply any compression.
+    */
+    void setCrossoverFrequencies (const Array<SampleType>& newFrequenciesHz);
+
+    /** Returns the number of bands. */
+    size_t getNumBands() const noexcept                          { return bands.size(); }
+
+    /** Returns the frequency in Hz of one of the crossovers. */
+    SampleType getCrossoverFrequency (size_t index) const noexcept;
+
+    //==============================================================================
+    /** Sets the threshold in dB of one of the bands. */
+    void setThreshold (size_t band, SampleType newThreshold);
+
+    /** Sets the ratio of one of the bands (must be higher or equal to 1). */
+    void setRatio (size_t band, SampleType newRatio);
+
+    /** Sets the attack time in milliseconds of one of the bands. */
+    void setAttack (size_t band, SampleType newAttack);
+
+    /** Sets the release time in milliseconds of one of the bands. */
+    void setRelease (size_t band, SampleType newRelease);
+
+    /** Sets the gain in dB applied to one of the bands after the compression. */
+    void setMakeupGain (size_t band, SampleType newGain);
+
+    //==============================================================================
+    /** Sets how much the channels are linked, between 0 and 1.
+
+        At 0, each channel is compressed according to its own level. At 1, which is
+        the default, all the channels follow the loudest one in each band.
+    */
+    void setChannelLink (SampleType newAmount);
+
+    /** Sets how far ahead in milliseconds the detector looks, which must be between
+        0 and 50 ms. The output is delayed by this amount, as reported by
+        getLatencyInSamples().
+    */
+    void setLookAhead (SampleType newLookAheadMs);
+
+    /** Returns the delay of the output in samples, caused by the look-ahead. */
+    int getLatencyInSamples() const noexcept                     { return lookAheadSamples; }
+
+    //==============================================================================
+    /** Initialises the processor. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the internal state variables of the processor. */
+    void reset();
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        processWithSidechain (context, nullptr);
+    }
+
+    /** Processes the input and output samples supplied in the processing context,
+        working out the compression from the bands of a sidechain signal instead of
+        the input.
+
+        The sidechain block must have the same number of samples as the context, and
+        either one channel per channel of the context, or a single channel which is
+        used for all of them.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context, const AudioBlock<const SampleType>& sidechainBlock) noexcept
+    {
+        jassert (sidechainBlock.getNumChannels() == 1 || sidechainBlock.getNumChannels() == context.getOutputBlock().getNumChannels());
+        jassert (sidechainBlock.getNumSamples() == context.getOutputBlock().getNumSamples());
+
+        processWithSidechain (context, &sidechainBlock);
+    }
+
+    /** Ensure that the state variables are rounded to zero if the state
+        variables are denormals.
+    */
+    void snapToZero() noexcept;
+
+private:
+    //==============================================================================
+    using Lanes     = detail::SIMDLanes<SampleType>;
+    using LanesType = typename Lanes::Type;
+
+    static constexpr size_t samplesPerChunk = 32;
+    static constexpr SampleType maxLookAheadMs = 50.0;
+
+    struct Band
+    {
+        SampleType thresholddB = 0.0, ratio = 1.0, attackTime = 1.0, releaseTime = 100.0, makeupGaindB = 0.0;
+        SampleType threshold = 1.0, thresholdInverse = 1.0, ratioInverse = 1.0, makeupGain = 1.0;
+    };
+
+    //==============================================================================
+    template <typename ProcessContext>
+    void processWithSidechain (const ProcessContext& context, const AudioBlock<const SampleType>* sidechainBlock) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+        const auto numChannels = outputBlock.getNumChannels();
+        const auto numSamples  = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumChannels() == numPreparedChannels);
+        jassert (inputBlock.getNumChannels() == numChannels);
+        jassert (inputBlock.getNumSamples()  == numSamples);
+
+        if (context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        for (size_t start = 0; start < numSamples; start += samplesPerChunk)
+        {
+            const auto numChunkSamples = jmin (samplesPerChunk, numSamples - start);
+
+            splitIntoBands (inputBlock, start, numChunkSamples, sidechainBlock == nullptr);
+
+            if (sidechainBlock != nullptr)
+                measureSidechain (*sidechainBlock, start, numChunkSamples);
+
+            linkChannels (numChunkSamples);
+            followEnvelopes (numChunkSamples);
+            applyGains (outputBlock, start, numChunkSamples);
+        }
+
+       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+        snapToZero();
+       #endif
+    }
+
+    void splitIntoBands (const AudioBlock<const SampleType>& inputBlock, size_t start, size_t numSamples, bool measureLevels) noexcept;
+    void measureSidechain (const AudioBlock<const SampleType>& sidechainBlock, size_t start, size_t numSamples) noexcept;
+    void linkChannels (size_t numSamples) noexcept;
+    void followEnvelopes (size_t numSamples) noexcept;
+    void applyGains (const AudioBlock<SampleType>& outputBlock, size_t start, size_t numSamples) noexcept;
+
+    static LanesType getBallisticsCoefficient (LanesType level, LanesType envelope, LanesType attack, LanesType release) noexcept;
+
+    void allocate();
+    void updateCrossovers();
+    void update (size_t band);
+    SampleType calculateBallisticsCoefficient (SampleType timeMs) const noexcept;
+
+    //==============================================================================
+    std::vector<Band> bands { 3 };
+    std::vector<SampleType> crossoverFrequencies { 200.0, 2000.0 };
+
+    std::vector<LinkwitzRileyFilter<SampleType>> splitters, sidechainSplitters, allpassFilters;
+    DelayLine<SampleType, DelayLineInterpolationTypes::None> lookAheadDelay;
+
+    // Every channel of every band has a lane, with the index band * numPreparedChannels + channel
+    std::vector<SampleType> bandSamples;
+    std::vector<LanesType> levels, envelopes, attackCoefficients, releaseCoefficients;
+    size_t numLanes = 0;
+
+    double sampleRate = 44100.0;
+    size_t numPreparedChannels = 0;
+    uint32 maximumBlockSize = 512;
+    SampleType channelLink = 1.0, lookAheadTime = 0.0;
+    int lookAheadSamples = 0;
+};
+
+} // namespace dsp
+} // namespace juce
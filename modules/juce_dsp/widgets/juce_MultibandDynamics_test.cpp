@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class MultibandDynamicsTest : public UnitTest
+{
+public:
+    MultibandDynamicsTest()
+        : UnitTest ("MultibandDynamics", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runDynamicsTests<float>();
+        runDynamicsTests<double>();
+    }
+
+private:
+    template <typename Type>
+    void runDynamicsTests()
+    {
+        using namespace AudioBufferTestHelpers;
+
+        constexpr auto sampleRate = 48000.0;
+        constexpr int numChannels = 3, numSamples = 1000;
+        const ProcessSpec spec { sampleRate, (uint32) numSamples, (uint32) numChannels };
+        Random random (0x2468);
+
+        const auto processAllpassReference = [&] (AudioBuffer<Type>& buffer, const Array<Type>& frequencies)
+        {
+            for (auto frequency : frequencies)
+            {
+                LinkwitzRileyFilter<Type> allpass;
+                allpass.setType (LinkwitzRileyFilterType::allpass);
+                allpass.prepare (spec);
+                allpass.setCutoffFrequency (frequency);
+
+                AudioBlock<Type> block (buffer);
+                allpass.process (ProcessContextReplacing<Type> (block));
+            }
+        };
+
+        beginTest ("Without compression, the bands add up to an allpass filtered signal");
+        {
+            for (auto frequencies : { Array<Type>(), Array<Type> { (Type) 1000 }, Array<Type> { (Type) 100, (Type) 1000, (Type) 5000, (Type) 12000 } })
+            {
+                MultibandDynamics<Type> dynamics;
+                dynamics.setCrossoverFrequencies (frequencies);
+                dynamics.prepare (spec);
+                expectEquals (dynamics.getNumBands(), (size_t) frequencies.size() + 1);
+
+                auto expected = makeNoise (random, numChannels, numSamples, (Type) 1);
+                AudioBuffer<Type> actual (expected);
+
+                processAllpassReference (expected, frequencies);
+
+                AudioBlock<Type> block (actual);
+                dynamics.process (ProcessContextReplacing<Type> (block));
+
+                expectLessThan (getMaxDifference (expected, actual), (Type) 1.0e-4);
+            }
+        }
+
+        beginTest ("Look-ahead delays the output by the reported latency");
+        {
+            const Array<Type> frequencies { (Type) 300, (Type) 3000 };
+
+            MultibandDynamics<Type> dynamics;
+            dynamics.setCrossoverFrequencies (frequencies);
+            dynamics.setLookAhead ((Type) 5);
+            dynamics.prepare (spec);
+            expectEquals (dynamics.getLatencyInSamples(), 240);
+
+            auto expected = makeNoise (random, numChannels, numSamples, (Type) 1);
+            AudioBuffer<Type> actual (expected);
+
+            processAllpassReference (expected, frequencies);
+
+            AudioBlock<Type> block (actual);
+            dynamics.process (ProcessContextReplacing<Type> (block));
+
+            expectLessThan (getMaxDifference (expected, actual, dynamics.getLatencyInSamples()), (Type) 1.0e-4);
+        }
+
+        beginTest ("Turning the look-ahead off and on again doesn't play back old audio");
+        {
+            MultibandDynamics<Type> dynamics;
+            dynamics.setCrossoverFrequencies ({});
+            dynamics.setLookAhead ((Type) 5);
+            dynamics.prepare (spec);
+
+            for (auto lookAhead : { (Type) 5, (Type) 0, (Type) 5 })
+            {
+                dynamics.setLookAhead (lookAhead);
+
+                const auto input = makeNoise (random, numChannels, numSamples, (Type) 1);
+                AudioBuffer<Type> output (input);
+
+                AudioBlock<Type> block (output);
+                dynamics.process (ProcessContextReplacing<Type> (block));
+
+                // After the look-ahead is turned back on, the output starts from
+                // silence rather than from the end of the first block
+                expectLessThan (getMaxDifference (input, output, dynamics.getLatencyInSamples()), (Type) 1.0e-5);
+            }
+        }
+
+        beginTest ("A single band behaves like a Compressor");
+        {
+            MultibandDynamics<Type> dynamics;
+            dynamics.setCrossoverFrequencies ({});
+            dynamics.setChannelLink (0);
+            dynamics.setThreshold (0, (Type) -12);
+            dynamics.setRatio (0, (Type) 4);
+            dynamics.setAttack (0, (Type) 2);
+            dynamics.setRelease (0, (Type) 50);
+            dynamics.prepare (spec);
+
+            Compressor<Type> compressor;
+            compressor.setThreshold ((Type) -12);
+            compressor.setRatio ((Type) 4);
+            compressor.setAttack ((Type) 2);
+            compressor.setRelease ((Type) 50);
+            compressor.prepare (spec);
+
+            auto expected = makeNoise (random, numChannels, numSamples, (Type) 1);
+            AudioBuffer<Type> actual (expected);
+
+            AudioBlock<Type> expectedBlock (expected), actualBlock (actual);
+            compressor.process (ProcessContextReplacing<Type> (expectedBlock));
+            dynamics.process (ProcessContextReplacing<Type> (actualBlock));
+
+            expectLessThan (getMaxDifference (expected, actual), (Type) 1.0e-5);
+        }
+
+        beginTest ("Linked channels get the same gain reduction");
+        {
+            MultibandDynamics<Type> dynamics;
+            dynamics.setCrossoverFrequencies ({});
+            dynamics.setThreshold (0, (Type) -20);
+            dynamics.setRatio (0, (Type) 10);
+            dynamics.prepare (spec);
+
+            // Replaces the other channels with scaled copies of the first one
+            const auto scaleChannels = [&] (AudioBuffer<Type>& buffer)
+            {
+                for (int ch = 1; ch < numChannels; ++ch)
+                    buffer.copyFrom (ch, 0, buffer, 0, 0, numSamples);
+
+                buffer.applyGain (1, 0, numSamples, (Type) 0.01);
+                buffer.applyGain (2, 0, numSamples, (Type) 0.5);
+            };
+
+            auto input = makeNoise (random, numChannels, numSamples, (Type) 1);
+            scaleChannels (input);
+
+            AudioBuffer<Type> output (input);
+            AudioBlock<Type> block (output);
+            dynamics.process (ProcessContextReplacing<Type> (block));
+
+            AudioBuffer<Type> expected (output);
+            scaleChannels (expected);
+
+            expectLessThan (getMaxDifference (expected, output), (Type) 1.0e-5);
+            expectLessThan (output.getRMSLevel (0, numSamples / 2, numSamples / 2),
+                            input.getRMSLevel (0, numSamples / 2, numSamples / 2) * (Type) 0.5);
+        }
+
+        beginTest ("The sidechain drives the compression");
+        {
+            const Array<Type> frequencies { (Type) 500, (Type) 4000 };
+
+            MultibandDynamics<Type> dynamics;
+            dynamics.setCrossoverFrequencies (frequencies);
+
+            for (size_t band = 0; band < dynamics.getNumBands(); ++band)
+            {
+                dynamics.setThreshold (band, (Type) -40);
+                dynamics.setRatio (band, (Type) 20);
+            }
+
+            dynamics.prepare (spec);
+
+            auto expected = makeNoise (random, numChannels, numSamples, (Type) 1);
+            AudioBuffer<Type> actual (expected), sidechain (1, numSamples);
+
+            processAllpassReference (expected, frequencies);
+
+            // A silent sidechain leaves the signal as it is
+            sidechain.clear();
+            AudioBlock<Type> block (actual);
+            dynamics.process (ProcessContextReplacing<Type> (block), AudioBlock<const Type> (sidechain));
+
+            expectLessThan (getMaxDifference (expected, actual), (Type) 1.0e-4);
+
+            // ...and a loud one makes it quieter
+            auto loudSidechain = makeNoise (random, 1, numSamples, (Type) 1);
+            auto quiet = makeNoise (random, numChannels, numSamples, (Type) 0.001);
+            AudioBuffer<Type> compressed (quiet);
+
+            AudioBlock<Type> compressedBlock (compressed);
+            dynamics.process (ProcessContextReplacing<Type> (compressedBlock), AudioBlock<const Type> (loudSidechain));
+
+            expectLessThan (compressed.getMagnitude (0, numSamples / 2, numSamples / 2),
+                            quiet.getMagnitude (0, numSamples / 2, numSamples / 2) * (Type) 0.5);
+        }
+    }
+};
+
+static MultibandDynamicsTest multibandDynamicsTest;
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,485 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+WavetableOscillatorBank<SampleType>::WavetableOscillatorBank()
+    : chunk (8 * samplesPerChunk)
+{
+    setWaveform ([] (SampleType x) { return std::sin (x); });
+    setNumOscillators (1);
+}
+
+//==============================================================================
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setWaveform (const std::function<SampleType (SampleType)>& function)
+{
+    AudioBuffer<SampleType> frame (1, (int) tableSize);
+    auto* samples = frame.getWritePointer (0);
+
+    for (size_t i = 0; i < tableSize; ++i)
+        samples[i] = function (MathConstants<SampleType>::twoPi * (SampleType) i / (SampleType) tableSize
+                                 - MathConstants<SampleType>::pi);
+
+    buildTables (frame);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setWavetable (const AudioBuffer<SampleType>& frames)
+{
+    jassert (frames.getNumChannels() > 0);
+    jassert (isPowerOfTwo (frames.getNumSamples()) && frames.getNumSamples() > 1);
+
+    buildTables (frames);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::buildTables (const AudioBuffer<SampleType>& frames)
+{
+    const auto frameSize = (size_t) frames.getNumSamples();
+    const auto numHarmonics = jmin (frameSize, tableSize) / 2 - 1;
+
+    FFT frameFFT (roundToInt (std::log2 (frameSize)));
+    FFT tableFFT (roundToInt (std::log2 (tableSize)));
+
+    std::vector<Complex<float>> frame (frameSize), spectrum (frameSize), levelSpectrum (tableSize), level (tableSize);
+
+    // The inverse transform is scaled by the size of the table, so the harmonics must be
+    // rescaled to keep the same amplitude when the frames have a different size
+    const auto scale = (float) tableSize / (float) frameSize;
+
+    numFrames = (size_t) frames.getNumChannels();
+    tables.resize (numFrames * numLevels * levelSize);
+
+    for (size_t f = 0; f < numFrames; ++f)
+    {
+        const auto* samples = frames.getReadPointer ((int) f);
+
+        for (size_t i = 0; i < frameSize; ++i)
+            frame[i] = { (float) samples[i], 0.0f };
+
+        frameFFT.perform (frame.data(), spectrum.data(), false);
+
+        for (size_t m = 0; m < numLevels; ++m)
+        {
+            // Level m keeps the harmonics that stay below the Nyquist frequency as long as
+            // the phase increment is at most 2^m / tableSize
+            const auto maxHarmonic = jmin (numHarmonics, (tableSize / 2) >> m);
+
+            std::fill (levelSpectrum.begin(), levelSpectrum.end(), Complex<float>());
+            levelSpectrum[0] = spectrum[0] * scale;
+
+            for (size_t h = 1; h <= maxHarmonic; ++h)
+            {
+                levelSpectrum[h] = spectrum[h] * scale;
+                levelSpectrum[tableSize - h] = std::conj (levelSpectrum[h]);
+            }
+
+            tableFFT.perform (levelSpectrum.data(), level.data(), true);
+
+            auto* table = tables.data() + (f * numLevels + m) * levelSize;
+
+            for (size_t i = 0; i < tableSize; ++i)
+                table[i] = (SampleType) level[i].real();
+
+            table[tableSize]     = table[0];
+            table[tableSize + 1] = table[1];
+        }
+    }
+
+    for (size_t i = 0; i < numOscillators; ++i)
+        setMorphPosition (i, morphPositions[i]);
+}
+
+//==============================================================================
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setNumOscillators (size_t newNumOscillators)
+{
+    const auto oldNumOscillators = numOscillators;
+
+    if (newNumOscillators == oldNumOscillators)
+        return;
+
+    const auto numGroups = (newNumOscillators + Lanes::numLanes - 1) / Lanes::numLanes;
+
+    for (auto* v : { &frequencies, &startPhases, &morphPositions, &gains, &pans })
+        v->resize (newNumOscillators);
+
+    for (auto* v : { &phases, &increments, &currentGains, &targetGains, &currentLeftGains,
+                     &targetLeftGains, &currentRightGains, &targetRightGains })
+        v->resize (numGroups);
+
+    numOscillators = newNumOscillators;
+
+    for (auto i = oldNumOscillators; i < newNumOscillators; ++i)
+    {
+        frequencies[i] = (SampleType) 440.0;
+        gains[i] = (SampleType) 1.0;
+        updateIncrement (i);
+        updateGains (i);
+
+        Lanes::getLane (currentGains, i)      = Lanes::getLane (targetGains, i);
+        Lanes::getLane (currentLeftGains, i)  = Lanes::getLane (targetLeftGains, i);
+        Lanes::getLane (currentRightGains, i) = Lanes::getLane (targetRightGains, i);
+    }
+
+    // The unused lanes of the last group must stay silent
+    for (auto i = newNumOscillators; i < numGroups * Lanes::numLanes; ++i)
+        for (auto* v : { &phases, &increments, &currentGains, &targetGains, &currentLeftGains,
+                         &targetLeftGains, &currentRightGains, &targetRightGains })
+            Lanes::getLane (*v, i) = SampleType();
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setFrequency (size_t index, SampleType newFrequencyHz) noexcept
+{
+    jassert (index < numOscillators);
+
+    frequencies[index] = newFrequencyHz;
+    updateIncrement (index);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setPhase (size_t index, SampleType newPhase) noexcept
+{
+    jassert (index < numOscillators);
+
+    startPhases[index] = newPhase - std::floor (newPhase);
+    Lanes::getLane (phases, index) = startPhases[index];
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setMorphPosition (size_t index, SampleType newPosition) noexcept
+{
+    jassert (index < numOscillators);
+
+    morphPositions[index] = jlimit (SampleType(), (SampleType) (numFrames - 1), newPosition);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setGain (size_t index, SampleType newGain) noexcept
+{
+    jassert (index < numOscillators);
+
+    gains[index] = newGain;
+    updateGains (index);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setPan (size_t index, SampleType newPan) noexcept
+{
+    jassert (index < numOscillators);
+    jassert (newPan >= -1 && newPan <= 1);
+
+    pans[index] = jlimit ((SampleType) -1.0, (SampleType) 1.0, newPan);
+    updateGains (index);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::updateIncrement (size_t index) noexcept
+{
+    Lanes::getLane (increments, index) = frequencies[index] / (SampleType) sampleRate;
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::updateGains (size_t index) noexcept
+{
+    const auto one = (SampleType) 1.0;
+
+    Lanes::getLane (targetGains, index)      = gains[index];
+    Lanes::getLane (targetLeftGains, index)  = gains[index] * jmin (one, one - pans[index]);
+    Lanes::getLane (targetRightGains, index) = gains[index] * jmin (one, one + pans[index]);
+}
+
+//==============================================================================
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+
+    sampleRate = spec.sampleRate;
+
+    for (size_t i = 0; i < numOscillators; ++i)
+        updateIncrement (i);
+
+    reset();
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::reset() noexcept
+{
+    for (size_t i = 0; i < numOscillators; ++i)
+        Lanes::getLane (phases, i) = startPhases[i];
+
+    currentGains      = targetGains;
+    currentLeftGains  = targetLeftGains;
+    currentRightGains = targetRightGains;
+}
+
+//==============================================================================
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::render (const AudioBlock<SampleType>& outputBlock,
+                                                  const AudioBlock<const SampleType>* frequencyRatios) noexcept
+{
+    const auto numChannels = outputBlock.getNumChannels();
+    const auto numSamples  = outputBlock.getNumSamples();
+    const auto isStereo = numChannels == 2;
+
+    auto* mixLeft  = chunk.data() + 6 * samplesPerChunk;
+    auto* mixRight = chunk.data() + 7 * samplesPerChunk;
+
+    for (size_t start = 0; start < numSamples; start += samplesPerChunk)
+    {
+        const auto numChunkSamples = jmin (samplesPerChunk, numSamples - start);
+
+        std::fill (mixLeft,  mixLeft  + numChunkSamples, LanesType());
+        std::fill (mixRight, mixRight + numChunkSamples, LanesType());
+
+        for (size_t group = 0; group < phases.size(); ++group)
+            renderGroup (group, start, numChunkSamples, frequencyRatios, isStereo);
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* mix = (isStereo && channel == 1) ? mixRight : mixLeft;
+            auto* output = outputBlock.getChannelPointer (channel) + start;
+
+            for (size_t i = 0; i < numChunkSamples; ++i)
+                output[i] += Lanes::sum (mix[i]);
+        }
+    }
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::renderGroup (size_t group, size_t start, size_t numSamples,
+                                                       const AudioBlock<const SampleType>* frequencyRatios,
+                                                       bool isStereo) noexcept
+{
+    auto* phaseChunk = chunk.data();
+    auto* fractions  = phaseChunk + samplesPerChunk;
+    auto* samplesA0  = phaseChunk + 2 * samplesPerChunk;
+    auto* samplesA1  = phaseChunk + 3 * samplesPerChunk;
+    auto* samplesB0  = phaseChunk + 4 * samplesPerChunk;
+    auto* samplesB1  = phaseChunk + 5 * samplesPerChunk;
+    auto* mixLeft    = phaseChunk + 6 * samplesPerChunk;
+    auto* mixRight   = phaseChunk + 7 * samplesPerChunk;
+
+    // Phases
+    auto phase = phases[group];
+    LanesType maxIncrement {};
+
+    if (frequencyRatios == nullptr)
+    {
+        const auto increment = clampIncrement (increments[group], maxIncrement);
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            phaseChunk[i] = phase;
+            phase = wrapPhase (phase + increment);
+        }
+    }
+    else
+    {
+        const SampleType* ratios[Lanes::numLanes];
+
+        for (size_t lane = 0; lane < Lanes::numLanes; ++lane)
+        {
+            const auto index = jmin (group * Lanes::numLanes + lane, frequencyRatios->getNumChannels() - 1);
+            ratios[lane] = frequencyRatios->getChannelPointer (index) + start;
+        }
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            LanesType ratio;
+            auto* r = Lanes::getLanes (&ratio);
+
+            for (size_t lane = 0; lane < Lanes::numLanes; ++lane)
+                r[lane] = ratios[lane][i];
+
+            phaseChunk[i] = phase;
+            phase = wrapPhase (phase + clampIncrement (increments[group] * ratio, maxIncrement));
+        }
+    }
+
+    phases[group] = phase;
+
+    // Table lookups
+    LanesType morph;
+    auto* morphAmounts = Lanes::getLanes (&morph);
+    size_t frames[Lanes::numLanes];
+    auto isMorphing = false;
+
+    for (size_t lane = 0; lane < Lanes::numLanes; ++lane)
+    {
+        const auto index = jmin (group * Lanes::numLanes + lane, numOscillators - 1);
+
+        frames[lane] = jmin ((size_t) morphPositions[index], numFrames - 1);
+        morphAmounts[lane] = morphPositions[index] - (SampleType) frames[lane];
+        isMorphing = isMorphing || morphAmounts[lane] > 0;
+    }
+
+    for (size_t lane = 0; lane < Lanes::numLanes; ++lane)
+    {
+        const auto maxLaneIncrement = Lanes::getLanes (&maxIncrement)[lane] * (SampleType) tableSize;
+        size_t level = 0;
+
+        while (level < numLevels - 1 && (SampleType) (1 << level) < maxLaneIncrement)
+            ++level;
+
+        const auto frameB = morphAmounts[lane] > 0 ? frames[lane] + 1 : frames[lane];
+
+        const auto* tableA = tables.data() + (frames[lane] * numLevels + level) * levelSize;
+        const auto* tableB = tables.data() + (frameB * numLevels + level) * levelSize;
+        const auto* lanePhases = Lanes::getLanes (phaseChunk) + lane;
+
+        auto* laneFractions = Lanes::getLanes (fractions) + lane;
+        auto* laneA0 = Lanes::getLanes (samplesA0) + lane;
+        auto* laneA1 = Lanes::getLanes (samplesA1) + lane;
+        auto* laneB0 = Lanes::getLanes (samplesB0) + lane;
+        auto* laneB1 = Lanes::getLanes (samplesB1) + lane;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto offset = i * Lanes::numLanes;
+            const auto position = lanePhases[offset] * (SampleType) tableSize;
+            const auto j = (size_t) position;
+
+            laneFractions[offset] = position - (SampleType) j;
+            laneA0[offset] = tableA[j];
+            laneA1[offset] = tableA[j + 1];
+
+            if (isMorphing)
+            {
+                laneB0[offset] = tableB[j];
+                laneB1[offset] = tableB[j + 1];
+            }
+        }
+    }
+
+    // Interpolation and mixing
+    const auto rampScale = (SampleType) 1.0 / (SampleType) numSamples;
+
+    auto gainLeft  = isStereo ? currentLeftGains[group] : currentGains[group];
+    auto gainRight = currentRightGains[group];
+    const auto gainLeftStep  = ((isStereo ? targetLeftGains[group] : targetGains[group]) - gainLeft) * rampScale;
+    const auto gainRightStep = (targetRightGains[group] - gainRight) * rampScale;
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto sample = samplesA0[i] + (samplesA1[i] - samplesA0[i]) * fractions[i];
+
+        if (isMorphing)
+        {
+            const auto sampleB = samplesB0[i] + (samplesB1[i] - samplesB0[i]) * fractions[i];
+            sample += (sampleB - sample) * morph;
+        }
+
+        gainLeft += gainLeftStep;
+        mixLeft[i] += sample * gainLeft;
+
+        if (isStereo)
+        {
+            gainRight += gainRightStep;
+            mixRight[i] += sample * gainRight;
+        }
+    }
+
+    currentGains[group]      = targetGains[group];
+    currentLeftGains[group]  = targetLeftGains[group];
+    currentRightGains[group] = targetRightGains[group];
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::advancePhases (size_t numSamples) noexcept
+{
+    for (size_t i = 0; i < numOscillators; ++i)
+    {
+        auto& phase = Lanes::getLane (phases, i);
+        phase += Lanes::getLane (increments, i) * (SampleType) numSamples;
+        phase -= std::floor (phase);
+    }
+}
+
+//==============================================================================
+#if JUCE_USE_SIMD
+
+template <typename SampleType>
+typename WavetableOscillatorBank<SampleType>::LanesType WavetableOscillatorBank<SampleType>::wrapPhase (LanesType phase) noexcept
+{
+    const auto one = LanesType::expand ((SampleType) 1.0);
+
+    phase -= one & LanesType::greaterThanOrEqual (phase, one);
+    phase += one & LanesType::greaterThan (LanesType(), phase);
+    return phase;
+}
+
+template <typename SampleType>
+typename WavetableOscillatorBank<SampleType>::LanesType WavetableOscillatorBank<SampleType>::clampIncrement (LanesType increment,
+                                                                                                            LanesType& maxIncrement) noexcept
+{
+    // The phase can't move by more than half a cycle per sample, which is the Nyquist frequency
+    const auto half = LanesType::expand ((SampleType) 0.5);
+
+    increment = LanesType::min (LanesType::max (increment, LanesType() - half), half);
+    maxIncrement = LanesType::max (maxIncrement, LanesType::max (increment, LanesType() - increment));
+    return increment;
+}
+
+#else
+
+template <typename SampleType>
+typename WavetableOscillatorBank<SampleType>::LanesType WavetableOscillatorBank<SampleType>::wrapPhase (LanesType phase) noexcept
+{
+    if (phase >= (SampleType) 1.0)
+        return phase - (SampleType) 1.0;
+
+    if (phase < SampleType())
+        return phase + (SampleType) 1.0;
+
+    return phase;
+}
+
+template <typename SampleType>
+typename WavetableOscillatorBank<SampleType>::LanesType WavetableOscillatorBank<SampleType>::clampIncrement (LanesType increment,
+                                                                                                            LanesType& maxIncrement) noexcept
+{
+    // The phase can't move by more than half a cycle per sample, which is the Nyquist frequency
+    increment = jlimit ((SampleType) -0.5, (SampleType) 0.5, increment);
+    maxIncrement = jmax (maxIncrement, std::abs (increment));
+    return increment;
+}
+
+#endif
+
+//==============================================================================
+template class WavetableOscillatorBank<float>;
+template class WavetableOscillatorBank<double>;
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    Generates the sum of many band-limited wavetable oscillators, such as the voices
+    of a unison patch or all the notes of a synthesiser.
+
+    Each waveform is stored as a set of mip-mapped tables, where every level keeps
+    half the harmonics of the previous one. The level used by each oscillator is
+    chosen so that none of its harmonics go above the Nyquist frequency, so unlike
+    Oscillator there is no aliasing, even when the frequencies are modulated.
+
+    The waveform can also be made of several frames, and each oscillator can morph
+    between them. All the oscillators are rendered together, several of them at a
+    time using SIMD instructions when they are available, so a single bank is much
+    cheaper than hundreds of separate Oscillator objects.
+
+    Like Oscillator, the oscillators are added to the input signal. When there are
+    two output channels, each oscillator is panned between them, otherwise every
+    channel gets the same mix.
+
+    @see Oscillator
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class WavetableOscillatorBank
+{
+public:
+    //==============================================================================
+    /** Constructor. By default, the bank has a single oscillator playing a sine wave
+        at 440 Hz.
+    */
+    WavetableOscillatorBank();
+
+    //==============================================================================
+    /** The number of samples in one cycle of each table. */
+    static constexpr size_t tableSize = 2048;
+
+    /** Sets a single-frame waveform, from a periodic function over -pi..pi.
+
+        The tables are worked out using FFTs and memory is allocated, so this
+        shouldn't be done on the audio thread.
+    */
+    void setWaveform (const std::function<SampleType (SampleType)>& function);
+
+    /** Sets a waveform made of several frames, which the oscillators can morph
+        between.
+
+        Each channel of the buffer holds a single cycle of one frame, and the number
+        of samples must be a power of two. Any harmonics above the ones that fit in
+        tableSize samples are removed.
+
+        The tables are worked out using FFTs and memory is allocated, so this
+        shouldn't be done on the audio thread.
+    */
+    void setWavetable (const AudioBuffer<SampleType>& frames);
+
+    /** Returns the number of frames in the waveform. */
+    size_t getNumFrames() const noexcept                        { return numFrames; }
+
+    //==============================================================================
+    /** Sets the number of oscillators.
+
+        If the number changes, memory is allocated, so this shouldn't be done on the
+        audio thread. The settings of the existing oscillators are kept, and new ones
+        play at 440 Hz with a gain of 1.
+    */
+    void setNumOscillators (size_t newNumOscillators);
+
+    /** Returns the number of oscillators. */
+    size_t getNumOscillators() const noexcept                   { return numOscillators; }
+
+    /** Sets the frequency in Hz of one of the oscillators. */
+    void setFrequency (size_t index, SampleType newFrequencyHz) noexcept;
+
+    /** Returns the frequency in Hz of one of the oscillators. */
+    SampleType getFrequency (size_t index) const noexcept       { return frequencies[index]; }
+
+    /** Sets the phase of one of the oscillators, between 0 and 1.
+
+        The phase is changed immediately, and it's also the one the oscillator goes
+        back to when reset() is called.
+    */
+    void setPhase (size_t index, SampleType newPhase) noexcept;
+
+    /** Sets the position of one of the oscillators in the waveform, between 0 and
+        getNumFrames() - 1. Positions between two frames crossfade them.
+
+        The position changes every 32 samples, so it should be moved in small steps
+        to avoid any zipper noise.
+    */
+    void setMorphPosition (size_t index, SampleType newPosition) noexcept;
+
+    /** Sets the linear gain of one of the oscillators. The changes are ramped over
+        32 samples to avoid clicks.
+    */
+    void setGain (size_t index, SampleType newGain) noexcept;
+
+    /** Sets the pan of one of the oscillators between -1 (left) and 1 (right),
+        which is only used when there are two output channels.
+    */
+    void setPan (size_t index, SampleType newPan) noexcept;
+
+    //==============================================================================
+    /** Initialises the processor. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the phases of the oscillators to their initial values. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        processWithModulation (context, nullptr);
+    }
+
+    /** Processes the input and output samples supplied in the processing context,
+        with the frequency of each oscillator multiplied by a ratio for every sample.
+
+        The block of ratios must have the same number of samples as the context, and
+        either one channel per oscillator, or a single channel which is used for all
+        of them.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context, const AudioBlock<const SampleType>& frequencyRatios) noexcept
+    {
+        jassert (frequencyRatios.getNumChannels() == 1 || frequencyRatios.getNumChannels() == numOscillators);
+        jassert (frequencyRatios.getNumSamples() == context.getOutputBlock().getNumSamples());
+
+        processWithModulation (context, &frequencyRatios);
+    }
+
+private:
+    //==============================================================================
+    using Lanes     = detail::SIMDLanes<SampleType>;
+    using LanesType = typename Lanes::Type;
+
+    static constexpr size_t samplesPerChunk = 32;
+    static constexpr size_t numLevels = 11;
+    static constexpr size_t levelSize = tableSize + 2;
+
+    //==============================================================================
+    template <typename ProcessContext>
+    void processWithModulation (const ProcessContext& context, const AudioBlock<const SampleType>* frequencyRatios) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+
+        if (context.isBypassed)
+        {
+            outputBlock.clear();
+            advancePhases (outputBlock.getNumSamples());
+            return;
+        }
+
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom (inputBlock);
+
+        render (outputBlock, frequencyRatios);
+    }
+
+    void render (const AudioBlock<SampleType>& outputBlock, const AudioBlock<const SampleType>* frequencyRatios) noexcept;
+    void renderGroup (size_t group, size_t start, size_t numSamples,
+                      const AudioBlock<const SampleType>* frequencyRatios, bool isStereo) noexcept;
+    void advancePhases (size_t numSamples) noexcept;
+
+    void buildTables (const AudioBuffer<SampleType>& frames);
+    void updateIncrement (size_t index) noexcept;
+    void updateGains (size_t index) noexcept;
+
+    static LanesType wrapPhase (LanesType phase) noexcept;
+    static LanesType clampIncrement (LanesType increment, LanesType& maxIncrement) noexcept;
+
+    //==============================================================================
+    // Every level of every frame holds tableSize samples, followed by copies of the
+    // first two, so that the interpolation never has to wrap around
+    std::vector<SampleType> tables;
+    size_t numFrames = 0;
+
+    std::vector<SampleType> frequencies, startPhases, morphPositions, gains, pans;
+    size_t numOscillators = 0;
+
+    // Each oscillator has a lane, with the index group * Lanes::numLanes + lane
+    std::vector<LanesType> phases, increments, currentGains, targetGains,
+                           currentLeftGains, targetLeftGains, currentRightGains, targetRightGains;
+    std::vector<LanesType> chunk;
+
+    double sampleRate = 44100.0;
+};
+
+} // namespace dsp
+} // namespace juce
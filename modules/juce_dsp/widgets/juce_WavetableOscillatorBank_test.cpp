@@ -0,0 +1,291 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class WavetableOscillatorBankTest : public UnitTest
+{
+public:
+    WavetableOscillatorBankTest()
+        : UnitTest ("WavetableOscillatorBank", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runOscillatorTests<float>();
+        runOscillatorTests<double>();
+    }
+
+private:
+    template <typename Type>
+    static AudioBuffer<Type> render (WavetableOscillatorBank<Type>& bank, int numChannels, int numSamples,
+                                     const AudioBuffer<Type>* ratios = nullptr)
+    {
+        AudioBuffer<Type> buffer (numChannels, numSamples);
+        buffer.clear();
+
+        // Uneven blocks, to check that nothing depends on where they start
+        for (int start = 0; start < numSamples;)
+        {
+            const auto num = jmin (numSamples - start, 37 + start % 100);
+            auto block = AudioBlock<Type> (buffer).getSubBlock ((size_t) start, (size_t) num);
+
+            if (ratios != nullptr)
+                bank.process (ProcessContextReplacing<Type> (block),
+                              AudioBlock<const Type> (*ratios).getSubBlock ((size_t) start, (size_t) num));
+            else
+                bank.process (ProcessContextReplacing<Type> (block));
+
+            start += num;
+        }
+
+        return buffer;
+    }
+
+    template <typename Type>
+    static AudioBuffer<Type> makeSine (int numChannels, int numSamples, double increment)
+    {
+        AudioBuffer<Type> buffer (numChannels, numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, (Type) -std::sin (MathConstants<double>::twoPi * increment * i));
+
+        return buffer;
+    }
+
+    template <typename Type>
+    void runOscillatorTests()
+    {
+        using namespace AudioBufferTestHelpers;
+
+        constexpr auto sampleRate = 48000.0;
+        constexpr int numSamples = 1000;
+        const ProcessSpec spec { sampleRate, (uint32) numSamples, 2 };
+        Random random (0x1357);
+
+        beginTest ("Sine");
+        {
+            WavetableOscillatorBank<Type> bank;
+            bank.setFrequency (0, (Type) 1000.0);
+            bank.prepare (spec);
+
+            expectLessThan (getMaxDifference (render (bank, 1, numSamples), makeSine<Type> (1, numSamples, 1000.0 / sampleRate)),
+                            (Type) 1.0e-4);
+
+            // The oscillators are added to the input
+            bank.reset();
+            auto expected = makeSine<Type> (1, numSamples, 1000.0 / sampleRate);
+            AudioBuffer<Type> input (1, numSamples), output (1, numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                input.setSample (0, i, (Type) i * (Type) 0.001);
+
+            AudioBlock<const Type> inputBlock (input);
+            AudioBlock<Type> outputBlock (output);
+            bank.process (ProcessContextNonReplacing<Type> (inputBlock, outputBlock));
+            expected.addFrom (0, 0, input, 0, 0, numSamples);
+
+            expectLessThan (getMaxDifference (output, expected), (Type) 1.0e-4);
+        }
+
+        beginTest ("No harmonics above the Nyquist frequency");
+        {
+            // The first 30 harmonics of a sawtooth
+            WavetableOscillatorBank<Type> bank;
+            bank.setWaveform ([] (Type x)
+            {
+                auto y = (Type) 0;
+
+                for (int h = 1; h <= 30; ++h)
+                    y += std::sin ((Type) h * x) / (Type) h;
+
+                return y;
+            });
+
+            // At these frequencies, the tables keep all of the harmonics below the Nyquist frequency
+            for (auto frequency : { 5000.0, 9000.0 })
+            {
+                bank.setFrequency (0, (Type) frequency);
+                bank.prepare (spec);
+                const auto output = render (bank, 1, numSamples);
+
+                AudioBuffer<Type> expected (1, numSamples);
+                expected.clear();
+
+                for (int h = 1; h * frequency < sampleRate / 2; ++h)
+                    for (int i = 0; i < numSamples; ++i)
+                        expected.addSample (0, i, (Type) (std::sin (h * (MathConstants<double>::twoPi * frequency * i / sampleRate
+                                                                         - MathConstants<double>::pi)) / h));
+
+                expectLessThan (getMaxDifference (output, expected), (Type) 1.0e-3);
+            }
+        }
+
+        beginTest ("Oscillators, gains and pans");
+        {
+            constexpr size_t numOscillators = 11;
+            WavetableOscillatorBank<Type> bank;
+            bank.setNumOscillators (numOscillators);
+            bank.prepare (spec);
+
+            AudioBuffer<Type> expected (2, numSamples), expectedMono (3, numSamples);
+            expected.clear();
+            expectedMono.clear();
+
+            for (size_t i = 0; i < numOscillators; ++i)
+            {
+                const auto frequency = 100.0 + 5000.0 * random.nextDouble();
+                const auto phase = random.nextDouble();
+                const auto gain = random.nextDouble();
+                const auto pan = 2.0 * random.nextDouble() - 1.0;
+
+                bank.setFrequency (i, (Type) frequency);
+                bank.setPhase (i, (Type) phase);
+                bank.setGain (i, (Type) gain);
+                bank.setPan (i, (Type) pan);
+
+                for (int n = 0; n < numSamples; ++n)
+                {
+                    const auto sample = -gain * std::sin (MathConstants<double>::twoPi * (phase + frequency * n / sampleRate));
+                    expected.addSample (0, n, (Type) (sample * jmin (1.0, 1.0 - pan)));
+                    expected.addSample (1, n, (Type) (sample * jmin (1.0, 1.0 + pan)));
+
+                    for (int ch = 0; ch < 3; ++ch)
+                        expectedMono.addSample (ch, n, (Type) sample);
+                }
+            }
+
+            bank.reset();
+            expectLessThan (getMaxDifference (render (bank, 2, numSamples), expected), (Type) 1.0e-3);
+
+            // With any other number of channels, the oscillators aren't panned
+            bank.reset();
+            expectLessThan (getMaxDifference (render (bank, 3, numSamples), expectedMono), (Type) 1.0e-3);
+        }
+
+        beginTest ("Morphing");
+        {
+            AudioBuffer<Type> frames (3, 256);
+
+            for (int i = 0; i < 256; ++i)
+            {
+                const auto x = MathConstants<double>::twoPi * i / 256.0;
+                frames.setSample (0, i, (Type) std::sin (x));
+                frames.setSample (1, i, (Type) std::sin (3.0 * x));
+                frames.setSample (2, i, (Type) std::cos (2.0 * x));
+            }
+
+            WavetableOscillatorBank<Type> bank;
+            bank.setWavetable (frames);
+            bank.setFrequency (0, (Type) 440.0);
+            bank.prepare (spec);
+            expectEquals ((int) bank.getNumFrames(), 3);
+
+            std::vector<AudioBuffer<Type>> outputs;
+
+            for (auto position : { 0.0, 1.0, 2.0, 1.25 })
+            {
+                bank.setMorphPosition (0, (Type) position);
+                bank.reset();
+                outputs.push_back (render (bank, 1, numSamples));
+            }
+
+            for (int frame = 0; frame < 3; ++frame)
+            {
+                AudioBuffer<Type> expected (1, numSamples);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto x = MathConstants<double>::twoPi * 440.0 * i / sampleRate;
+                    expected.setSample (0, i, (Type) (frame == 0 ? std::sin (x) : frame == 1 ? std::sin (3.0 * x) : std::cos (2.0 * x)));
+                }
+
+                expectLessThan (getMaxDifference (outputs[(size_t) frame], expected), (Type) 1.0e-3);
+            }
+
+            AudioBuffer<Type> crossfade (outputs[1]);
+            crossfade.applyGain ((Type) 0.75);
+            crossfade.addFrom (0, 0, outputs[2], 0, 0, numSamples, (Type) 0.25);
+
+            expectLessThan (getMaxDifference (outputs[3], crossfade), (Type) 1.0e-5);
+        }
+
+        beginTest ("Frequency modulation");
+        {
+            constexpr size_t numOscillators = 5;
+            WavetableOscillatorBank<Type> bank;
+            bank.setNumOscillators (numOscillators);
+            bank.prepare (spec);
+
+            for (size_t i = 0; i < numOscillators; ++i)
+                bank.setFrequency (i, (Type) (200.0 * (double) (i + 1)));
+
+            // A single ratio is used for all the oscillators...
+            AudioBuffer<Type> ratios (1, numSamples);
+
+            for (int n = 0; n < numSamples; ++n)
+                ratios.setSample (0, n, (Type) 2.0);
+
+            const auto modulated = render (bank, 1, numSamples, &ratios);
+
+            for (size_t i = 0; i < numOscillators; ++i)
+                bank.setFrequency (i, (Type) (400.0 * (double) (i + 1)));
+
+            bank.reset();
+            expectLessThan (getMaxDifference (modulated, render (bank, 1, numSamples)), (Type) 1.0e-4);
+
+            // ...or each oscillator has its own, and the phase follows them
+            AudioBuffer<Type> sweeps (numOscillators, numSamples);
+            AudioBuffer<Type> expected (1, numSamples);
+            expected.clear();
+
+            for (size_t i = 0; i < numOscillators; ++i)
+            {
+                bank.setFrequency (i, (Type) 1000.0);
+                auto phase = 0.0;
+
+                for (int n = 0; n < numSamples; ++n)
+                {
+                    const auto ratio = 1.0 + 0.5 * std::sin (0.01 * n * (double) (i + 1));
+                    sweeps.setSample ((int) i, n, (Type) ratio);
+                    expected.addSample (0, n, (Type) -std::sin (MathConstants<double>::twoPi * phase));
+                    phase += 1000.0 * (double) (Type) ratio / sampleRate;
+                }
+            }
+
+            bank.reset();
+            expectLessThan (getMaxDifference (render (bank, 1, numSamples, &sweeps), expected), (Type) 1.0e-3);
+        }
+    }
+};
+
+static WavetableOscillatorBankTest wavetableOscillatorBankTest;
+
+} // namespace dsp
+} // namespace juce
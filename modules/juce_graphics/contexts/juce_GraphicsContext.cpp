@@ -26,107 +26,20 @@
 namespace juce
 {
 
-struct GraphicsFontHelpers
-{
-    static auto compareFont (const Font& a, const Font& b) { return Font::compare (a, b); }
-};
-
-static auto operator< (const Font& a, const Font& b)
-{
-    return GraphicsFontHelpers::compareFont (a, b);
-}
-
-template <typename T>
-static auto operator< (const Rectangle<T>& a, const Rectangle<T>& b)
-{
-    const auto tie = [] (auto& t) { return std::make_tuple (t.getX(), t.getY(), t.getWidth(), t.getHeight()); };
-    return tie (a) < tie (b);
-}
-
-static auto operator< (const Justification& a, const Justification& b)
-{
-    return a.getFlags() < b.getFlags();
-}
-
 //==============================================================================
 namespace
 {
     struct ConfiguredArrangement
     {
-        void draw (const Graphics& g) const { arrangement.draw (g, transform); }
-
-        GlyphArrangement arrangement;
-        AffineTransform transform;
-    };
-
-    template <typename ArrangementArgs>
-    class GlyphArrangementCache final : public DeletedAtShutdown
-    {
-    public:
-        GlyphArrangementCache() = default;
-
-        ~GlyphArrangementCache() override
+        void draw (const Graphics& g, Point<float> position) const
         {
-            clearSingletonInstance();
+            arrangement.draw (g, transform.translated (position));
         }
 
-        template <typename ConfigureArrangement>
-        void draw (const Graphics& g, ArrangementArgs&& args, ConfigureArrangement&& configureArrangement)
-        {
-            const ScopedTryLock stl (lock);
-
-            if (! stl.isLocked())
-            {
-                configureArrangement (args).draw (g);
-                return;
-            }
-
-            const auto cached = [&]
-            {
-                const auto iter = cache.find (args);
-
-                if (iter != cache.end())
-                {
-                    if (iter->second.cachePosition != cacheOrder.begin())
-                        cacheOrder.splice (cacheOrder.begin(), cacheOrder, iter->second.cachePosition);
-
-                    return iter;
-                }
-
-                auto result = cache.emplace (std::move (args), CachedGlyphArrangement { configureArrangement (args), {} }).first;
-                cacheOrder.push_front (result);
-                return result;
-            }();
-
-            cached->second.cachePosition = cacheOrder.begin();
-            cached->second.configured.draw (g);
-
-            while (cache.size() > cacheSize)
-            {
-                cache.erase (cacheOrder.back());
-                cacheOrder.pop_back();
-            }
-        }
-
-        JUCE_DECLARE_SINGLETON (GlyphArrangementCache<ArrangementArgs>, false)
-
-    private:
-        struct CachedGlyphArrangement
-        {
-            using CachePtr = typename std::map<ArrangementArgs, CachedGlyphArrangement>::const_iterator;
-            ConfiguredArrangement configured;
-            typename std::list<CachePtr>::const_iterator cachePosition;
-        };
-
-        static constexpr size_t cacheSize = 128;
-        std::map<ArrangementArgs, CachedGlyphArrangement> cache;
-        std::list<typename CachedGlyphArrangement::CachePtr> cacheOrder;
-        CriticalSection lock;
+        GlyphArrangement arrangement;
+        AffineTransform transform;
     };
 
-    template <typename ArrangementArgs>
-    juce::SingletonHolder<GlyphArrangementCache<ArrangementArgs>, juce::CriticalSection, false> GlyphArrangementCache<ArrangementArgs>::singletonHolder;
-
     //==============================================================================
     template <typename Type>
     Rectangle<Type> coordsToRectangle (Type x, Type y, Type w, Type h) noexcept
@@ -345,27 +258,17 @@ void Graphics::drawSingleLineText (const String& text, const int startX, const i
     if (flags == Justification::left && startX > context.getClipBounds().getRight())
         return;
 
-    struct ArrangementArgs
-    {
-        auto tie() const noexcept { return std::tie (font, text, startX, baselineY); }
-        bool operator< (const ArrangementArgs& other) const { return tie() < other.tie(); }
-
-        const Font font;
-        const String text;
-        const int startX, baselineY, flags;
-    };
-
-    auto configureArrangement = [] (const ArrangementArgs& args)
+    auto configureArrangement = [&]
     {
         AffineTransform transform;
         GlyphArrangement arrangement;
-        arrangement.addLineOfText (args.font, args.text, (float) args.startX, (float) args.baselineY);
+        arrangement.addLineOfText (context.getFont(), text, 0.0f, 0.0f);
 
-        if (args.flags != Justification::left)
+        if (flags != Justification::left)
         {
             auto w = arrangement.getBoundingBox (0, -1, true).getWidth();
 
-            if ((args.flags & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
+            if ((flags & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
                 w /= 2.0f;
 
             transform = AffineTransform::translation (-w, 0);
@@ -374,9 +277,11 @@ void Graphics::drawSingleLineText (const String& text, const int startX, const i
         return ConfiguredArrangement { std::move (arrangement), std::move (transform) };
     };
 
-    GlyphArrangementCache<ArrangementArgs>::getInstance()->draw (*this,
-                                                                 { context.getFont(), text, startX, baselineY, flags },
-                                                                 std::move (configureArrangement));
+    TextShapingCache::Key key { TextShapingCache::KeyType::singleLineText, text, { context.getFont() },
+                                { (double) flags } };
+
+    TextShapingCache::getInstance()->findOrCreate<ConfiguredArrangement> (std::move (key), configureArrangement)
+                                   ->draw (*this, { (float) startX, (float) baselineY });
 }
 
 void Graphics::drawMultiLineText (const String& text, const int startX,
@@ -386,30 +291,19 @@ void Graphics::drawMultiLineText (const String& text, const int startX,
     if (text.isEmpty() || startX >= context.getClipBounds().getRight())
         return;
 
-    struct ArrangementArgs
-    {
-        auto tie() const noexcept { return std::tie (font, text, startX, baselineY, maximumLineWidth, justification, leading); }
-        bool operator< (const ArrangementArgs& other) const { return tie() < other.tie(); }
-
-        const Font font;
-        const String text;
-        const int startX, baselineY, maximumLineWidth;
-        const Justification justification;
-        const float leading;
-    };
-
-    auto configureArrangement = [] (const ArrangementArgs& args)
+    auto configureArrangement = [&]
     {
         GlyphArrangement arrangement;
-        arrangement.addJustifiedText (args.font, args.text,
-                                      (float) args.startX, (float) args.baselineY, (float) args.maximumLineWidth,
-                                      args.justification, args.leading);
+        arrangement.addJustifiedText (context.getFont(), text, 0.0f, 0.0f, (float) maximumLineWidth,
+                                      justification, leading);
         return ConfiguredArrangement { std::move (arrangement), {} };
     };
 
-    GlyphArrangementCache<ArrangementArgs>::getInstance()->draw (*this,
-                                                                 { context.getFont(), text, startX, baselineY, maximumLineWidth, justification, leading },
-                                                                 std::move (configureArrangement));
+    TextShapingCache::Key key { TextShapingCache::KeyType::multiLineText, text, { context.getFont() },
+                                { (double) maximumLineWidth, (double) justification.getFlags(), (double) leading } };
+
+    TextShapingCache::getInstance()->findOrCreate<ConfiguredArrangement> (std::move (key), configureArrangement)
+                                   ->draw (*this, { (float) startX, (float) baselineY });
 }
 
 void Graphics::drawText (const String& text, Rectangle<float> area,
@@ -418,33 +312,24 @@ void Graphics::drawText (const String& text, Rectangle<float> area,
     if (text.isEmpty() || ! context.clipRegionIntersects (area.getSmallestIntegerContainer()))
         return;
 
-    struct ArrangementArgs
-    {
-        auto tie() const noexcept { return std::tie (font, text, area, justificationType, useEllipsesIfTooBig); }
-        bool operator< (const ArrangementArgs& other) const { return tie() < other.tie(); }
-
-        const Font font;
-        const String text;
-        const Rectangle<float> area;
-        const Justification justificationType;
-        const bool useEllipsesIfTooBig;
-    };
-
-    auto configureArrangement = [] (const ArrangementArgs& args)
+    auto configureArrangement = [&]
     {
         GlyphArrangement arrangement;
-        arrangement.addCurtailedLineOfText (args.font, args.text, 0.0f, 0.0f,
-                                            args.area.getWidth(), args.useEllipsesIfTooBig);
+        arrangement.addCurtailedLineOfText (context.getFont(), text, 0.0f, 0.0f,
+                                            area.getWidth(), useEllipsesIfTooBig);
 
         arrangement.justifyGlyphs (0, arrangement.getNumGlyphs(),
-                                   args.area.getX(), args.area.getY(), args.area.getWidth(), args.area.getHeight(),
-                                   args.justificationType);
+                                   0.0f, 0.0f, area.getWidth(), area.getHeight(),
+                                   justificationType);
         return ConfiguredArrangement { std::move (arrangement), {} };
     };
 
-    GlyphArrangementCache<ArrangementArgs>::getInstance()->draw (*this,
-                                                                 { context.getFont(), text, area, justificationType, useEllipsesIfTooBig },
-                                                                 std::move (configureArrangement));
+    TextShapingCache::Key key { TextShapingCache::KeyType::text, text, { context.getFont() },
+                                { (double) area.getWidth(), (double) area.getHeight(),
+                                  (double) justificationType.getFlags(), useEllipsesIfTooBig ? 1.0 : 0.0 } };
+
+    TextShapingCache::getInstance()->findOrCreate<ConfiguredArrangement> (std::move (key), configureArrangement)
+                                   ->draw (*this, area.getPosition());
 }
 
 void Graphics::drawText (const String& text, Rectangle<int> area,
@@ -467,34 +352,24 @@ void Graphics::drawFittedText (const String& text, Rectangle<int> area,
     if (text.isEmpty() || area.isEmpty() || ! context.clipRegionIntersects (area))
         return;
 
-    struct ArrangementArgs
-    {
-        auto tie() const noexcept { return std::tie (font, text, area, justification, maximumNumberOfLines, minimumHorizontalScale); }
-        bool operator< (const ArrangementArgs& other) const noexcept { return tie() < other.tie(); }
-
-        const Font font;
-        const String text;
-        const Rectangle<float> area;
-        const Justification justification;
-        const int maximumNumberOfLines;
-        const float minimumHorizontalScale;
-    };
-
-    auto configureArrangement = [] (const ArrangementArgs& args)
+    auto configureArrangement = [&]
     {
         GlyphArrangement arrangement;
-        arrangement.addFittedText (args.font, args.text,
-                                   args.area.getX(), args.area.getY(),
-                                   args.area.getWidth(), args.area.getHeight(),
-                                   args.justification,
-                                   args.maximumNumberOfLines,
-                                   args.minimumHorizontalScale);
+        arrangement.addFittedText (context.getFont(), text,
+                                   0.0f, 0.0f,
+                                   (float) area.getWidth(), (float) area.getHeight(),
+                                   justification,
+                                   maximumNumberOfLines,
+                                   minimumHorizontalScale);
         return ConfiguredArrangement { std::move (arrangement), {} };
     };
 
-    GlyphArrangementCache<ArrangementArgs>::getInstance()->draw (*this,
-                                                                 { context.getFont(), text, area.toFloat(), justification, maximumNumberOfLines, minimumHorizontalScale },
-                                                                 std::move (configureArrangement));
+    TextShapingCache::Key key { TextShapingCache::KeyType::fittedText, text, { context.getFont() },
+                                { (double) area.getWidth(), (double) area.getHeight(), (double) justification.getFlags(),
+                                  (double) maximumNumberOfLines, (double) minimumHorizontalScale } };
+
+    TextShapingCache::getInstance()->findOrCreate<ConfiguredArrangement> (std::move (key), configureArrangement)
+                                   ->draw (*this, area.getPosition().toFloat());
 }
 
 void Graphics::drawFittedText (const String& text, int x, int y, int width, int height,
@@ -572,6 +447,17 @@ void Graphics::strokePath (const Path& path,
                            const PathStrokeType& strokeType,
                            const AffineTransform& transform) const
 {
+    if (PathCache::isWorthCaching (path))
+    {
+        // The outline is cached without any translation, so that it can be re-used
+        // wherever the path gets drawn
+        auto stroke = PathCache::getInstance()->getStrokedPath (path, strokeType,
+                                                                transform.withAbsoluteTranslation (0.0f, 0.0f),
+                                                                context.getPhysicalPixelScaleFactor());
+        fillPath (*stroke, AffineTransform::translation (transform.getTranslationX(), transform.getTranslationY()));
+        return;
+    }
+
     Path stroke;
     strokeType.createStrokedPath (stroke, path, transform, context.getPhysicalPixelScaleFactor());
     fillPath (stroke);
@@ -0,0 +1,615 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct LowLevelGraphicsTiledSoftwareRenderer::Command
+{
+    enum class Type
+    {
+        stateChange,
+        save,       // saveState() or beginTransparencyLayer()
+        restore,    // restoreState() or endTransparencyLayer()
+        drawing
+    };
+
+    std::function<void (LowLevelGraphicsContext&)> apply;
+    Type type;
+    Rectangle<int> bounds;  // for drawing commands, the device-space area that they could change
+};
+
+// This follows the transform and clip region that the real renderer will have when the
+// commands are replayed. The clip is only tracked as a bounding box, which always
+// contains the real clip region.
+struct LowLevelGraphicsTiledSoftwareRenderer::RecordedState
+{
+    RenderingHelpers::TranslationOrTransform transform;
+    Rectangle<int> clipBounds;
+    Font font;
+};
+
+struct LowLevelGraphicsTiledSoftwareRenderer::GlyphInfo
+{
+    Typeface::Ptr typeface;
+    Rectangle<float> bounds;
+};
+
+//==============================================================================
+// An image which uses the pixels of the target image, so that each tile can be given
+// its own image object to render into. The tiles never touch each other's pixels, but
+// they would all be sending change messages to the target image's listeners.
+class LowLevelGraphicsTiledSoftwareRenderer::TilePixelData  : public ImagePixelData
+{
+public:
+    TilePixelData (const Image::BitmapData& target)
+        : ImagePixelData (target.pixelFormat, target.width, target.height),
+          data (target.data), size (target.size),
+          lineStride (target.lineStride), pixelStride (target.pixelStride)
+    {
+    }
+
+    std::unique_ptr<LowLevelGraphicsContext> createLowLevelContext() override
+    {
+        return std::make_unique<LowLevelGraphicsSoftwareRenderer> (Image (*this));
+    }
+
+    void initialiseBitmapData (Image::BitmapData& bitmap, int x, int y, Image::BitmapData::ReadWriteMode) override
+    {
+        const auto offset = (size_t) x * (size_t) pixelStride + (size_t) y * (size_t) lineStride;
+        bitmap.data = data + offset;
+        bitmap.size = size - offset;
+        bitmap.pixelFormat = pixelFormat;
+        bitmap.lineStride = lineStride;
+        bitmap.pixelStride = pixelStride;
+    }
+
+    ImagePixelData::Ptr clone() override
+    {
+        Image copy (SoftwareImageType().create (pixelFormat, width, height, false));
+        Image::BitmapData dest (copy, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < height; ++y)
+            memcpy (dest.getLinePointer (y), data + y * lineStride, (size_t) jmin (lineStride, dest.lineStride));
+
+        return copy.getPixelData();
+    }
+
+    std::unique_ptr<ImageType> createType() const override    { return std::make_unique<SoftwareImageType>(); }
+
+private:
+    uint8* const data;
+    const size_t size;
+    const int lineStride, pixelStride;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TilePixelData)
+};
+
+//==============================================================================
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto)
+    : LowLevelGraphicsTiledSoftwareRenderer (imageToRenderOnto, {}, imageToRenderOnto.getBounds())
+{
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, Point<int> o,
+                                                                              const RectangleList<int>& clip)
+    : LowLevelGraphicsTiledSoftwareRenderer (imageToRenderOnto, o, clip, RenderingHelpers::getSharedThreadPool())
+{
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, Point<int> o,
+                                                                              const RectangleList<int>& clip, ThreadPool& pool)
+    : image (imageToRenderOnto), origin (o), initialClip (clip), threadPool (&pool),
+      state (new RecordedState { o, clip.getBounds().getIntersection (imageToRenderOnto.getBounds()), {} })
+{
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::~LowLevelGraphicsTiledSoftwareRenderer()
+{
+    renderCommands();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setTileHeight (int newTileHeight) noexcept
+{
+    jassert (newTileHeight > 0);
+    tileHeight = jmax (1, newTileHeight);
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::addStateCommand (std::function<void (LowLevelGraphicsContext&)> command)
+{
+    commands.push_back ({ std::move (command), Command::Type::stateChange, {} });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addDrawingCommand (Rectangle<float> userSpaceBounds, const AffineTransform& t,
+                                                               std::function<void (LowLevelGraphicsContext&)> command)
+{
+    if (state->clipBounds.isEmpty())
+        return;
+
+    // (the extra pixels allow for anti-aliasing, image resampling and glyph hinting)
+    auto deviceBounds = userSpaceBounds.transformedBy (state->transform.getTransformWith (t))
+                                       .getSmallestIntegerContainer()
+                                       .expanded (2)
+                                       .getIntersection (state->clipBounds);
+
+    if (! deviceBounds.isEmpty())
+        commands.push_back ({ std::move (command), Command::Type::drawing, deviceBounds });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::pushState()
+{
+    stateStack.push_back (std::make_unique<RecordedState> (*state));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::popState()
+{
+    if (stateStack.empty())
+    {
+        jassertfalse; // trying to pop with an empty stack!
+        return;
+    }
+
+    state = std::move (stateStack.back());
+    stateStack.pop_back();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::intersectClip (Rectangle<float> userSpaceBounds, const AffineTransform& t)
+{
+    state->clipBounds = state->clipBounds.getIntersection (userSpaceBounds.transformedBy (state->transform.getTransformWith (t))
+                                                                          .getSmallestIntegerContainer());
+}
+
+const LowLevelGraphicsTiledSoftwareRenderer::GlyphInfo& LowLevelGraphicsTiledSoftwareRenderer::getGlyphInfo (const Font& font, int glyphNumber)
+{
+    auto typeface = font.getTypefacePtr();
+    const auto key = std::make_pair (typeface.get(), glyphNumber);
+    auto found = glyphs.find (key);
+
+    if (found != glyphs.end())
+        return found->second;
+
+    // As well as giving us the glyph's bounds, this makes sure that any typeface which
+    // loads its glyphs lazily has done so before the tiles start using it on other threads.
+    Path outline;
+    typeface->getOutlineForGlyph (glyphNumber, outline);
+
+    return glyphs.emplace (key, GlyphInfo { typeface, outline.getBounds() }).first->second;
+}
+
+//==============================================================================
+bool LowLevelGraphicsTiledSoftwareRenderer::isVectorDevice() const
+{
+    return false;
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOrigin (Point<int> o)
+{
+    state->transform.setOrigin (o);
+    addStateCommand ([o] (LowLevelGraphicsContext& g) { g.setOrigin (o); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addTransform (const AffineTransform& t)
+{
+    state->transform.addTransform (t);
+    addStateCommand ([t] (LowLevelGraphicsContext& g) { g.addTransform (t); });
+}
+
+float LowLevelGraphicsTiledSoftwareRenderer::getPhysicalPixelScaleFactor()
+{
+    return state->transform.getPhysicalPixelScaleFactor();
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangle (const Rectangle<int>& r)
+{
+    intersectClip (r.toFloat(), {});
+    addStateCommand ([r] (LowLevelGraphicsContext& g) { g.clipToRectangle (r); });
+    return ! state->clipBounds.isEmpty();
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangleList (const RectangleList<int>& list)
+{
+    intersectClip (list.getBounds().toFloat(), {});
+    addStateCommand ([list] (LowLevelGraphicsContext& g) { g.clipToRectangleList (list); });
+    return ! state->clipBounds.isEmpty();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::excludeClipRectangle (const Rectangle<int>& r)
+{
+    addStateCommand ([r] (LowLevelGraphicsContext& g) { g.excludeClipRectangle (r); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToPath (const Path& path, const AffineTransform& t)
+{
+    intersectClip (path.getBounds(), t);
+    addStateCommand ([path, t] (LowLevelGraphicsContext& g) { g.clipToPath (path, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToImageAlpha (const Image& im, const AffineTransform& t)
+{
+    intersectClip (im.getBounds().toFloat(), t);
+    addStateCommand ([im, t] (LowLevelGraphicsContext& g) { g.clipToImageAlpha (im, t); });
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipRegionIntersects (const Rectangle<int>& r)
+{
+    return r.toFloat().transformedBy (state->transform.getTransform())
+                      .getSmallestIntegerContainer()
+                      .intersects (state->clipBounds);
+}
+
+Rectangle<int> LowLevelGraphicsTiledSoftwareRenderer::getClipBounds() const
+{
+    return state->transform.deviceSpaceToUserSpace (state->clipBounds);
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::isClipEmpty() const
+{
+    return state->clipBounds.isEmpty();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::saveState()
+{
+    pushState();
+    commands.push_back ({ [] (LowLevelGraphicsContext& g) { g.saveState(); }, Command::Type::save, {} });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::restoreState()
+{
+    popState();
+    commands.push_back ({ [] (LowLevelGraphicsContext& g) { g.restoreState(); }, Command::Type::restore, {} });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::beginTransparencyLayer (float opacity)
+{
+    pushState();
+    commands.push_back ({ [opacity] (LowLevelGraphicsContext& g) { g.beginTransparencyLayer (opacity); }, Command::Type::save, {} });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::endTransparencyLayer()
+{
+    popState();
+    commands.push_back ({ [] (LowLevelGraphicsContext& g) { g.endTransparencyLayer(); }, Command::Type::restore, {} });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFill (const FillType& fillType)
+{
+    addStateCommand ([fillType] (LowLevelGraphicsContext& g) { g.setFill (fillType); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOpacity (float newOpacity)
+{
+    addStateCommand ([newOpacity] (LowLevelGraphicsContext& g) { g.setOpacity (newOpacity); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    addStateCommand ([quality] (LowLevelGraphicsContext& g) { g.setInterpolationQuality (quality); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<int>& r, bool replaceExistingContents)
+{
+    addDrawingCommand (r.toFloat(), {}, [r, replaceExistingContents] (LowLevelGraphicsContext& g) { g.fillRect (r, replaceExistingContents); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<float>& r)
+{
+    addDrawingCommand (r, {}, [r] (LowLevelGraphicsContext& g) { g.fillRect (r); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRectList (const RectangleList<float>& list)
+{
+    addDrawingCommand (list.getBounds(), {}, [list] (LowLevelGraphicsContext& g) { g.fillRectList (list); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillPath (const Path& path, const AffineTransform& t)
+{
+    addDrawingCommand (path.getBounds(), t, [path, t] (LowLevelGraphicsContext& g) { g.fillPath (path, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawImage (const Image& im, const AffineTransform& t)
+{
+    addDrawingCommand (im.getBounds().toFloat(), t, [im, t] (LowLevelGraphicsContext& g) { g.drawImage (im, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawLine (const Line<float>& line)
+{
+    addDrawingCommand (Rectangle<float> (line.getStart(), line.getEnd()).expanded (1.0f), {},
+                       [line] (LowLevelGraphicsContext& g) { g.drawLine (line); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFont (const Font& newFont)
+{
+    state->font = newFont;
+    addStateCommand ([newFont] (LowLevelGraphicsContext& g) { g.setFont (newFont); });
+}
+
+const Font& LowLevelGraphicsTiledSoftwareRenderer::getFont()
+{
+    return state->font;
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawGlyph (int glyphNumber, const AffineTransform& t)
+{
+    if (state->clipBounds.isEmpty())
+        return;
+
+    auto& glyph = getGlyphInfo (state->font, glyphNumber);
+
+    if (glyph.bounds.isEmpty())
+        return;
+
+    auto fontHeight = state->font.getHeight();
+
+    addDrawingCommand (glyph.bounds,
+                       AffineTransform::scale (fontHeight * state->font.getHorizontalScale(), fontHeight).followedBy (t),
+                       [glyphNumber, t] (LowLevelGraphicsContext& g) { g.drawGlyph (glyphNumber, t); });
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::renderCommands()
+{
+    auto area = initialClip.getBounds().getIntersection (image.getBounds());
+
+    if (commands.empty() || area.isEmpty())
+        return;
+
+    const Image::BitmapData targetData (image, Image::BitmapData::readWrite);
+
+    // The tiles are always the full width of the area being drawn: the software renderer's
+    // image and gradient interpolators, and the way it clips edge tables at the right-hand side,
+    // depend on where each horizontal span starts and ends, so splitting the area vertically
+    // would leave visible differences along the seams.
+    const auto numTiles = (area.getHeight() + tileHeight - 1) / tileHeight;
+
+    auto renderTile = [&] (int tileIndex)
+    {
+        const auto tileArea = area.withY (area.getY() + tileIndex * tileHeight)
+                                  .withHeight (tileHeight)
+                                  .getIntersection (area);
+
+        auto tileClip = initialClip;
+        tileClip.clipTo (tileArea);
+
+        if (tileClip.isEmpty())
+            return;
+
+        // Pick out the commands that this tile needs. Any saved state or transparency layer
+        // that ends without anything having been drawn in this tile is left out completely.
+        std::vector<size_t> tileCommands, openStates;
+        int lastDrawingPosition = -1;
+
+        for (size_t i = 0; i < commands.size(); ++i)
+        {
+            auto& command = commands[i];
+
+            if (command.type == Command::Type::drawing)
+            {
+                if (! command.bounds.intersects (tileArea))
+                    continue;
+
+                lastDrawingPosition = (int) tileCommands.size();
+            }
+            else if (command.type == Command::Type::save)
+            {
+                openStates.push_back (tileCommands.size());
+            }
+            else if (command.type == Command::Type::restore && ! openStates.empty())
+            {
+                auto savePosition = openStates.back();
+                openStates.pop_back();
+
+                if (lastDrawingPosition < (int) savePosition)
+                {
+                    tileCommands.resize (savePosition);
+                    continue;
+                }
+            }
+
+            tileCommands.push_back (i);
+        }
+
+        if (lastDrawingPosition < 0)
+            return;
+
+        Image tileImage (*new TilePixelData (targetData));
+        LowLevelGraphicsSoftwareRenderer renderer (tileImage, origin, tileClip);
+
+        for (auto index : tileCommands)
+            commands[index].apply (renderer);
+    };
+
+    RenderingHelpers::runInParallel (*threadPool, numTiles, renderTile);
+
+    commands.clear();
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TiledSoftwareRendererTests  : public UnitTest
+{
+public:
+    TiledSoftwareRendererTests()
+        : UnitTest ("LowLevelGraphicsTiledSoftwareRenderer", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        ThreadPool pool (3);
+
+        beginTest ("Whole image");
+        {
+            for (auto format : { Image::ARGB, Image::RGB })
+            {
+                Image expected (format, 300, 200, true), actual (format, 300, 200, true);
+
+                {
+                    LowLevelGraphicsSoftwareRenderer context (expected);
+                    drawTestScene (context);
+                }
+
+                {
+                    LowLevelGraphicsTiledSoftwareRenderer context (actual, {}, actual.getBounds(), pool);
+                    context.setTileHeight (5);
+                    drawTestScene (context);
+                }
+
+                expectImagesMatch (expected, actual);
+            }
+        }
+
+        beginTest ("Clipped region with an origin");
+        {
+            RectangleList<int> clip;
+            clip.add ({ 10, 10, 120, 50 });
+            clip.add ({ 150, 70, 100, 120 });
+
+            Image expected (Image::ARGB, 300, 200, true), actual (Image::ARGB, 300, 200, true);
+
+            {
+                LowLevelGraphicsSoftwareRenderer context (expected, { 7, -3 }, clip);
+                drawTestScene (context);
+            }
+
+            {
+                LowLevelGraphicsTiledSoftwareRenderer context (actual, { 7, -3 }, clip, pool);
+                context.setTileHeight (17);
+                drawTestScene (context);
+            }
+
+            expectImagesMatch (expected, actual);
+        }
+
+        beginTest ("Clip queries");
+        {
+            Image im (Image::ARGB, 100, 100, true);
+            LowLevelGraphicsTiledSoftwareRenderer context (im, {}, im.getBounds(), pool);
+
+            expect (context.getClipBounds() == im.getBounds());
+
+            context.saveState();
+            context.setOrigin ({ 10, 20 });
+            expect (context.clipToRectangle ({ 0, 0, 30, 40 }));
+            expect (context.getClipBounds() == Rectangle<int> (0, 0, 30, 40));
+            expect (context.clipRegionIntersects ({ 20, 30, 50, 50 }));
+            expect (! context.clipRegionIntersects ({ 40, 0, 10, 10 }));
+            expect (! context.clipToRectangle ({ 50, 50, 10, 10 }));
+            expect (context.isClipEmpty());
+            context.restoreState();
+
+            expect (! context.isClipEmpty());
+            expect (context.getClipBounds() == im.getBounds());
+        }
+    }
+
+    static void drawTestScene (LowLevelGraphicsContext& context)
+    {
+        Graphics g (context);
+
+        g.fillAll (Colours::white);
+
+        ColourGradient gradient (Colours::red, 0.0f, 0.0f, Colours::blue.withAlpha (0.5f), 250.0f, 180.0f, false);
+        gradient.addColour (0.3, Colours::yellow);
+        g.setGradientFill (gradient);
+        g.fillRoundedRectangle (12.3f, 8.7f, 200.0f, 120.0f, 15.0f);
+
+        g.setColour (Colours::darkgreen);
+        g.drawEllipse (40.5f, 60.25f, 180.0f, 90.0f, 3.5f);
+        g.drawLine (0.0f, 199.0f, 299.0f, 0.0f, 2.0f);
+        g.fillRect (Rectangle<float> (220.4f, 20.3f, 40.5f, 30.25f));
+        g.fillCheckerBoard ({ 230.0f, 120.0f, 60.0f, 60.0f }, 7.0f, 7.0f, Colours::grey, Colours::orange);
+
+        {
+            Graphics::ScopedSaveState s (g);
+            g.addTransform (AffineTransform::rotation (0.4f, 150.0f, 100.0f));
+            g.reduceClipRegion (50, 50, 200, 100);
+            g.excludeClipRegion ({ 100, 70, 30, 30 });
+            g.setColour (Colours::purple.withAlpha (0.6f));
+            g.fillRect (0, 0, 300, 200);
+        }
+
+        {
+            Path star;
+            star.addStar ({ 100.0f, 120.0f }, 7, 20.0f, 60.0f, 0.3f);
+
+            Graphics::ScopedSaveState s (g);
+            g.reduceClipRegion (star);
+            g.setTiledImageFill (createTestImage(), 3, 5, 0.8f);
+            g.fillAll();
+        }
+
+        g.beginTransparencyLayer (0.5f);
+        g.setColour (Colours::cyan);
+        g.fillEllipse (150.0f, 50.0f, 100.0f, 100.0f);
+        g.setColour (Colours::black);
+        g.setFont (30.0f);
+        g.drawText ("Tiles!", 140, 80, 150, 40, Justification::centred);
+        g.endTransparencyLayer();
+
+        g.setOpacity (0.7f);
+        g.drawImageTransformed (createTestImage(), AffineTransform::scale (2.3f).rotated (-0.2f).translated (20.0f, 110.0f));
+        g.setImageResamplingQuality (Graphics::highResamplingQuality);
+        g.drawImage (createTestImage(), { 180.0f, 150.0f, 70.0f, 45.0f }, RectanglePlacement::stretchToFit);
+
+        g.setColour (Colours::black);
+        g.setFont (Font (14.0f, Font::bold));
+        g.drawText ("The quick brown fox jumps over the lazy dog", 5, 5, 290, 20, Justification::left);
+
+        g.addTransform (AffineTransform::rotation (-0.3f).scaled (1.2f, 0.9f).translated (20.0f, 190.0f));
+        g.drawText ("Rotated text", 0, 0, 200, 30, Justification::left);
+    }
+
+    static Image createTestImage()
+    {
+        Image im (Image::ARGB, 20, 15, true);
+        Graphics g (im);
+        g.setColour (Colours::green);
+        g.fillEllipse (im.getBounds().toFloat().reduced (2.0f));
+        g.setColour (Colours::red.withAlpha (0.5f));
+        g.drawLine (0.0f, 0.0f, 20.0f, 15.0f, 3.0f);
+        return im;
+    }
+
+    void expectImagesMatch (const Image& expected, const Image& actual)
+    {
+        int numDifferences = 0;
+
+        for (int y = 0; y < expected.getHeight(); ++y)
+            for (int x = 0; x < expected.getWidth(); ++x)
+                if (expected.getPixelAt (x, y) != actual.getPixelAt (x, y))
+                    ++numDifferences;
+
+        expectEquals (numDifferences, 0);
+    }
+};
+
+static TiledSoftwareRendererTests tiledSoftwareRendererTests;
+
+#endif
+
+} // namespace juce
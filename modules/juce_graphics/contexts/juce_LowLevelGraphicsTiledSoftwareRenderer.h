@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A software renderer that records everything drawn into it, and then rasterises
+    it on several threads at once.
+
+    Instead of drawing immediately, each call is stored in a display list along with
+    the area of the image that it could affect. When the renderer is deleted, the
+    target area is split up into horizontal strips, which are rendered in parallel
+    by a LowLevelGraphicsSoftwareRenderer that's clipped to each one, replaying only
+    the commands which touch that strip. The pixels produced are identical to those
+    that a LowLevelGraphicsSoftwareRenderer would have drawn.
+
+    This pays off when a large area is repainted at once, e.g. a whole editor window
+    on a high-DPI display. To use it for a window's painting, you can override
+    LookAndFeel::createGraphicsContext() to return one of these.
+
+    Because rendering is deferred, any images and paths passed to the renderer are
+    kept until it is deleted, and the contents of an Image that has been drawn must
+    not be changed until then. The target image must not be used for anything else
+    while the renderer exists.
+
+    User code is not supposed to create instances of this class directly - do all your
+    rendering via the Graphics class instead.
+
+    @see LowLevelGraphicsSoftwareRenderer
+
+    @tags{Graphics}
+*/
+class JUCE_API  LowLevelGraphicsTiledSoftwareRenderer    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates a context to render into an image, using a thread pool that's shared
+        between all tiled renderers.
+    */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto);
+
+    /** Creates a context to render into a clipped subsection of an image, using a
+        thread pool that's shared between all tiled renderers.
+    */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, Point<int> origin,
+                                           const RectangleList<int>& initialClip);
+
+    /** Creates a context to render into a clipped subsection of an image, using the
+        threads of the given pool. The pool must outlive the renderer, and it mustn't
+        be deleted from one of the pool's own threads.
+    */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, Point<int> origin,
+                                           const RectangleList<int>& initialClip, ThreadPool& threadPool);
+
+    /** Destructor.
+        This is where the recorded drawing actually gets rendered onto the image.
+    */
+    ~LowLevelGraphicsTiledSoftwareRenderer() override;
+
+    //==============================================================================
+    /** Changes the height of the strips that the image is split into.
+        The default is 32 pixels.
+    */
+    void setTileHeight (int newTileHeight) noexcept;
+
+    //==============================================================================
+    bool isVectorDevice() const override;
+    void setOrigin (Point<int>) override;
+    void addTransform (const AffineTransform&) override;
+    float getPhysicalPixelScaleFactor() override;
+    bool clipToRectangle (const Rectangle<int>&) override;
+    bool clipToRectangleList (const RectangleList<int>&) override;
+    void excludeClipRectangle (const Rectangle<int>&) override;
+    void clipToPath (const Path&, const AffineTransform&) override;
+    void clipToImageAlpha (const Image&, const AffineTransform&) override;
+    bool clipRegionIntersects (const Rectangle<int>&) override;
+    Rectangle<int> getClipBounds() const override;
+    bool isClipEmpty() const override;
+    void saveState() override;
+    void restoreState() override;
+    void beginTransparencyLayer (float opacity) override;
+    void endTransparencyLayer() override;
+    void setFill (const FillType&) override;
+    void setOpacity (float) override;
+    void setInterpolationQuality (Graphics::ResamplingQuality) override;
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents) override;
+    void fillRect (const Rectangle<float>&) override;
+    void fillRectList (const RectangleList<float>&) override;
+    void fillPath (const Path&, const AffineTransform&) override;
+    void drawImage (const Image&, const AffineTransform&) override;
+    void drawLine (const Line<float>&) override;
+    void setFont (const Font&) override;
+    const Font& getFont() override;
+    void drawGlyph (int glyphNumber, const AffineTransform&) override;
+
+private:
+    //==============================================================================
+    struct Command;
+    struct RecordedState;
+    struct GlyphInfo;
+    class TilePixelData;
+
+    Image image;
+    Point<int> origin;
+    RectangleList<int> initialClip;
+    ThreadPool* threadPool;
+    int tileHeight = 32;
+
+    std::vector<Command> commands;
+    std::unique_ptr<RecordedState> state;
+    std::vector<std::unique_ptr<RecordedState>> stateStack;
+    std::map<std::pair<Typeface*, int>, GlyphInfo> glyphs;
+
+    void addStateCommand (std::function<void (LowLevelGraphicsContext&)>);
+    void addDrawingCommand (Rectangle<float> userSpaceBounds, const AffineTransform&, std::function<void (LowLevelGraphicsContext&)>);
+    void pushState();
+    void popState();
+    void intersectClip (Rectangle<float> userSpaceBounds, const AffineTransform&);
+    const GlyphInfo& getGlyphInfo (const Font&, int glyphNumber);
+    void renderCommands();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsTiledSoftwareRenderer)
+};
+
+} // namespace juce
@@ -26,45 +26,99 @@
 namespace juce
 {
 
-static void blurDataTriplets (uint8* d, int num, const int delta) noexcept
+// The shadows used to be made by repeatedly averaging each pixel with its neighbours,
+// 2 * radius times in each direction. This Gaussian gives them the same spread.
+static float getShadowStandardDeviation (int radius) noexcept
 {
-    uint32 last = d[0];
-    d[0] = (uint8) ((d[0] + d[delta] + 1) / 3);
-    d += delta;
+    return std::sqrt ((float) radius * 4.0f / 3.0f);
+}
+
+//==============================================================================
+/*  Keeps the most recently used path shadows, so that a path which is drawn with
+    the same shadow on every repaint only needs to be rendered and blurred once.
+    Each shadow is stored as a blurred single-channel mask for the untranslated path.
+*/
+class DropShadowImageCache  : private DeletedAtShutdown
+{
+public:
+    DropShadowImageCache() = default;
+    ~DropShadowImageCache() override    { clearSingletonInstance(); }
 
-    num -= 2;
+    // Shadows bigger than this aren't cached, so that a big path which is mostly clipped
+    // doesn't need to be blurred in its entirety.
+    static constexpr int maxPixelsPerShadow = 512 * 512;
 
-    do
+    static Rectangle<int> getShadowArea (const Path& path, int radius)
     {
-        const uint32 newLast = d[0];
-        d[0] = (uint8) ((last + d[0] + d[delta] + 1) / 3);
-        d += delta;
-        last = newLast;
+        return path.getBounds().getSmallestIntegerContainer().expanded (radius + 1);
     }
-    while (--num > 0);
 
-    d[0] = (uint8) ((last + d[0] + 1) / 3);
-}
+    Image getShadow (const Path& path, int radius)
+    {
+        const auto area = getShadowArea (path, radius);
 
-static void blurSingleChannelImage (uint8* const data, const int width, const int height,
-                                    const int lineStride, const int repetitions) noexcept
-{
-    jassert (width > 2 && height > 2);
+        {
+            const ScopedLock sl (lock);
 
-    for (int y = 0; y < height; ++y)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + lineStride * y, width, 1);
+            for (int i = 0; i < shadows.size(); ++i)
+            {
+                auto& item = shadows.getReference (i);
 
-    for (int x = 0; x < width; ++x)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + x, height, lineStride);
-}
+                if (item.radius == radius && item.area == area && item.path == path)
+                {
+                    if (i > 0)
+                        shadows.move (i, 0);
 
-static void blurSingleChannelImage (Image& image, int radius)
-{
-    const Image::BitmapData bm (image, Image::BitmapData::readWrite);
-    blurSingleChannelImage (bm.data, bm.width, bm.height, bm.lineStride, 2 * radius);
-}
+                    return shadows.getReference (0).image;
+                }
+            }
+        }
+
+        auto image = renderShadow (path, radius, area);
+
+        const ScopedLock sl (lock);
+        shadows.insert (0, { path, radius, area, image });
+
+        if (shadows.size() > maxNumShadows)
+            shadows.removeLast();
+
+        return image;
+    }
+
+    static Image renderShadow (const Path& path, int radius, Rectangle<int> area)
+    {
+        Image image (Image::SingleChannel, area.getWidth(), area.getHeight(), true);
+
+        {
+            Graphics g (image);
+            g.setColour (Colours::white);
+            g.fillPath (path, AffineTransform::translation ((float) -area.getX(), (float) -area.getY()));
+        }
+
+        ImageBlur::applyGaussianBlur (image, getShadowStandardDeviation (radius));
+        return image;
+    }
+
+    JUCE_DECLARE_SINGLETON (DropShadowImageCache, false)
+
+private:
+    struct CachedShadow
+    {
+        Path path;
+        int radius;
+        Rectangle<int> area;
+        Image image;
+    };
+
+    static constexpr int maxNumShadows = 32;
+
+    CriticalSection lock;
+    Array<CachedShadow> shadows;
+
+    JUCE_DECLARE_NON_COPYABLE (DropShadowImageCache)
+};
+
+JUCE_IMPLEMENT_SINGLETON (DropShadowImageCache)
 
 //==============================================================================
 DropShadow::DropShadow (Colour shadowColour, const int r, Point<int> o) noexcept
@@ -82,7 +136,7 @@ void DropShadow::drawForImage (Graphics& g, const Image& srcImage) const
         Image shadowImage (srcImage.convertedToFormat (Image::SingleChannel));
         shadowImage.duplicateIfShared();
 
-        blurSingleChannelImage (shadowImage, radius);
+        ImageBlur::applyGaussianBlur (shadowImage, getShadowStandardDeviation (radius));
 
         g.setColour (colour);
         g.drawImageAt (shadowImage, offset.x, offset.y, true);
@@ -93,9 +147,23 @@ void DropShadow::drawForPath (Graphics& g, const Path& path) const
 {
     jassert (radius > 0);
 
+    auto clip = g.getClipBounds().expanded (radius + 1);
+    auto shadowArea = DropShadowImageCache::getShadowArea (path, radius);
+
+    if (! (shadowArea + offset).intersects (clip))
+        return;
+
+    if (shadowArea.getWidth() * shadowArea.getHeight() <= DropShadowImageCache::maxPixelsPerShadow)
+    {
+        g.setColour (colour);
+        g.drawImageAt (DropShadowImageCache::getInstance()->getShadow (path, radius),
+                       shadowArea.getX() + offset.x, shadowArea.getY() + offset.y, true);
+        return;
+    }
+
     auto area = (path.getBounds().getSmallestIntegerContainer() + offset)
                   .expanded (radius + 1)
-                  .getIntersection (g.getClipBounds().expanded (radius + 1));
+                  .getIntersection (clip);
 
     if (area.getWidth() > 2 && area.getHeight() > 2)
     {
@@ -108,7 +176,7 @@ void DropShadow::drawForPath (Graphics& g, const Path& path) const
                                                              (float) (offset.y - area.getY())));
         }
 
-        blurSingleChannelImage (renderedPath, radius);
+        ImageBlur::applyGaussianBlur (renderedPath, getShadowStandardDeviation (radius));
 
         g.setColour (colour);
         g.drawImageAt (renderedPath, area.getX(), area.getY(), true);
@@ -43,7 +43,10 @@ struct JUCE_API  DropShadow
     /** Renders a drop-shadow based on the alpha-channel of the given image. */
     void drawForImage (Graphics& g, const Image& srcImage) const;
 
-    /** Renders a drop-shadow based on the shape of a path. */
+    /** Renders a drop-shadow based on the shape of a path.
+        The most recently drawn shadows are cached, so drawing the same path with
+        the same radius again (at any offset) won't need to blur it again.
+    */
     void drawForPath (Graphics& g, const Path& path) const;
 
     /** Renders a drop-shadow for a rectangle.
@@ -74,8 +77,8 @@ struct JUCE_API  DropShadow
     shadow based on what gets drawn inside it. The shadow will also
     be applied to the component's children.
 
-    For speed, this doesn't use a proper gaussian blur, but cheats by
-    using a simple bilinear filter. If you need a really high-quality
+    The shadow is blurred using ImageBlur, which approximates a gaussian
+    blur with a few quick box filters. If you need a really high-quality
     shadow, check out ImageConvolutionKernel::createGaussianBlur()
 
     @see Component::setComponentEffect
@@ -38,14 +38,24 @@ void GlowEffect::setGlowProperties (float newRadius, Colour newColour, Point<int
 
 void GlowEffect::applyEffect (Image& image, Graphics& g, float scaleFactor, float alpha)
 {
-    Image temp (image.getFormat(), image.getWidth(), image.getHeight(), true);
+    // Only the alpha channel is used to draw the glow, so there's no need to blur the others
+    Image temp (image.convertedToFormat (Image::SingleChannel));
+    temp.duplicateIfShared();
 
-    ImageConvolutionKernel blurKernel (roundToInt (radius * scaleFactor * 2.0f));
+    ImageBlur::applyGaussianBlur (temp, radius * scaleFactor * 0.5f);
 
-    blurKernel.createGaussianBlur (radius);
-    blurKernel.rescaleAllValues (radius);
+    if (radius > 1.0f)
+    {
+        const Image::BitmapData data (temp, Image::BitmapData::readWrite);
 
-    blurKernel.applyToImage (temp, image, image.getBounds());
+        for (int y = 0; y < data.height; ++y)
+        {
+            auto* line = data.getLinePointer (y);
+
+            for (int x = 0; x < data.width; ++x)
+                line[x] = (uint8) jmin (255, roundToInt (line[x] * radius));
+        }
+    }
 
     g.setColour (colour.withMultipliedAlpha (alpha));
     g.drawImageAt (temp, offset.x, offset.y, true);
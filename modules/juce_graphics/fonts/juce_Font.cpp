@@ -170,16 +170,14 @@ void Typeface::setTypefaceCacheSize (int numFontsToCache)
     TypefaceCache::getInstance()->setSize (numFontsToCache);
 }
 
-void (*clearOpenGLGlyphCache)() = nullptr;
-
 void Typeface::clearTypefaceCache()
 {
     TypefaceCache::getInstance()->clear();
 
-    RenderingHelpers::SoftwareRendererSavedState::clearGlyphCache();
+    RenderingHelpers::GlyphCache::getInstance().reset();
 
-    if (clearOpenGLGlyphCache != nullptr)
-        clearOpenGLGlyphCache();
+    if (auto* textCache = TextShapingCache::getInstanceWithoutCreating())
+        textCache->clear();
 }
 
 //==============================================================================
@@ -477,7 +477,7 @@ private:
     void checkTypefaceSuitability();
     float getHeightToPointsFactor() const;
 
-    friend struct GraphicsFontHelpers;
+    friend class TextShapingCache;
 
     class SharedFontInternal;
     ReferenceCountedObjectPtr<SharedFontInternal> font;
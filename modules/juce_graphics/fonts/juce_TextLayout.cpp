@@ -246,6 +246,31 @@ void TextLayout::createLayout (const AttributedString& text, float maxWidth)
 }
 
 void TextLayout::createLayout (const AttributedString& text, float maxWidth, float maxHeight)
+{
+    *this = *TextShapingCache::getInstance()->findOrCreate<TextLayout> (createCacheKey (text, false, maxWidth, maxHeight), [&]
+    {
+        TextLayout layout;
+        layout.createUncachedLayout (text, maxWidth, maxHeight);
+        return layout;
+    });
+}
+
+void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& text, float maxWidth)
+{
+    createLayoutWithBalancedLineLengths (text, maxWidth, 1.0e7f);
+}
+
+void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& text, float maxWidth, float maxHeight)
+{
+    *this = *TextShapingCache::getInstance()->findOrCreate<TextLayout> (createCacheKey (text, true, maxWidth, maxHeight), [&]
+    {
+        TextLayout layout;
+        layout.createUncachedLayoutWithBalancedLineLengths (text, maxWidth, maxHeight);
+        return layout;
+    });
+}
+
+void TextLayout::createUncachedLayout (const AttributedString& text, float maxWidth, float maxHeight)
 {
     lines.clear();
     width = maxWidth;
@@ -258,12 +283,7 @@ void TextLayout::createLayout (const AttributedString& text, float maxWidth, flo
     recalculateSize();
 }
 
-void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& text, float maxWidth)
-{
-    createLayoutWithBalancedLineLengths (text, maxWidth, 1.0e7f);
-}
-
-void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& text, float maxWidth, float maxHeight)
+void TextLayout::createUncachedLayoutWithBalancedLineLengths (const AttributedString& text, float maxWidth, float maxHeight)
 {
     auto minimumWidth = maxWidth / 2.0f;
     auto bestWidth = maxWidth;
@@ -271,7 +291,7 @@ void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& te
 
     while (maxWidth > minimumWidth)
     {
-        createLayout (text, maxWidth, maxHeight);
+        createUncachedLayout (text, maxWidth, maxHeight);
 
         if (getNumLines() < 2)
             return;
@@ -295,7 +315,33 @@ void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& te
     }
 
     if (bestWidth != maxWidth)
-        createLayout (text, bestWidth, maxHeight);
+        createUncachedLayout (text, bestWidth, maxHeight);
+}
+
+TextShapingCache::Key TextLayout::createCacheKey (const AttributedString& text, bool balanceLineLengths,
+                                                  float maxWidth, float maxHeight)
+{
+    TextShapingCache::Key key { balanceLineLengths ? TextShapingCache::KeyType::balancedTextLayout
+                                                   : TextShapingCache::KeyType::textLayout,
+                                text.getText(), {}, {} };
+
+    key.values = { (double) maxWidth, (double) maxHeight,
+                   (double) text.getJustification().getFlags(),
+                   (double) text.getWordWrap(),
+                   (double) text.getReadingDirection(),
+                   (double) text.getLineSpacing() };
+
+    for (int i = 0; i < text.getNumAttributes(); ++i)
+    {
+        auto& attribute = text.getAttribute (i);
+
+        key.fonts.push_back (attribute.font);
+        key.values.push_back ((double) attribute.range.getStart());
+        key.values.push_back ((double) attribute.range.getEnd());
+        key.values.push_back ((double) attribute.colour.getARGB());
+    }
+
+    return key;
 }
 
 //==============================================================================
@@ -263,6 +263,9 @@ private:
 
     void createStandardLayout (const AttributedString&);
     bool createNativeLayout (const AttributedString&);
+    void createUncachedLayout (const AttributedString&, float maxWidth, float maxHeight);
+    void createUncachedLayoutWithBalancedLineLengths (const AttributedString&, float maxWidth, float maxHeight);
+    static TextShapingCache::Key createCacheKey (const AttributedString&, bool balanceLineLengths, float maxWidth, float maxHeight);
 
     JUCE_LEAK_DETECTOR (TextLayout)
 };
@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+bool TextShapingCache::Key::operator< (const Key& other) const noexcept
+{
+    if (type != other.type)               return type < other.type;
+    if (values != other.values)           return values < other.values;
+    if (fonts.size() != other.fonts.size()) return fonts.size() < other.fonts.size();
+
+    for (size_t i = 0; i < fonts.size(); ++i)
+        if (fonts[i] != other.fonts[i])
+            return Font::compare (fonts[i], other.fonts[i]);
+
+    return text < other.text;
+}
+
+//==============================================================================
+TextShapingCache::TextShapingCache() = default;
+
+TextShapingCache::~TextShapingCache()
+{
+    clearSingletonInstance();
+}
+
+JUCE_IMPLEMENT_SINGLETON (TextShapingCache)
+
+void TextShapingCache::clear()
+{
+    const ScopedLock sl (lock);
+    entries.clear();
+    entryOrder.clear();
+}
+
+void TextShapingCache::setMaximumNumEntries (int newMaxNumEntries)
+{
+    jassert (newMaxNumEntries >= 0);
+
+    const ScopedLock sl (lock);
+    maxNumEntries = jmax (0, newMaxNumEntries);
+    removeOldestEntries();
+}
+
+int TextShapingCache::getMaximumNumEntries() const noexcept
+{
+    return maxNumEntries;
+}
+
+TextShapingCache::Statistics TextShapingCache::getStatistics() const
+{
+    const ScopedLock sl (lock);
+
+    Statistics stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.numEntries = (int) entries.size();
+    return stats;
+}
+
+void TextShapingCache::resetStatistics()
+{
+    const ScopedLock sl (lock);
+    hits = 0;
+    misses = 0;
+}
+
+std::shared_ptr<const void> TextShapingCache::findOrCreateEntry (Key key, const std::function<std::shared_ptr<const void>()>& create)
+{
+    {
+        const ScopedLock sl (lock);
+
+        const auto iter = entries.find (key);
+
+        if (iter != entries.end())
+        {
+            ++hits;
+
+            if (iter->second.orderPosition != entryOrder.begin())
+                entryOrder.splice (entryOrder.begin(), entryOrder, iter->second.orderPosition);
+
+            return iter->second.value;
+        }
+
+        ++misses;
+    }
+
+    // The text is laid out without holding the lock, so that other threads can carry on
+    // drawing. If two threads lay out the same text at once, the first result is kept.
+    auto value = create();
+
+    const ScopedLock sl (lock);
+
+    if (maxNumEntries == 0)
+        return value;
+
+    const auto result = entries.emplace (std::move (key), Entry { value, {} });
+
+    if (result.second)
+    {
+        entryOrder.push_front (&result.first->first);
+        result.first->second.orderPosition = entryOrder.begin();
+        removeOldestEntries();
+    }
+
+    return value;
+}
+
+void TextShapingCache::removeOldestEntries()
+{
+    while (entries.size() > (size_t) maxNumEntries)
+    {
+        entries.erase (entries.find (*entryOrder.back()));
+        entryOrder.pop_back();
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TextShapingCacheTests  : public UnitTest
+{
+public:
+    TextShapingCacheTests()
+        : UnitTest ("TextShapingCache", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto& cache = *TextShapingCache::getInstance();
+        const auto oldMaxNumEntries = cache.getMaximumNumEntries();
+
+        Image image (Image::ARGB, 200, 100, true);
+        Graphics g (image);
+        g.setFont (14.0f);
+
+        beginTest ("Text drawn in several places is only laid out once");
+        {
+            cache.clear();
+            cache.resetStatistics();
+
+            g.drawFittedText ("Channel 1", 0, 0, 80, 20, Justification::centred, 1);
+            g.drawFittedText ("Channel 1", 100, 50, 80, 20, Justification::centred, 1);
+            g.drawFittedText ("Channel 1", 100, 50, 90, 20, Justification::centred, 1);
+
+            auto stats = cache.getStatistics();
+            expectEquals (stats.hits, (int64) 1);
+            expectEquals (stats.misses, (int64) 2);
+            expectEquals (stats.numEntries, 2);
+        }
+
+        beginTest ("Cached text is drawn in the right place");
+        {
+            Image direct (Image::ARGB, 200, 100, true);
+
+            {
+                Graphics directGraphics (direct);
+                GlyphArrangement arrangement;
+                arrangement.addFittedText (Font (14.0f), "Channel 1", 100.0f, 50.0f, 80.0f, 20.0f, Justification::centred, 1);
+                arrangement.draw (directGraphics);
+            }
+
+            image.clear (image.getBounds());
+            g.drawFittedText ("Channel 1", 100, 50, 80, 20, Justification::centred, 1);
+
+            expect (ImageTestHelpers::imagesAreEqual (image, direct));
+        }
+
+        beginTest ("Least recently used entries are removed");
+        {
+            cache.clear();
+            cache.setMaximumNumEntries (2);
+
+            g.drawText ("a", 0, 0, 50, 20, Justification::left);
+            g.drawText ("b", 0, 0, 50, 20, Justification::left);
+            g.drawText ("a", 0, 0, 50, 20, Justification::left);
+            g.drawText ("c", 0, 0, 50, 20, Justification::left);
+
+            cache.resetStatistics();
+            g.drawText ("a", 0, 0, 50, 20, Justification::left);
+            g.drawText ("b", 0, 0, 50, 20, Justification::left);
+
+            auto stats = cache.getStatistics();
+            expectEquals (stats.hits, (int64) 1);
+            expectEquals (stats.misses, (int64) 1);
+            expectEquals (stats.numEntries, 2);
+        }
+
+        beginTest ("Text layouts are reused");
+        {
+            cache.clear();
+            cache.setMaximumNumEntries (oldMaxNumEntries);
+            cache.resetStatistics();
+
+            AttributedString text ("Some text that is long enough to wrap onto more than one line");
+            text.setFont (Font (15.0f));
+
+            TextLayout first, second, narrower;
+            first.createLayout (text, 100.0f);
+            second.createLayout (text, 100.0f);
+            narrower.createLayout (text, 80.0f);
+
+            expect (first.getNumLines() > 1);
+            expectEquals (second.getNumLines(), first.getNumLines());
+            expectEquals (second.getHeight(), first.getHeight());
+
+            text.setColour (Colours::red);
+            second.createLayout (text, 100.0f);
+
+            auto stats = cache.getStatistics();
+            expectEquals (stats.hits, (int64) 1);
+            expectEquals (stats.misses, (int64) 3);
+        }
+
+        cache.clear();
+        cache.setMaximumNumEntries (oldMaxNumEntries);
+    }
+};
+
+static TextShapingCacheTests textShapingCacheTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Keeps hold of text that has recently been laid out, so that it doesn't need to
+    be shaped again every time it's drawn.
+
+    Graphics::drawText(), drawFittedText(), drawSingleLineText() and drawMultiLineText()
+    look up their glyph arrangements here, as does TextLayout::createLayout(). Entries
+    are keyed on the text, font and size constraints, but not on the position that the
+    text is drawn at, so a string that's drawn in lots of places (e.g. the same value
+    shown by many Labels) only needs to be laid out once.
+
+    The least recently used entries are discarded once the cache holds more than
+    getMaximumNumEntries() of them. The cache is shared by all threads, so the only
+    thing you'd normally need to do with it is to change its size, or to look at its
+    statistics to see how well it's working.
+
+    @see GlyphArrangement, TextLayout
+
+    @tags{Graphics}
+*/
+class JUCE_API  TextShapingCache  : private DeletedAtShutdown
+{
+public:
+    //==============================================================================
+    /** Creates an empty cache.
+        You'll normally want to use the shared instance returned by getInstance()
+        rather than creating one of these.
+    */
+    TextShapingCache();
+
+    /** Destructor. */
+    ~TextShapingCache() override;
+
+    //==============================================================================
+    /** Removes all the entries from the cache. */
+    void clear();
+
+    /** Changes the number of entries that the cache can hold.
+        The default is 2048.
+    */
+    void setMaximumNumEntries (int maxNumEntries);
+
+    /** Returns the number of entries that the cache can hold. */
+    int getMaximumNumEntries() const noexcept;
+
+    //==============================================================================
+    /** Some numbers describing how effective the cache is. */
+    struct Statistics
+    {
+        int64 hits = 0;         /**< The number of lookups that found an existing entry. */
+        int64 misses = 0;       /**< The number of lookups that had to lay out the text. */
+        int numEntries = 0;     /**< The number of entries currently in the cache. */
+    };
+
+    /** Returns the cache's current statistics. */
+    Statistics getStatistics() const;
+
+    /** Sets the hit and miss counts back to zero. */
+    void resetStatistics();
+
+    //==============================================================================
+    JUCE_DECLARE_SINGLETON (TextShapingCache, false)
+
+private:
+    //==============================================================================
+    friend class Graphics;
+    friend class TextLayout;
+
+    enum class KeyType
+    {
+        singleLineText,
+        multiLineText,
+        text,
+        fittedText,
+        textLayout,
+        balancedTextLayout
+    };
+
+    struct Key
+    {
+        KeyType type;
+        String text;
+        std::vector<Font> fonts;
+        std::vector<double> values;
+
+        bool operator< (const Key&) const noexcept;
+    };
+
+    struct Entry
+    {
+        std::shared_ptr<const void> value;
+        std::list<const Key*>::iterator orderPosition;
+    };
+
+    template <typename ValueType, typename CreateFunction>
+    std::shared_ptr<const ValueType> findOrCreate (Key key, CreateFunction&& create)
+    {
+        return std::static_pointer_cast<const ValueType> (findOrCreateEntry (std::move (key), [&]() -> std::shared_ptr<const void>
+        {
+            return std::make_shared<const ValueType> (create());
+        }));
+    }
+
+    std::shared_ptr<const void> findOrCreateEntry (Key, const std::function<std::shared_ptr<const void>()>&);
+    void removeOldestEntries();
+
+    CriticalSection lock;
+    std::map<Key, Entry> entries;
+    std::list<const Key*> entryOrder;
+    int maxNumEntries = 2048;
+    int64 hits = 0, misses = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (TextShapingCache)
+};
+
+} // namespace juce
@@ -91,8 +91,8 @@ EdgeTable::EdgeTable (Rectangle<int> area, const Path& path, const AffineTransfo
 
                     if (x < leftLimit)
                         x = leftLimit;
-                    else if (x >= rightLimit)
-                        x = rightLimit - 1;
+                    else if (x > rightLimit)
+                        x = rightLimit;
 
                     addEdgePoint (x, y1 / scale, direction * step);
                     y1 += step;
@@ -273,6 +273,22 @@ EdgeTable::EdgeTable (const EdgeTable& other)
     operator= (other);
 }
 
+EdgeTable::EdgeTable (const EdgeTable& other, Rectangle<int> clipLimits)
+   : bounds (other.bounds.getX(), jmax (other.bounds.getY(), clipLimits.getY()), other.bounds.getWidth(), 0),
+     maxEdgesPerLine (other.maxEdgesPerLine),
+     lineStrideElements (other.lineStrideElements),
+     needToCheckEmptiness (true)
+{
+    bounds.setBottom (jmax (bounds.getY(), jmin (other.bounds.getBottom(), clipLimits.getBottom())));
+
+    allocate();
+    copyEdgeTableData (table, lineStrideElements,
+                       other.table + lineStrideElements * (bounds.getY() - other.bounds.getY()),
+                       lineStrideElements, bounds.getHeight());
+
+    clipToRectangle (clipLimits);
+}
+
 EdgeTable& EdgeTable::operator= (const EdgeTable& other)
 {
     bounds = other.bounds;
@@ -285,6 +301,9 @@ EdgeTable& EdgeTable::operator= (const EdgeTable& other)
     return *this;
 }
 
+EdgeTable::EdgeTable (EdgeTable&&) noexcept = default;
+EdgeTable& EdgeTable::operator= (EdgeTable&&) noexcept = default;
+
 EdgeTable::~EdgeTable()
 {
 }
@@ -420,6 +439,11 @@ void EdgeTable::optimiseTable()
     remapTableForNumEdges (maxLineElements);
 }
 
+size_t EdgeTable::getMemoryUsage() const noexcept
+{
+    return sizeof (*this) + getEdgeTableAllocationSize (lineStrideElements, bounds.getHeight()) * sizeof (int);
+}
+
 void EdgeTable::addEdgePoint (const int x, const int y, const int winding)
 {
     jassert (y >= 0 && y < bounds.getHeight());
@@ -66,9 +66,20 @@ public:
     /** Creates a copy of another edge table. */
     EdgeTable (const EdgeTable&);
 
+    /** Creates a copy of the part of another edge table that lies within a rectangle.
+        This is quicker than copying the whole table and then clipping it.
+    */
+    EdgeTable (const EdgeTable& tableToCopy, Rectangle<int> clipLimits);
+
     /** Copies from another edge table. */
     EdgeTable& operator= (const EdgeTable&);
 
+    /** Move constructor. */
+    EdgeTable (EdgeTable&&) noexcept;
+
+    /** Move assignment operator. */
+    EdgeTable& operator= (EdgeTable&&) noexcept;
+
     /** Destructor. */
     ~EdgeTable();
 
@@ -91,6 +102,9 @@ public:
     */
     void optimiseTable();
 
+    /** Returns the number of bytes of memory that the table's data is using. */
+    size_t getMemoryUsage() const noexcept;
+
 
     //==============================================================================
     /** Iterates the lines in the table, for rendering.
@@ -803,6 +803,7 @@ private:
     friend class PathFlatteningIterator;
     friend class Path::Iterator;
     friend class EdgeTable;
+    friend class PathCache;
 
     Array<float> data;
 
@@ -0,0 +1,439 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+PathCache::PathCache() = default;
+
+PathCache::~PathCache()
+{
+    clearSingletonInstance();
+}
+
+JUCE_IMPLEMENT_SINGLETON (PathCache)
+
+void PathCache::clear()
+{
+    const ScopedLock sl (lock);
+    entries.clear();
+    entryOrder.clear();
+    recentMisses.fill (0);
+    totalBytes = 0;
+}
+
+void PathCache::setMaximumMemoryUsage (size_t newMaxNumBytes)
+{
+    const ScopedLock sl (lock);
+    maxNumBytes = newMaxNumBytes;
+    removeOldestEntries();
+}
+
+size_t PathCache::getMaximumMemoryUsage() const noexcept
+{
+    return maxNumBytes;
+}
+
+PathCache::Statistics PathCache::getStatistics() const
+{
+    const ScopedLock sl (lock);
+
+    Statistics stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.numEntries = (int) entries.size();
+    stats.numBytes = totalBytes;
+    return stats;
+}
+
+void PathCache::resetStatistics()
+{
+    const ScopedLock sl (lock);
+    hits = 0;
+    misses = 0;
+}
+
+//==============================================================================
+bool PathCache::isWorthCaching (const Path& path) noexcept
+{
+    // This is about the size of an ellipse - anything smaller than that is
+    // quicker to flatten again than it is to look up.
+    return path.data.size() >= 32;
+}
+
+std::shared_ptr<const Path> PathCache::getStrokedPath (const Path& path, const PathStrokeType& strokeType,
+                                                       const AffineTransform& transform, float extraAccuracy)
+{
+    auto createStroke = [&]
+    {
+        Path stroke;
+        strokeType.createStrokedPath (stroke, path, transform, extraAccuracy);
+        return stroke;
+    };
+
+    if (isWorthCaching (path))
+    {
+        if (auto cached = findOrCreate<Path> (path, { 0.0f,
+                                                      transform.mat00, transform.mat01, transform.mat02,
+                                                      transform.mat10, transform.mat11, transform.mat12,
+                                                      extraAccuracy,
+                                                      strokeType.getStrokeThickness(),
+                                                      (float) (strokeType.getJointStyle() * 16 + strokeType.getEndStyle()) },
+                                              createStroke))
+            return cached;
+    }
+
+    return std::make_shared<const Path> (createStroke());
+}
+
+std::optional<EdgeTable> PathCache::createEdgeTable (const Path& path, const AffineTransform& transform,
+                                                     Rectangle<int> clipLimits)
+{
+    if (! isWorthCaching (path))
+        return {};
+
+    // The cached table is created with any whole-pixel translation removed, so that it
+    // can be shared by all the places where the same path is drawn.
+    auto offsetX = std::floor (transform.getTranslationX());
+    auto offsetY = std::floor (transform.getTranslationY());
+
+    if (std::abs (offsetX) > 1.0e6f || std::abs (offsetY) > 1.0e6f)
+        return {};
+
+    auto t = transform.translated (-offsetX, -offsetY);
+    auto tableBounds = path.getBoundsTransformed (t).getSmallestIntegerContainer().expanded (1);
+
+    if (tableBounds.getWidth() > 8192 || tableBounds.getHeight() > 2048)
+        return {};
+
+    auto table = findOrCreate<EdgeTable> (path, { 1.0f,
+                                                  t.mat00, t.mat01, t.mat02,
+                                                  t.mat10, t.mat11, t.mat12,
+                                                  0.0f, 0.0f, 0.0f },
+                                          [&]
+                                          {
+                                              EdgeTable et (tableBounds, path, t);
+                                              et.optimiseTable();
+                                              return et;
+                                          });
+
+    if (table == nullptr)
+        return {};
+
+    const Point<int> offset ((int) offsetX, (int) offsetY);
+
+    std::optional<EdgeTable> result (std::in_place, *table, clipLimits - offset);
+    result->translate ((float) offset.x, offset.y);
+    return result;
+}
+
+//==============================================================================
+uint64 PathCache::getHash (const Path& path, const std::array<float, 10>& params) noexcept
+{
+    auto hash = (uint64) 0xcbf29ce484222325ull;
+
+    auto addToHash = [&hash] (const float* values, size_t num)
+    {
+        for (size_t i = 0; i < num; ++i)
+        {
+            uint32 bits;
+            memcpy (&bits, values + i, sizeof (bits));
+            hash = (hash ^ bits) * 0x100000001b3ull;
+        }
+    };
+
+    addToHash (path.data.begin(), (size_t) path.data.size());
+    addToHash (params.data(), params.size());
+
+    return hash ^ (path.isUsingNonZeroWinding() ? 1 : 0);
+}
+
+size_t PathCache::getMemoryUsage (const Path& path) noexcept
+{
+    return sizeof (Path) + (size_t) path.data.size() * sizeof (float);
+}
+
+size_t PathCache::getMemoryUsage (const EdgeTable& table) noexcept
+{
+    return table.getMemoryUsage();
+}
+
+std::shared_ptr<const void> PathCache::findOrCreateEntry (const Path& path, const std::array<float, 10>& params,
+                                                          const std::function<std::pair<std::shared_ptr<const void>, size_t>()>& create)
+{
+    const auto hash = getHash (path, params);
+
+    {
+        const ScopedLock sl (lock);
+
+        const auto iter = entries.find (hash);
+
+        if (iter != entries.end() && iter->second.key.params == params && iter->second.key.path == path)
+        {
+            ++hits;
+
+            if (iter->second.orderPosition != entryOrder.begin())
+                entryOrder.splice (entryOrder.begin(), entryOrder, iter->second.orderPosition);
+
+            return iter->second.value;
+        }
+
+        ++misses;
+
+        auto& recentMiss = recentMisses[hash % recentMisses.size()];
+
+        if (recentMiss != hash)
+        {
+            recentMiss = hash;
+            return {};
+        }
+
+        recentMiss = 0;
+    }
+
+    // The value is created without holding the lock, so that other threads can carry on
+    // drawing. If two threads create the same entry at once, the last one is kept.
+    auto value = create();
+    auto numBytes = value.second + getMemoryUsage (path);
+
+    const ScopedLock sl (lock);
+
+    if (numBytes > maxNumBytes / 4)
+        return value.first;
+
+    const auto iter = entries.find (hash);
+
+    if (iter != entries.end())
+    {
+        totalBytes -= iter->second.numBytes;
+        entryOrder.erase (iter->second.orderPosition);
+        entries.erase (iter);
+    }
+
+    entryOrder.push_front (hash);
+    entries.emplace (hash, Entry { { path, params }, value.first, numBytes, entryOrder.begin() });
+    totalBytes += numBytes;
+
+    removeOldestEntries();
+    return value.first;
+}
+
+void PathCache::removeOldestEntries()
+{
+    while (totalBytes > maxNumBytes && ! entryOrder.empty())
+    {
+        const auto iter = entries.find (entryOrder.back());
+        totalBytes -= iter->second.numBytes;
+        entries.erase (iter);
+        entryOrder.pop_back();
+    }
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PathCacheTests  : public UnitTest
+{
+public:
+    PathCacheTests()
+        : UnitTest ("PathCache", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto& cache = *PathCache::getInstance();
+        const auto oldMaxSize = cache.getMaximumMemoryUsage();
+
+        Path path;
+        path.startNewSubPath (10.0f, 10.0f);
+        path.cubicTo (60.0f, -20.0f, 90.0f, 80.0f, 40.0f, 70.0f);
+        path.quadraticTo (0.0f, 60.0f, 20.0f, 30.0f);
+        path.closeSubPath();
+        path.addEllipse (30.0f, 25.0f, 20.0f, 15.0f);
+
+        beginTest ("Cached edge tables match ones created directly");
+        {
+            Random r (1234);
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto transform = AffineTransform::rotation (r.nextFloat() * 6.0f)
+                                                 .scaled (0.5f + r.nextFloat() * 2.0f)
+                                                 .translated (r.nextFloat() * 100.0f, r.nextFloat() * 100.0f);
+
+                Rectangle<int> clip (r.nextInt (150), r.nextInt (150), 1 + r.nextInt (150), 1 + r.nextInt (150));
+
+                EdgeTable direct (clip, path, transform);
+                expect (! cache.createEdgeTable (path, transform, clip).has_value());
+
+                auto cached = cache.createEdgeTable (path, transform, clip);
+                expect (cached.has_value());
+
+                // Edges that cross the clip region may be rounded differently, but by no more than one level
+                if (cached.has_value())
+                    expect (coverageIsClose (getCoverage (*cached, 300), getCoverage (direct, 300)));
+            }
+        }
+
+        beginTest ("Paths are only cached once they've been seen again");
+        {
+            cache.clear();
+            cache.resetStatistics();
+
+            expect (! cache.createEdgeTable (path, {}, { 0, 0, 200, 200 }).has_value());
+            expectEquals (cache.getStatistics().numEntries, 0);
+
+            expect (cache.createEdgeTable (path, {}, { 0, 0, 200, 200 }).has_value());
+            expectEquals (cache.getStatistics().numEntries, 1);
+
+            expect (cache.createEdgeTable (path, {}, { 0, 0, 200, 200 }).has_value());
+
+            auto stats = cache.getStatistics();
+            expectEquals (stats.hits, (int64) 1);
+            expectEquals (stats.misses, (int64) 2);
+        }
+
+        beginTest ("Paths moved by whole pixels share an edge table");
+        {
+            cache.clear();
+            cache.resetStatistics();
+
+            cache.createEdgeTable (path, AffineTransform::translation (0.5f, 0.0f), { 0, 0, 200, 200 });
+            cache.createEdgeTable (path, AffineTransform::translation (10.5f, 20.0f), { 0, 0, 200, 200 });
+            cache.createEdgeTable (path, AffineTransform::translation (3.5f, 7.0f), { 0, 0, 200, 200 });
+            cache.createEdgeTable (path, AffineTransform::translation (10.0f, 20.0f), { 0, 0, 200, 200 });
+
+            auto stats = cache.getStatistics();
+            expectEquals (stats.hits, (int64) 1);
+            expectEquals (stats.misses, (int64) 3);
+            expectEquals (stats.numEntries, 1);
+            expect (stats.numBytes > 0);
+        }
+
+        beginTest ("Stroked paths are re-used wherever they're drawn");
+        {
+            cache.clear();
+            cache.resetStatistics();
+
+            Image image (Image::ARGB, 200, 200, true);
+            Graphics g (image);
+            PathStrokeType stroke (3.0f);
+
+            g.strokePath (path, stroke);
+            g.strokePath (path, stroke, AffineTransform::translation (50.0f, 40.0f));
+            expectEquals (cache.getStatistics().numEntries, 2);
+
+            g.strokePath (path, stroke, AffineTransform::translation (20.0f, 10.0f));
+
+            auto stats = cache.getStatistics();
+            expectEquals (stats.hits, (int64) 2);
+            expectEquals (stats.misses, (int64) 4);
+
+            g.strokePath (path, PathStrokeType (4.0f));
+            expectEquals (cache.getStatistics().misses, (int64) 6);
+            expectEquals (cache.getStatistics().numEntries, 2);
+
+            auto outline = cache.getStrokedPath (path, stroke, {}, 1.0f);
+            Path expected;
+            stroke.createStrokedPath (expected, path, {}, 1.0f);
+            expect (*outline == expected);
+        }
+
+        beginTest ("Least recently used entries are removed");
+        {
+            const auto addEntry = [&] (const AffineTransform& transform)
+            {
+                cache.createEdgeTable (path, transform, { 0, 0, 200, 200 });
+                cache.createEdgeTable (path, transform, { 0, 0, 200, 200 });
+            };
+
+            cache.clear();
+            cache.setMaximumMemoryUsage (1);
+            addEntry ({});
+            expectEquals (cache.getStatistics().numEntries, 0);
+
+            cache.setMaximumMemoryUsage (oldMaxSize);
+            addEntry ({});
+            addEntry (AffineTransform::scale (2.0f));
+            expectEquals (cache.getStatistics().numEntries, 2);
+
+            auto size = cache.getStatistics().numBytes;
+            cache.setMaximumMemoryUsage (size - 1);
+            expectEquals (cache.getStatistics().numEntries, 1);
+
+            cache.resetStatistics();
+            cache.createEdgeTable (path, AffineTransform::scale (2.0f), { 0, 0, 200, 200 });
+            expectEquals (cache.getStatistics().hits, (int64) 1);
+        }
+
+        cache.clear();
+        cache.setMaximumMemoryUsage (oldMaxSize);
+    }
+
+private:
+    static bool coverageIsClose (const std::vector<uint8>& a, const std::vector<uint8>& b)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+            if (std::abs ((int) a[i] - (int) b[i]) > 1)
+                return false;
+
+        return true;
+    }
+
+    static std::vector<uint8> getCoverage (const EdgeTable& table, int size)
+    {
+        struct Collector
+        {
+            std::vector<uint8>& levels;
+            int size, y = 0;
+
+            void setEdgeTableYPos (int newY) noexcept                       { y = newY; }
+            void handleEdgeTablePixel (int x, int alpha) const noexcept     { set (x, 1, alpha); }
+            void handleEdgeTablePixelFull (int x) const noexcept            { set (x, 1, 255); }
+            void handleEdgeTableLine (int x, int w, int alpha) const noexcept { set (x, w, alpha); }
+            void handleEdgeTableLineFull (int x, int w) const noexcept      { set (x, w, 255); }
+
+            void set (int x, int w, int alpha) const noexcept
+            {
+                for (int i = x; i < x + w; ++i)
+                    if (isPositiveAndBelow (i, size) && isPositiveAndBelow (y, size))
+                        levels[(size_t) (y * size + i)] = (uint8) alpha;
+            }
+        };
+
+        std::vector<uint8> levels ((size_t) (size * size));
+        Collector collector { levels, size };
+        table.iterate (collector);
+        return levels;
+    }
+};
+
+static PathCacheTests pathCacheTests;
+
+#endif
+
+} // namespace juce
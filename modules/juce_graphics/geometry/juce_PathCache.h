@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Keeps hold of the stroked outlines and rasterised edge tables of paths that are
+    drawn repeatedly, so that their curves don't need to be flattened again every
+    time they're drawn.
+
+    Graphics::strokePath() looks up its outlines here, and the software and OpenGL
+    renderers use it for the edge tables of the paths they fill. This means that
+    vector icons and Drawables, which tend to draw the same paths over and over, only
+    pay for flattening and scan-converting them once. Paths that are very simple, or
+    that would need very large edge tables, aren't cached.
+
+    Entries are keyed on the contents of the path, the stroke settings and the
+    transform. Edge tables are shared between paths that are only moved by a whole
+    number of pixels. A path is only cached the second time it's drawn with the same
+    settings, so paths that are drawn once, or change on every frame, don't push out
+    the entries that are actually being re-used. The least recently used entries are
+    discarded when the cache goes over its memory limit.
+
+    @see Path, EdgeTable, PathStrokeType
+
+    @tags{Graphics}
+*/
+class JUCE_API  PathCache  : private DeletedAtShutdown
+{
+public:
+    //==============================================================================
+    /** Creates an empty cache.
+        You'll normally want to use the shared instance returned by getInstance()
+        rather than creating one of these.
+    */
+    PathCache();
+
+    /** Destructor. */
+    ~PathCache() override;
+
+    //==============================================================================
+    /** Removes all the entries from the cache. */
+    void clear();
+
+    /** Changes the amount of memory that the cache may use, in bytes.
+        The default is 8MB.
+    */
+    void setMaximumMemoryUsage (size_t maxNumBytes);
+
+    /** Returns the amount of memory that the cache may use, in bytes. */
+    size_t getMaximumMemoryUsage() const noexcept;
+
+    //==============================================================================
+    /** Returns true if a path is complex enough to be worth caching. */
+    static bool isWorthCaching (const Path&) noexcept;
+
+    /** Returns the outline of a path stroked with the given settings, re-using a previous
+        result if there is one.
+
+        This behaves like PathStrokeType::createStrokedPath(). Because the result is shared,
+        you'll get more use out of it if you leave any translation out of the transform,
+        and apply it when the outline is drawn instead.
+    */
+    std::shared_ptr<const Path> getStrokedPath (const Path& path, const PathStrokeType& strokeType,
+                                                const AffineTransform& transform, float extraAccuracy);
+
+    /** Returns an EdgeTable for a path, clipped to the given area, made from a cached
+        table if possible.
+
+        The result is the same as constructing an EdgeTable from the path. If the path isn't
+        worth caching, hasn't been seen before, or would need too big a table, this returns
+        an empty optional, and you should create the table yourself.
+    */
+    std::optional<EdgeTable> createEdgeTable (const Path& path, const AffineTransform& transform,
+                                              Rectangle<int> clipLimits);
+
+    //==============================================================================
+    /** Some numbers describing how effective the cache is. */
+    struct Statistics
+    {
+        int64 hits = 0;         /**< The number of lookups that found an existing entry. */
+        int64 misses = 0;       /**< The number of lookups that had to create a new entry. */
+        int numEntries = 0;     /**< The number of entries currently in the cache. */
+        size_t numBytes = 0;    /**< The approximate amount of memory used by the entries. */
+    };
+
+    /** Returns the cache's current statistics. */
+    Statistics getStatistics() const;
+
+    /** Sets the hit and miss counts back to zero. */
+    void resetStatistics();
+
+    //==============================================================================
+    JUCE_DECLARE_SINGLETON (PathCache, false)
+
+private:
+    //==============================================================================
+    struct Key
+    {
+        Path path;
+        std::array<float, 10> params;
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::shared_ptr<const void> value;
+        size_t numBytes;
+        std::list<uint64>::iterator orderPosition;
+    };
+
+    static uint64 getHash (const Path&, const std::array<float, 10>&) noexcept;
+
+    // Returns nullptr if the entry doesn't exist and the key hasn't been seen recently
+    template <typename ValueType, typename CreateFunction>
+    std::shared_ptr<const ValueType> findOrCreate (const Path& path, const std::array<float, 10>& params,
+                                                   CreateFunction&& create)
+    {
+        return std::static_pointer_cast<const ValueType> (findOrCreateEntry (path, params, [&]
+        {
+            auto value = std::make_shared<const ValueType> (create());
+            return std::make_pair (std::shared_ptr<const void> (value), getMemoryUsage (*value));
+        }));
+    }
+
+    std::shared_ptr<const void> findOrCreateEntry (const Path&, const std::array<float, 10>&,
+                                                   const std::function<std::pair<std::shared_ptr<const void>, size_t>()>&);
+    void removeOldestEntries();
+
+    static size_t getMemoryUsage (const Path&) noexcept;
+    static size_t getMemoryUsage (const EdgeTable&) noexcept;
+
+    CriticalSection lock;
+    std::unordered_map<uint64, Entry> entries;
+    std::list<uint64> entryOrder;
+    size_t maxNumBytes = 8 * 1024 * 1024, totalBytes = 0;
+    int64 hits = 0, misses = 0;
+
+    // The hashes of recent misses, each in a slot chosen by its hash. A key is only
+    // added to the cache if it's still here when it misses again.
+    std::array<uint64, 1024> recentMisses {};
+
+    JUCE_DECLARE_NON_COPYABLE (PathCache)
+};
+
+} // namespace juce
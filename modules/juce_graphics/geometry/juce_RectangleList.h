@@ -617,6 +617,75 @@ public:
         }
     }
 
+    /** The largest number of rectangles that coalesce() will try to merge. */
+    static constexpr int maxRectanglesToCoalesce = 64;
+
+    /** The largest number of merges that a single call to coalesce() will make. */
+    static constexpr int maxCoalescedMerges = 32;
+
+    /** Merges rectangles together where drawing their bounding box would be cheaper
+        than drawing them separately.
+
+        When redrawing a region, each rectangle usually has a fixed cost of its own (e.g.
+        setting up a clip region or copying the result to the screen), on top of the cost
+        of the area it covers. This looks for pairs of rectangles where the area that
+        would be added by replacing them with their bounding box is no more than the given
+        cost, and merges them, as long as the merged rectangle doesn't overlap any others.
+
+        Unlike consolidate(), this can make the region bigger than it was, but will never
+        make it smaller.
+
+        The time this takes grows quickly with the number of rectangles, so lists of more
+        than maxRectanglesToCoalesce rectangles are left alone, and it stops after
+        maxCoalescedMerges merges.
+
+        @param costPerRectangle     the cost of each rectangle, expressed as an area
+        @see consolidate
+    */
+    void coalesce (ValueType costPerRectangle)
+    {
+        if (rects.size() > maxRectanglesToCoalesce)
+            return;
+
+        auto getArea = [] (RectangleType r) { return r.getWidth() * r.getHeight(); };
+        int numMerges = 0;
+
+        for (bool anyMerged = true; anyMerged && numMerges < maxCoalescedMerges;)
+        {
+            anyMerged = false;
+
+            for (int i = 0; i < rects.size() - 1 && numMerges < maxCoalescedMerges; ++i)
+            {
+                for (int j = i + 1; j < rects.size(); ++j)
+                {
+                    auto r = rects.getReference (i);
+                    auto r2 = rects.getReference (j);
+                    auto merged = r.getUnion (r2);
+
+                    if (getArea (merged) - getArea (r) - getArea (r2) > costPerRectangle)
+                        continue;
+
+                    bool overlapsOthers = false;
+
+                    for (int k = 0; k < rects.size() && ! overlapsOthers; ++k)
+                        overlapsOthers = (k != i && k != j && merged.intersects (rects.getReference (k)));
+
+                    if (! overlapsOthers)
+                    {
+                        rects.getReference (i) = merged;
+                        rects.remove (j);
+                        anyMerged = true;
+
+                        if (++numMerges == maxCoalescedMerges)
+                            break;
+
+                        j = i;
+                    }
+                }
+            }
+        }
+    }
+
     /** Adds an x and y value to all the coordinates. */
     void offsetAll (Point<ValueType> offset) noexcept
     {
@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct RectangleListUnitTest  : public UnitTest
+{
+    RectangleListUnitTest() : UnitTest ("RectangleList", UnitTestCategories::graphics) {}
+
+    void runTest() override
+    {
+        beginTest ("Coalescing merges nearby rectangles");
+        {
+            RectangleList<int> list;
+            list.addWithoutMerging ({ 0, 0, 10, 10 });
+            list.addWithoutMerging ({ 12, 0, 10, 10 });
+            list.addWithoutMerging ({ 100, 100, 10, 10 });
+
+            list.coalesce (20);
+            expectEquals (list.getNumRectangles(), 2);
+            expect (list.containsRectangle ({ 0, 0, 22, 10 }));
+            expect (list.containsRectangle ({ 100, 100, 10, 10 }));
+
+            list.coalesce (0);
+            expectEquals (list.getNumRectangles(), 2);
+
+            list.coalesce (100000);
+            expectEquals (list.getNumRectangles(), 1);
+            expect (list.getRectangle (0) == Rectangle<int> (0, 0, 110, 110));
+        }
+
+        beginTest ("Coalescing never creates overlapping rectangles");
+        {
+            Random r (1234);
+
+            for (int n = 0; n < 20; ++n)
+            {
+                RectangleList<int> list;
+
+                for (int i = 0; i < 30; ++i)
+                    list.add ({ r.nextInt (500), r.nextInt (500), 1 + r.nextInt (50), 1 + r.nextInt (50) });
+
+                auto original = list;
+                list.coalesce (1000);
+
+                expect (list.getNumRectangles() <= original.getNumRectangles());
+
+                for (auto& rect : original)
+                    expect (list.containsRectangle (rect));
+
+                for (int i = 0; i < list.getNumRectangles(); ++i)
+                    for (int j = i + 1; j < list.getNumRectangles(); ++j)
+                        expect (! list.getRectangle (i).intersects (list.getRectangle (j)));
+            }
+        }
+
+        beginTest ("Coalescing lots of rectangles");
+        {
+            for (auto numMeters : { 20, 60, 300 })
+            {
+                for (auto cost : { 1000, 1000000 })
+                {
+                    RectangleList<int> list;
+
+                    for (int i = 0; i < numMeters; ++i)
+                    {
+                        auto height = 1 + (i * 37) % 100;
+                        list.add ({ i * 6, 100 - height, 5, height });
+                    }
+
+                    auto original = list;
+                    list.coalesce (cost);
+
+                    if (numMeters > RectangleList<int>::maxRectanglesToCoalesce)
+                    {
+                        expectEquals (list.getNumRectangles(), original.getNumRectangles());
+                    }
+                    else
+                    {
+                        expect (list.getNumRectangles() < original.getNumRectangles());
+                        expect (list.getNumRectangles() >= jmax (1, original.getNumRectangles() - RectangleList<int>::maxCoalescedMerges));
+
+                        if (cost == 1000000)
+                            expectEquals (list.getNumRectangles(), jmax (1, numMeters - RectangleList<int>::maxCoalescedMerges));
+                    }
+
+                    for (auto& rect : original)
+                        expect (list.containsRectangle (rect));
+
+                    for (int i = 0; i < list.getNumRectangles(); ++i)
+                        for (int j = i + 1; j < list.getNumRectangles(); ++j)
+                            expect (! list.getRectangle (i).intersects (list.getRectangle (j)));
+                }
+            }
+        }
+    }
+};
+
+static RectangleListUnitTest rectangleListUnitTest;
+
+} // namespace juce
@@ -247,115 +247,153 @@ bool JPEGImageFormat::canUnderstand (InputStream& in)
 
 #if JUCE_USING_COREIMAGE_LOADER
  Image juce_loadWithCoreImage (InputStream& input);
-#endif
-
-Image JPEGImageFormat::decodeImage (InputStream& in)
+#else
+namespace JPEGHelpers
 {
-   #if JUCE_USING_COREIMAGE_LOADER
-    return juce_loadWithCoreImage (in);
-   #else
-    using namespace jpeglibNamespace;
-    using namespace JPEGHelpers;
-
-    MemoryOutputStream mb;
-    mb << in;
+    static Image readImage (InputStream& in, int maxWidth, int maxHeight)
+    {
+        using namespace jpeglibNamespace;
 
-    Image image;
+        MemoryOutputStream mb;
+        mb << in;
 
-    if (mb.getDataSize() > 16)
-    {
-        struct jpeg_decompress_struct jpegDecompStruct;
+        Image image;
+        Rectangle<int> targetSize;
 
-        struct jpeg_error_mgr jerr;
-        setupSilentErrorHandler (jerr);
-        jpegDecompStruct.err = &jerr;
+        if (mb.getDataSize() > 16)
+        {
+            struct jpeg_decompress_struct jpegDecompStruct;
 
-        jpeg_create_decompress (&jpegDecompStruct);
+            struct jpeg_error_mgr jerr;
+            setupSilentErrorHandler (jerr);
+            jpegDecompStruct.err = &jerr;
 
-        jpegDecompStruct.src = (jpeg_source_mgr*)(jpegDecompStruct.mem->alloc_small)
-            ((j_common_ptr)(&jpegDecompStruct), JPOOL_PERMANENT, sizeof (jpeg_source_mgr));
+            jpeg_create_decompress (&jpegDecompStruct);
 
-        bool hasFailed = false;
-        jpegDecompStruct.client_data = &hasFailed;
+            jpegDecompStruct.src = (jpeg_source_mgr*)(jpegDecompStruct.mem->alloc_small)
+                ((j_common_ptr)(&jpegDecompStruct), JPOOL_PERMANENT, sizeof (jpeg_source_mgr));
 
-        jpegDecompStruct.src->init_source       = dummyCallback1;
-        jpegDecompStruct.src->fill_input_buffer = jpegFill;
-        jpegDecompStruct.src->skip_input_data   = jpegSkip;
-        jpegDecompStruct.src->resync_to_restart = jpeg_resync_to_restart;
-        jpegDecompStruct.src->term_source       = dummyCallback1;
+            bool hasFailed = false;
+            jpegDecompStruct.client_data = &hasFailed;
 
-        jpegDecompStruct.src->next_input_byte   = static_cast<const unsigned char*> (mb.getData());
-        jpegDecompStruct.src->bytes_in_buffer   = mb.getDataSize();
+            jpegDecompStruct.src->init_source       = dummyCallback1;
+            jpegDecompStruct.src->fill_input_buffer = jpegFill;
+            jpegDecompStruct.src->skip_input_data   = jpegSkip;
+            jpegDecompStruct.src->resync_to_restart = jpeg_resync_to_restart;
+            jpegDecompStruct.src->term_source       = dummyCallback1;
 
-        jpeg_read_header (&jpegDecompStruct, TRUE);
+            jpegDecompStruct.src->next_input_byte   = static_cast<const unsigned char*> (mb.getData());
+            jpegDecompStruct.src->bytes_in_buffer   = mb.getDataSize();
 
-        if (! hasFailed)
-        {
-            jpeg_calc_output_dimensions (&jpegDecompStruct);
+            jpeg_read_header (&jpegDecompStruct, TRUE);
 
             if (! hasFailed)
             {
-                const int width  = (int) jpegDecompStruct.output_width;
-                const int height = (int) jpegDecompStruct.output_height;
+                // libjpeg can skip most of the work of decoding an image if it only needs to
+                // produce a version that's 1/2, 1/4 or 1/8 of the size
+                targetSize = ImageFileFormat::getSizeToFit ((int) jpegDecompStruct.image_width,
+                                                            (int) jpegDecompStruct.image_height,
+                                                            maxWidth, maxHeight);
 
-                jpegDecompStruct.out_color_space = JCS_RGB;
+                for (unsigned int denom = 8; denom > 1; denom /= 2)
+                {
+                    if ((int) ((jpegDecompStruct.image_width  + denom - 1) / denom) >= targetSize.getWidth()
+                         && (int) ((jpegDecompStruct.image_height + denom - 1) / denom) >= targetSize.getHeight())
+                    {
+                        jpegDecompStruct.scale_num = 1;
+                        jpegDecompStruct.scale_denom = denom;
+                        break;
+                    }
+                }
 
-                JSAMPARRAY buffer
-                    = (*jpegDecompStruct.mem->alloc_sarray) ((j_common_ptr) &jpegDecompStruct,
-                                                             JPOOL_IMAGE,
-                                                             (JDIMENSION) width * 3, 1);
+                jpeg_calc_output_dimensions (&jpegDecompStruct);
 
-                if (jpeg_start_decompress (&jpegDecompStruct) && ! hasFailed)
+                if (! hasFailed)
                 {
-                    image = Image (Image::RGB, width, height, false);
-                    image.getProperties()->set ("originalImageHadAlpha", false);
-                    const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
+                    const int width  = (int) jpegDecompStruct.output_width;
+                    const int height = (int) jpegDecompStruct.output_height;
 
-                    const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+                    jpegDecompStruct.out_color_space = JCS_RGB;
 
-                    for (int y = 0; y < height; ++y)
-                    {
-                        jpeg_read_scanlines (&jpegDecompStruct, buffer, 1);
+                    JSAMPARRAY buffer
+                        = (*jpegDecompStruct.mem->alloc_sarray) ((j_common_ptr) &jpegDecompStruct,
+                                                                 JPOOL_IMAGE,
+                                                                 (JDIMENSION) width * 3, 1);
 
-                        if (hasFailed)
-                            break;
+                    if (jpeg_start_decompress (&jpegDecompStruct) && ! hasFailed)
+                    {
+                        image = Image (Image::RGB, width, height, false);
+                        image.getProperties()->set ("originalImageHadAlpha", false);
+                        const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
 
-                        const uint8* src = *buffer;
-                        uint8* dest = destData.getLinePointer (y);
+                        const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
 
-                        if (hasAlphaChan)
+                        for (int y = 0; y < height; ++y)
                         {
-                            for (int i = width; --i >= 0;)
+                            jpeg_read_scanlines (&jpegDecompStruct, buffer, 1);
+
+                            if (hasFailed)
+                                break;
+
+                            const uint8* src = *buffer;
+                            uint8* dest = destData.getLinePointer (y);
+
+                            if (hasAlphaChan)
                             {
-                                ((PixelARGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
-                                ((PixelARGB*) dest)->premultiply();
-                                dest += destData.pixelStride;
-                                src += 3;
+                                for (int i = width; --i >= 0;)
+                                {
+                                    ((PixelARGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
+                                    ((PixelARGB*) dest)->premultiply();
+                                    dest += destData.pixelStride;
+                                    src += 3;
+                                }
                             }
-                        }
-                        else
-                        {
-                            for (int i = width; --i >= 0;)
+                            else
                             {
-                                ((PixelRGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
-                                dest += destData.pixelStride;
-                                src += 3;
+                                for (int i = width; --i >= 0;)
+                                {
+                                    ((PixelRGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
+                                    dest += destData.pixelStride;
+                                    src += 3;
+                                }
                             }
                         }
-                    }
 
-                    if (! hasFailed)
-                        jpeg_finish_decompress (&jpegDecompStruct);
+                        if (! hasFailed)
+                            jpeg_finish_decompress (&jpegDecompStruct);
 
-                    in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
+                        in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
+                    }
                 }
             }
+
+            jpeg_destroy_decompress (&jpegDecompStruct);
         }
 
-        jpeg_destroy_decompress (&jpegDecompStruct);
+        // libjpeg can only shrink the image by 1/2, 1/4 or 1/8, so it may need a bit more..
+        if (image.isValid() && (image.getWidth() != targetSize.getWidth() || image.getHeight() != targetSize.getHeight()))
+            return image.rescaled (targetSize.getWidth(), targetSize.getHeight(), Graphics::mediumResamplingQuality);
+
+        return image;
     }
+}
+#endif
 
-    return image;
+Image JPEGImageFormat::decodeImage (InputStream& in)
+{
+   #if JUCE_USING_COREIMAGE_LOADER
+    return juce_loadWithCoreImage (in);
+   #else
+    return JPEGHelpers::readImage (in, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+   #endif
+}
+
+Image JPEGImageFormat::decodeImageScaledToFit (InputStream& in, int maxWidth, int maxHeight)
+{
+   #if JUCE_USING_COREIMAGE_LOADER
+    return ImageFileFormat::decodeImageScaledToFit (in, maxWidth, maxHeight);
+   #else
+    return JPEGHelpers::readImage (in, maxWidth, maxHeight);
    #endif
 }
 
@@ -414,48 +414,169 @@ namespace PNGHelpers
         return false;
     }
 
+    template <typename RowCallback>
+    static bool readImageRows (png_structp pngReadStruct, png_infop pngInfoStruct, jmp_buf& errorJumpBuf,
+                               png_bytep rowBuffer, png_uint_32 height, RowCallback&& handleRow) noexcept
+    {
+        if (setjmp (errorJumpBuf) == 0)
+        {
+            if (png_get_valid (pngReadStruct, pngInfoStruct, PNG_INFO_tRNS))
+                png_set_expand (pngReadStruct);
+
+            png_set_add_alpha (pngReadStruct, 0xff, PNG_FILLER_AFTER);
+
+            for (png_uint_32 y = 0; y < height; ++y)
+            {
+                png_read_row (pngReadStruct, rowBuffer, nullptr);
+                handleRow ((int) y, rowBuffer);
+            }
+
+            png_read_end (pngReadStruct, pngInfoStruct);
+            return true;
+        }
+
+        return false;
+    }
+
     JUCE_END_IGNORE_WARNINGS_MSVC
 
-    static Image createImageFromData (bool hasAlphaChan, int width, int height, png_bytepp rows)
+    static void convertRow (const uint8* src, uint8* dest, int width, int pixelStride, bool hasAlphaChan) noexcept
+    {
+        if (hasAlphaChan)
+        {
+            for (int i = width; --i >= 0;)
+            {
+                ((PixelARGB*) dest)->setARGB (src[3], src[0], src[1], src[2]);
+                ((PixelARGB*) dest)->premultiply();
+                dest += pixelStride;
+                src += 4;
+            }
+        }
+        else
+        {
+            for (int i = width; --i >= 0;)
+            {
+                ((PixelRGB*) dest)->setARGB (0, src[0], src[1], src[2]);
+                dest += pixelStride;
+                src += 4;
+            }
+        }
+    }
+
+    static Image createEmptyImage (bool& hasAlphaChan, int width, int height)
     {
-        // now convert the data to a juce image format..
         Image image (hasAlphaChan ? Image::ARGB : Image::RGB, width, height, hasAlphaChan);
 
         image.getProperties()->set ("originalImageHadAlpha", image.hasAlphaChannel());
         hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
 
+        return image;
+    }
+
+    static Image createImageFromData (bool hasAlphaChan, int width, int height, png_bytepp rows)
+    {
+        // now convert the data to a juce image format..
+        auto image = createEmptyImage (hasAlphaChan, width, height);
         const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
 
         for (int y = 0; y < (int) height; ++y)
+            convertRow (rows[y], destData.getLinePointer (y), width, destData.pixelStride, hasAlphaChan);
+
+        return image;
+    }
+
+    // The image can only be shrunk by a whole-number factor while it's being decoded,
+    // so it may need a bit more to get it to the size that was asked for
+    static Image rescaleToSize (const Image& image, Rectangle<int> size)
+    {
+        if (image.getWidth() == size.getWidth() && image.getHeight() == size.getHeight())
+            return image;
+
+        return image.rescaled (size.getWidth(), size.getHeight(), Graphics::mediumResamplingQuality);
+    }
+
+    // Averages each block of (shrinkFactor * shrinkFactor) pixels as the rows arrive from the
+    // decoder, so the full-size image never needs to be held in memory.
+    struct ShrinkingRowWriter
+    {
+        ShrinkingRowWriter (const Image::BitmapData& d, int srcWidth, int srcHeight, int factor, bool alpha)
+            : destData (d), sourceWidth (srcWidth), sourceHeight (srcHeight),
+              shrinkFactor (factor), hasAlphaChan (alpha), sums ((size_t) d.width * 4, true)
         {
-            const uint8* src = rows[y];
-            uint8* dest = destData.getLinePointer (y);
+        }
+
+        void addRow (int y, const uint8* src) noexcept
+        {
+            auto* sum = sums.get();
 
-            if (hasAlphaChan)
+            for (int x = 0; x < sourceWidth; x += shrinkFactor)
             {
-                for (int i = (int) width; --i >= 0;)
+                uint32 a = 0, r = 0, g = 0, b = 0;
+
+                for (int i = jmin (shrinkFactor, sourceWidth - x); --i >= 0;)
                 {
-                    ((PixelARGB*) dest)->setARGB (src[3], src[0], src[1], src[2]);
-                    ((PixelARGB*) dest)->premultiply();
-                    dest += destData.pixelStride;
+                    if (src[3] == 0xff || ! hasAlphaChan)
+                    {
+                        a += 0xff;
+                        r += src[0];
+                        g += src[1];
+                        b += src[2];
+                    }
+                    else
+                    {
+                        PixelARGB p;
+                        p.setARGB (src[3], src[0], src[1], src[2]);
+                        p.premultiply();
+
+                        a += p.getAlpha();
+                        r += p.getRed();
+                        g += p.getGreen();
+                        b += p.getBlue();
+                    }
+
                     src += 4;
                 }
+
+                sum[0] += a;
+                sum[1] += r;
+                sum[2] += g;
+                sum[3] += b;
+                sum += 4;
             }
-            else
+
+            if ((y + 1) % shrinkFactor == 0 || y == sourceHeight - 1)
+                writeDestRow (y / shrinkFactor, y % shrinkFactor + 1);
+        }
+
+        void writeDestRow (int destY, int numRows) noexcept
+        {
+            auto* dest = destData.getLinePointer (destY);
+
+            for (int x = 0; x < destData.width; ++x)
             {
-                for (int i = (int) width; --i >= 0;)
-                {
-                    ((PixelRGB*) dest)->setARGB (0, src[0], src[1], src[2]);
-                    dest += destData.pixelStride;
-                    src += 4;
-                }
+                auto* sum = sums + x * 4;
+                auto count = (uint32) (numRows * jmin (shrinkFactor, sourceWidth - x * shrinkFactor));
+                auto average = [&] (int channel) { return (uint8) ((sum[channel] + count / 2) / count); };
+
+                if (hasAlphaChan)
+                    ((PixelARGB*) dest)->setARGB (average (0), average (1), average (2), average (3));
+                else
+                    ((PixelRGB*) dest)->setARGB (0, average (1), average (2), average (3));
+
+                dest += destData.pixelStride;
             }
+
+            zeromem (sums, (size_t) destData.width * 4 * sizeof (uint32));
         }
 
-        return image;
-    }
+        const Image::BitmapData& destData;
+        const int sourceWidth, sourceHeight, shrinkFactor;
+        const bool hasAlphaChan;
+        HeapBlock<uint32> sums;
+    };
 
-    static Image readImage (InputStream& in, png_structp pngReadStruct, png_infop pngInfoStruct)
+    static Image readImage (InputStream& in, png_structp pngReadStruct, png_infop pngInfoStruct,
+                            int maxWidth, int maxHeight)
     {
         jmp_buf errorJumpBuf;
         png_set_error_fn (pngReadStruct, &errorJumpBuf, errorCallback, warningCallback);
@@ -466,34 +587,75 @@ namespace PNGHelpers
         if (readHeader (in, pngReadStruct, pngInfoStruct, errorJumpBuf,
                         width, height, bitDepth, colorType, interlaceType))
         {
-            // Load the image into a temp buffer..
-            const size_t lineStride = width * 4;
-            HeapBlock<uint8> tempBuffer (height * lineStride);
-            HeapBlock<png_bytep> rows (height);
-
-            for (size_t y = 0; y < height; ++y)
-                rows[y] = (png_bytep) (tempBuffer + lineStride * y);
-
             png_bytep trans_alpha = nullptr;
             png_color_16p trans_color = nullptr;
             int num_trans = 0;
             png_get_tRNS (pngReadStruct, pngInfoStruct, &trans_alpha, &num_trans, &trans_color);
 
-            if (readImageData (pngReadStruct, pngInfoStruct, errorJumpBuf, rows))
-                return createImageFromData ((colorType & PNG_COLOR_MASK_ALPHA) != 0 || num_trans != 0,
-                                            (int) width, (int) height, rows);
+            bool hasAlphaChan = (colorType & PNG_COLOR_MASK_ALPHA) != 0 || num_trans != 0;
+            const size_t lineStride = width * 4;
+            const auto targetSize = ImageFileFormat::getSizeToFit ((int) width, (int) height, maxWidth, maxHeight);
+
+            if (interlaceType != PNG_INTERLACE_NONE)
+            {
+                // The rows of an interlaced image arrive in several passes, so it has
+                // to be loaded into a temp buffer..
+                HeapBlock<uint8> tempBuffer (height * lineStride);
+                HeapBlock<png_bytep> rows (height);
+
+                for (size_t y = 0; y < height; ++y)
+                    rows[y] = (png_bytep) (tempBuffer + lineStride * y);
+
+                if (readImageData (pngReadStruct, pngInfoStruct, errorJumpBuf, rows))
+                    return rescaleToSize (createImageFromData (hasAlphaChan, (int) width, (int) height, rows), targetSize);
+
+                return Image();
+            }
+
+            // Otherwise, each row is converted straight into the image as it's decoded,
+            // and if the image is being shrunk, only the smaller version is ever created.
+            const auto shrinkFactor = jmax (1, jmin ((int) width / targetSize.getWidth(),
+                                                     (int) height / targetSize.getHeight()));
+
+            auto image = createEmptyImage (hasAlphaChan,
+                                           ((int) width  + shrinkFactor - 1) / shrinkFactor,
+                                           ((int) height + shrinkFactor - 1) / shrinkFactor);
+
+            const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+            HeapBlock<uint8> rowBuffer (lineStride);
+            bool ok = false;
+
+            if (shrinkFactor == 1)
+            {
+                ok = readImageRows (pngReadStruct, pngInfoStruct, errorJumpBuf, rowBuffer, height, [&] (int y, const uint8* row)
+                {
+                    convertRow (row, destData.getLinePointer (y), (int) width, destData.pixelStride, hasAlphaChan);
+                });
+            }
+            else
+            {
+                ShrinkingRowWriter writer (destData, (int) width, (int) height, shrinkFactor, hasAlphaChan);
+
+                ok = readImageRows (pngReadStruct, pngInfoStruct, errorJumpBuf, rowBuffer, height, [&] (int y, const uint8* row)
+                {
+                    writer.addRow (y, row);
+                });
+            }
+
+            if (ok)
+                return rescaleToSize (image, targetSize);
         }
 
         return Image();
     }
 
-    static Image readImage (InputStream& in)
+    static Image readImage (InputStream& in, int maxWidth, int maxHeight)
     {
         if (png_structp pngReadStruct = png_create_read_struct (PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr))
         {
             if (png_infop pngInfoStruct = png_create_info_struct (pngReadStruct))
             {
-                Image image (readImage (in, pngReadStruct, pngInfoStruct));
+                Image image (readImage (in, pngReadStruct, pngInfoStruct, maxWidth, maxHeight));
                 png_destroy_read_struct (&pngReadStruct, &pngInfoStruct, nullptr);
                 return image;
             }
@@ -533,7 +695,16 @@ Image PNGImageFormat::decodeImage (InputStream& in)
    #if JUCE_USING_COREIMAGE_LOADER
     return juce_loadWithCoreImage (in);
    #else
-    return PNGHelpers::readImage (in);
+    return PNGHelpers::readImage (in, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+   #endif
+}
+
+Image PNGImageFormat::decodeImageScaledToFit (InputStream& in, int maxWidth, int maxHeight)
+{
+   #if JUCE_USING_COREIMAGE_LOADER
+    return ImageFileFormat::decodeImageScaledToFit (in, maxWidth, maxHeight);
+   #else
+    return PNGHelpers::readImage (in, maxWidth, maxHeight);
    #endif
 }
 
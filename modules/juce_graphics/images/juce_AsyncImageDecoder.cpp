@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+// The callbacks are shared with the jobs and the messages that deliver their results,
+// so that these can safely outlive the decoder.
+struct AsyncImageDecoder::PendingRequests
+{
+    bool isPending (int requestID) const
+    {
+        const ScopedLock sl (lock);
+        return callbacks.find (requestID) != callbacks.end();
+    }
+
+    void deliver (int requestID, const Image& image)
+    {
+        Callback callback;
+
+        {
+            const ScopedLock sl (lock);
+            auto iter = callbacks.find (requestID);
+
+            if (iter == callbacks.end())
+                return;
+
+            callback = std::move (iter->second);
+            callbacks.erase (iter);
+        }
+
+        if (callback != nullptr)
+            callback (image);
+    }
+
+    CriticalSection lock;
+    std::map<int, Callback> callbacks;
+};
+
+//==============================================================================
+class AsyncImageDecoder::DecodingJob  : public ThreadPoolJob
+{
+public:
+    DecodingJob (std::shared_ptr<PendingRequests> pending, int request, std::function<Image()> decodeFunction)
+        : ThreadPoolJob ("Image decoder"),
+          pendingRequests (std::move (pending)),
+          requestID (request),
+          decode (std::move (decodeFunction))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        if (shouldExit() || ! pendingRequests->isPending (requestID))
+            return jobHasFinished;
+
+        auto image = decode();
+
+        MessageManager::callAsync ([pending = pendingRequests, id = requestID, image]
+        {
+            pending->deliver (id, image);
+        });
+
+        return jobHasFinished;
+    }
+
+    const std::shared_ptr<PendingRequests> pendingRequests;
+    const int requestID;
+
+private:
+    std::function<Image()> decode;
+
+    JUCE_DECLARE_NON_COPYABLE (DecodingJob)
+};
+
+//==============================================================================
+AsyncImageDecoder::AsyncImageDecoder (int numberOfThreads)
+    : pendingRequests (std::make_shared<PendingRequests>()),
+      threadPool (jmax (1, numberOfThreads), 0, Thread::Priority::background)
+{
+}
+
+AsyncImageDecoder::~AsyncImageDecoder()
+{
+    cancelAll();
+}
+
+int AsyncImageDecoder::loadImage (const File& imageFile, int maxWidth, int maxHeight, Callback callback)
+{
+    return addRequest ([imageFile, maxWidth, maxHeight]
+                       {
+                           if (maxWidth > 0 && maxHeight > 0)
+                               return ImageFileFormat::loadFrom (imageFile, maxWidth, maxHeight);
+
+                           return ImageFileFormat::loadFrom (imageFile);
+                       },
+                       std::move (callback));
+}
+
+int AsyncImageDecoder::loadImage (MemoryBlock imageData, int maxWidth, int maxHeight, Callback callback)
+{
+    return addRequest ([data = std::move (imageData), maxWidth, maxHeight]
+                       {
+                           MemoryInputStream stream (data, false);
+
+                           if (maxWidth > 0 && maxHeight > 0)
+                               return ImageFileFormat::loadFrom (stream, maxWidth, maxHeight);
+
+                           return ImageFileFormat::loadFrom (stream);
+                       },
+                       std::move (callback));
+}
+
+int AsyncImageDecoder::addRequest (std::function<Image()> decode, Callback callback)
+{
+    const auto requestID = ++nextRequestID;
+
+    {
+        const ScopedLock sl (pendingRequests->lock);
+        pendingRequests->callbacks[requestID] = std::move (callback);
+    }
+
+    threadPool.addJob (new DecodingJob (pendingRequests, requestID, std::move (decode)), true);
+    return requestID;
+}
+
+bool AsyncImageDecoder::cancel (int requestID)
+{
+    bool wasPending = false;
+
+    {
+        const ScopedLock sl (pendingRequests->lock);
+        wasPending = pendingRequests->callbacks.erase (requestID) > 0;
+    }
+
+    if (wasPending)
+        removeJobs (requestID);
+
+    return wasPending;
+}
+
+void AsyncImageDecoder::cancelAll()
+{
+    {
+        const ScopedLock sl (pendingRequests->lock);
+        pendingRequests->callbacks.clear();
+    }
+
+    removeJobs (0);
+}
+
+int AsyncImageDecoder::getNumPendingRequests() const
+{
+    const ScopedLock sl (pendingRequests->lock);
+    return (int) pendingRequests->callbacks.size();
+}
+
+void AsyncImageDecoder::removeJobs (int requestID)
+{
+    struct Selector  : public ThreadPool::JobSelector
+    {
+        explicit Selector (int id) : requestID (id) {}
+
+        bool isJobSuitable (ThreadPoolJob* job) override
+        {
+            return requestID == 0 || static_cast<DecodingJob*> (job)->requestID == requestID;
+        }
+
+        const int requestID;
+    };
+
+    // Jobs that are already running won't take long to finish, and their results will be ignored
+    Selector selector (requestID);
+    threadPool.removeAllJobs (false, 0, &selector);
+}
+
+} // namespace juce
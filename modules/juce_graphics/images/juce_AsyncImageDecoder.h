@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Loads images on a set of background threads, and delivers them to the message
+    thread when they're ready.
+
+    This is handy for things like file browsers which need to show lots of images,
+    where loading them all on the message thread would make the UI unresponsive.
+    Each image can be given a maximum size, and formats that are able to decode a
+    smaller version of an image more quickly (see ImageFileFormat::decodeImageScaledToFit())
+    will do so, so asking for thumbnails is much cheaper than loading the full images.
+
+    e.g.
+    @code
+    decoder.loadImage (file, 128, 128, [safeThis = SafePointer<MyComponent> (this)] (const Image& thumbnail)
+    {
+        if (safeThis != nullptr)
+            safeThis->setThumbnail (thumbnail);
+    });
+    @endcode
+
+    Requests are handled in the order in which they're made. If a result is no longer
+    needed (e.g. because the item that wanted it has been scrolled out of view), it can
+    be cancelled, and a request that hasn't started yet won't be decoded at all.
+
+    @see ImageFileFormat, ImageCache
+
+    @tags{Graphics}
+*/
+class JUCE_API  AsyncImageDecoder
+{
+public:
+    //==============================================================================
+    /** Creates a decoder which uses the given number of background threads. */
+    explicit AsyncImageDecoder (int numberOfThreads = jmax (1, SystemStats::getNumCpus() - 1));
+
+    /** Destructor.
+        Any requests that haven't been delivered are cancelled, and this waits for
+        any images that are being decoded to finish.
+    */
+    ~AsyncImageDecoder();
+
+    //==============================================================================
+    /** A function which is called on the message thread with a decoded image. If the
+        image couldn't be loaded, it'll be invalid.
+    */
+    using Callback = std::function<void (const Image&)>;
+
+    /** Starts loading an image file.
+
+        If maxWidth and maxHeight are greater than zero, the image will be shrunk to fit
+        within that size, keeping its proportions. The callback will be called on the
+        message thread once the image has been decoded, unless the request is cancelled
+        first.
+
+        @returns an ID for the request, which can be passed to cancel()
+    */
+    int loadImage (const File& imageFile, int maxWidth, int maxHeight, Callback callback);
+
+    /** Starts decoding an image from a block of data that's held in memory.
+        This works in the same way as the other loadImage() method.
+    */
+    int loadImage (MemoryBlock imageData, int maxWidth, int maxHeight, Callback callback);
+
+    /** Cancels a request, so that its callback won't be called.
+        @returns false if the request had already been delivered or cancelled
+    */
+    bool cancel (int requestID);
+
+    /** Cancels all the requests which haven't yet been delivered. */
+    void cancelAll();
+
+    /** Returns the number of requests which haven't yet been delivered. */
+    int getNumPendingRequests() const;
+
+private:
+    //==============================================================================
+    struct PendingRequests;
+    class DecodingJob;
+
+    std::shared_ptr<PendingRequests> pendingRequests;
+    ThreadPool threadPool;
+    int nextRequestID = 0;
+
+    int addRequest (std::function<Image()>, Callback);
+    void removeJobs (int requestID);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncImageDecoder)
+};
+
+} // namespace juce
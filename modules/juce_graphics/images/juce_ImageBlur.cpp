@@ -0,0 +1,361 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace ImageBlurHelpers
+{
+    // Each box is divided by its size using a fixed-point multiplication. For radii up to
+    // 128 this gives exactly the same results as a rounded division, and it's never more
+    // than one level out for larger ones.
+    constexpr int maxRadius = 30000; // (any bigger and the multiplication could overflow)
+
+    static uint32 getBoxMultiplier (int radius) noexcept
+    {
+        return (uint32) ((((int64) 1 << 24) + radius) / (2 * radius + 1));
+    }
+
+    static forcedinline uint8 getBoxAverage (uint32 sum, uint32 multiplier) noexcept
+    {
+        return (uint8) ((sum * multiplier + (1u << 23)) >> 24);
+    }
+
+    static void blurLine (const uint8* src, uint8* dest, int num, int stride, int radius) noexcept
+    {
+        const auto multiplier = getBoxMultiplier (radius);
+        uint32 sum = 0;
+
+        for (int i = jmin (radius, num - 1); i >= 0; --i)
+            sum += src[i * stride];
+
+        for (int i = 0; i < num; ++i)
+        {
+            dest[i * stride] = getBoxAverage (sum, multiplier);
+
+            if (i + radius + 1 < num)   sum += src[(i + radius + 1) * stride];
+            if (i >= radius)            sum -= src[(i - radius) * stride];
+        }
+    }
+
+    static void blurRows (const Image::BitmapData& data, int startRow, int endRow, const Array<int>& radii)
+    {
+        const auto numBytes = (size_t) (data.width * data.pixelStride);
+        HeapBlock<uint8> original (numBytes);
+
+        for (int y = startRow; y < endRow; ++y)
+        {
+            auto* line = data.getLinePointer (y);
+
+            for (auto radius : radii)
+            {
+                memcpy (original, line, numBytes);
+
+                for (int channel = 0; channel < data.pixelStride; ++channel)
+                    blurLine (original + channel, line + channel, data.width, data.pixelStride, radius);
+            }
+        }
+    }
+
+    // The vertical pass works on a strip of columns at a time, moving down the image and
+    // keeping a running total for each byte of the strip. Every step is a simple loop along
+    // the strip, which the compiler can vectorise. The last few rows are kept in their
+    // unblurred state, so they can be subtracted from the totals once they're out of range.
+    static void blurColumns (const Image::BitmapData& data, int startByte, int endByte, const Array<int>& radii)
+    {
+        const auto numBytes = endByte - startByte;
+        HeapBlock<uint32> sums ((size_t) numBytes);
+
+        for (auto radius : radii)
+        {
+            const auto multiplier = getBoxMultiplier (radius);
+            const auto numSavedRows = radius + 1;
+            HeapBlock<uint8> savedRows ((size_t) (numSavedRows * numBytes));
+
+            auto getRow = [&] (int y) { return data.getLinePointer (y) + startByte; };
+
+            std::fill (sums.get(), sums.get() + numBytes, 0u);
+
+            for (int y = jmin (radius, data.height - 1); y >= 0; --y)
+            {
+                auto* row = getRow (y);
+
+                for (int i = 0; i < numBytes; ++i)
+                    sums[i] += row[i];
+            }
+
+            for (int y = 0; y < data.height; ++y)
+            {
+                auto* row = getRow (y);
+                memcpy (savedRows + (y % numSavedRows) * numBytes, row, (size_t) numBytes);
+
+                for (int i = 0; i < numBytes; ++i)
+                    row[i] = getBoxAverage (sums[i], multiplier);
+
+                if (y + radius + 1 < data.height)
+                {
+                    auto* next = getRow (y + radius + 1);
+
+                    for (int i = 0; i < numBytes; ++i)
+                        sums[i] += next[i];
+                }
+
+                if (y >= radius)
+                {
+                    auto* previous = savedRows + ((y - radius) % numSavedRows) * numBytes;
+
+                    for (int i = 0; i < numBytes; ++i)
+                        sums[i] -= previous[i];
+                }
+            }
+        }
+    }
+
+    static void applyBoxBlurs (Image& image, Rectangle<int> area, Array<int> radii)
+    {
+        area = area.getIntersection (image.getBounds());
+
+        if (area.isEmpty() || radii.isEmpty())
+            return;
+
+        for (auto& radius : radii)
+            radius = jmin (radius, maxRadius);
+
+        const Image::BitmapData data (image, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
+                                      Image::BitmapData::readWrite);
+
+        // Splitting the work up is only worthwhile if there's enough of it
+        constexpr int minPixelsForThreading = 256 * 256;
+        constexpr int rowsPerTask = 16, bytesPerStrip = 256;
+
+        const auto useThreads = area.getWidth() * area.getHeight() * radii.size() >= minPixelsForThreading
+                                  && SystemStats::getNumCpus() > 1;
+
+        const auto numRowTasks = (data.height + rowsPerTask - 1) / rowsPerTask;
+        const auto rowBytes = data.width * data.pixelStride;
+        const auto numStrips = (rowBytes + bytesPerStrip - 1) / bytesPerStrip;
+
+        auto blurRowTask = [&] (int task)
+        {
+            blurRows (data, task * rowsPerTask, jmin (data.height, (task + 1) * rowsPerTask), radii);
+        };
+
+        auto blurColumnTask = [&] (int strip)
+        {
+            blurColumns (data, strip * bytesPerStrip, jmin (rowBytes, (strip + 1) * bytesPerStrip), radii);
+        };
+
+        if (useThreads)
+        {
+            auto& pool = RenderingHelpers::getSharedThreadPool();
+            RenderingHelpers::runInParallel (pool, numRowTasks, blurRowTask);
+            RenderingHelpers::runInParallel (pool, numStrips, blurColumnTask);
+        }
+        else
+        {
+            for (int i = 0; i < numRowTasks; ++i)   blurRowTask (i);
+            for (int i = 0; i < numStrips; ++i)     blurColumnTask (i);
+        }
+    }
+
+    // Finds the sizes of three box blurs whose combined variance matches the Gaussian's
+    static Array<int> getGaussianBoxRadii (float standardDeviation)
+    {
+        constexpr int numBoxes = 3;
+        const auto variance = (double) standardDeviation * standardDeviation;
+
+        auto lowerWidth = (int) std::floor (std::sqrt (12.0 * variance / numBoxes + 1.0));
+
+        if ((lowerWidth & 1) == 0)
+            --lowerWidth;
+
+        lowerWidth = jmax (1, lowerWidth);
+
+        const auto numLower = roundToInt ((12.0 * variance - numBoxes * lowerWidth * lowerWidth
+                                             - 4 * numBoxes * lowerWidth - 3 * numBoxes)
+                                            / (-4.0 * lowerWidth - 4.0));
+
+        Array<int> radii;
+
+        for (int i = 0; i < numBoxes; ++i)
+        {
+            auto radius = ((i < numLower ? lowerWidth : lowerWidth + 2) - 1) / 2;
+
+            if (radius > 0)
+                radii.add (radius);
+        }
+
+        return radii;
+    }
+}
+
+//==============================================================================
+void ImageBlur::applyBoxBlur (Image& image, Rectangle<int> area, int radius, int numPasses)
+{
+    jassert (radius >= 0 && numPasses >= 0);
+
+    if (radius <= 0)
+        return;
+
+    Array<int> radii;
+
+    for (int i = 0; i < numPasses; ++i)
+        radii.add (radius);
+
+    ImageBlurHelpers::applyBoxBlurs (image, area, radii);
+}
+
+void ImageBlur::applyGaussianBlur (Image& image, Rectangle<int> area, float standardDeviation)
+{
+    jassert (standardDeviation >= 0);
+
+    if (standardDeviation > 0)
+        ImageBlurHelpers::applyBoxBlurs (image, area, ImageBlurHelpers::getGaussianBoxRadii (standardDeviation));
+}
+
+void ImageBlur::applyGaussianBlur (Image& image, float standardDeviation)
+{
+    applyGaussianBlur (image, image.getBounds(), standardDeviation);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageBlurTests  : public UnitTest
+{
+public:
+    ImageBlurTests()
+        : UnitTest ("ImageBlur", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("Box blurs match a direct calculation");
+        {
+            for (auto format : { Image::ARGB, Image::RGB, Image::SingleChannel })
+            {
+                for (auto size : { Point<int> (3, 5), Point<int> (37, 23), Point<int> (300, 260) })
+                {
+                    auto image = createRandomImage (format, size.x, size.y, random);
+                    const Rectangle<int> area (1, 2, size.x - 1, size.y - 2);
+
+                    for (auto radius : { 1, 4, 50 })
+                    {
+                        auto blurred = image.createCopy();
+                        ImageBlur::applyBoxBlur (blurred, area, radius, 2);
+
+                        // the passes are separable, so all the horizontal ones are done first
+                        auto expected = image.createCopy();
+
+                        for (auto horizontal : { true, true, false, false })
+                            applyDirectBoxBlur (expected, area, radius, horizontal);
+
+                        expect (ImageTestHelpers::imagesAreEqual (blurred, expected));
+                    }
+                }
+            }
+        }
+
+        beginTest ("Gaussian blurs have the right spread");
+        {
+            for (auto standardDeviation : { 2.0f, 5.0f, 12.5f })
+            {
+                Image image (Image::SingleChannel, 201, 101, true);
+                image.clear ({ 100, 0, 1, 101 }, Colours::white);
+
+                ImageBlur::applyGaussianBlur (image, standardDeviation);
+
+                // away from the top and bottom edges, blurring a vertical line should
+                // produce a one-dimensional Gaussian
+                double total = 0, variance = 0;
+
+                for (int x = 0; x < image.getWidth(); ++x)
+                {
+                    auto value = (double) image.getPixelAt (x, 50).getAlpha();
+                    total += value;
+                    variance += value * (x - 100) * (x - 100);
+                }
+
+                expectWithinAbsoluteError (std::sqrt (variance / total), (double) standardDeviation,
+                                           0.15 * standardDeviation + 0.5);
+            }
+        }
+    }
+
+private:
+    static Image createRandomImage (Image::PixelFormat format, int width, int height, Random& random)
+    {
+        Image image (format, width, height, false);
+        const Image::BitmapData data (image, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < height; ++y)
+            for (int i = 0; i < width * data.pixelStride; ++i)
+                data.getLinePointer (y)[i] = (uint8) random.nextInt (256);
+
+        return image;
+    }
+
+    static void applyDirectBoxBlur (Image& image, Rectangle<int> area, int radius, bool horizontal)
+    {
+        auto original = image.createCopy();
+        const Image::BitmapData src (original, Image::BitmapData::readOnly);
+        const Image::BitmapData dest (image, Image::BitmapData::writeOnly);
+
+        for (int y = area.getY(); y < area.getBottom(); ++y)
+        {
+            for (int x = area.getX(); x < area.getRight(); ++x)
+            {
+                for (int channel = 0; channel < src.pixelStride; ++channel)
+                {
+                    int total = 0;
+
+                    for (int i = -radius; i <= radius; ++i)
+                    {
+                        auto position = horizontal ? Point<int> (x + i, y) : Point<int> (x, y + i);
+
+                        if (area.contains (position))
+                            total += src.getPixelPointer (position.x, position.y)[channel];
+                    }
+
+                    dest.getPixelPointer (x, y)[channel] = (uint8) roundedAverage (total, 2 * radius + 1);
+                }
+            }
+        }
+    }
+
+    static int roundedAverage (int total, int count) noexcept
+    {
+        return (2 * total + count) / (2 * count);
+    }
+};
+
+static ImageBlurTests imageBlurTests;
+
+#endif
+
+} // namespace juce
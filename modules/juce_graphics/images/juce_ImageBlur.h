@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Some fast blurring operations for images.
+
+    These work by running a box filter (which replaces each pixel with the average of
+    the pixels in a square around it) across the image in two separate passes, one
+    horizontal and one vertical. Each pass keeps a running total of the pixels it has
+    moved past, so the cost doesn't depend on the blur radius. Repeating a box blur
+    a few times produces a very close approximation to a Gaussian blur.
+
+    All the channels of the image are blurred, and pixels outside the area being
+    blurred are treated as transparent. Large images are split up and blurred using
+    several threads at once.
+
+    For more general filtering, see ImageConvolutionKernel.
+
+    @see ImageConvolutionKernel, DropShadow, GlowEffect
+
+    @tags{Graphics}
+*/
+class JUCE_API  ImageBlur
+{
+public:
+    //==============================================================================
+    /** Applies a box blur to a region of an image.
+
+        @param image        the image to blur, which can be in any format
+        @param area         the region of the image to blur
+        @param radius       each pixel will be replaced by the average of the pixels
+                            within this distance of it, horizontally and vertically
+        @param numPasses    the number of times to repeat the blur
+    */
+    static void applyBoxBlur (Image& image, Rectangle<int> area, int radius, int numPasses = 1);
+
+    /** Applies an approximation of a Gaussian blur to a region of an image.
+
+        @param image                the image to blur, which can be in any format
+        @param area                 the region of the image to blur
+        @param standardDeviation    the standard deviation of the Gaussian, in pixels
+    */
+    static void applyGaussianBlur (Image& image, Rectangle<int> area, float standardDeviation);
+
+    /** Applies an approximation of a Gaussian blur to a whole image. */
+    static void applyGaussianBlur (Image& image, float standardDeviation);
+
+private:
+    ImageBlur() = delete;
+};
+
+} // namespace juce
@@ -38,16 +38,17 @@ struct ImageCache::Pimpl     : private Timer,
     {
         const ScopedLock sl (lock);
 
-        for (auto& item : images)
+        auto found = itemsByHashCode.find (hashCode);
+
+        if (found == itemsByHashCode.end())
         {
-            if (item.hashCode == hashCode)
-            {
-                item.lastUseTime = Time::getApproximateMillisecondCounter();
-                return item.image;
-            }
+            ++stats.misses;
+            return {};
         }
 
-        return {};
+        ++stats.hits;
+        markAsUsed (found->second, Time::getApproximateMillisecondCounter());
+        return found->second->image;
      }
 
     void addImageToCache (const Image& image, const int64 hashCode)
@@ -58,7 +59,22 @@ struct ImageCache::Pimpl     : private Timer,
                 startTimer (2000);
 
             const ScopedLock sl (lock);
-            images.add ({ image, hashCode, Time::getApproximateMillisecondCounter() });
+            bool pinned = false;
+
+            auto found = itemsByHashCode.find (hashCode);
+
+            if (found != itemsByHashCode.end())
+            {
+                pinned = found->second->pinned;
+                removeItem (found->second);
+            }
+
+            items.push_front ({ image, hashCode, getImageSizeInBytes (image),
+                                Time::getApproximateMillisecondCounter(), pinned });
+            itemsByHashCode[hashCode] = items.begin();
+            totalBytes += items.front().numBytes;
+
+            applySizeLimit();
         }
     }
 
@@ -68,22 +84,22 @@ struct ImageCache::Pimpl     : private Timer,
 
         const ScopedLock sl (lock);
 
-        for (int i = images.size(); --i >= 0;)
+        for (auto i = items.begin(); i != items.end();)
         {
-            auto& item = images.getReference(i);
+            auto item = i++;
 
-            if (item.image.getReferenceCount() <= 1)
+            if (! isInUse (*item))
             {
-                if (now > item.lastUseTime + cacheTimeout || now < item.lastUseTime - 1000)
-                    images.remove (i);
+                if (now > item->lastUseTime + cacheTimeout || now < item->lastUseTime - 1000)
+                    removeItem (item);
             }
             else
             {
-                item.lastUseTime = now; // multiply-referenced, so this image is still in use.
+                markAsUsed (item, now); // multiply-referenced, so this image is still in use.
             }
         }
 
-        if (images.isEmpty())
+        if (items.empty())
             stopTimer();
     }
 
@@ -91,21 +107,134 @@ struct ImageCache::Pimpl     : private Timer,
     {
         const ScopedLock sl (lock);
 
-        for (int i = images.size(); --i >= 0;)
-            if (images.getReference(i).image.getReferenceCount() <= 1)
-                images.remove (i);
+        for (auto i = items.begin(); i != items.end();)
+        {
+            auto item = i++;
+
+            if (! isInUse (*item))
+                removeItem (item);
+        }
     }
 
+    void setMaximumCacheSize (size_t newMaxNumBytes)
+    {
+        const ScopedLock sl (lock);
+        maxNumBytes = newMaxNumBytes;
+        applySizeLimit();
+    }
+
+    bool setImagePinned (const Image& image, bool shouldBePinned)
+    {
+        const ScopedLock sl (lock);
+        bool found = false;
+
+        for (auto& item : items)
+        {
+            if (item.image == image)
+            {
+                item.pinned = shouldBePinned;
+                found = true;
+            }
+        }
+
+        if (found && ! shouldBePinned)
+            applySizeLimit();
+
+        return found;
+    }
+
+    bool containsImageData (const ImagePixelData* imageData) const
+    {
+        const ScopedLock sl (lock);
+
+        for (auto& item : items)
+            if (item.image.getPixelData() == imageData)
+                return true;
+
+        return false;
+    }
+
+    Statistics getStatistics() const
+    {
+        const ScopedLock sl (lock);
+
+        auto result = stats;
+        result.numImages = (int) items.size();
+        result.numBytes = totalBytes;
+
+        for (auto& item : items)
+            if (item.pinned)
+                ++result.numPinnedImages;
+
+        return result;
+    }
+
+    void resetStatistics()
+    {
+        const ScopedLock sl (lock);
+        stats = {};
+    }
+
+    static size_t getImageSizeInBytes (const Image& image) noexcept
+    {
+        auto bytesPerPixel = image.getFormat() == Image::SingleChannel ? 1 : (image.getFormat() == Image::RGB ? 3 : 4);
+        return (size_t) image.getWidth() * (size_t) image.getHeight() * (size_t) bytesPerPixel;
+    }
+
+    //==============================================================================
     struct Item
     {
         Image image;
         int64 hashCode;
+        size_t numBytes;
         uint32 lastUseTime;
+        bool pinned;
     };
 
-    Array<Item> images;
+    // Ordered from most to least recently used
+    using ItemList = std::list<Item>;
+
+    ItemList items;
+    std::unordered_map<int64, ItemList::iterator> itemsByHashCode;
     CriticalSection lock;
+    Statistics stats;
+    size_t totalBytes = 0, maxNumBytes = 64 * 1024 * 1024;
     unsigned int cacheTimeout = 5000;
+    std::atomic<bool> retainGPUTextures { false };
+
+private:
+    static bool isInUse (const Item& item) noexcept
+    {
+        return item.pinned || item.image.getReferenceCount() > 1;
+    }
+
+    void markAsUsed (ItemList::iterator item, uint32 now) noexcept
+    {
+        item->lastUseTime = now;
+        items.splice (items.begin(), items, item);
+    }
+
+    void removeItem (ItemList::iterator item)
+    {
+        totalBytes -= item->numBytes;
+        itemsByHashCode.erase (item->hashCode);
+        items.erase (item);
+    }
+
+    void applySizeLimit()
+    {
+        for (auto i = items.end(); totalBytes > maxNumBytes && i != items.begin();)
+        {
+            auto item = --i;
+
+            if (! isInUse (*item))
+            {
+                ++i;
+                removeItem (item);
+                ++stats.evictions;
+            }
+        }
+    }
 
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
@@ -161,9 +290,144 @@ void ImageCache::setCacheTimeout (const int millisecs)
     Pimpl::getInstance()->cacheTimeout = (unsigned int) millisecs;
 }
 
+void ImageCache::setMaximumCacheSize (size_t maxNumBytes)
+{
+    Pimpl::getInstance()->setMaximumCacheSize (maxNumBytes);
+}
+
+size_t ImageCache::getMaximumCacheSize()
+{
+    auto* pimpl = Pimpl::getInstance();
+    const ScopedLock sl (pimpl->lock);
+    return pimpl->maxNumBytes;
+}
+
+bool ImageCache::setImagePinned (const Image& image, bool shouldBePinned)
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        return pimpl->setImagePinned (image, shouldBePinned);
+
+    return false;
+}
+
 void ImageCache::releaseUnusedImages()
 {
     Pimpl::getInstance()->releaseUnusedImages();
 }
 
+void ImageCache::setGPUTexturesRetained (bool shouldRetainTextures)
+{
+    Pimpl::getInstance()->retainGPUTextures = shouldRetainTextures;
+}
+
+bool ImageCache::shouldRetainGPUTextureFor (const ImagePixelData* imageData)
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        return pimpl->retainGPUTextures && pimpl->containsImageData (imageData);
+
+    return false;
+}
+
+ImageCache::Statistics ImageCache::getStatistics()
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        return pimpl->getStatistics();
+
+    return {};
+}
+
+void ImageCache::resetStatistics()
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        pimpl->resetStatistics();
+}
+
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageCacheTests  : public UnitTest
+{
+public:
+    ImageCacheTests()
+        : UnitTest ("ImageCache", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        const auto originalMaxSize = ImageCache::getMaximumCacheSize();
+        const int64 firstHash = 0x1234567800000000;
+        const auto imageBytes = (size_t) (100 * 100 * 4);
+
+        auto addImages = [&] (int start, int end)
+        {
+            for (int i = start; i < end; ++i)
+                ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, false), firstHash + i);
+        };
+
+        auto isCached = [&] (int index)
+        {
+            return ImageCache::getFromHashCode (firstHash + index).isValid();
+        };
+
+        ImageCache::releaseUnusedImages();
+        ImageCache::setMaximumCacheSize (imageBytes * 4);
+
+        beginTest ("Least recently used images are removed when the cache is full");
+        {
+            ImageCache::resetStatistics();
+            addImages (0, 4);
+            expect (isCached (0));
+
+            addImages (4, 6);
+
+            auto stats = ImageCache::getStatistics();
+            expectEquals (stats.numImages, 4);
+            expectEquals ((int64) stats.numBytes, (int64) (imageBytes * 4));
+            expectEquals (stats.evictions, (int64) 2);
+            expect (isCached (0));
+            expect (! isCached (1));
+            expect (! isCached (2));
+            expect (isCached (3));
+            expect (isCached (5));
+
+            stats = ImageCache::getStatistics();
+            expectEquals (stats.hits, (int64) 4);
+            expectEquals (stats.misses, (int64) 2);
+        }
+
+        beginTest ("Images that are in use or pinned aren't removed");
+        {
+            ImageCache::releaseUnusedImages();
+            addImages (0, 1);
+            auto inUse = ImageCache::getFromHashCode (firstHash);
+
+            ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, false), firstHash + 1);
+            expect (ImageCache::setImagePinned (ImageCache::getFromHashCode (firstHash + 1), true));
+            expect (! ImageCache::setImagePinned (Image (Image::ARGB, 1, 1, false), true));
+
+            addImages (2, 10);
+            expect (isCached (0));
+            expect (isCached (1));
+            expectEquals (ImageCache::getStatistics().numPinnedImages, 1);
+
+            inUse = {};
+            ImageCache::releaseUnusedImages();
+            expect (! isCached (0));
+            expect (isCached (1));
+            expectEquals (ImageCache::getStatistics().numImages, 1);
+
+            ImageCache::setImagePinned (ImageCache::getFromHashCode (firstHash + 1), false);
+            ImageCache::releaseUnusedImages();
+            expectEquals (ImageCache::getStatistics().numImages, 0);
+        }
+
+        ImageCache::setMaximumCacheSize (originalMaxSize);
+    }
+};
+
+static ImageCacheTests imageCacheTests;
+
+#endif
+
 } // namespace juce
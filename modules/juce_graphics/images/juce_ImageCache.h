@@ -39,6 +39,11 @@ namespace juce
     loading/deleting the same image, it'll reduce the chances of having to reload it
     each time.
 
+    The cache also has a memory budget (see setMaximumCacheSize()). When the images
+    it holds take up more than this, the least recently used ones that aren't being
+    used anywhere else are released, oldest first. Images can be pinned to stop them
+    being released at all.
+
     @see Image, ImageFileFormat
 
     @tags{Graphics}
@@ -108,11 +113,73 @@ public:
     */
     static void setCacheTimeout (int millisecs);
 
+    /** Changes the amount of memory that the cached images may use, in bytes.
+
+        If the total size of the images in the cache goes over this limit, the least
+        recently used images are removed until it fits again. Pinned images and any that
+        are still being used by other Image objects are never removed this way, as doing
+        so wouldn't free any memory. The default is 64MB.
+
+        @see getMaximumCacheSize, setImagePinned
+    */
+    static void setMaximumCacheSize (size_t maxNumBytes);
+
+    /** Returns the amount of memory that the cached images may use, in bytes.
+        @see setMaximumCacheSize
+    */
+    static size_t getMaximumCacheSize();
+
+    /** Pins or unpins an image that's in the cache.
+
+        A pinned image will stay in the cache until it's unpinned, regardless of the cache
+        timeout or size limit, and even if releaseUnusedImages() is called.
+
+        @returns    false if the image isn't in the cache
+    */
+    static bool setImagePinned (const Image& image, bool shouldBePinned);
+
     /** Releases any images in the cache that aren't being referenced by active
-        Image objects.
+        Image objects, and aren't pinned.
     */
     static void releaseUnusedImages();
 
+    //==============================================================================
+    /** Tells the cache whether renderers that keep copies of images in GPU memory (such
+        as the OpenGL renderer) should hang on to the copies of cached images for as long
+        as they stay in the cache, rather than releasing them when their own texture
+        cache fills up.
+
+        This is off by default. Turning it on avoids re-uploading images that are drawn
+        often, at the cost of using more GPU memory.
+
+        @see OpenGLContext::setImageCacheSize
+    */
+    static void setGPUTexturesRetained (bool shouldRetainTextures);
+
+    /** Returns true if a GPU renderer should hang on to its texture for the given image.
+        This is used by renderers that implement their own texture caches - it returns
+        true if setGPUTexturesRetained() is enabled and this image is in the cache.
+    */
+    static bool shouldRetainGPUTextureFor (const ImagePixelData* imageData);
+
+    //==============================================================================
+    /** Some numbers describing how effective the cache is. */
+    struct Statistics
+    {
+        int64 hits = 0;             /**< The number of lookups that found an image in the cache. */
+        int64 misses = 0;           /**< The number of lookups that didn't find an image. */
+        int64 evictions = 0;        /**< The number of images removed to keep the cache within its size limit. */
+        int numImages = 0;          /**< The number of images currently in the cache. */
+        int numPinnedImages = 0;    /**< The number of images in the cache that are pinned. */
+        size_t numBytes = 0;        /**< The approximate amount of memory used by the cached images. */
+    };
+
+    /** Returns the cache's current statistics. */
+    static Statistics getStatistics();
+
+    /** Sets the hit, miss and eviction counts back to zero. */
+    static void resetStatistics();
+
 private:
     //==============================================================================
     struct Pimpl;
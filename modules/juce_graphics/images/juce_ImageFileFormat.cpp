@@ -108,4 +108,254 @@ Image ImageFileFormat::loadFrom (const void* rawData, const size_t numBytes)
     return Image();
 }
 
+Image ImageFileFormat::loadFrom (InputStream& input, int maxWidth, int maxHeight)
+{
+    if (ImageFileFormat* format = findImageFormatForStream (input))
+        return format->decodeImageScaledToFit (input, maxWidth, maxHeight);
+
+    return Image();
+}
+
+Image ImageFileFormat::loadFrom (const File& file, int maxWidth, int maxHeight)
+{
+    FileInputStream stream (file);
+
+    if (stream.openedOk())
+    {
+        BufferedInputStream b (stream, 8192);
+        return loadFrom (b, maxWidth, maxHeight);
+    }
+
+    return Image();
+}
+
+//==============================================================================
+Image ImageFileFormat::decodeImageScaledToFit (InputStream& input, int maxWidth, int maxHeight)
+{
+    auto image = decodeImage (input);
+
+    if (! image.isValid())
+        return image;
+
+    auto size = getSizeToFit (image.getWidth(), image.getHeight(), maxWidth, maxHeight);
+
+    if (size.getWidth() == image.getWidth() && size.getHeight() == image.getHeight())
+        return image;
+
+    return image.rescaled (size.getWidth(), size.getHeight(), Graphics::mediumResamplingQuality);
+}
+
+Rectangle<int> ImageFileFormat::getSizeToFit (int imageWidth, int imageHeight, int maxWidth, int maxHeight) noexcept
+{
+    if (imageWidth <= maxWidth && imageHeight <= maxHeight)
+        return { imageWidth, imageHeight };
+
+    auto scale = jmin ((double) maxWidth / imageWidth, (double) maxHeight / imageHeight);
+
+    return { jlimit (1, imageWidth,  roundToInt (imageWidth  * scale)),
+             jlimit (1, imageHeight, roundToInt (imageHeight * scale)) };
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+#if ! JUCE_MODAL_LOOPS_PERMITTED && (JUCE_LINUX || JUCE_BSD || JUCE_WINDOWS)
+ bool dispatchNextMessageOnSystemQueue (bool returnIfNoPendingMessages);
+#endif
+
+class ImageFileFormatTests  : public UnitTest
+{
+public:
+    ImageFileFormatTests()
+        : UnitTest ("ImageFileFormat", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        const auto source = createTestImage (333, 200);
+
+        beginTest ("PNGs can be round-tripped");
+        {
+            for (auto hasAlpha : { false, true })
+            {
+                auto image = hasAlpha ? source : source.convertedToFormat (Image::RGB);
+                auto data = encode (PNGImageFormat(), image);
+                auto decoded = ImageFileFormat::loadFrom (data.getData(), data.getSize());
+
+                expect (decoded.isValid());
+                expect (decoded.hasAlphaChannel() == hasAlpha);
+                expect (getMaximumDifference (decoded, image) == 0);
+            }
+        }
+
+        beginTest ("Images can be decoded at a smaller size");
+        {
+            PNGImageFormat png;
+            JPEGImageFormat jpeg;
+            jpeg.setQuality (1.0f);
+
+            for (auto* format : { static_cast<ImageFileFormat*> (&png), static_cast<ImageFileFormat*> (&jpeg) })
+            {
+                auto data = encode (*format, source);
+
+                for (auto maxSize : { Point<int> (1000, 1000), Point<int> (333, 200), Point<int> (150, 150),
+                                      Point<int> (100, 20), Point<int> (30, 40), Point<int> (1, 1) })
+                {
+                    auto expectedSize = ImageFileFormat::getSizeToFit (source.getWidth(), source.getHeight(), maxSize.x, maxSize.y);
+
+                    MemoryInputStream stream (data, false);
+                    auto decoded = ImageFileFormat::loadFrom (stream, maxSize.x, maxSize.y);
+
+                    expectEquals (decoded.getWidth(),  expectedSize.getWidth());
+                    expectEquals (decoded.getHeight(), expectedSize.getHeight());
+
+                    // The test image is made of big blocks of colour, so a shrunken version should
+                    // still be quite close to one that's been rescaled from the full-size image
+                    if (decoded.getWidth() >= 30)
+                    {
+                        auto reference = source.rescaled (decoded.getWidth(), decoded.getHeight(), Graphics::highResamplingQuality);
+                        expect (getAverageDifference (decoded, reference) < 12.0);
+                    }
+                }
+            }
+        }
+
+        beginTest ("Cancelled requests aren't delivered");
+        {
+            AsyncImageDecoder decoder (1);
+            auto data = encode (PNGImageFormat(), source);
+            Array<int> requestIDs, delivered;
+
+            const auto loadImage = [&] (int index)
+            {
+                requestIDs.add (decoder.loadImage (data, 0, 0, [&, index] (const Image& image)
+                {
+                    expect (getMaximumDifference (image, source) == 0);
+                    delivered.add (index);
+                }));
+            };
+
+            for (int i = 0; i < 10; ++i)
+                loadImage (i);
+
+            expectEquals (decoder.getNumPendingRequests(), 10);
+            expect (decoder.cancel (requestIDs[1]));
+            expect (! decoder.cancel (requestIDs[1]));
+            expectEquals (decoder.getNumPendingRequests(), 9);
+
+            for (int i = 2; i < 10; i += 2)
+                expect (decoder.cancel (requestIDs[i]));
+
+            if (dispatchMessagesUntil ([&] { return decoder.getNumPendingRequests() == 0; }))
+            {
+                expectEquals (decoder.getNumPendingRequests(), 0);
+                expect (delivered == Array<int> { 0, 3, 5, 7, 9 });
+            }
+
+            delivered.clear();
+
+            for (int i = 10; i < 15; ++i)
+                loadImage (i);
+
+            decoder.cancelAll();
+            expectEquals (decoder.getNumPendingRequests(), 0);
+
+            // The requests are decoded and delivered in order, so once this one has arrived,
+            // any of the cancelled ones would have been delivered too
+            loadImage (15);
+
+            if (dispatchMessagesUntil ([&] { return decoder.getNumPendingRequests() == 0; }))
+                expect (delivered == Array<int> { 15 });
+        }
+    }
+
+private:
+    // Dispatches messages until the condition is met, or a few seconds have passed.
+    // Returns false if messages can't be dispatched from here.
+    template <typename Condition>
+    bool dispatchMessagesUntil (Condition&& condition)
+    {
+       #if JUCE_MODAL_LOOPS_PERMITTED || JUCE_LINUX || JUCE_BSD || JUCE_WINDOWS
+        if (MessageManager::existsAndIsCurrentThread())
+        {
+            const auto endTime = Time::getMillisecondCounter() + 5000;
+
+            while (! condition() && Time::getMillisecondCounter() < endTime)
+            {
+               #if JUCE_MODAL_LOOPS_PERMITTED
+                MessageManager::getInstance()->runDispatchLoopUntil (5);
+               #else
+                if (! dispatchNextMessageOnSystemQueue (true))
+                    Thread::sleep (1);
+               #endif
+            }
+
+            return true;
+        }
+       #endif
+
+        ignoreUnused (condition);
+        logMessage ("Can't dispatch messages here, so the delivered images weren't checked");
+        return false;
+    }
+
+    static Image createTestImage (int width, int height)
+    {
+        Image image (Image::ARGB, width, height, true);
+        Graphics g (image);
+
+        g.fillAll (Colours::white);
+        g.setColour (Colours::red);
+        g.fillRect (0, 0, width / 2, height / 2);
+        g.setColour (Colours::blue.withAlpha (0.5f));
+        g.fillRect (width / 3, height / 3, width / 2, height / 2);
+        return image;
+    }
+
+    static MemoryBlock encode (ImageFileFormat&& format, const Image& image)    { return encode (format, image); }
+
+    static MemoryBlock encode (ImageFileFormat& format, const Image& image)
+    {
+        MemoryOutputStream out;
+        format.writeImageToStream (image, out);
+        return out.getMemoryBlock();
+    }
+
+    template <typename Function>
+    static void forEachChannelDifference (const Image& a, const Image& b, Function&& function)
+    {
+        for (int y = 0; y < a.getHeight(); ++y)
+        {
+            for (int x = 0; x < a.getWidth(); ++x)
+            {
+                auto pa = a.getPixelAt (x, y), pb = b.getPixelAt (x, y);
+
+                function (std::abs (pa.getRed()   - pb.getRed()));
+                function (std::abs (pa.getGreen() - pb.getGreen()));
+                function (std::abs (pa.getBlue()  - pb.getBlue()));
+                function (std::abs (pa.getAlpha() - pb.getAlpha()));
+            }
+        }
+    }
+
+    static int getMaximumDifference (const Image& a, const Image& b)
+    {
+        int maxDifference = 0;
+        forEachChannelDifference (a, b, [&] (int difference) { maxDifference = jmax (maxDifference, difference); });
+        return maxDifference;
+    }
+
+    static double getAverageDifference (const Image& a, const Image& b)
+    {
+        double total = 0;
+        forEachChannelDifference (a, b, [&] (int difference) { total += difference; });
+        return total / (a.getWidth() * a.getHeight() * 4);
+    }
+};
+
+static ImageFileFormatTests imageFileFormatTests;
+
+#endif
+
 } // namespace juce
@@ -84,6 +84,26 @@ public:
     */
     virtual Image decodeImage (InputStream& input) = 0;
 
+    /** Tries to decode an image from the given stream, shrinking it to fit within a
+        maximum size.
+
+        Some formats can produce a smaller version of an image much more quickly than
+        they can decode the whole thing (e.g. a JPEG can be decoded at 1/2, 1/4 or 1/8
+        of its full size), so if you only need a thumbnail, this can save a lot of time
+        and memory.
+
+        The image that's returned has the same proportions as the original, and is never
+        bigger than it. The default implementation calls decodeImage() and rescales the
+        result.
+
+        @param input        the stream to read the data from, positioned as for decodeImage()
+        @param maxWidth     the maximum width of the image to return
+        @param maxHeight    the maximum height of the image to return
+        @returns            the image that was decoded, or an invalid image if it fails.
+        @see decodeImage
+    */
+    virtual Image decodeImageScaledToFit (InputStream& input, int maxWidth, int maxHeight);
+
     //==============================================================================
     /** Attempts to write an image to a stream.
 
@@ -137,6 +157,31 @@ public:
     */
     static Image loadFrom (const void* rawData,
                            size_t numBytesOfData);
+
+    /** Tries to load an image from a stream, shrinking it to fit within a maximum size.
+
+        This will use the findImageFormatForStream() method to locate a suitable
+        codec, and use its decodeImageScaledToFit() method to load the image.
+
+        @returns        the image that was decoded, or an invalid image if it fails.
+    */
+    static Image loadFrom (InputStream& input, int maxWidth, int maxHeight);
+
+    /** Tries to load an image from a file, shrinking it to fit within a maximum size.
+
+        This will use the findImageFormatForStream() method to locate a suitable
+        codec, and use its decodeImageScaledToFit() method to load the image.
+
+        @returns        the image that was decoded, or an invalid image if it fails.
+    */
+    static Image loadFrom (const File& file, int maxWidth, int maxHeight);
+
+    //==============================================================================
+    /** Returns the size that an image should be shrunk to so that it fits within a
+        maximum size, keeping its proportions. An image which already fits is left at
+        its original size.
+    */
+    static Rectangle<int> getSizeToFit (int imageWidth, int imageHeight, int maxWidth, int maxHeight) noexcept;
 };
 
 //==============================================================================
@@ -159,6 +204,7 @@ public:
     bool usesFileExtension (const File&) override;
     bool canUnderstand (InputStream&) override;
     Image decodeImage (InputStream&) override;
+    Image decodeImageScaledToFit (InputStream&, int maxWidth, int maxHeight) override;
     bool writeImageToStream (const Image&, OutputStream&) override;
 };
 
@@ -191,6 +237,7 @@ public:
     bool usesFileExtension (const File&) override;
     bool canUnderstand (InputStream&) override;
     Image decodeImage (InputStream&) override;
+    Image decodeImageScaledToFit (InputStream&, int maxWidth, int maxHeight) override;
     bool writeImageToStream (const Image&, OutputStream&) override;
 
 private:
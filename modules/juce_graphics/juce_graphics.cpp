@@ -98,12 +98,24 @@
 
 #undef SIZEOF
 
+#if JUCE_INTEL && (JUCE_64BIT || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #define JUCE_GRAPHICS_USE_SSE2 1
+ #include <emmintrin.h>
+#elif JUCE_ARM && ! JUCE_BIG_ENDIAN && (defined (__ARM_NEON__) || defined (__ARM_NEON) || defined (_M_ARM64))
+ #define JUCE_GRAPHICS_USE_NEON 1
+ #include <arm_neon.h>
+#endif
+
 #if (JUCE_MAC || JUCE_IOS) && USE_COREGRAPHICS_RENDERING && JUCE_USE_COREIMAGE_LOADER
  #define JUCE_USING_COREIMAGE_LOADER 1
 #else
  #define JUCE_USING_COREIMAGE_LOADER 0
 #endif
 
+#if JUCE_UNIT_TESTS
+ #include "images/juce_ImageTestHelpers.h"
+#endif
+
 //==============================================================================
 #include "colour/juce_Colour.cpp"
 #include "colour/juce_ColourGradient.cpp"
@@ -114,14 +126,19 @@
 #include "geometry/juce_Path.cpp"
 #include "geometry/juce_PathIterator.cpp"
 #include "geometry/juce_PathStrokeType.cpp"
+#include "geometry/juce_PathCache.cpp"
 #include "placement/juce_RectanglePlacement.cpp"
 #include "contexts/juce_GraphicsContext.cpp"
 #include "contexts/juce_LowLevelGraphicsPostScriptRenderer.cpp"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.cpp"
+#include "contexts/juce_LowLevelGraphicsTiledSoftwareRenderer.cpp"
+#include "native/juce_RenderingHelpers.cpp"
 #include "images/juce_Image.cpp"
 #include "images/juce_ImageCache.cpp"
 #include "images/juce_ImageConvolutionKernel.cpp"
+#include "images/juce_ImageBlur.cpp"
 #include "images/juce_ImageFileFormat.cpp"
+#include "images/juce_AsyncImageDecoder.cpp"
 #include "image_formats/juce_GIFLoader.cpp"
 #include "image_formats/juce_JPEGLoader.cpp"
 #include "image_formats/juce_PNGLoader.cpp"
@@ -131,11 +148,13 @@
 #include "fonts/juce_Font.cpp"
 #include "fonts/juce_GlyphArrangement.cpp"
 #include "fonts/juce_TextLayout.cpp"
+#include "fonts/juce_TextShapingCache.cpp"
 #include "effects/juce_DropShadowEffect.cpp"
 #include "effects/juce_GlowEffect.cpp"
 
 #if JUCE_UNIT_TESTS
  #include "geometry/juce_Rectangle_test.cpp"
+ #include "geometry/juce_RectangleList_test.cpp"
 #endif
 
 #if JUCE_USE_FREETYPE
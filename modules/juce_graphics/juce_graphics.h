@@ -103,6 +103,7 @@
 namespace juce
 {
     class Image;
+    class ImagePixelData;
     class AffineTransform;
     class Path;
     class Font;
@@ -127,12 +128,16 @@ namespace juce
 #include "geometry/juce_EdgeTable.h"
 #include "geometry/juce_PathIterator.h"
 #include "geometry/juce_PathStrokeType.h"
+#include "geometry/juce_PathCache.h"
 #include "placement/juce_RectanglePlacement.h"
 #include "images/juce_ImageCache.h"
+#include "images/juce_AsyncImageDecoder.h"
 #include "images/juce_ImageConvolutionKernel.h"
+#include "images/juce_ImageBlur.h"
 #include "images/juce_ImageFileFormat.h"
 #include "fonts/juce_Typeface.h"
 #include "fonts/juce_Font.h"
+#include "fonts/juce_TextShapingCache.h"
 #include "fonts/juce_AttributedString.h"
 #include "fonts/juce_GlyphArrangement.h"
 #include "fonts/juce_TextLayout.h"
@@ -144,6 +149,7 @@ namespace juce
 #include "colour/juce_FillType.h"
 #include "native/juce_RenderingHelpers.h"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.h"
+#include "contexts/juce_LowLevelGraphicsTiledSoftwareRenderer.h"
 #include "contexts/juce_LowLevelGraphicsPostScriptRenderer.h"
 #include "effects/juce_ImageEffectFilter.h"
 #include "effects/juce_DropShadowEffect.h"
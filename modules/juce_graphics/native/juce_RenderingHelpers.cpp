@@ -0,0 +1,851 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace RenderingHelpers
+{
+namespace SpanBlending
+{
+
+/*  All of the blend() methods in the pixel classes work out each component as
+
+        src + ((dest * (256 - srcAlpha)) >> 8), clamped to 255
+
+    so the SIMD versions below just do that on 16-bit lanes, with a saturating pack
+    taking care of the clamping. A product of a component and an alpha of up to 256
+    always fits into 16 bits, so the results match the scalar code exactly.
+*/
+static forcedinline uint8 blendComponent (uint32 src, uint32 dest, uint32 inverseAlpha) noexcept
+{
+    return (uint8) jmin ((uint32) 255, src + ((dest * inverseAlpha) >> 8));
+}
+
+// Below this length, setting up the vector registers costs more than it saves.
+static constexpr int minSIMDSpanLength = 8;
+
+// The pattern is 48 bytes long, so that it holds a whole number of pixels of each format.
+static constexpr size_t patternSize = 48;
+
+static void blendPattern (uint8* dest, size_t numBytes, const uint8* pattern, uint32 inverseAlpha) noexcept
+{
+    size_t i = 0;
+
+   #if JUCE_GRAPHICS_USE_SSE2
+    const auto zero = _mm_setzero_si128();
+    const auto inverse = _mm_set1_epi16 ((short) inverseAlpha);
+
+    const __m128i patternLo[] = { _mm_unpacklo_epi8 (_mm_loadu_si128 ((const __m128i*) pattern),        zero),
+                                  _mm_unpacklo_epi8 (_mm_loadu_si128 ((const __m128i*) (pattern + 16)), zero),
+                                  _mm_unpacklo_epi8 (_mm_loadu_si128 ((const __m128i*) (pattern + 32)), zero) };
+
+    const __m128i patternHi[] = { _mm_unpackhi_epi8 (_mm_loadu_si128 ((const __m128i*) pattern),        zero),
+                                  _mm_unpackhi_epi8 (_mm_loadu_si128 ((const __m128i*) (pattern + 16)), zero),
+                                  _mm_unpackhi_epi8 (_mm_loadu_si128 ((const __m128i*) (pattern + 32)), zero) };
+
+    for (; i + patternSize <= numBytes; i += patternSize)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            auto* d = (__m128i*) (dest + i + (size_t) j * 16);
+            auto pixels = _mm_loadu_si128 (d);
+
+            auto lo = _mm_srli_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (pixels, zero), inverse), 8);
+            auto hi = _mm_srli_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (pixels, zero), inverse), 8);
+
+            _mm_storeu_si128 (d, _mm_packus_epi16 (_mm_add_epi16 (lo, patternLo[j]),
+                                                   _mm_add_epi16 (hi, patternHi[j])));
+        }
+    }
+   #elif JUCE_GRAPHICS_USE_NEON
+    const auto inverse = vdupq_n_u16 ((uint16) inverseAlpha);
+    const uint8x16_t patternVectors[] = { vld1q_u8 (pattern), vld1q_u8 (pattern + 16), vld1q_u8 (pattern + 32) };
+
+    for (; i + patternSize <= numBytes; i += patternSize)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            auto* d = dest + i + (size_t) j * 16;
+            auto pixels = vld1q_u8 (d);
+
+            auto lo = vaddq_u16 (vmovl_u8 (vget_low_u8 (patternVectors[j])),
+                                 vshrq_n_u16 (vmulq_u16 (vmovl_u8 (vget_low_u8 (pixels)), inverse), 8));
+            auto hi = vaddq_u16 (vmovl_u8 (vget_high_u8 (patternVectors[j])),
+                                 vshrq_n_u16 (vmulq_u16 (vmovl_u8 (vget_high_u8 (pixels)), inverse), 8));
+
+            vst1q_u8 (d, vcombine_u8 (vqmovn_u16 (lo), vqmovn_u16 (hi)));
+        }
+    }
+   #endif
+
+    for (; i < numBytes; ++i)
+        dest[i] = blendComponent (pattern[i % patternSize], dest[i], inverseAlpha);
+}
+
+template <class PixelType>
+static void blendColourWithPattern (PixelType* dest, PixelARGB colour, int numPixels) noexcept
+{
+    static_assert (patternSize % sizeof (PixelType) == 0, "The pattern must hold a whole number of pixels");
+
+    if (numPixels < minSIMDSpanLength)
+    {
+        while (--numPixels >= 0)
+            (dest++)->blend (colour);
+
+        return;
+    }
+
+    PixelType pattern[patternSize / sizeof (PixelType)];
+
+    for (auto& p : pattern)
+        p.set (colour);
+
+    blendPattern (reinterpret_cast<uint8*> (dest), (size_t) numPixels * sizeof (PixelType),
+                  reinterpret_cast<const uint8*> (pattern), (uint32) (0x100 - colour.getAlpha()));
+}
+
+void blendColour (PixelARGB* dest, PixelARGB colour, int numPixels) noexcept   { blendColourWithPattern (dest, colour, numPixels); }
+void blendColour (PixelRGB* dest, PixelARGB colour, int numPixels) noexcept    { blendColourWithPattern (dest, colour, numPixels); }
+void blendColour (PixelAlpha* dest, PixelARGB colour, int numPixels) noexcept  { blendColourWithPattern (dest, colour, numPixels); }
+
+//==============================================================================
+template <bool applyExtraAlpha>
+static void blendARGBPixels (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept
+{
+    jassert (extraAlpha <= 0x100);
+    int i = 0;
+
+   #if JUCE_GRAPHICS_USE_SSE2
+    if (numPixels >= minSIMDSpanLength)
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto maxAlpha = _mm_set1_epi16 (0x100);
+        const auto extra = _mm_set1_epi16 ((short) extraAlpha);
+
+        auto blendPair = [&] (__m128i s, __m128i d)
+        {
+            if (applyExtraAlpha)
+                s = _mm_srli_epi16 (_mm_mullo_epi16 (s, extra), 8);
+
+            // copy each pixel's alpha into all four of its lanes
+            auto inverse = _mm_sub_epi16 (maxAlpha, _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (s, 0xff), 0xff));
+            return _mm_add_epi16 (s, _mm_srli_epi16 (_mm_mullo_epi16 (d, inverse), 8));
+        };
+
+        for (; i + 4 <= numPixels; i += 4)
+        {
+            auto s = _mm_loadu_si128 ((const __m128i*) (src + i));
+            auto d = _mm_loadu_si128 ((const __m128i*) (dest + i));
+
+            _mm_storeu_si128 ((__m128i*) (dest + i),
+                              _mm_packus_epi16 (blendPair (_mm_unpacklo_epi8 (s, zero), _mm_unpacklo_epi8 (d, zero)),
+                                                blendPair (_mm_unpackhi_epi8 (s, zero), _mm_unpackhi_epi8 (d, zero))));
+        }
+    }
+   #elif JUCE_GRAPHICS_USE_NEON
+    if (numPixels >= minSIMDSpanLength)
+    {
+        const auto maxAlpha = vdupq_n_u16 (0x100);
+        const auto extra = vdupq_n_u16 ((uint16) extraAlpha);
+
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            auto s = vld4_u8 (reinterpret_cast<const uint8*> (src + i));
+            auto d = vld4_u8 (reinterpret_cast<uint8*> (dest + i));
+
+            uint16x8_t components[4];
+
+            for (int c = 0; c < 4; ++c)
+            {
+                components[c] = vmovl_u8 (s.val[c]);
+
+                if (applyExtraAlpha)
+                    components[c] = vshrq_n_u16 (vmulq_u16 (components[c], extra), 8);
+            }
+
+            auto inverse = vsubq_u16 (maxAlpha, components[PixelARGB::indexA]);
+
+            for (int c = 0; c < 4; ++c)
+                d.val[c] = vqmovn_u16 (vaddq_u16 (components[c], vshrq_n_u16 (vmulq_u16 (vmovl_u8 (d.val[c]), inverse), 8)));
+
+            vst4_u8 (reinterpret_cast<uint8*> (dest + i), d);
+        }
+    }
+   #endif
+
+    for (; i < numPixels; ++i)
+    {
+        if (applyExtraAlpha)
+            dest[i].blend (src[i], extraAlpha);
+        else
+            dest[i].blend (src[i]);
+    }
+}
+
+template <bool applyExtraAlpha>
+static void blendRGBPixels (PixelRGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept
+{
+    jassert (extraAlpha <= 0x100);
+    int i = 0;
+
+    // SSE2 has no byte shuffles for unpacking 24-bit pixels, so only NEON gets a fast path here
+   #if JUCE_GRAPHICS_USE_NEON
+    if (numPixels >= minSIMDSpanLength)
+    {
+        const auto maxAlpha = vdupq_n_u16 (0x100);
+        const auto extra = vdupq_n_u16 ((uint16) extraAlpha);
+
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            auto s = vld4_u8 (reinterpret_cast<const uint8*> (src + i));
+            auto d = vld3_u8 (reinterpret_cast<uint8*> (dest + i));
+
+            uint16x8_t components[4];
+
+            for (int c = 0; c < 4; ++c)
+            {
+                components[c] = vmovl_u8 (s.val[c]);
+
+                if (applyExtraAlpha)
+                    components[c] = vshrq_n_u16 (vmulq_u16 (components[c], extra), 8);
+            }
+
+            auto inverse = vsubq_u16 (maxAlpha, components[PixelARGB::indexA]);
+
+            d.val[PixelRGB::indexR] = vqmovn_u16 (vaddq_u16 (components[PixelARGB::indexR], vshrq_n_u16 (vmulq_u16 (vmovl_u8 (d.val[PixelRGB::indexR]), inverse), 8)));
+            d.val[PixelRGB::indexG] = vqmovn_u16 (vaddq_u16 (components[PixelARGB::indexG], vshrq_n_u16 (vmulq_u16 (vmovl_u8 (d.val[PixelRGB::indexG]), inverse), 8)));
+            d.val[PixelRGB::indexB] = vqmovn_u16 (vaddq_u16 (components[PixelARGB::indexB], vshrq_n_u16 (vmulq_u16 (vmovl_u8 (d.val[PixelRGB::indexB]), inverse), 8)));
+
+            vst3_u8 (reinterpret_cast<uint8*> (dest + i), d);
+        }
+    }
+   #endif
+
+    for (; i < numPixels; ++i)
+    {
+        if (applyExtraAlpha)
+            dest[i].blend (src[i], extraAlpha);
+        else
+            dest[i].blend (src[i]);
+    }
+}
+
+template <bool applyExtraAlpha>
+static void blendAlphaPixels (PixelAlpha* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept
+{
+    jassert (extraAlpha <= 0x100);
+    int i = 0;
+
+    // PixelAlpha::blend() adds one to the extra alpha before using it, so this does the same
+    const auto alphaMultiplier = extraAlpha + 1;
+
+   #if JUCE_GRAPHICS_USE_SSE2
+    if (numPixels >= minSIMDSpanLength)
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto maxAlpha = _mm_set1_epi16 (0x100);
+        const auto extra = _mm_set1_epi16 ((short) alphaMultiplier);
+
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            auto alphas = _mm_packs_epi32 (_mm_srli_epi32 (_mm_loadu_si128 ((const __m128i*) (src + i)), 24),
+                                           _mm_srli_epi32 (_mm_loadu_si128 ((const __m128i*) (src + i + 4)), 24));
+
+            if (applyExtraAlpha)
+                alphas = _mm_srli_epi16 (_mm_mullo_epi16 (alphas, extra), 8);
+
+            auto d = _mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i*) (dest + i)), zero);
+            d = _mm_add_epi16 (alphas, _mm_srli_epi16 (_mm_mullo_epi16 (d, _mm_sub_epi16 (maxAlpha, alphas)), 8));
+
+            _mm_storel_epi64 ((__m128i*) (dest + i), _mm_packus_epi16 (d, zero));
+        }
+    }
+   #elif JUCE_GRAPHICS_USE_NEON
+    if (numPixels >= minSIMDSpanLength)
+    {
+        const auto maxAlpha = vdupq_n_u16 (0x100);
+        const auto extra = vdupq_n_u16 ((uint16) alphaMultiplier);
+
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            auto alphas = vmovl_u8 (vld4_u8 (reinterpret_cast<const uint8*> (src + i)).val[PixelARGB::indexA]);
+
+            if (applyExtraAlpha)
+                alphas = vshrq_n_u16 (vmulq_u16 (alphas, extra), 8);
+
+            auto* d = reinterpret_cast<uint8*> (dest + i);
+            auto result = vaddq_u16 (alphas, vshrq_n_u16 (vmulq_u16 (vmovl_u8 (vld1_u8 (d)), vsubq_u16 (maxAlpha, alphas)), 8));
+
+            vst1_u8 (d, vqmovn_u16 (result));
+        }
+    }
+   #endif
+
+    ignoreUnused (alphaMultiplier);
+
+    for (; i < numPixels; ++i)
+    {
+        if (applyExtraAlpha)
+            dest[i].blend (src[i], extraAlpha);
+        else
+            dest[i].blend (src[i]);
+    }
+}
+
+void blendPixels (PixelARGB* dest, const PixelARGB* src, int numPixels) noexcept                     { blendARGBPixels<false>  (dest, src, numPixels, 0); }
+void blendPixels (PixelRGB* dest, const PixelARGB* src, int numPixels) noexcept                      { blendRGBPixels<false>   (dest, src, numPixels, 0); }
+void blendPixels (PixelAlpha* dest, const PixelARGB* src, int numPixels) noexcept                    { blendAlphaPixels<false> (dest, src, numPixels, 0); }
+
+void blendPixels (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept  { blendARGBPixels<true>  (dest, src, numPixels, extraAlpha); }
+void blendPixels (PixelRGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept   { blendRGBPixels<true>   (dest, src, numPixels, extraAlpha); }
+void blendPixels (PixelAlpha* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept { blendAlphaPixels<true> (dest, src, numPixels, extraAlpha); }
+
+} // namespace SpanBlending
+
+//==============================================================================
+struct GlyphCache::Key
+{
+    Typeface* typeface;
+    float height, horizontalScale;
+    int glyphNumber;
+
+    bool operator== (const Key& other) const noexcept
+    {
+        return typeface == other.typeface
+                && glyphNumber == other.glyphNumber
+                && height == other.height
+                && horizontalScale == other.horizontalScale;
+    }
+};
+
+struct GlyphCache::KeyHash
+{
+    int generateHash (const Key& key, int upperLimit) const noexcept
+    {
+        auto floatBits = [] (float f)
+        {
+            uint32 bits;
+            memcpy (&bits, &f, sizeof (bits));
+            return (uint64) bits;
+        };
+
+        auto hash = (uint64) (pointer_sized_uint) key.typeface;
+        hash = hash * 0x100000001b3ull + (uint64) key.glyphNumber;
+        hash = hash * 0x100000001b3ull + floatBits (key.height);
+        hash = hash * 0x100000001b3ull + floatBits (key.horizontalScale);
+
+        return (int) ((hash ^ (hash >> 29)) % (uint64) upperLimit);
+    }
+};
+
+static std::unique_ptr<const EdgeTable> createGlyphEdgeTable (Typeface& typeface, const Font& font, int glyphNumber)
+{
+    auto fontHeight = font.getHeight();
+
+    std::unique_ptr<EdgeTable> edgeTable (typeface.getEdgeTableForGlyph (glyphNumber,
+                                                                         AffineTransform::scale (fontHeight * font.getHorizontalScale(),
+                                                                                                 fontHeight), fontHeight));
+
+    // The table will never be modified again, so it's worth trimming off any unused space
+    if (edgeTable != nullptr)
+        edgeTable->optimiseTable();
+
+    return edgeTable;
+}
+
+GlyphCache::Glyph::Glyph (const Font& font, Typeface::Ptr face, int glyph)
+    : edgeTable (createGlyphEdgeTable (*face, font, glyph)),
+      snapToIntegerCoordinate (face->isHinted()),
+      typeface (std::move (face)),
+      height (font.getHeight()),
+      horizontalScale (font.getHorizontalScale()),
+      glyphNumber (glyph),
+      numBytes (sizeof (Glyph) + (edgeTable != nullptr ? edgeTable->getMemoryUsage() : 0))
+{
+}
+
+//==============================================================================
+struct SharedRenderingThreadPool  : public DeletedAtShutdown
+{
+    SharedRenderingThreadPool() = default;
+    ~SharedRenderingThreadPool() override   { clearSingletonInstance(); }
+
+    ThreadPool pool { jmax (1, SystemStats::getNumCpus() - 1) };
+
+    JUCE_DECLARE_SINGLETON (SharedRenderingThreadPool, false)
+};
+
+JUCE_IMPLEMENT_SINGLETON (SharedRenderingThreadPool)
+
+ThreadPool& getSharedThreadPool()
+{
+    return SharedRenderingThreadPool::getInstance()->pool;
+}
+
+void runInParallel (ThreadPool& threadPool, int numTasks, const std::function<void (int)>& task)
+{
+    std::atomic<int> nextTask { 0 };
+
+    auto runTasks = [&]
+    {
+        for (int i = nextTask++; i < numTasks; i = nextTask++)
+            task (i);
+    };
+
+    const auto numJobs = jmin (threadPool.getNumThreads(), numTasks - 1);
+    std::atomic<int> numJobsRunning { numJobs };
+    WaitableEvent allJobsFinished;
+
+    for (int i = 0; i < numJobs; ++i)
+    {
+        threadPool.addJob ([&]
+        {
+            runTasks();
+
+            if (--numJobsRunning == 0)
+                allJobsFinished.signal();
+        });
+    }
+
+    runTasks();
+
+    if (numJobs > 0)
+        allJobsFinished.wait();
+}
+
+//==============================================================================
+static std::atomic<GlyphCache*> glyphCacheInstance { nullptr };
+
+// Typefaces aren't necessarily safe to use from several threads at once, so only
+// one glyph is rasterised at a time, but this lock is never held while searching the cache.
+static CriticalSection glyphRasterisingLock;
+
+GlyphCache::GlyphCache()
+    : glyphs (std::make_unique<FlatHashMap<Key, Glyph::Ptr, KeyHash>> (256))
+{
+}
+
+GlyphCache::~GlyphCache()
+{
+    reset();
+    glyphCacheInstance = nullptr;
+}
+
+GlyphCache& GlyphCache::getInstance()
+{
+    if (auto* instance = glyphCacheInstance.load())
+        return *instance;
+
+    const ScopedLock sl (glyphRasterisingLock);
+
+    if (glyphCacheInstance.load() == nullptr)
+        glyphCacheInstance = new GlyphCache();
+
+    return *glyphCacheInstance.load();
+}
+
+GlyphCache::Glyph::Ptr GlyphCache::findOrCreateGlyph (const Font& font, int glyphNumber)
+{
+    auto typeface = font.getTypefacePtr();
+    const Key key { typeface.get(), font.getHeight(), font.getHorizontalScale(), glyphNumber };
+
+    {
+        const ScopedLock sl (lock);
+
+        if (auto* existing = glyphs->find (key))
+        {
+            ++hits;
+            moveToFront (**existing);
+            return *existing;
+        }
+    }
+
+    const ScopedLock rasterisingLock (glyphRasterisingLock);
+    const ScopedLock sl (lock);
+
+    // another thread may have added this glyph while we were waiting
+    if (auto* existing = glyphs->find (key))
+    {
+        ++hits;
+        moveToFront (**existing);
+        return *existing;
+    }
+
+    ++misses;
+
+    Glyph::Ptr glyph;
+
+    {
+        const ScopedUnlock su (lock);
+        glyph = new Glyph (font, std::move (typeface), glyphNumber);
+    }
+
+    glyphs->set (key, glyph);
+    addToFront (*glyph);
+    totalBytes += glyph->numBytes;
+    removeOldestGlyphs();
+
+    return glyph;
+}
+
+void GlyphCache::reset()
+{
+    const ScopedLock sl (lock);
+
+    glyphs->clear();
+    newest = oldest = nullptr;
+    totalBytes = 0;
+    hits = misses = 0;
+}
+
+void GlyphCache::setMaximumSize (size_t newMaxBytes)
+{
+    const ScopedLock sl (lock);
+    maxBytes = newMaxBytes;
+    removeOldestGlyphs();
+}
+
+size_t GlyphCache::getMaximumSize() const
+{
+    const ScopedLock sl (lock);
+    return maxBytes;
+}
+
+GlyphCache::Statistics GlyphCache::getStatistics() const
+{
+    const ScopedLock sl (lock);
+
+    Statistics stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.numGlyphs = glyphs->size();
+    stats.numBytes = totalBytes;
+    return stats;
+}
+
+void GlyphCache::addToFront (Glyph& glyph) noexcept
+{
+    glyph.previous = nullptr;
+    glyph.next = newest;
+
+    if (newest != nullptr)
+        newest->previous = &glyph;
+    else
+        oldest = &glyph;
+
+    newest = &glyph;
+}
+
+void GlyphCache::moveToFront (Glyph& glyph) noexcept
+{
+    if (&glyph != newest)
+    {
+        removeFromList (glyph);
+        addToFront (glyph);
+    }
+}
+
+void GlyphCache::removeFromList (Glyph& glyph) noexcept
+{
+    if (glyph.previous != nullptr)
+        glyph.previous->next = glyph.next;
+    else
+        newest = glyph.next;
+
+    if (glyph.next != nullptr)
+        glyph.next->previous = glyph.previous;
+    else
+        oldest = glyph.previous;
+
+    glyph.previous = glyph.next = nullptr;
+}
+
+void GlyphCache::removeOldestGlyphs()
+{
+    // the newest glyph is always kept, even if it's bigger than the whole cache
+    while (totalBytes > maxBytes && oldest != nullptr && oldest != newest)
+    {
+        Glyph::Ptr glyph (oldest);
+        removeFromList (*glyph);
+        totalBytes -= glyph->numBytes;
+        glyphs->remove (Key { glyph->typeface.get(), glyph->height, glyph->horizontalScale, glyph->glyphNumber });
+    }
+}
+
+} // namespace RenderingHelpers
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SpanBlendingTests  : public UnitTest
+{
+public:
+    SpanBlendingTests()
+        : UnitTest ("SpanBlending", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("Colours match PixelType::blend");
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                auto colour = randomPixel (random);
+                auto numPixels = random.nextInt (150);
+
+                checkColour<PixelARGB>  (random, colour, numPixels);
+                checkColour<PixelRGB>   (random, colour, numPixels);
+                checkColour<PixelAlpha> (random, colour, numPixels);
+            }
+        }
+
+        beginTest ("Pixels match PixelType::blend");
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                auto numPixels = random.nextInt (150);
+
+                checkPixels<PixelARGB>  (random, numPixels, 0x100);
+                checkPixels<PixelRGB>   (random, numPixels, 0x100);
+                checkPixels<PixelAlpha> (random, numPixels, 0x100);
+
+                auto extraAlpha = (uint32) random.nextInt (0x101);
+
+                checkPixels<PixelARGB>  (random, numPixels, extraAlpha);
+                checkPixels<PixelRGB>   (random, numPixels, extraAlpha);
+                checkPixels<PixelAlpha> (random, numPixels, extraAlpha);
+            }
+        }
+    }
+
+private:
+    static PixelARGB randomPixel (Random& random)
+    {
+        auto alpha = (uint8) random.nextInt (256);
+
+        // use premultiplied components, except for a few over-bright ones to check the clamping
+        auto component = [&] { return (uint8) (random.nextInt (12) == 0 ? random.nextInt (256)
+                                                                         : random.nextInt (alpha + 1)); };
+
+        PixelARGB p;
+        p.setARGB (alpha, component(), component(), component());
+        return p;
+    }
+
+    template <class PixelType>
+    static std::vector<PixelType> randomPixels (Random& random, int numPixels)
+    {
+        std::vector<PixelType> pixels ((size_t) numPixels);
+
+        for (auto& p : pixels)
+            p.set (randomPixel (random));
+
+        return pixels;
+    }
+
+    template <class PixelType>
+    static bool pixelsMatch (const std::vector<PixelType>& a, const std::vector<PixelType>& b)
+    {
+        return a.size() == b.size()
+                && memcmp (a.data(), b.data(), a.size() * sizeof (PixelType)) == 0;
+    }
+
+    template <class PixelType>
+    void checkColour (Random& random, PixelARGB colour, int numPixels)
+    {
+        auto expected = randomPixels<PixelType> (random, numPixels);
+        auto actual = expected;
+
+        for (auto& p : expected)
+            p.blend (colour);
+
+        RenderingHelpers::SpanBlending::blendColour (actual.data(), colour, numPixels);
+        expect (pixelsMatch (expected, actual));
+    }
+
+    template <class PixelType>
+    void checkPixels (Random& random, int numPixels, uint32 extraAlpha)
+    {
+        std::vector<PixelARGB> src ((size_t) numPixels);
+
+        for (auto& p : src)
+            p = randomPixel (random);
+
+        auto expected = randomPixels<PixelType> (random, numPixels);
+        auto actual = expected;
+
+        for (size_t i = 0; i < src.size(); ++i)
+        {
+            if (extraAlpha < 0x100)
+                expected[i].blend (src[i], extraAlpha);
+            else
+                expected[i].blend (src[i]);
+        }
+
+        if (extraAlpha < 0x100)
+            RenderingHelpers::SpanBlending::blendPixels (actual.data(), src.data(), numPixels, extraAlpha);
+        else
+            RenderingHelpers::SpanBlending::blendPixels (actual.data(), src.data(), numPixels);
+
+        expect (pixelsMatch (expected, actual));
+    }
+};
+
+static SpanBlendingTests spanBlendingTests;
+
+//==============================================================================
+class GlyphCacheTests  : public UnitTest
+{
+public:
+    GlyphCacheTests()
+        : UnitTest ("GlyphCache", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto& cache = RenderingHelpers::GlyphCache::getInstance();
+        const auto originalMaxSize = cache.getMaximumSize();
+        const Font font (20.0f);
+
+        beginTest ("Glyphs are only rasterised once");
+        {
+            cache.reset();
+
+            auto glyph = getGlyphNumber (font, 'A');
+            auto first = cache.findOrCreateGlyph (font, glyph);
+            auto second = cache.findOrCreateGlyph (font, glyph);
+            auto other = cache.findOrCreateGlyph (font.withHeight (21.0f), glyph);
+
+            expect (first != nullptr && first == second);
+            expect (other != first);
+
+            auto stats = cache.getStatistics();
+            expectEquals (stats.hits, (int64) 1);
+            expectEquals (stats.misses, (int64) 2);
+            expectEquals (stats.numGlyphs, 2);
+            expect (stats.numBytes > 0);
+        }
+
+        beginTest ("Least recently used glyphs are removed");
+        {
+            cache.reset();
+
+            auto glyphA = getGlyphNumber (font, 'A');
+            auto glyphB = getGlyphNumber (font, 'B');
+
+            auto a = cache.findOrCreateGlyph (font, glyphA);
+            cache.findOrCreateGlyph (font, glyphB);
+            cache.setMaximumSize (cache.getStatistics().numBytes);
+
+            // a full stop is smaller than a B, so adding one should only push out the B
+            cache.findOrCreateGlyph (font, glyphA);
+            cache.findOrCreateGlyph (font, getGlyphNumber (font, '.'));
+
+            expectEquals (cache.getStatistics().numGlyphs, 2);
+            expect (cache.getStatistics().numBytes <= cache.getMaximumSize());
+            expect (cache.findOrCreateGlyph (font, glyphA) == a);
+
+            auto missesBefore = cache.getStatistics().misses;
+            cache.findOrCreateGlyph (font, glyphB);
+            expectEquals (cache.getStatistics().misses, missesBefore + 1);
+
+            // glyphs which are still being used are unaffected when they're removed
+            cache.reset();
+            expect (a->edgeTable != nullptr);
+
+            cache.setMaximumSize (originalMaxSize);
+        }
+
+        beginTest ("Glyphs can be used from several threads");
+        {
+            cache.reset();
+
+            constexpr int numThreads = 4, numLookups = 500;
+            std::atomic<int> numFailures { 0 };
+            OwnedArray<Thread> threads;
+
+            const String text ("The quick brown fox jumps over the lazy dog");
+            Array<int> glyphs;
+            Array<float> offsets;
+            font.getGlyphPositions (text, glyphs, offsets);
+
+            for (int t = 0; t < numThreads; ++t)
+            {
+                threads.add (new LambdaThread ([&, t]
+                {
+                    Random r (t);
+
+                    for (int i = 0; i < numLookups; ++i)
+                    {
+                        auto f = font.withHeight (10.0f + (float) r.nextInt (8));
+
+                        if (cache.findOrCreateGlyph (f, glyphs[r.nextInt (glyphs.size())]) == nullptr)
+                            ++numFailures;
+                    }
+                }));
+            }
+
+            for (auto* t : threads)
+                t->startThread();
+
+            for (auto* t : threads)
+                t->waitForThreadToExit (-1);
+
+            expectEquals (numFailures.load(), 0);
+
+            auto stats = cache.getStatistics();
+            expectEquals (stats.hits + stats.misses, (int64) (numThreads * numLookups));
+        }
+
+        cache.reset();
+    }
+
+private:
+    struct LambdaThread  : public Thread
+    {
+        LambdaThread (std::function<void()> f)  : Thread ("GlyphCache test"), function (std::move (f)) {}
+        void run() override     { function(); }
+
+        std::function<void()> function;
+    };
+
+    static int getGlyphNumber (const Font& font, juce_wchar character)
+    {
+        Array<int> glyphs;
+        Array<float> offsets;
+        font.getGlyphPositions (String::charToString (character), glyphs, offsets);
+        return glyphs[0];
+    }
+};
+
+static GlyphCacheTests glyphCacheTests;
+
+#endif
+
+} // namespace juce
@@ -135,176 +135,139 @@ public:
 };
 
 //==============================================================================
-/** Holds a cache of recently-used glyph objects of some type.
+/** Returns a pool of threads which the software renderers and image operations
+    share for doing work in parallel.
+*/
+JUCE_API ThreadPool& getSharedThreadPool();
 
-    @tags{Graphics}
+/** Calls a function once for each number from 0 to numTasks - 1, spreading the calls
+    across the threads of a pool and the calling thread, and returns when they have
+    all finished.
 */
-template <class CachedGlyphType, class RenderTargetType>
-class GlyphCache  : private DeletedAtShutdown
-{
-public:
-    GlyphCache()
-    {
-        reset();
-    }
+JUCE_API void runInParallel (ThreadPool& threadPool, int numTasks, const std::function<void (int)>& task);
 
-    ~GlyphCache() override
-    {
-        getSingletonPointer() = nullptr;
-    }
+//==============================================================================
+/** Holds a cache of glyphs which have been rasterised into edge tables.
 
-    static GlyphCache& getInstance()
-    {
-        auto& g = getSingletonPointer();
+    A single instance is shared by all of the renderers which draw glyphs as edge
+    tables, so each glyph only needs to be rasterised once, and it can be used by
+    several rendering threads at the same time. When the glyphs take up more than
+    the cache's maximum size, the least recently used ones are discarded.
 
-        if (g == nullptr)
-            g = new GlyphCache();
+    Glyphs are drawn by translating their edge tables, so a glyph from a typeface
+    that isn't hinted can be drawn at any sub-pixel position without needing a
+    separate version for each one.
 
-        return *g;
-    }
+    @tags{Graphics}
+*/
+class JUCE_API  GlyphCache  : private DeletedAtShutdown
+{
+public:
+    //==============================================================================
+    /** Returns the shared instance of the cache. */
+    static GlyphCache& getInstance();
+
+    /** Destructor. */
+    ~GlyphCache() override;
 
     //==============================================================================
-    void reset()
-    {
-        const ScopedLock sl (lock);
-        glyphs.clear();
-        addNewGlyphSlots (120);
-        hits = 0;
-        misses = 0;
-    }
+    /** A glyph which has been rasterised by the cache.
 
-    void drawGlyph (RenderTargetType& target, const Font& font, const int glyphNumber, Point<float> pos)
+        Its contents never change, so it can safely be used after it has been removed
+        from the cache, for as long as a pointer to it is being held.
+    */
+    class JUCE_API  Glyph  : public ReferenceCountedObject
     {
-        if (auto glyph = findOrCreateGlyph (font, glyphNumber))
+    public:
+        /** Draws the glyph onto a renderer, which must have a fillEdgeTable() method. */
+        template <class RendererType>
+        void draw (RendererType& state, Point<float> pos) const
         {
-            glyph->lastAccessCount = ++accessCounter;
-            glyph->draw (target, pos);
-        }
-    }
-
-    ReferenceCountedObjectPtr<CachedGlyphType> findOrCreateGlyph (const Font& font, int glyphNumber)
-    {
-        const ScopedLock sl (lock);
+            if (snapToIntegerCoordinate)
+                pos.x = std::floor (pos.x + 0.5f);
 
-        if (auto g = findExistingGlyph (font, glyphNumber))
-        {
-            ++hits;
-            return g;
+            if (edgeTable != nullptr)
+                state.fillEdgeTable (*edgeTable, pos.x, roundToInt (pos.y));
         }
 
-        ++misses;
-        auto g = getGlyphForReuse();
-        jassert (g != nullptr);
-        g->generate (font, glyphNumber);
-        return g;
-    }
+        /** The glyph's shape, or nullptr if it doesn't have one. */
+        const std::unique_ptr<const EdgeTable> edgeTable;
 
-private:
-    ReferenceCountedArray<CachedGlyphType> glyphs;
-    Atomic<int> accessCounter, hits, misses;
-    CriticalSection lock;
+        /** True if the typeface is hinted, so the glyph shouldn't be drawn at fractional positions. */
+        const bool snapToIntegerCoordinate;
 
-    ReferenceCountedObjectPtr<CachedGlyphType> findExistingGlyph (const Font& font, int glyphNumber) const noexcept
-    {
-        for (auto g : glyphs)
-            if (g->glyph == glyphNumber && g->font == font)
-                return *g;
+        using Ptr = ReferenceCountedObjectPtr<Glyph>;
 
-        return {};
-    }
+    private:
+        friend class GlyphCache;
 
-    ReferenceCountedObjectPtr<CachedGlyphType> getGlyphForReuse()
-    {
-        if (hits.get() + misses.get() > glyphs.size() * 16)
-        {
-            if (misses.get() * 2 > hits.get())
-                addNewGlyphSlots (32);
+        Glyph (const Font&, Typeface::Ptr, int glyphNumber);
 
-            hits = 0;
-            misses = 0;
-        }
+        const Typeface::Ptr typeface;
+        const float height, horizontalScale;
+        const int glyphNumber;
+        const size_t numBytes;
+        Glyph* previous = nullptr;
+        Glyph* next = nullptr;
 
-        if (auto g = findLeastRecentlyUsedGlyph())
-            return *g;
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Glyph)
+    };
 
-        addNewGlyphSlots (32);
-        return glyphs.getLast();
-    }
+    //==============================================================================
+    /** Returns a glyph for the given font, rasterising it if it's not already in the cache. */
+    Glyph::Ptr findOrCreateGlyph (const Font& font, int glyphNumber);
 
-    void addNewGlyphSlots (int num)
+    /** Draws a glyph onto a renderer, which must have a fillEdgeTable() method. */
+    template <class RendererType>
+    void drawGlyph (RendererType& target, const Font& font, int glyphNumber, Point<float> pos)
     {
-        glyphs.ensureStorageAllocated (glyphs.size() + num);
-
-        while (--num >= 0)
-            glyphs.add (new CachedGlyphType());
+        findOrCreateGlyph (font, glyphNumber)->draw (target, pos);
     }
 
-    CachedGlyphType* findLeastRecentlyUsedGlyph() const noexcept
-    {
-        CachedGlyphType* oldest = nullptr;
-        auto oldestCounter = std::numeric_limits<int>::max();
+    /** Removes all the glyphs from the cache. */
+    void reset();
 
-        for (auto* g : glyphs)
-        {
-            if (g->lastAccessCount <= oldestCounter
-                 && g->getReferenceCount() == 1)
-            {
-                oldestCounter = g->lastAccessCount;
-                oldest = g;
-            }
-        }
+    //==============================================================================
+    /** Sets the number of bytes that the cached glyphs are allowed to use.
+        The default is 8MB.
+    */
+    void setMaximumSize (size_t maxBytes);
 
-        return oldest;
-    }
+    /** Returns the number of bytes that the cached glyphs are allowed to use. */
+    size_t getMaximumSize() const;
 
-    static GlyphCache*& getSingletonPointer() noexcept
+    /** Some statistics about how well the cache is performing. */
+    struct Statistics
     {
-        static GlyphCache* g = nullptr;
-        return g;
-    }
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GlyphCache)
-};
-
-//==============================================================================
-/** Caches a glyph as an edge-table.
-
-    @tags{Graphics}
-*/
-template <class RendererType>
-class CachedGlyphEdgeTable  : public ReferenceCountedObject
-{
-public:
-    CachedGlyphEdgeTable() = default;
+        int64 hits = 0;             /**< The number of times a glyph was found in the cache. */
+        int64 misses = 0;           /**< The number of times a glyph had to be rasterised. */
+        int numGlyphs = 0;          /**< The number of glyphs currently in the cache. */
+        size_t numBytes = 0;        /**< The amount of memory used by the glyphs in the cache. */
+    };
 
-    void draw (RendererType& state, Point<float> pos) const
-    {
-        if (snapToIntegerCoordinate)
-            pos.x = std::floor (pos.x + 0.5f);
+    /** Returns the cache's current statistics. */
+    Statistics getStatistics() const;
 
-        if (edgeTable != nullptr)
-            state.fillEdgeTable (*edgeTable, pos.x, roundToInt (pos.y));
-    }
+private:
+    //==============================================================================
+    GlyphCache();
 
-    void generate (const Font& newFont, int glyphNumber)
-    {
-        font = newFont;
-        auto typeface = newFont.getTypefacePtr();
-        snapToIntegerCoordinate = typeface->isHinted();
-        glyph = glyphNumber;
+    struct Key;
+    struct KeyHash;
 
-        auto fontHeight = font.getHeight();
-        edgeTable.reset (typeface->getEdgeTableForGlyph (glyphNumber,
-                                                         AffineTransform::scale (fontHeight * font.getHorizontalScale(),
-                                                                                 fontHeight), fontHeight));
-    }
+    CriticalSection lock;
+    std::unique_ptr<FlatHashMap<Key, Glyph::Ptr, KeyHash>> glyphs;
+    Glyph* newest = nullptr;
+    Glyph* oldest = nullptr;
+    size_t totalBytes = 0, maxBytes = 8 * 1024 * 1024;
+    int64 hits = 0, misses = 0;
 
-    Font font;
-    std::unique_ptr<EdgeTable> edgeTable;
-    int glyph = 0, lastAccessCount = 0;
-    bool snapToIntegerCoordinate = false;
+    void addToFront (Glyph&) noexcept;
+    void moveToFront (Glyph&) noexcept;
+    void removeFromList (Glyph&) noexcept;
+    void removeOldestGlyphs();
 
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedGlyphEdgeTable)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GlyphCache)
 };
 
 //==============================================================================
@@ -555,6 +518,68 @@ namespace GradientPixelIterators
     };
 }
 
+//==============================================================================
+/** Functions for blending runs of tightly-packed pixels, which use SSE2 or NEON
+    instructions where they're available.
+
+    Each of these produces exactly the same pixels as calling blend() on each of the
+    destination pixels in turn.
+*/
+namespace SpanBlending
+{
+    /** Blends a colour onto a run of pixels, like PixelType::blend (colour). */
+    JUCE_API void blendColour (PixelARGB* dest, PixelARGB colour, int numPixels) noexcept;
+    JUCE_API void blendColour (PixelRGB* dest, PixelARGB colour, int numPixels) noexcept;
+    JUCE_API void blendColour (PixelAlpha* dest, PixelARGB colour, int numPixels) noexcept;
+
+    /** Blends a run of source pixels onto a run of pixels, like PixelType::blend (src). */
+    JUCE_API void blendPixels (PixelARGB* dest, const PixelARGB* src, int numPixels) noexcept;
+    JUCE_API void blendPixels (PixelRGB* dest, const PixelARGB* src, int numPixels) noexcept;
+    JUCE_API void blendPixels (PixelAlpha* dest, const PixelARGB* src, int numPixels) noexcept;
+
+    /** Blends a run of source pixels onto a run of pixels, like PixelType::blend (src, extraAlpha).
+        The extraAlpha value must be no greater than 256.
+    */
+    JUCE_API void blendPixels (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    JUCE_API void blendPixels (PixelRGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    JUCE_API void blendPixels (PixelAlpha* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+
+    /** Returns true if a run of pixels in an image is long enough to be worth using these
+        functions for, and the image's pixels are tightly packed so that they can be used.
+    */
+    template <class PixelType>
+    forcedinline bool canBlendSpan (const Image::BitmapData& data, int numPixels) noexcept
+    {
+        return numPixels >= 8 && (size_t) data.pixelStride == sizeof (PixelType);
+    }
+
+    /** Blends a run of pixels which are produced by calling a function for each x position.
+        The colours are generated in small batches which are then blended together.
+    */
+    template <class PixelType, class GeneratorFunction>
+    void blendGenerated (PixelType* dest, int x, int numPixels, uint32 extraAlpha, GeneratorFunction&& generate) noexcept
+    {
+        constexpr int batchSize = 64;
+        PixelARGB batch[batchSize];
+
+        while (numPixels > 0)
+        {
+            auto num = jmin (batchSize, numPixels);
+
+            for (int i = 0; i < num; ++i)
+                batch[i] = generate (x++);
+
+            if (extraAlpha < 0xff)
+                blendPixels (dest, batch, num, extraAlpha);
+            else
+                blendPixels (dest, batch, num);
+
+            dest += num;
+            numPixels -= num;
+        }
+    }
+}
+
 #define JUCE_PERFORM_PIXEL_OP_LOOP(op) \
 { \
     const int destStride = destData.pixelStride;  \
@@ -667,7 +692,10 @@ namespace EdgeTableFillers
 
         inline void blendLine (PixelType* dest, PixelARGB colour, int width) const noexcept
         {
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
+            if (SpanBlending::canBlendSpan<PixelType> (destData, width))
+                SpanBlending::blendColour (dest, colour, width);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
         }
 
         forcedinline void replaceLine (PixelRGB* dest, PixelARGB colour, int width) const noexcept
@@ -726,7 +754,10 @@ namespace EdgeTableFillers
         {
             auto* dest = getPixel (x);
 
-            if (alphaLevel < 0xff)
+            if (SpanBlending::canBlendSpan<PixelType> (destData, width))
+                SpanBlending::blendGenerated (dest, x, width, (uint32) alphaLevel,
+                                              [this] (int px) { return GradientType::getPixel (px); });
+            else if (alphaLevel < 0xff)
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
             else
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
@@ -734,8 +765,7 @@ namespace EdgeTableFillers
 
         void handleEdgeTableLineFull (int x, int width) const noexcept
         {
-            auto* dest = getPixel (x);
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+            handleEdgeTableLine (x, width, 0xff);
         }
 
         void handleEdgeTableRectangle (int x, int y, int width, int height, int alphaLevel) noexcept
@@ -814,7 +844,9 @@ namespace EdgeTableFillers
             alphaLevel = (alphaLevel * extraAlpha) >> 8;
             x -= xOffset;
 
-            if (repeatPattern)
+            if (canBlendSpan (width))
+                blendSpan (dest, x, width, (uint32) alphaLevel);
+            else if (repeatPattern)
             {
                 if (alphaLevel < 0xfe)
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) alphaLevel))
@@ -837,7 +869,9 @@ namespace EdgeTableFillers
             auto* dest = getDestPixel (x);
             x -= xOffset;
 
-            if (repeatPattern)
+            if (canBlendSpan (width))
+                blendSpan (dest, x, width, (uint32) extraAlpha);
+            else if (repeatPattern)
             {
                 if (extraAlpha < 0xfe)
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) extraAlpha))
@@ -902,6 +936,39 @@ namespace EdgeTableFillers
             return addBytesToPointer (sourceLineStart, x * srcData.pixelStride);
         }
 
+        forcedinline bool canBlendSpan (int width) const noexcept
+        {
+            if constexpr (std::is_same_v<SrcPixelType, PixelARGB>)
+                return SpanBlending::canBlendSpan<DestPixelType> (destData, width)
+                        && (size_t) srcData.pixelStride == sizeof (PixelARGB);
+
+            return false;
+        }
+
+        void blendSpan (DestPixelType* dest, int x, int width, uint32 alphaLevel) const noexcept
+        {
+            if (repeatPattern)
+                x %= srcData.width;
+            else
+                jassert (x >= 0 && x + width <= srcData.width);
+
+            while (width > 0)
+            {
+                // a repeating pattern is blended in sections which end at the edge of the source image
+                auto num = repeatPattern ? jmin (width, srcData.width - x) : width;
+                auto* src = reinterpret_cast<const PixelARGB*> (getSrcPixel (x));
+
+                if (alphaLevel < 0xfe)
+                    SpanBlending::blendPixels (dest, src, num, alphaLevel);
+                else
+                    SpanBlending::blendPixels (dest, src, num);
+
+                dest += num;
+                width -= num;
+                x = 0;
+            }
+        }
+
         forcedinline void copyRow (DestPixelType* dest, SrcPixelType const* src, int width) const noexcept
         {
             auto destStride = destData.pixelStride;
@@ -984,6 +1051,19 @@ namespace EdgeTableFillers
             alphaLevel *= extraAlpha;
             alphaLevel >>= 8;
 
+            if constexpr (std::is_same_v<SrcPixelType, PixelARGB>)
+            {
+                if (SpanBlending::canBlendSpan<DestPixelType> (destData, width))
+                {
+                    if (alphaLevel < 0xfe)
+                        SpanBlending::blendPixels (dest, span, width, (uint32) alphaLevel);
+                    else
+                        SpanBlending::blendPixels (dest, span, width);
+
+                    return;
+                }
+            }
+
             if (alphaLevel < 0xfe)
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++, (uint32) alphaLevel))
             else
@@ -1623,6 +1703,7 @@ struct ClipRegions
     struct EdgeTableRegion  : public Base
     {
         EdgeTableRegion (const EdgeTable& e)            : edgeTable (e) {}
+        EdgeTableRegion (EdgeTable&& e)                 : edgeTable (std::move (e)) {}
         EdgeTableRegion (Rectangle<int> r)              : edgeTable (r) {}
         EdgeTableRegion (Rectangle<float> r)            : edgeTable (r) {}
         EdgeTableRegion (const RectangleList<int>& r)   : edgeTable (r) {}
@@ -2328,7 +2409,12 @@ public:
             auto clipRect = clip->getClipBounds();
 
             if (path.getBoundsTransformed (trans).getSmallestIntegerContainer().intersects (clipRect))
-                fillShape (*new EdgeTableRegionType (clipRect, path, trans), false);
+            {
+                if (auto cached = PathCache::getInstance()->createEdgeTable (path, trans, clipRect))
+                    fillShape (*new EdgeTableRegionType (std::move (*cached)), false);
+                else
+                    fillShape (*new EdgeTableRegionType (clipRect, path, trans), false);
+            }
         }
     }
 
@@ -2524,13 +2610,6 @@ public:
         }
     }
 
-    using GlyphCacheType = GlyphCache<CachedGlyphEdgeTable<SoftwareRendererSavedState>, SoftwareRendererSavedState>;
-
-    static void clearGlyphCache()
-    {
-        GlyphCacheType::getInstance().reset();
-    }
-
     //==============================================================================
     void drawGlyph (int glyphNumber, const AffineTransform& trans)
     {
@@ -2538,7 +2617,7 @@ public:
         {
             if (trans.isOnlyTranslation() && ! transform.isRotated)
             {
-                auto& cache = GlyphCacheType::getInstance();
+                auto& cache = GlyphCache::getInstance();
                 Point<float> pos (trans.getTranslationX(), trans.getTranslationY());
 
                 if (transform.isOnlyTranslated)
@@ -273,6 +273,66 @@ struct ScalingHelpers
 
 static const char colourPropertyPrefix[] = "jcclr_";
 
+//==============================================================================
+struct Component::BackgroundLayer
+{
+    void paint (Component& owner, Graphics& g)
+    {
+        auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        auto compBounds = owner.getLocalBounds();
+        auto imageBounds = compBounds * scale;
+        auto format = owner.isOpaque() ? Image::RGB : Image::ARGB;
+
+        if (image.isNull() || image.getBounds() != imageBounds || image.getFormat() != format)
+        {
+            image = Image (format,
+                           jmax (1, imageBounds.getWidth()),
+                           jmax (1, imageBounds.getHeight()),
+                           ! owner.isOpaque());
+
+            validArea.clear();
+        }
+
+        if (! validArea.containsRectangle (compBounds))
+        {
+            Graphics imG (image);
+            auto& lg = imG.getInternalContext();
+
+            lg.addTransform (AffineTransform::scale (scale));
+
+            for (auto& i : validArea)
+                lg.excludeClipRectangle (i);
+
+            if (! owner.isOpaque())
+            {
+                lg.setFill (Colours::transparentBlack);
+                lg.fillRect (compBounds, true);
+                lg.setFill (Colours::black);
+            }
+
+            ComponentPaintMonitor::componentPainted (owner, false);
+            owner.paint (imG);
+            validArea = compBounds;
+        }
+        else
+        {
+            ComponentPaintMonitor::componentPainted (owner, true);
+        }
+
+        g.setColour (Colours::black);
+        g.drawImageTransformed (image, AffineTransform::scale ((float) compBounds.getWidth()  / (float) imageBounds.getWidth(),
+                                                               (float) compBounds.getHeight() / (float) imageBounds.getHeight()), false);
+    }
+
+    void invalidateAll()                            { validArea.clear(); }
+    void invalidate (const Rectangle<int>& area)    { validArea.subtract (area); }
+    void releaseResources()                         { image = Image(); }
+
+private:
+    Image image;
+    RectangleList<int> validArea;
+};
+
 //==============================================================================
 struct Component::ComponentHelpers
 {
@@ -472,6 +532,9 @@ struct Component::ComponentHelpers
         if (auto* cached = c.getCachedComponentImage())
             cached->releaseResources();
 
+        if (c.backgroundLayer != nullptr)
+            c.backgroundLayer->releaseResources();
+
         for (auto* child : c.childComponentList)
             releaseAllCachedImageResources (*child);
     }
@@ -917,6 +980,20 @@ void Component::setBufferedToImage (bool shouldBeBuffered)
     }
 }
 
+void Component::setBackgroundBufferedToImage (bool shouldBeBuffered)
+{
+    if (shouldBeBuffered != isBackgroundBufferedToImage())
+    {
+        backgroundLayer.reset (shouldBeBuffered ? new BackgroundLayer() : nullptr);
+        repaint();
+    }
+}
+
+bool Component::isBackgroundBufferedToImage() const noexcept
+{
+    return backgroundLayer != nullptr;
+}
+
 //==============================================================================
 void Component::reorderChildInternal (int sourceIndex, int destIndex)
 {
@@ -1907,16 +1984,22 @@ void Component::alphaChanged()
 //==============================================================================
 void Component::repaint()
 {
+    if (backgroundLayer != nullptr)
+        backgroundLayer->invalidateAll();
+
     internalRepaintUnchecked (getLocalBounds(), true);
 }
 
 void Component::repaint (int x, int y, int w, int h)
 {
-    internalRepaint ({ x, y, w, h });
+    repaint ({ x, y, w, h });
 }
 
 void Component::repaint (Rectangle<int> area)
 {
+    if (backgroundLayer != nullptr)
+        backgroundLayer->invalidate (area);
+
     internalRepaint (area);
 }
 
@@ -1994,20 +2077,33 @@ void Component::paintWithinParentContext (Graphics& g)
         paintEntireComponent (g, false);
 }
 
+void Component::internalPaint (Graphics& g)
+{
+    if (backgroundLayer != nullptr)
+    {
+        backgroundLayer->paint (*this, g);
+    }
+    else
+    {
+        ComponentPaintMonitor::componentPainted (*this, false);
+        paint (g);
+    }
+}
+
 void Component::paintComponentAndChildren (Graphics& g)
 {
     auto clipBounds = g.getClipBounds();
 
     if (flags.dontClipGraphicsFlag && getNumChildComponents() == 0)
     {
-        paint (g);
+        internalPaint (g);
     }
     else
     {
         Graphics::ScopedSaveState ss (g);
 
         if (! (ComponentHelpers::clipObscuredRegions (*this, g, clipBounds, {}) && g.isClipEmpty()))
-            paint (g);
+            internalPaint (g);
     }
 
     for (int i = 0; i < childComponentList.size(); ++i)
@@ -1068,6 +1068,28 @@ public:
     */
     void setBufferedToImage (bool shouldBeBuffered);
 
+    /** Makes the component keep the output of its paint() method in an internal buffer.
+
+        Unlike setBufferedToImage(), the buffer only holds what paint() draws, and not the
+        child components or anything drawn by paintOverChildren(), which are still drawn
+        on top of it each time. Repainting a child component doesn't invalidate the buffer,
+        so this is useful for a component with a complex but static background behind some
+        children that change often, e.g. meters or animations. When these are redrawn, the
+        area of the background behind them is just copied from the buffer rather than
+        being painted again.
+
+        The buffer is invalidated when repaint() is called on this component itself, and
+        when its size changes.
+
+        @see setBufferedToImage, ComponentPaintMonitor
+    */
+    void setBackgroundBufferedToImage (bool shouldBeBuffered);
+
+    /** Returns true if setBackgroundBufferedToImage() has been used to buffer this component.
+        @see setBackgroundBufferedToImage
+    */
+    bool isBackgroundBufferedToImage() const noexcept;
+
     /** Generates a snapshot of part of this component.
 
         This will return a new Image, the size of the rectangle specified,
@@ -2542,6 +2564,9 @@ private:
     ImageEffectFilter* effect = nullptr;
     std::unique_ptr<CachedComponentImage> cachedImage;
 
+    struct BackgroundLayer;
+    std::unique_ptr<BackgroundLayer> backgroundLayer;
+
     class MouseListenerList;
     std::unique_ptr<MouseListenerList> mouseListeners;
     std::unique_ptr<Array<KeyListener*>> keyListeners;
@@ -2613,6 +2638,7 @@ private:
     void internalRepaintUnchecked (Rectangle<int>, bool);
     Component* removeChildComponent (int index, bool sendParentEvents, bool sendChildEvents);
     void reorderChildInternal (int sourceIndex, int destIndex);
+    void internalPaint (Graphics&);
     void paintComponentAndChildren (Graphics&);
     void paintWithinParentContext (Graphics&);
     void sendMovedResizedMessages (bool wasMoved, bool wasResized);
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static Array<ComponentPaintMonitor*>& getActivePaintMonitors()
+{
+    static Array<ComponentPaintMonitor*> monitors;
+    return monitors;
+}
+
+ComponentPaintMonitor::ComponentPaintMonitor()
+{
+    JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
+    getActivePaintMonitors().add (this);
+}
+
+ComponentPaintMonitor::~ComponentPaintMonitor()
+{
+    JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
+    getActivePaintMonitors().removeFirstMatchingValue (this);
+}
+
+void ComponentPaintMonitor::componentPainted (Component& c, bool usedBuffer)
+{
+    for (auto* monitor : getActivePaintMonitors())
+    {
+        auto& count = monitor->counts[&c];
+
+        // If the component that was here has been deleted, this must be a new one at the same address
+        if (count.component == nullptr)
+        {
+            count = {};
+            count.component = &c;
+            count.description = c.getName().isNotEmpty() ? c.getName()
+                                                         : String (typeid (c).name());
+        }
+
+        if (usedBuffer)
+            ++count.numBufferedPaints;
+        else
+            ++count.numPaints;
+    }
+}
+
+const ComponentPaintMonitor::PaintCount* ComponentPaintMonitor::findCount (const Component& c) const
+{
+    auto found = counts.find (&c);
+
+    if (found != counts.end() && found->second.component == &c)
+        return &(found->second);
+
+    return nullptr;
+}
+
+std::vector<ComponentPaintMonitor::PaintCount> ComponentPaintMonitor::getPaintCounts() const
+{
+    std::vector<PaintCount> result;
+    result.reserve (counts.size());
+
+    for (auto& c : counts)
+        result.push_back (c.second);
+
+    std::stable_sort (result.begin(), result.end(), [] (const PaintCount& a, const PaintCount& b)
+    {
+        return a.numPaints > b.numPaints;
+    });
+
+    return result;
+}
+
+int ComponentPaintMonitor::getNumPaints (const Component& c) const
+{
+    if (auto* count = findCount (c))
+        return count->numPaints;
+
+    return 0;
+}
+
+int ComponentPaintMonitor::getNumBufferedPaints (const Component& c) const
+{
+    if (auto* count = findCount (c))
+        return count->numBufferedPaints;
+
+    return 0;
+}
+
+String ComponentPaintMonitor::getSummary (int maxNumComponents) const
+{
+    String s;
+
+    for (auto& count : getPaintCounts())
+    {
+        if (--maxNumComponents < 0)
+            break;
+
+        s << String (count.numPaints).paddedLeft (' ', 8)
+          << String (count.numBufferedPaints).paddedLeft (' ', 8)
+          << "  " << count.description
+          << (count.component == nullptr ? " (deleted)" : "")
+          << newLine;
+    }
+
+    return s;
+}
+
+void ComponentPaintMonitor::reset()
+{
+    counts.clear();
+}
+
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ComponentPaintMonitorTests  : public UnitTest
+{
+public:
+    ComponentPaintMonitorTests()
+        : UnitTest ("ComponentPaintMonitor", UnitTestCategories::gui)
+    {}
+
+    void runTest() override
+    {
+        struct FilledComponent  : public Component
+        {
+            explicit FilledComponent (Colour c)  : colour (c) {}
+
+            void paint (Graphics& g) override
+            {
+                g.setColour (colour);
+                g.fillEllipse (getLocalBounds().toFloat());
+            }
+
+            Colour colour;
+        };
+
+        FilledComponent parent (Colours::red), child (Colours::blue);
+        parent.setBounds (0, 0, 100, 80);
+        child.setBounds (10, 10, 30, 20);
+        parent.addAndMakeVisible (child);
+
+        beginTest ("Paint calls are counted");
+        {
+            ComponentPaintMonitor monitor;
+
+            parent.createComponentSnapshot (parent.getLocalBounds());
+            parent.createComponentSnapshot (parent.getLocalBounds());
+
+            expectEquals (monitor.getNumPaints (parent), 2);
+            expectEquals (monitor.getNumPaints (child), 2);
+            expectEquals (monitor.getNumBufferedPaints (parent), 0);
+
+            auto counts = monitor.getPaintCounts();
+            expectEquals ((int) counts.size(), 2);
+            expect (monitor.getSummary().isNotEmpty());
+
+            monitor.reset();
+            expectEquals (monitor.getNumPaints (parent), 0);
+        }
+
+        beginTest ("Background buffers are only repainted when the component is");
+        {
+            auto unbuffered = parent.createComponentSnapshot (parent.getLocalBounds());
+
+            ComponentPaintMonitor monitor;
+            parent.setBackgroundBufferedToImage (true);
+            expect (parent.isBackgroundBufferedToImage());
+
+            auto buffered = parent.createComponentSnapshot (parent.getLocalBounds());
+            child.repaint();
+            parent.createComponentSnapshot (parent.getLocalBounds());
+
+            expectEquals (monitor.getNumPaints (parent), 1);
+            expectEquals (monitor.getNumBufferedPaints (parent), 1);
+            expectEquals (monitor.getNumPaints (child), 2);
+
+            for (int y = 0; y < unbuffered.getHeight(); ++y)
+                for (int x = 0; x < unbuffered.getWidth(); ++x)
+                    expect (unbuffered.getPixelAt (x, y) == buffered.getPixelAt (x, y));
+
+            parent.repaint (0, 0, 5, 5);
+            parent.createComponentSnapshot (parent.getLocalBounds());
+            expectEquals (monitor.getNumPaints (parent), 2);
+
+            parent.setBackgroundBufferedToImage (false);
+        }
+    }
+};
+
+static ComponentPaintMonitorTests componentPaintMonitorTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Counts how many times components get painted, to help find the ones that are
+    being redrawn more often than they need to be.
+
+    While one of these objects exists, it keeps a tally of each call to a component's
+    paint() method, and of each time that a component which uses
+    Component::setBackgroundBufferedToImage() was drawn from its buffer instead. Create
+    one, use your app for a while, and then have a look at getPaintCounts() or
+    getSummary() to see what's been going on.
+
+    This is meant as a debugging aid, and it must only be used on the message thread.
+
+    @see Component::setBackgroundBufferedToImage
+
+    @tags{GUI}
+*/
+class JUCE_API  ComponentPaintMonitor
+{
+public:
+    //==============================================================================
+    /** Creates a monitor, which starts counting straight away. */
+    ComponentPaintMonitor();
+
+    /** Destructor. */
+    ~ComponentPaintMonitor();
+
+    //==============================================================================
+    /** The number of times that a component has been drawn. */
+    struct PaintCount
+    {
+        Component::SafePointer<Component> component;  /**< The component, or nullptr if it has been deleted. */
+        String description;                             /**< The component's name, or its type if it has no name. */
+        int numPaints = 0;                              /**< The number of times its paint() method was called. */
+        int numBufferedPaints = 0;                      /**< The number of times its background was drawn from a buffer instead. */
+    };
+
+    /** Returns the counts for all the components that have been drawn, with the most
+        frequently painted ones first.
+    */
+    std::vector<PaintCount> getPaintCounts() const;
+
+    /** Returns the number of times that the paint() method of the given component was called. */
+    int getNumPaints (const Component&) const;
+
+    /** Returns the number of times that the given component's background was drawn from
+        its buffer rather than by calling paint().
+        @see Component::setBackgroundBufferedToImage
+    */
+    int getNumBufferedPaints (const Component&) const;
+
+    /** Returns a human-readable table of the most frequently painted components. */
+    String getSummary (int maxNumComponents = 20) const;
+
+    /** Sets all the counts back to zero. */
+    void reset();
+
+private:
+    //==============================================================================
+    friend class Component;
+
+    static void componentPainted (Component&, bool usedBuffer);
+    const PaintCount* findCount (const Component&) const;
+
+    std::map<const Component*, PaintCount> counts;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ComponentPaintMonitor)
+};
+
+} // namespace juce
@@ -156,6 +156,7 @@ namespace juce
 #include "accessibility/juce_AccessibilityHandler.cpp"
 #include "components/juce_Component.cpp"
 #include "components/juce_ComponentListener.cpp"
+#include "components/juce_ComponentPaintMonitor.cpp"
 #include "components/juce_FocusTraverser.cpp"
 #include "mouse/juce_MouseInputSource.cpp"
 #include "desktop/juce_Displays.cpp"
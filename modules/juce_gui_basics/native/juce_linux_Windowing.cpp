@@ -443,6 +443,10 @@ private:
 
             auto originalRepaintRegion = regionsNeedingRepaint;
             regionsNeedingRepaint.clear();
+
+            // Each rectangle gets blitted separately, so it's worth drawing a few extra
+            // pixels to avoid having lots of small, nearly-adjacent ones
+            originalRepaintRegion.coalesce (costOfEachRepaintRectangle);
             auto totalArea = originalRepaintRegion.getBounds();
 
             if (! totalArea.isEmpty())
@@ -503,6 +507,8 @@ private:
         uint32 lastTimeImageUsed = 0;
         RectangleList<int> regionsNeedingRepaint;
 
+        static constexpr int costOfEachRepaintRectangle = 64 * 64;
+
         bool useARGBImagesForRendering = XWindowSystem::getInstance()->canUseARGBImages();
 
         JUCE_DECLARE_NON_COPYABLE (LinuxRepaintManager)
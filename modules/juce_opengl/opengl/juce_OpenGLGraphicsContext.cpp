@@ -26,8 +26,6 @@
 namespace juce
 {
 
-extern void (*clearOpenGLGlyphCache)(); // declared in juce_graphics
-
 namespace OpenGLRendering
 {
 
@@ -84,7 +82,8 @@ struct CachedImageList  : public ReferenceCountedObject,
             totalSize += c->imageSize;
 
             while (totalSize > maxCacheSize && images.size() > 1 && totalSize > 0)
-                removeOldestItem();
+                if (! removeOldestItem())
+                    break;
         }
 
         return c->getTextureInfo();
@@ -190,19 +189,21 @@ private:
         return {};
     }
 
-    void removeOldestItem()
+    bool removeOldestItem()
     {
         CachedImage* oldest = nullptr;
 
         for (auto& i : images)
-            if (oldest == nullptr || i->lastUsed < oldest->lastUsed)
+            if ((oldest == nullptr || i->lastUsed < oldest->lastUsed)
+                 && ! ImageCache::shouldRetainGPUTextureFor (i->pixelData))
                 oldest = i;
 
-        if (oldest != nullptr)
-        {
-            totalSize -= oldest->imageSize;
-            images.removeObject (oldest);
-        }
+        if (oldest == nullptr)
+            return false;
+
+        totalSize -= oldest->imageSize;
+        images.removeObject (oldest);
+        return true;
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedImageList)
@@ -1635,15 +1636,13 @@ struct SavedState  : public RenderingHelpers::SavedStateBase<SavedState>
         }
     }
 
-    using GlyphCacheType = RenderingHelpers::GlyphCache<RenderingHelpers::CachedGlyphEdgeTable<SavedState>, SavedState>;
-
     void drawGlyph (int glyphNumber, const AffineTransform& trans)
     {
         if (clip != nullptr)
         {
             if (trans.isOnlyTranslation() && ! transform.isRotated)
             {
-                auto& cache = GlyphCacheType::getInstance();
+                auto& cache = RenderingHelpers::GlyphCache::getInstance();
                 Point<float> pos (trans.getTranslationX(), trans.getTranslationY());
 
                 if (transform.isOnlyTranslated)
@@ -1814,15 +1813,8 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NonShaderContext)
 };
 
-static void clearOpenGLGlyphCacheCallback()
-{
-    SavedState::GlyphCacheType::getInstance().reset();
-}
-
 static std::unique_ptr<LowLevelGraphicsContext> createOpenGLContext (const Target& target)
 {
-    clearOpenGLGlyphCache = clearOpenGLGlyphCacheCallback;
-
     if (target.context.areShadersAvailable())
         return std::make_unique<ShaderContext> (target);
 